@@ -50,6 +50,8 @@ gboolean fma_core_utils_boolean_from_string( const gchar *string );
 #ifdef FMA_ENABLE_DEPRECATED
 gchar   *fma_core_utils_str_add_prefix( const gchar *prefix, const gchar *str );
 #endif
+guint    fma_core_utils_str_ascii_case_hash ( gconstpointer str );
+gboolean fma_core_utils_str_ascii_case_equal( gconstpointer str1, gconstpointer str2 );
 int      fma_core_utils_str_collate( const gchar *str1, const gchar *str2 );
 gchar   *fma_core_utils_str_remove_char( const gchar *string, const gchar *to_remove );
 gchar   *fma_core_utils_str_remove_suffix( const gchar *string, const gchar *suffix );
@@ -98,10 +98,14 @@ GType    fma_icontext_get_type        ( void );
 gboolean fma_icontext_are_equal       ( const FMAIContext *a, const FMAIContext *b );
 gboolean fma_icontext_is_candidate    ( const FMAIContext *context, guint target, GList *selection );
 gboolean fma_icontext_is_valid        ( const FMAIContext *context );
+gboolean fma_icontext_is_dynamic      ( const FMAIContext *context );
+void     fma_icontext_dump_stats      ( void );
+void     fma_icontext_set_view        ( const gchar *view );
 
 void     fma_icontext_check_mimetypes ( const FMAIContext *context );
 
 void     fma_icontext_copy            ( FMAIContext *context, const FMAIContext *source );
+void     fma_icontext_data_changed    ( FMAIContext *context, const gchar *name );
 void     fma_icontext_read_done       ( FMAIContext *context );
 void     fma_icontext_set_scheme      ( FMAIContext *context, const gchar *scheme, gboolean selected );
 void     fma_icontext_set_only_desktop( FMAIContext *context, const gchar *desktop, gboolean selected );
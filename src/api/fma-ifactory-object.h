@@ -255,6 +255,7 @@ GType         fma_ifactory_object_get_type       ( void );
 FMADataBoxed *fma_ifactory_object_get_data_boxed ( const FMAIFactoryObject *object, const gchar *name );
 FMADataGroup *fma_ifactory_object_get_data_groups( const FMAIFactoryObject *object );
 void         *fma_ifactory_object_get_as_void    ( const FMAIFactoryObject *object, const gchar *name );
+gconstpointer fma_ifactory_object_peek           ( const FMAIFactoryObject *object, const gchar *name );
 void          fma_ifactory_object_set_from_void  ( FMAIFactoryObject *object, const gchar *name, const void *data );
 
 G_END_DECLS
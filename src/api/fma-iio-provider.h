@@ -253,6 +253,10 @@ typedef struct _FMAIIOProviderInterfacePrivate     FMAIIOProviderInterfacePrivat
  * @write_item:          [should] writes an item.
  * @delete_item:         [should] deletes an item.
  * @duplicate_data:      [may]    let the I/O provider duplicates its specific data.
+ * @get_sources:         [may]    lists the directories and files the items are read from.
+ * @read_item_from_path: [may]    reads the item a changed path refers to.
+ * @is_able_to_read_concurrently: [may] tells whether read_items() may run
+ *                                concurrently with other I/O providers.
  *
  * This defines the methods that a #FMAIIOProvider may, should, or must
  * implement.
@@ -468,6 +472,94 @@ typedef struct {
 											FMAObjectItem *dest,
 											const FMAObjectItem *source,
 											GSList **messages );
+
+	/**
+	 * get_sources:
+	 * @instance: the FMAIIOProvider provider.
+	 *
+	 * Lists the directories and the files the read_items() method would
+	 * read its items from.
+	 *
+	 * FileManager-Actions uses this list to check whether a previously
+	 * saved snapshot of the items tree is still up to date: the items are
+	 * considered unchanged as long as neither the listed paths nor the
+	 * files directly contained in the listed directories have been
+	 * modified. When the snapshot is used, read_items() is not called, so
+	 * the I/O provider should take this opportunity to start monitoring
+	 * its sources as it would have done while reading the items.
+	 *
+	 * An I/O provider which does not implement this method prevents any
+	 * snapshot to be used.
+	 *
+	 * Return value: if implemented, this method must return a #GSList
+	 * list of paths, as newly allocated strings which will be
+	 * fma_core_utils_slist_free() by the caller.
+	 *
+	 * Defaults to NULL list.
+	 *
+	 * Since: 3.5
+	 */
+	GSList * ( *get_sources )        ( const FMAIIOProvider *instance );
+
+	/**
+	 * read_item_from_path:
+	 * @instance: the FMAIIOProvider provider.
+	 * @path: a path which has been reported as changed through
+	 *  fma_iio_provider_paths_changed().
+	 * @id: [out]: a pointer to a string which will be set to the
+	 *  identifier of the item the @path refers to, as a newly allocated
+	 *  string which will be g_free() by the caller, or %NULL if the
+	 *  @path does not refer to any item.
+	 * @item: [out]: a pointer to a FMAObjectItem which will be set to
+	 *  the item which is now read for this @id, or %NULL if the item
+	 *  does not exist any more.
+	 * @messages: a pointer to a GSList list of strings; the provider
+	 *  may append messages to this list, but shouldn't reinitialize it.
+	 *
+	 * Re-reads only the item a changed @path refers to, so that
+	 * FileManager-Actions is able to update its tree of items without
+	 * reloading all of them.
+	 *
+	 * Note that the returned @item is not necessarily read from @path
+	 * itself: it is the item which would have been returned by
+	 * read_items() for this @id.
+	 *
+	 * Return value: if implemented, this method must return %TRUE if
+	 * the change has been handled, or %FALSE if the whole items list
+	 * must be reloaded (e.g. because a directory has been removed).
+	 *
+	 * Defaults to FALSE.
+	 *
+	 * Since: 3.5
+	 */
+	gboolean ( *read_item_from_path )( const FMAIIOProvider *instance,
+											const gchar *path,
+											gchar **id,
+											FMAObjectItem **item,
+											GSList **messages );
+
+	/**
+	 * is_able_to_read_concurrently:
+	 * @instance: the FMAIIOProvider provider.
+	 *
+	 * FileManager-Actions may call the read_items() method of several
+	 * I/O providers concurrently, each one on a thread of the shared
+	 * #FMAWorkerPool, while still merging their items in the order of
+	 * the I/O providers priority.
+	 *
+	 * An I/O provider which answers %TRUE here guarantees that its
+	 * read_items() method may be called from any thread; note that the
+	 * sources it may attach then belong to the global default main
+	 * context.
+	 *
+	 * Return value: if implemented, this method must return %TRUE if
+	 * read_items() may be run on a worker thread.
+	 *
+	 * Defaults to FALSE.
+	 *
+	 * Since: 3.5
+	 */
+	gboolean ( *is_able_to_read_concurrently )( const FMAIIOProvider *instance );
 }
 	FMAIIOProviderInterface;
 
@@ -541,7 +633,8 @@ GType fma_iio_provider_get_type    ( void );
 
 /* -- to be called by the I/O provider when an item has changed
  */
-void  fma_iio_provider_item_changed( const FMAIIOProvider *instance );
+void  fma_iio_provider_item_changed ( const FMAIIOProvider *instance );
+void  fma_iio_provider_paths_changed( const FMAIIOProvider *instance, GSList *paths );
 
 G_END_DECLS
 
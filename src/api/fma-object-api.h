@@ -39,6 +39,12 @@
  * We define here a common API which makes easier to write (and read)
  * the code; all object functions are named fma_object; all arguments
  * are casted directly in the macro.
+ *
+ * The fma_object_get_xxx() string and list accessors return newly allocated
+ * copies, which should be released by the caller. The fma_object_peek_xxx()
+ * ones return the very value stored in the object, which should not be
+ * modified nor released, and which is only valid until this same data be
+ * set again.
  */
 
 #include "fma-ifactory-object.h"
@@ -78,6 +84,8 @@ G_BEGIN_DECLS
 #define fma_object_get_id( obj )                         (( gchar * ) fma_ifactory_object_get_as_void( FMA_IFACTORY_OBJECT( obj ), FMAFO_DATA_ID ))
 #define fma_object_get_label( obj )                      (( gchar * ) fma_ifactory_object_get_as_void( FMA_IFACTORY_OBJECT( obj ), ( FMA_IS_OBJECT_PROFILE( obj ) ? FMAFO_DATA_DESCNAME : FMAFO_DATA_LABEL )))
 #define fma_object_get_label_noloc( obj )                (( gchar * )( FMA_IS_OBJECT_PROFILE( obj ) ? fma_ifactory_object_get_as_void( FMA_IFACTORY_OBJECT( obj ), FMAFO_DATA_DESCNAME_NOLOC ) : NULL ))
+#define fma_object_peek_id( obj )                        (( const gchar * ) fma_ifactory_object_peek( FMA_IFACTORY_OBJECT( obj ), FMAFO_DATA_ID ))
+#define fma_object_peek_label( obj )                     (( const gchar * ) fma_ifactory_object_peek( FMA_IFACTORY_OBJECT( obj ), ( FMA_IS_OBJECT_PROFILE( obj ) ? FMAFO_DATA_DESCNAME : FMAFO_DATA_LABEL )))
 #define fma_object_get_parent( obj )                     (( FMAObjectItem * ) fma_ifactory_object_get_as_void( FMA_IFACTORY_OBJECT( obj ), FMAFO_DATA_PARENT ))
 
 #define fma_object_set_id( obj, id )                     fma_ifactory_object_set_from_void( FMA_IFACTORY_OBJECT( obj ), FMAFO_DATA_ID, ( const void * )( id ))
@@ -100,6 +108,9 @@ G_BEGIN_DECLS
 #define fma_object_get_description( obj )                (( gchar * ) fma_ifactory_object_get_as_void( FMA_IFACTORY_OBJECT( obj ), FMAFO_DATA_DESCRIPTION ))
 #define fma_object_get_items( obj )                      (( GList * ) fma_ifactory_object_get_as_void( FMA_IFACTORY_OBJECT( obj ), FMAFO_DATA_SUBITEMS ))
 #define fma_object_get_items_slist( obj )                (( GSList * ) fma_ifactory_object_get_as_void( FMA_IFACTORY_OBJECT( obj ), FMAFO_DATA_SUBITEMS_SLIST ))
+#define fma_object_peek_tooltip( obj )                   (( const gchar * ) fma_ifactory_object_peek( FMA_IFACTORY_OBJECT( obj ), FMAFO_DATA_TOOLTIP ))
+#define fma_object_peek_icon( obj )                      (( const gchar * ) fma_ifactory_object_peek( FMA_IFACTORY_OBJECT( obj ), FMAFO_DATA_ICON ))
+#define fma_object_peek_items_slist( obj )               (( const GSList * ) fma_ifactory_object_peek( FMA_IFACTORY_OBJECT( obj ), FMAFO_DATA_SUBITEMS_SLIST ))
 #define fma_object_is_enabled( obj )                     (( gboolean ) GPOINTER_TO_UINT( fma_ifactory_object_get_as_void( FMA_IFACTORY_OBJECT( obj ), FMAFO_DATA_ENABLED )))
 #define fma_object_is_readonly( obj )                    (( gboolean ) GPOINTER_TO_UINT( fma_ifactory_object_get_as_void( FMA_IFACTORY_OBJECT( obj ), FMAFO_DATA_READONLY )))
 #define fma_object_get_provider( obj )                   fma_ifactory_object_get_as_void( FMA_IFACTORY_OBJECT( obj ), FMAFO_DATA_PROVIDER )
@@ -143,6 +154,7 @@ G_BEGIN_DECLS
 #define fma_object_get_toolbar_label( obj )              (( gchar * ) fma_ifactory_object_get_as_void( FMA_IFACTORY_OBJECT( obj ), FMAFO_DATA_TOOLBAR_LABEL ))
 #define fma_object_is_toolbar_same_label( obj )          (( gboolean ) GPOINTER_TO_UINT( fma_ifactory_object_get_as_void( FMA_IFACTORY_OBJECT( obj ), FMAFO_DATA_TOOLBAR_SAME_LABEL )))
 #define fma_object_get_last_allocated( obj )             (( guint ) GPOINTER_TO_UINT( fma_ifactory_object_get_as_void( FMA_IFACTORY_OBJECT( obj ), FMAFO_DATA_LAST_ALLOCATED )))
+#define fma_object_peek_toolbar_label( obj )             (( const gchar * ) fma_ifactory_object_peek( FMA_IFACTORY_OBJECT( obj ), FMAFO_DATA_TOOLBAR_LABEL ))
 
 #define fma_object_set_version( obj, version )           fma_ifactory_object_set_from_void( FMA_IFACTORY_OBJECT( obj ), FMAFO_DATA_VERSION, ( const void * )( version ))
 #define fma_object_set_target_selection( obj, target )   fma_ifactory_object_set_from_void( FMA_IFACTORY_OBJECT( obj ), FMAFO_DATA_TARGET_SELECTION, ( const void * ) GUINT_TO_POINTER( target ))
@@ -165,6 +177,9 @@ G_BEGIN_DECLS
 #define fma_object_get_startup_notify( obj )             (( gboolean ) GPOINTER_TO_UINT( fma_ifactory_object_get_as_void( FMA_IFACTORY_OBJECT( obj ), FMAFO_DATA_STARTUP_NOTIFY )))
 #define fma_object_get_startup_class( obj )              (( gchar * ) fma_ifactory_object_get_as_void( FMA_IFACTORY_OBJECT( obj ), FMAFO_DATA_STARTUP_WMCLASS ))
 #define fma_object_get_execute_as( obj )                 (( gchar * ) fma_ifactory_object_get_as_void( FMA_IFACTORY_OBJECT( obj ), FMAFO_DATA_EXECUTE_AS ))
+#define fma_object_peek_path( obj )                      (( const gchar * ) fma_ifactory_object_peek( FMA_IFACTORY_OBJECT( obj ), FMAFO_DATA_PATH ))
+#define fma_object_peek_parameters( obj )                (( const gchar * ) fma_ifactory_object_peek( FMA_IFACTORY_OBJECT( obj ), FMAFO_DATA_PARAMETERS ))
+#define fma_object_peek_working_dir( obj )               (( const gchar * ) fma_ifactory_object_peek( FMA_IFACTORY_OBJECT( obj ), FMAFO_DATA_WORKING_DIR ))
 
 #define fma_object_set_path( obj, path )                 fma_ifactory_object_set_from_void( FMA_IFACTORY_OBJECT( obj ), FMAFO_DATA_PATH, ( const void * )( path ))
 #define fma_object_set_parameters( obj, parms )          fma_ifactory_object_set_from_void( FMA_IFACTORY_OBJECT( obj ), FMAFO_DATA_PARAMETERS, ( const void * )( parms ))
@@ -192,6 +207,18 @@ G_BEGIN_DECLS
 #define fma_object_get_show_if_running( obj )            (( gchar * ) fma_ifactory_object_get_as_void( FMA_IFACTORY_OBJECT( obj ), FMAFO_DATA_SHOW_IF_RUNNING ))
 #define fma_object_get_selection_count( obj )            (( gchar * ) fma_ifactory_object_get_as_void( FMA_IFACTORY_OBJECT( obj ), FMAFO_DATA_SELECTION_COUNT ))
 #define fma_object_get_capabilities( obj )               (( GSList * ) fma_ifactory_object_get_as_void( FMA_IFACTORY_OBJECT( obj ), FMAFO_DATA_CAPABILITITES ))
+#define fma_object_peek_basenames( obj )                 (( const GSList * ) fma_ifactory_object_peek( FMA_IFACTORY_OBJECT( obj ), FMAFO_DATA_BASENAMES ))
+#define fma_object_peek_mimetypes( obj )                 (( const GSList * ) fma_ifactory_object_peek( FMA_IFACTORY_OBJECT( obj ), FMAFO_DATA_MIMETYPES ))
+#define fma_object_peek_folders( obj )                   (( const GSList * ) fma_ifactory_object_peek( FMA_IFACTORY_OBJECT( obj ), FMAFO_DATA_FOLDERS ))
+#define fma_object_peek_schemes( obj )                   (( const GSList * ) fma_ifactory_object_peek( FMA_IFACTORY_OBJECT( obj ), FMAFO_DATA_SCHEMES ))
+#define fma_object_peek_only_show_in( obj )              (( const GSList * ) fma_ifactory_object_peek( FMA_IFACTORY_OBJECT( obj ), FMAFO_DATA_ONLY_SHOW ))
+#define fma_object_peek_not_show_in( obj )               (( const GSList * ) fma_ifactory_object_peek( FMA_IFACTORY_OBJECT( obj ), FMAFO_DATA_NOT_SHOW ))
+#define fma_object_peek_try_exec( obj )                  (( const gchar * ) fma_ifactory_object_peek( FMA_IFACTORY_OBJECT( obj ), FMAFO_DATA_TRY_EXEC ))
+#define fma_object_peek_show_if_registered( obj )        (( const gchar * ) fma_ifactory_object_peek( FMA_IFACTORY_OBJECT( obj ), FMAFO_DATA_SHOW_IF_REGISTERED ))
+#define fma_object_peek_show_if_true( obj )              (( const gchar * ) fma_ifactory_object_peek( FMA_IFACTORY_OBJECT( obj ), FMAFO_DATA_SHOW_IF_TRUE ))
+#define fma_object_peek_show_if_running( obj )           (( const gchar * ) fma_ifactory_object_peek( FMA_IFACTORY_OBJECT( obj ), FMAFO_DATA_SHOW_IF_RUNNING ))
+#define fma_object_peek_selection_count( obj )           (( const gchar * ) fma_ifactory_object_peek( FMA_IFACTORY_OBJECT( obj ), FMAFO_DATA_SELECTION_COUNT ))
+#define fma_object_peek_capabilities( obj )              (( const GSList * ) fma_ifactory_object_peek( FMA_IFACTORY_OBJECT( obj ), FMAFO_DATA_CAPABILITITES ))
 
 #define fma_object_set_basenames( obj, bnames )          fma_ifactory_object_set_from_void( FMA_IFACTORY_OBJECT( obj ), FMAFO_DATA_BASENAMES, ( const void * )( bnames ))
 #define fma_object_set_matchcase( obj, match )           fma_ifactory_object_set_from_void( FMA_IFACTORY_OBJECT( obj ), FMAFO_DATA_MATCHCASE, ( const void * ) GUINT_TO_POINTER( match ))
@@ -58,9 +58,12 @@ typedef void ( *FMATimeoutFunc )( void *user_data );
 
 /**
  * FMATimeout:
- * @timeout:   timeout configurable parameter (ms)
- * @handler:   handler function
- * @user_data: user data
+ * @timeout:     timeout configurable parameter (ms)
+ * @handler:     handler function
+ * @user_data:   user data
+ * @max_latency: the maximum delay (ms) between the first event of a burst
+ *               and the triggering of the @handler, or zero for no limit;
+ *               since 3.5
  *
  * This structure let the user (i.e. the code which uses it) manage functions
  * which should only be called after some time of inactivity, which is typically
@@ -75,7 +78,8 @@ typedef void ( *FMATimeoutFunc )( void *user_data );
  * When an event is detected, the fma_timeout_event() function must be called
  * with this structure. The function makes sure that the @handler callback
  * will be triggered as soon as no event will be recorded after @timeout
- * milliseconds of inactivity.
+ * milliseconds of inactivity, or at latest @max_latency milliseconds after
+ * the first event of the burst when this later is set.
  *
  * Since: 3.1
  */
@@ -84,13 +88,20 @@ typedef struct {
 	guint          timeout;
 	FMATimeoutFunc handler;
 	gpointer       user_data;
+	guint          max_latency;
 	/*< private >*/
-	GTimeVal       last_time;
+	gint64         first_time;
+	gint64         last_time;
 	guint          source_id;
+	guint          coalesced;
+	guint          flushes;
 }
 	FMATimeout;
 
-void fma_timeout_event( FMATimeout *timeout );
+void  fma_timeout_event        ( FMATimeout *timeout );
+
+guint fma_timeout_get_coalesced( const FMATimeout *timeout );
+guint fma_timeout_get_flushes  ( const FMATimeout *timeout );
 
 G_END_DECLS
 
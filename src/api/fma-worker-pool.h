@@ -0,0 +1,88 @@
+/*
+ * FileManager-Actions
+ * A file-manager extension which offers configurable context menu actions.
+ *
+ * Copyright (C) 2005 The GNOME Foundation
+ * Copyright (C) 2006-2008 Frederic Ruaudel and others (see AUTHORS)
+ * Copyright (C) 2009-2015 Pierre Wieser and others (see AUTHORS)
+ *
+ * FileManager-Actions is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * FileManager-Actions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FileManager-Actions; see the file COPYING. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Authors:
+ *   Frederic Ruaudel <grumz@grumz.net>
+ *   Rodrigo Moya <rodrigo@gnome-db.org>
+ *   Pierre Wieser <pwieser@trychlos.org>
+ *   ... and many others (see AUTHORS)
+ */
+
+#ifndef __FILEMANAGER_ACTIONS_API_WORKER_POOL_H__
+#define __FILEMANAGER_ACTIONS_API_WORKER_POOL_H__
+
+/**
+ * SECTION: worker-pool
+ * @title: FMAWorkerPool
+ * @short_description: A Shared Pool of Worker Threads
+ * @include: filemanager-actions/fma-worker-pool.h
+ *
+ * FileManager-Actions maintains a pool of worker threads which is
+ * shared between the library and the plugins, and is used to run
+ * independant tasks concurrently, e.g. reading items from several I/O
+ * providers, or parsing many files.
+ *
+ * A batch of tasks is a #GPtrArray whose each element is passed in turn
+ * to the worker function; this later should store its results in the
+ * element itself, so that the caller is able to consume them in the
+ * order of the array, whatever be the order in which the tasks have
+ * actually been run.
+ *
+ * The thread which waits for a batch takes its part of the work: a
+ * worker function may so itself run a batch without any risk of
+ * deadlock, even when all the threads of the pool are busy.
+ *
+ * Since: 3.5
+ */
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/**
+ * FMAWorkerFunc:
+ * @task: an element of the batch.
+ * @user_data: data passed to fma_worker_pool_start().
+ *
+ * Prototype of the worker function, which may be called from any
+ * thread.
+ *
+ * Since: 3.5
+ */
+typedef void ( *FMAWorkerFunc )( gpointer task, gpointer user_data );
+
+/**
+ * FMAWorkerBatch:
+ *
+ * An opaque structure which describes a batch of running tasks.
+ *
+ * Since: 3.5
+ */
+typedef struct _FMAWorkerBatch FMAWorkerBatch;
+
+FMAWorkerBatch *fma_worker_pool_start( GPtrArray *tasks, FMAWorkerFunc func, gpointer user_data );
+void            fma_worker_pool_wait ( FMAWorkerBatch *batch );
+void            fma_worker_pool_run  ( GPtrArray *tasks, FMAWorkerFunc func, gpointer user_data );
+
+G_END_DECLS
+
+#endif /* __FILEMANAGER_ACTIONS_API_WORKER_POOL_H__ */
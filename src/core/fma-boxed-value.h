@@ -0,0 +1,104 @@
+/*
+ * FileManager-Actions
+ * A file-manager extension which offers configurable context menu actions.
+ *
+ * Copyright (C) 2005 The GNOME Foundation
+ * Copyright (C) 2006-2008 Frederic Ruaudel and others (see AUTHORS)
+ * Copyright (C) 2009-2015 Pierre Wieser and others (see AUTHORS)
+ *
+ * FileManager-Actions is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * FileManager-Actions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FileManager-Actions; see the file COPYING. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Authors:
+ *   Frederic Ruaudel <grumz@grumz.net>
+ *   Rodrigo Moya <rodrigo@gnome-db.org>
+ *   Pierre Wieser <pwieser@trychlos.org>
+ *   ... and many others (see AUTHORS)
+ */
+
+#ifndef __CORE_FMA_BOXED_VALUE_H__
+#define __CORE_FMA_BOXED_VALUE_H__
+
+/* @title: FMABoxedValue
+ * @short_description: The compact storage of the #FMABoxed values
+ * @include: core/fma-boxed-value.h
+ *
+ * A FMABoxedValue is a plain tagged union, which holds the value of an
+ * elementary data without any GObject overhead.
+ *
+ * The elementary data of a #FMAIFactoryObject are stored as an array of
+ * FMABoxedValue's, allocated in one block owned by the object. #FMABoxed
+ * and #FMADataBoxed are thin facades over such a value, which are only
+ * instanciated when a caller asks for them.
+ *
+ * String and string list values may be interned, so that all identical
+ * values share the same storage: two interned values are then equal if
+ * and only if they point to the same data.
+ *
+ * The fma_boxed_value_xxx() functions are implemented in fma-boxed.c,
+ * while the fma_data_boxed_value_xxx() ones, which also need the
+ * #FMADataDef of the value, are implemented in fma-data-boxed.c.
+ */
+
+#include <api/fma-data-boxed.h>
+
+G_BEGIN_DECLS
+
+typedef struct {
+	guint            type        : 8;	/* as defined in fma-data-types.h, zero if unused */
+	guint            is_set      : 1;
+	guint            is_interned : 1;	/* see fma_boxed_value_intern() */
+	union {
+		gboolean     boolean;
+		void        *pointer;
+		gchar       *string;
+		GSList      *string_list;
+		guint        uint;
+		GList       *uint_list;
+	} u;
+}
+	FMABoxedValue;
+
+void           fma_boxed_value_init             ( FMABoxedValue *value, guint type );
+void           fma_boxed_value_clear            ( FMABoxedValue *value );
+
+gboolean       fma_boxed_value_are_equal        ( const FMABoxedValue *a, const FMABoxedValue *b );
+void           fma_boxed_value_copy             ( FMABoxedValue *dest, const FMABoxedValue *src );
+void           fma_boxed_value_move             ( FMABoxedValue *dest, FMABoxedValue *src );
+
+gconstpointer  fma_boxed_value_get_pointer      ( const FMABoxedValue *value );
+gchar         *fma_boxed_value_get_string       ( const FMABoxedValue *value );
+void           fma_boxed_value_get_as_value     ( const FMABoxedValue *value, GValue *gvalue );
+void          *fma_boxed_value_get_as_void      ( const FMABoxedValue *value );
+
+void           fma_boxed_value_set_from_string  ( FMABoxedValue *value, const gchar *string );
+void           fma_boxed_value_set_from_value   ( FMABoxedValue *value, const GValue *gvalue );
+void           fma_boxed_value_set_from_void    ( FMABoxedValue *value, const void *data );
+
+void           fma_boxed_value_intern           ( FMABoxedValue *value );
+
+gboolean       fma_boxed_interned_list_ref      ( const GSList *list );
+void           fma_boxed_interned_list_unref    ( const GSList *list );
+
+FMABoxedValue *fma_boxed_peek_value             ( const FMABoxed *boxed );
+void           fma_boxed_set_value_storage      ( FMABoxed *boxed, FMABoxedValue *storage );
+
+FMADataBoxed  *fma_data_boxed_new_for_value     ( const FMADataDef *def, FMABoxedValue *storage );
+
+gboolean       fma_data_boxed_value_is_default  ( const FMADataDef *def, const FMABoxedValue *value );
+gboolean       fma_data_boxed_value_is_valid    ( const FMADataDef *def, const FMABoxedValue *value );
+
+G_END_DECLS
+
+#endif /* __CORE_FMA_BOXED_VALUE_H__ */
@@ -38,6 +38,8 @@
 #include <api/fma-data-types.h>
 #include <api/fma-core-utils.h>
 
+#include "fma-boxed-value.h"
+
 /* private class data
  */
 struct _FMABoxedClassPrivate {
@@ -50,126 +52,142 @@ struct _FMABoxedClassPrivate {
 typedef struct {
 	guint            type;
 	const gchar     *label;
-	gboolean      ( *are_equal )     ( const FMABoxed *, const FMABoxed * );
-	void          ( *copy )          ( FMABoxed *, const FMABoxed * );
-	void          ( *free )          ( FMABoxed * );
-	void          ( *from_string )   ( FMABoxed *, const gchar * );
-	void          ( *from_value )    ( FMABoxed *, const GValue * );
-	void          ( *from_void )     ( FMABoxed *, const void * );
-	gboolean      ( *to_bool )       ( const FMABoxed * );
-	gconstpointer ( *to_pointer )    ( const FMABoxed * );
-	gchar       * ( *to_string )     ( const FMABoxed * );
-	GSList      * ( *to_string_list )( const FMABoxed * );
-	guint         ( *to_uint )       ( const FMABoxed * );
-	GList       * ( *to_uint_list )  ( const FMABoxed * );
-	void          ( *to_value )      ( const FMABoxed *, GValue * );
-	void        * ( *to_void )       ( const FMABoxed * );
+	gboolean      ( *are_equal )     ( const FMABoxedValue *, const FMABoxedValue * );
+	void          ( *copy )          ( FMABoxedValue *, const FMABoxedValue * );
+	void          ( *free )          ( FMABoxedValue * );
+	void          ( *from_string )   ( FMABoxedValue *, const gchar * );
+	void          ( *from_value )    ( FMABoxedValue *, const GValue * );
+	void          ( *from_void )     ( FMABoxedValue *, const void * );
+	gboolean      ( *to_bool )       ( const FMABoxedValue * );
+	gconstpointer ( *to_pointer )    ( const FMABoxedValue * );
+	gchar       * ( *to_string )     ( const FMABoxedValue * );
+	GSList      * ( *to_string_list )( const FMABoxedValue * );
+	guint         ( *to_uint )       ( const FMABoxedValue * );
+	GList       * ( *to_uint_list )  ( const FMABoxedValue * );
+	void          ( *to_value )      ( const FMABoxedValue *, GValue * );
+	void        * ( *to_void )       ( const FMABoxedValue * );
 }
 	sBoxedDef;
 
 /* private instance data
  */
 struct _FMABoxedPrivate {
-	gboolean         dispose_has_run;
-	const sBoxedDef *def;
-	gboolean         is_set;
-	union {
-		gboolean  boolean;
-		void     *pointer;
-		gchar    *string;
-		GSList   *string_list;
-		guint     uint;
-		GList    *uint_list;
-	} u;
+	gboolean       dispose_has_run;
+	FMABoxedValue *value;				/* either &own, or an entry of the */
+	FMABoxedValue  own;					/* values of an FMAIFactoryObject */
 };
 
+/* an interned string or string list, shared between all the values
+ * which have been interned, and counted by reference
+ */
+typedef struct {
+	guint    ref_count;
+	gpointer data;
+}
+	sInterned;
+
 #define LIST_SEPARATOR					";"
 #define DEBUG							if( 0 ) g_debug
 
 static GObjectClass *st_parent_class    = NULL;
 
+/* the interned strings and string lists, indexed by their content
+ * the elements of an interned list are themselves interned strings
+ * values may be interned by the threads which read the items
+ */
+static GHashTable   *st_interned_strings = NULL;
+static GHashTable   *st_interned_lists   = NULL;
+G_LOCK_DEFINE_STATIC( st_interned );
+
 static GType            register_type( void );
 static void             class_init( FMABoxedClass *klass );
 static void             instance_init( GTypeInstance *instance, gpointer klass );
 static void             instance_dispose( GObject *object );
 static void             instance_finalize( GObject *object );
 
-static FMABoxed        *boxed_new( const sBoxedDef *def );
+static FMABoxed        *boxed_new( guint type );
 static const sBoxedDef *get_boxed_def( guint type );
 static gchar          **string_to_array( const gchar *string );
 
-static gboolean         bool_are_equal( const FMABoxed *a, const FMABoxed *b );
-static void             bool_copy( FMABoxed *dest, const FMABoxed *src );
-static void             bool_free( FMABoxed *boxed );
-static void             bool_from_string( FMABoxed *boxed, const gchar *string );
-static void             bool_from_value( FMABoxed *boxed, const GValue *value );
-static void             bool_from_void( FMABoxed *boxed, const void *value );
-static gchar           *bool_to_string( const FMABoxed *boxed );
-static gboolean         bool_to_bool( const FMABoxed *boxed );
-static gconstpointer    bool_to_pointer( const FMABoxed *boxed );
-static gchar           *bool_to_string( const FMABoxed *boxed );
-static void             bool_to_value( const FMABoxed *boxed, GValue *value );
-static void            *bool_to_void( const FMABoxed *boxed );
-
-static gboolean         pointer_are_equal( const FMABoxed *a, const FMABoxed *b );
-static void             pointer_copy( FMABoxed *dest, const FMABoxed *src );
-static void             pointer_free( FMABoxed *boxed );
-static void             pointer_from_string( FMABoxed *boxed, const gchar *string );
-static void             pointer_from_value( FMABoxed *boxed, const GValue *value );
-static void             pointer_from_void( FMABoxed *boxed, const void *value );
-static gconstpointer    pointer_to_pointer( const FMABoxed *boxed );
-static gchar           *pointer_to_string( const FMABoxed *boxed );
-static void             pointer_to_value( const FMABoxed *boxed, GValue *value );
-static void            *pointer_to_void( const FMABoxed *boxed );
-
-static gboolean         string_are_equal( const FMABoxed *a, const FMABoxed *b );
-static void             string_copy( FMABoxed *dest, const FMABoxed *src );
-static void             string_free( FMABoxed *boxed );
-static void             string_from_string( FMABoxed *boxed, const gchar *string );
-static void             string_from_value( FMABoxed *boxed, const GValue *value );
-static void             string_from_void( FMABoxed *boxed, const void *value );
-static gconstpointer    string_to_pointer( const FMABoxed *boxed );
-static gchar           *string_to_string( const FMABoxed *boxed );
-static void             string_to_value( const FMABoxed *boxed, GValue *value );
-static void            *string_to_void( const FMABoxed *boxed );
-
-static gboolean         string_list_are_equal( const FMABoxed *a, const FMABoxed *b );
-static void             string_list_copy( FMABoxed *dest, const FMABoxed *src );
-static void             string_list_free( FMABoxed *boxed );
-static void             string_list_from_string( FMABoxed *boxed, const gchar *string );
-static void             string_list_from_value( FMABoxed *boxed, const GValue *value );
-static void             string_list_from_void( FMABoxed *boxed, const void *value );
-static gconstpointer    string_list_to_pointer( const FMABoxed *boxed );
-static gchar           *string_list_to_string( const FMABoxed *boxed );
-static GSList          *string_list_to_string_list( const FMABoxed *boxed );
-static void             string_list_to_value( const FMABoxed *boxed, GValue *value );
-static void            *string_list_to_void( const FMABoxed *boxed );
-
-static gboolean         locale_are_equal( const FMABoxed *a, const FMABoxed *b );
-
-static gboolean         uint_are_equal( const FMABoxed *a, const FMABoxed *b );
-static void             uint_copy( FMABoxed *dest, const FMABoxed *src );
-static void             uint_free( FMABoxed *boxed );
-static void             uint_from_string( FMABoxed *boxed, const gchar *string );
-static void             uint_from_value( FMABoxed *boxed, const GValue *value );
-static void             uint_from_void( FMABoxed *boxed, const void *value );
-static gconstpointer    uint_to_pointer( const FMABoxed *boxed );
-static gchar           *uint_to_string( const FMABoxed *boxed );
-static guint            uint_to_uint( const FMABoxed *boxed );
-static void             uint_to_value( const FMABoxed *boxed, GValue *value );
-static void            *uint_to_void( const FMABoxed *boxed );
-
-static gboolean         uint_list_are_equal( const FMABoxed *a, const FMABoxed *b );
-static void             uint_list_copy( FMABoxed *dest, const FMABoxed *src );
-static void             uint_list_free( FMABoxed *boxed );
-static void             uint_list_from_string( FMABoxed *boxed, const gchar *string );
-static void             uint_list_from_value( FMABoxed *boxed, const GValue *value );
-static void             uint_list_from_void( FMABoxed *boxed, const void *value );
-static gconstpointer    uint_list_to_pointer( const FMABoxed *boxed );
-static gchar           *uint_list_to_string( const FMABoxed *boxed );
-static GList           *uint_list_to_uint_list( const FMABoxed *boxed );
-static void             uint_list_to_value( const FMABoxed *boxed, GValue *value );
-static void            *uint_list_to_void( const FMABoxed *boxed );
+static const gchar     *intern_string_locked( const gchar *string );
+static void             release_string_locked( const gchar *string );
+static GSList          *intern_string_list_locked( const GSList *list );
+static void             release_string_list_locked( const GSList *list );
+static guint            interned_list_hash( gconstpointer list );
+static gboolean         interned_list_equal( gconstpointer a, gconstpointer b );
+
+static gboolean         bool_are_equal( const FMABoxedValue *a, const FMABoxedValue *b );
+static void             bool_copy( FMABoxedValue *dest, const FMABoxedValue *src );
+static void             bool_free( FMABoxedValue *boxed );
+static void             bool_from_string( FMABoxedValue *boxed, const gchar *string );
+static void             bool_from_value( FMABoxedValue *boxed, const GValue *value );
+static void             bool_from_void( FMABoxedValue *boxed, const void *value );
+static gchar           *bool_to_string( const FMABoxedValue *boxed );
+static gboolean         bool_to_bool( const FMABoxedValue *boxed );
+static gconstpointer    bool_to_pointer( const FMABoxedValue *boxed );
+static gchar           *bool_to_string( const FMABoxedValue *boxed );
+static void             bool_to_value( const FMABoxedValue *boxed, GValue *value );
+static void            *bool_to_void( const FMABoxedValue *boxed );
+
+static gboolean         pointer_are_equal( const FMABoxedValue *a, const FMABoxedValue *b );
+static void             pointer_copy( FMABoxedValue *dest, const FMABoxedValue *src );
+static void             pointer_free( FMABoxedValue *boxed );
+static void             pointer_from_string( FMABoxedValue *boxed, const gchar *string );
+static void             pointer_from_value( FMABoxedValue *boxed, const GValue *value );
+static void             pointer_from_void( FMABoxedValue *boxed, const void *value );
+static gconstpointer    pointer_to_pointer( const FMABoxedValue *boxed );
+static gchar           *pointer_to_string( const FMABoxedValue *boxed );
+static void             pointer_to_value( const FMABoxedValue *boxed, GValue *value );
+static void            *pointer_to_void( const FMABoxedValue *boxed );
+
+static gboolean         string_are_equal( const FMABoxedValue *a, const FMABoxedValue *b );
+static void             string_copy( FMABoxedValue *dest, const FMABoxedValue *src );
+static void             string_free( FMABoxedValue *boxed );
+static void             string_from_string( FMABoxedValue *boxed, const gchar *string );
+static void             string_from_value( FMABoxedValue *boxed, const GValue *value );
+static void             string_from_void( FMABoxedValue *boxed, const void *value );
+static gconstpointer    string_to_pointer( const FMABoxedValue *boxed );
+static gchar           *string_to_string( const FMABoxedValue *boxed );
+static void             string_to_value( const FMABoxedValue *boxed, GValue *value );
+static void            *string_to_void( const FMABoxedValue *boxed );
+
+static gboolean         string_list_are_equal( const FMABoxedValue *a, const FMABoxedValue *b );
+static void             string_list_copy( FMABoxedValue *dest, const FMABoxedValue *src );
+static void             string_list_free( FMABoxedValue *boxed );
+static void             string_list_from_string( FMABoxedValue *boxed, const gchar *string );
+static void             string_list_from_value( FMABoxedValue *boxed, const GValue *value );
+static void             string_list_from_void( FMABoxedValue *boxed, const void *value );
+static gconstpointer    string_list_to_pointer( const FMABoxedValue *boxed );
+static gchar           *string_list_to_string( const FMABoxedValue *boxed );
+static GSList          *string_list_to_string_list( const FMABoxedValue *boxed );
+static void             string_list_to_value( const FMABoxedValue *boxed, GValue *value );
+static void            *string_list_to_void( const FMABoxedValue *boxed );
+
+static gboolean         locale_are_equal( const FMABoxedValue *a, const FMABoxedValue *b );
+
+static gboolean         uint_are_equal( const FMABoxedValue *a, const FMABoxedValue *b );
+static void             uint_copy( FMABoxedValue *dest, const FMABoxedValue *src );
+static void             uint_free( FMABoxedValue *boxed );
+static void             uint_from_string( FMABoxedValue *boxed, const gchar *string );
+static void             uint_from_value( FMABoxedValue *boxed, const GValue *value );
+static void             uint_from_void( FMABoxedValue *boxed, const void *value );
+static gconstpointer    uint_to_pointer( const FMABoxedValue *boxed );
+static gchar           *uint_to_string( const FMABoxedValue *boxed );
+static guint            uint_to_uint( const FMABoxedValue *boxed );
+static void             uint_to_value( const FMABoxedValue *boxed, GValue *value );
+static void            *uint_to_void( const FMABoxedValue *boxed );
+
+static gboolean         uint_list_are_equal( const FMABoxedValue *a, const FMABoxedValue *b );
+static void             uint_list_copy( FMABoxedValue *dest, const FMABoxedValue *src );
+static void             uint_list_free( FMABoxedValue *boxed );
+static void             uint_list_from_string( FMABoxedValue *boxed, const gchar *string );
+static void             uint_list_from_value( FMABoxedValue *boxed, const GValue *value );
+static void             uint_list_from_void( FMABoxedValue *boxed, const void *value );
+static gconstpointer    uint_list_to_pointer( const FMABoxedValue *boxed );
+static gchar           *uint_list_to_string( const FMABoxedValue *boxed );
+static GList           *uint_list_to_uint_list( const FMABoxedValue *boxed );
+static void             uint_list_to_value( const FMABoxedValue *boxed, GValue *value );
+static void            *uint_list_to_void( const FMABoxedValue *boxed );
 
 static sBoxedDef st_boxed_def[] = {
 		{ FMA_DATA_TYPE_BOOLEAN,
@@ -364,8 +382,7 @@ instance_init( GTypeInstance *instance, gpointer klass )
 	self->private = g_new0( FMABoxedPrivate, 1 );
 
 	self->private->dispose_has_run = FALSE;
-	self->private->def = NULL;
-	self->private->is_set = FALSE;
+	self->private->value = &self->private->own;
 }
 
 static void
@@ -388,6 +405,10 @@ instance_dispose( GObject *object )
 	}
 }
 
+/*
+ * a borrowed value is owned by the FMAIFactoryObject, and so is not
+ * released here
+ */
 static void
 instance_finalize( GObject *object )
 {
@@ -400,11 +421,7 @@ instance_finalize( GObject *object )
 
 	self = FMA_BOXED( object );
 
-	if( self->private->def ){
-		if( self->private->def->free ){
-			( *self->private->def->free )( self );
-		}
-	}
+	fma_boxed_value_clear( &self->private->own );
 
 	g_free( self->private );
 
@@ -415,26 +432,26 @@ instance_finalize( GObject *object )
 }
 
 static FMABoxed *
-boxed_new( const sBoxedDef *def )
+boxed_new( guint type )
 {
 	FMABoxed *boxed;
 
 	boxed = g_object_new( FMA_TYPE_BOXED, NULL );
-	boxed->private->def = def;
+	fma_boxed_value_init( boxed->private->value, type );
 
 	return( boxed );
 }
 
+/*
+ * the st_boxed_def array is ordered as the FMADataType enumeration
+ */
 static const sBoxedDef *
 get_boxed_def( guint type )
 {
 	static const gchar *thisfn = "fma_boxed_get_boxed_def";
-	sBoxedDef *def;
 
-	for( def = st_boxed_def ; def->type ; ++def ){
-		if( def->type == type ){
-			return(( const sBoxedDef * ) def );
-		}
+	if( type > 0 && type < FMA_DATA_TYPE_N && st_boxed_def[type-1].type == type ){
+		return(( const sBoxedDef * ) st_boxed_def+type-1 );
 	}
 
 	g_warning( "%s: unmanaged data type: %d", thisfn, type );
@@ -482,6 +499,555 @@ string_to_array( const gchar *string )
 	return( array );
 }
 
+/*
+ * returns the interned copy of @string, incrementing its reference count
+ */
+static const gchar *
+intern_string_locked( const gchar *string )
+{
+	sInterned *interned;
+
+	if( !st_interned_strings ){
+		st_interned_strings = g_hash_table_new( g_str_hash, g_str_equal );
+	}
+
+	interned = g_hash_table_lookup( st_interned_strings, string );
+
+	if( !interned ){
+		interned = g_new0( sInterned, 1 );
+		interned->data = g_strdup( string );
+		g_hash_table_insert( st_interned_strings, interned->data, interned );
+	}
+
+	interned->ref_count += 1;
+
+	return(( const gchar * ) interned->data );
+}
+
+static void
+release_string_locked( const gchar *string )
+{
+	sInterned *interned;
+
+	interned = st_interned_strings ? g_hash_table_lookup( st_interned_strings, string ) : NULL;
+
+	if( interned ){
+		interned->ref_count -= 1;
+		if( !interned->ref_count ){
+			g_hash_table_remove( st_interned_strings, interned->data );
+			g_free( interned->data );
+			g_free( interned );
+		}
+	}
+}
+
+/*
+ * returns the interned copy of @list, incrementing its reference count
+ *
+ * the elements are interned first, so that lists may then be hashed and
+ * compared on the address of their elements
+ */
+static GSList *
+intern_string_list_locked( const GSList *list )
+{
+	sInterned *interned;
+	GSList *candidate, *it;
+	const GSList *il;
+
+	if( !st_interned_lists ){
+		st_interned_lists = g_hash_table_new( interned_list_hash, interned_list_equal );
+	}
+
+	candidate = NULL;
+	for( il = list ; il ; il = il->next ){
+		candidate = g_slist_prepend( candidate, ( gpointer ) intern_string_locked(( const gchar * ) il->data ));
+	}
+	candidate = g_slist_reverse( candidate );
+
+	interned = g_hash_table_lookup( st_interned_lists, candidate );
+
+	if( interned ){
+		for( it = candidate ; it ; it = it->next ){
+			release_string_locked(( const gchar * ) it->data );
+		}
+		g_slist_free( candidate );
+
+	} else {
+		interned = g_new0( sInterned, 1 );
+		interned->data = candidate;
+		g_hash_table_insert( st_interned_lists, interned->data, interned );
+	}
+
+	interned->ref_count += 1;
+
+	return(( GSList * ) interned->data );
+}
+
+static void
+release_string_list_locked( const GSList *list )
+{
+	sInterned *interned;
+	GSList *it;
+
+	interned = st_interned_lists ? g_hash_table_lookup( st_interned_lists, list ) : NULL;
+
+	if( interned && interned->data == list ){
+		interned->ref_count -= 1;
+		if( !interned->ref_count ){
+			g_hash_table_remove( st_interned_lists, interned->data );
+			for( it = ( GSList * ) interned->data ; it ; it = it->next ){
+				release_string_locked(( const gchar * ) it->data );
+			}
+			g_slist_free(( GSList * ) interned->data );
+			g_free( interned );
+		}
+	}
+}
+
+static guint
+interned_list_hash( gconstpointer list )
+{
+	const GSList *it;
+	guint hash;
+
+	hash = 0;
+	for( it = ( const GSList * ) list ; it ; it = it->next ){
+		hash = 31 * hash + g_direct_hash( it->data );
+	}
+
+	return( hash );
+}
+
+static gboolean
+interned_list_equal( gconstpointer a, gconstpointer b )
+{
+	const GSList *ia, *ib;
+
+	for( ia = a, ib = b ; ia && ib ; ia = ia->next, ib = ib->next ){
+		if( ia->data != ib->data ){
+			return( FALSE );
+		}
+	}
+
+	return( ia == NULL && ib == NULL );
+}
+
+/*
+ * fma_boxed_value_init:
+ * @value: the #FMABoxedValue to be initialized.
+ * @type: the required type as defined in fma-data-types.h
+ *
+ * Initializes an unused @value as an unset value of the given @type.
+ */
+void
+fma_boxed_value_init( FMABoxedValue *value, guint type )
+{
+	g_return_if_fail( value );
+	g_return_if_fail( get_boxed_def( type ));
+
+	memset( value, '\0', sizeof( FMABoxedValue ));
+	value->type = type;
+}
+
+/*
+ * fma_boxed_value_clear:
+ * @value: the #FMABoxedValue to be cleared.
+ *
+ * Releases the content of @value, which becomes unused.
+ */
+void
+fma_boxed_value_clear( FMABoxedValue *value )
+{
+	const sBoxedDef *def;
+
+	g_return_if_fail( value );
+
+	if( value->type ){
+		def = get_boxed_def( value->type );
+		if( def && def->free ){
+			( *def->free )( value );
+		}
+	}
+
+	memset( value, '\0', sizeof( FMABoxedValue ));
+}
+
+/*
+ * fma_boxed_value_are_equal:
+ * @a: the first #FMABoxedValue.
+ * @b: the second #FMABoxedValue.
+ *
+ * Returns: %TRUE if @a and @b are equal, %FALSE else.
+ */
+gboolean
+fma_boxed_value_are_equal( const FMABoxedValue *a, const FMABoxedValue *b )
+{
+	const sBoxedDef *def;
+	gboolean are_equal;
+
+	g_return_val_if_fail( a && b, FALSE );
+	g_return_val_if_fail( a->type == b->type, FALSE );
+
+	def = get_boxed_def( a->type );
+
+	g_return_val_if_fail( def, FALSE );
+	g_return_val_if_fail( def->are_equal, FALSE );
+
+	are_equal = FALSE;
+
+	if( a->is_set == b->is_set ){
+		are_equal = TRUE;
+		if( a->is_set ){
+			are_equal = ( *def->are_equal )( a, b );
+		}
+	}
+
+	return( are_equal );
+}
+
+/*
+ * fma_boxed_value_copy:
+ * @dest: the target #FMABoxedValue.
+ * @src: the source #FMABoxedValue.
+ *
+ * Copy the content of @src to @dest, which may be unused, or must be of
+ * the same type.
+ */
+void
+fma_boxed_value_copy( FMABoxedValue *dest, const FMABoxedValue *src )
+{
+	const sBoxedDef *def;
+
+	g_return_if_fail( dest && src );
+	g_return_if_fail( dest->type == 0 || dest->type == src->type );
+
+	def = get_boxed_def( src->type );
+
+	g_return_if_fail( def );
+	g_return_if_fail( def->copy );
+	g_return_if_fail( def->free );
+
+	if( dest->type ){
+		( *def->free )( dest );
+	} else {
+		fma_boxed_value_init( dest, src->type );
+	}
+
+	( *def->copy )( dest, src );
+	dest->is_set = TRUE;
+}
+
+/*
+ * fma_boxed_value_move:
+ * @dest: the target #FMABoxedValue.
+ * @src: the source #FMABoxedValue.
+ *
+ * Moves the content of @src to @dest, without copying it; @dest content
+ * is first released, while @src becomes unused.
+ */
+void
+fma_boxed_value_move( FMABoxedValue *dest, FMABoxedValue *src )
+{
+	g_return_if_fail( dest && src );
+
+	if( dest != src ){
+		fma_boxed_value_clear( dest );
+		*dest = *src;
+		memset( src, '\0', sizeof( FMABoxedValue ));
+	}
+}
+
+/*
+ * fma_boxed_value_get_pointer:
+ * @value: the #FMABoxedValue.
+ *
+ * Returns: the content of @value, as it is stored, i.e. without any copy.
+ */
+gconstpointer
+fma_boxed_value_get_pointer( const FMABoxedValue *value )
+{
+	const sBoxedDef *def;
+
+	g_return_val_if_fail( value, NULL );
+
+	def = get_boxed_def( value->type );
+
+	g_return_val_if_fail( def, NULL );
+	g_return_val_if_fail( def->to_pointer, NULL );
+
+	return(( *def->to_pointer )( value ));
+}
+
+/*
+ * fma_boxed_value_get_string:
+ * @value: the #FMABoxedValue.
+ *
+ * Returns: the content of @value, as a newly allocated string which
+ * should be g_free() by the caller.
+ */
+gchar *
+fma_boxed_value_get_string( const FMABoxedValue *value )
+{
+	const sBoxedDef *def;
+
+	g_return_val_if_fail( value, NULL );
+
+	def = get_boxed_def( value->type );
+
+	g_return_val_if_fail( def, NULL );
+	g_return_val_if_fail( def->to_string, NULL );
+
+	return(( *def->to_string )( value ));
+}
+
+/*
+ * fma_boxed_value_get_as_value:
+ * @value: the #FMABoxedValue.
+ * @gvalue: the #GValue to be set.
+ *
+ * Setup @gvalue with the content of @value.
+ */
+void
+fma_boxed_value_get_as_value( const FMABoxedValue *value, GValue *gvalue )
+{
+	const sBoxedDef *def;
+
+	g_return_if_fail( value );
+
+	def = get_boxed_def( value->type );
+
+	g_return_if_fail( def );
+	g_return_if_fail( def->to_value );
+
+	( *def->to_value )( value, gvalue );
+}
+
+/*
+ * fma_boxed_value_get_as_void:
+ * @value: the #FMABoxedValue.
+ *
+ * Returns: the content of @value, as fma_boxed_get_as_void().
+ */
+void *
+fma_boxed_value_get_as_void( const FMABoxedValue *value )
+{
+	const sBoxedDef *def;
+
+	g_return_val_if_fail( value, NULL );
+
+	def = get_boxed_def( value->type );
+
+	g_return_val_if_fail( def, NULL );
+	g_return_val_if_fail( def->to_void, NULL );
+
+	return(( *def->to_void )( value ));
+}
+
+/*
+ * fma_boxed_value_set_from_string:
+ * @value: the #FMABoxedValue to be set.
+ * @string: the string to be evaluated.
+ */
+void
+fma_boxed_value_set_from_string( FMABoxedValue *value, const gchar *string )
+{
+	const sBoxedDef *def;
+
+	g_return_if_fail( value );
+
+	def = get_boxed_def( value->type );
+
+	g_return_if_fail( def );
+	g_return_if_fail( def->free );
+	g_return_if_fail( def->from_string );
+
+	( *def->free )( value );
+	( *def->from_string )( value, string );
+	value->is_set = TRUE;
+}
+
+/*
+ * fma_boxed_value_set_from_value:
+ * @value: the #FMABoxedValue to be set.
+ * @gvalue: the #GValue whose content is to be got.
+ */
+void
+fma_boxed_value_set_from_value( FMABoxedValue *value, const GValue *gvalue )
+{
+	const sBoxedDef *def;
+
+	g_return_if_fail( value );
+
+	def = get_boxed_def( value->type );
+
+	g_return_if_fail( def );
+	g_return_if_fail( def->free );
+	g_return_if_fail( def->from_value );
+
+	( *def->free )( value );
+	( *def->from_value )( value, gvalue );
+	value->is_set = TRUE;
+}
+
+/*
+ * fma_boxed_value_set_from_void:
+ * @value: the #FMABoxedValue to be set.
+ * @data: the data whose content is to be got.
+ */
+void
+fma_boxed_value_set_from_void( FMABoxedValue *value, const void *data )
+{
+	const sBoxedDef *def;
+
+	g_return_if_fail( value );
+
+	def = get_boxed_def( value->type );
+
+	g_return_if_fail( def );
+	g_return_if_fail( def->free );
+	g_return_if_fail( def->from_void );
+
+	( *def->free )( value );
+	( *def->from_void )( value, data );
+	value->is_set = TRUE;
+}
+
+/*
+ * fma_boxed_value_intern:
+ * @value: the #FMABoxedValue to be interned.
+ *
+ * Replaces the content of a set string or string list @value with the
+ * interned one: identical values then share the same storage, and are
+ * equal if and only if they point to the same data.
+ *
+ * The interned content is released with the value; it must not be
+ * modified.
+ */
+void
+fma_boxed_value_intern( FMABoxedValue *value )
+{
+	const gchar *string;
+	GSList *list;
+
+	g_return_if_fail( value );
+
+	if( !value->is_set || value->is_interned ){
+		return;
+	}
+
+	switch( value->type ){
+		case FMA_DATA_TYPE_STRING:
+			if( value->u.string ){
+				G_LOCK( st_interned );
+				string = intern_string_locked( value->u.string );
+				G_UNLOCK( st_interned );
+				g_free( value->u.string );
+				value->u.string = ( gchar * ) string;
+				value->is_interned = TRUE;
+			}
+			break;
+
+		case FMA_DATA_TYPE_STRING_LIST:
+			if( value->u.string_list ){
+				G_LOCK( st_interned );
+				list = intern_string_list_locked( value->u.string_list );
+				G_UNLOCK( st_interned );
+				fma_core_utils_slist_free( value->u.string_list );
+				value->u.string_list = list;
+				value->is_interned = TRUE;
+			}
+			break;
+	}
+}
+
+/*
+ * fma_boxed_interned_list_ref:
+ * @list: a string list, as stored in a #FMABoxedValue.
+ *
+ * Returns: %TRUE if @list is an interned string list, which is then
+ * guaranteed to stay alive until fma_boxed_interned_list_unref() be
+ * called, %FALSE else.
+ */
+gboolean
+fma_boxed_interned_list_ref( const GSList *list )
+{
+	sInterned *interned;
+
+	interned = NULL;
+
+	if( list ){
+		G_LOCK( st_interned );
+		if( st_interned_lists ){
+			interned = g_hash_table_lookup( st_interned_lists, list );
+			if( interned && interned->data == list ){
+				interned->ref_count += 1;
+			} else {
+				interned = NULL;
+			}
+		}
+		G_UNLOCK( st_interned );
+	}
+
+	return( interned != NULL );
+}
+
+/*
+ * fma_boxed_interned_list_unref:
+ * @list: an interned string list.
+ *
+ * Releases a reference taken with fma_boxed_interned_list_ref().
+ */
+void
+fma_boxed_interned_list_unref( const GSList *list )
+{
+	G_LOCK( st_interned );
+	release_string_list_locked( list );
+	G_UNLOCK( st_interned );
+}
+
+/*
+ * fma_boxed_peek_value:
+ * @boxed: this #FMABoxed object.
+ *
+ * Returns: the #FMABoxedValue which stores the content of @boxed.
+ */
+FMABoxedValue *
+fma_boxed_peek_value( const FMABoxed *boxed )
+{
+	g_return_val_if_fail( FMA_IS_BOXED( boxed ), NULL );
+
+	return( boxed->private->value );
+}
+
+/*
+ * fma_boxed_set_value_storage:
+ * @boxed: this #FMABoxed object.
+ * @storage: [allow-none]: the #FMABoxedValue to be used as storage.
+ *
+ * Makes @boxed a facade over @storage, which stays owned by the caller.
+ *
+ * If @storage is %NULL, then @boxed gets back its own storage, where
+ * the content of the previously borrowed value is copied.
+ */
+void
+fma_boxed_set_value_storage( FMABoxed *boxed, FMABoxedValue *storage )
+{
+	g_return_if_fail( FMA_IS_BOXED( boxed ));
+	g_return_if_fail( boxed->private->dispose_has_run == FALSE );
+
+	if( storage ){
+		fma_boxed_value_clear( &boxed->private->own );
+		boxed->private->value = storage;
+
+	} else if( boxed->private->value != &boxed->private->own ){
+		fma_boxed_value_init( &boxed->private->own, boxed->private->value->type );
+		if( boxed->private->value->is_set ){
+			fma_boxed_value_copy( &boxed->private->own, boxed->private->value );
+		}
+		boxed->private->value = &boxed->private->own;
+	}
+}
+
 /**
  * fma_boxed_set_type:
  * @boxed: this #FMABoxed object.
@@ -496,9 +1062,9 @@ fma_boxed_set_type( FMABoxed *boxed, guint type )
 {
 	g_return_if_fail( FMA_IS_BOXED( boxed ));
 	g_return_if_fail( boxed->private->dispose_has_run == FALSE );
-	g_return_if_fail( boxed->private->def == NULL );
+	g_return_if_fail( boxed->private->value->type == 0 );
 
-	boxed->private->def = get_boxed_def( type );
+	fma_boxed_value_init( boxed->private->value, type );
 }
 
 /**
@@ -513,26 +1079,12 @@ fma_boxed_set_type( FMABoxed *boxed, guint type )
 gboolean
 fma_boxed_are_equal( const FMABoxed *a, const FMABoxed *b )
 {
-	gboolean are_equal;
-
 	g_return_val_if_fail( FMA_IS_BOXED( a ), FALSE );
 	g_return_val_if_fail( a->private->dispose_has_run == FALSE, FALSE );
 	g_return_val_if_fail( FMA_IS_BOXED( b ), FALSE );
 	g_return_val_if_fail( b->private->dispose_has_run == FALSE, FALSE );
-	g_return_val_if_fail( a->private->def, FALSE );
-	g_return_val_if_fail( a->private->def == b->private->def, FALSE );
-	g_return_val_if_fail( a->private->def->are_equal, FALSE );
-
-	are_equal = FALSE;
 
-	if( a->private->is_set == b->private->is_set ){
-		are_equal = TRUE;
-		if( a->private->is_set ){
-			are_equal = ( *a->private->def->are_equal )( a, b );
-		}
-	}
-
-	return( are_equal );
+	return( fma_boxed_value_are_equal( a->private->value, b->private->value ));
 }
 
 /**
@@ -551,13 +1103,11 @@ fma_boxed_copy( const FMABoxed *boxed )
 
 	g_return_val_if_fail( FMA_IS_BOXED( boxed ), NULL );
 	g_return_val_if_fail( boxed->private->dispose_has_run == FALSE, NULL );
-	g_return_val_if_fail( boxed->private->def, NULL );
-	g_return_val_if_fail( boxed->private->def->copy, NULL );
+	g_return_val_if_fail( get_boxed_def( boxed->private->value->type ), NULL );
 
-	dest = boxed_new( boxed->private->def );
-	if( boxed->private->is_set ){
-		( *boxed->private->def->copy )( dest, boxed );
-		dest->private->is_set = TRUE;
+	dest = boxed_new( boxed->private->value->type );
+	if( boxed->private->value->is_set ){
+		fma_boxed_value_copy( dest->private->value, boxed->private->value );
 	}
 
 	return( dest );
@@ -575,17 +1125,17 @@ void
 fma_boxed_dump( const FMABoxed *boxed )
 {
 	static const gchar *thisfn = "fma_boxed_dump";
+	const FMABoxedValue *value;
 	gchar *str;
 
 	g_return_if_fail( FMA_IS_BOXED( boxed ));
 	g_return_if_fail( boxed->private->dispose_has_run == FALSE );
-	g_return_if_fail( boxed->private->def );
-	g_return_if_fail( boxed->private->def->to_string );
 
-	str = ( boxed->private->is_set ) ? ( *boxed->private->def->to_string )( boxed ) : NULL;
+	value = boxed->private->value;
+	str = value->is_set ? fma_boxed_value_get_string( value ) : NULL;
 	g_debug( "%s: boxed=%p, type=%u, is_set=%s, value=%s",
-			thisfn, ( void * ) boxed, boxed->private->def->type,
-			boxed->private->is_set ? "True":"False", str );
+			thisfn, ( void * ) boxed, value->type,
+			value->is_set ? "True":"False", str );
 	g_free( str );
 }
 
@@ -616,9 +1166,8 @@ fma_boxed_new_from_string( guint type, const gchar *string )
 	g_return_val_if_fail( def, NULL );
 	g_return_val_if_fail( def->from_string, NULL );
 
-	boxed = boxed_new( def );
-	( *def->from_string )( boxed, string );
-	boxed->private->is_set = TRUE;
+	boxed = boxed_new( type );
+	fma_boxed_value_set_from_string( boxed->private->value, string );
 
 	return( boxed );
 }
@@ -635,17 +1184,16 @@ fma_boxed_new_from_string( guint type, const gchar *string )
 gboolean
 fma_boxed_get_boolean( const FMABoxed *boxed )
 {
-	gboolean value;
+	const FMABoxedValue *value;
 
 	g_return_val_if_fail( FMA_IS_BOXED( boxed ), FALSE );
 	g_return_val_if_fail( boxed->private->dispose_has_run == FALSE, FALSE );
-	g_return_val_if_fail( boxed->private->def, FALSE );
-	g_return_val_if_fail( boxed->private->def->type == FMA_DATA_TYPE_BOOLEAN, FALSE );
-	g_return_val_if_fail( boxed->private->def->to_bool, FALSE );
 
-	value = ( *boxed->private->def->to_bool )( boxed );
+	value = boxed->private->value;
 
-	return( value );
+	g_return_val_if_fail( value->type == FMA_DATA_TYPE_BOOLEAN, FALSE );
+
+	return( bool_to_bool( value ));
 }
 
 /**
@@ -655,21 +1203,20 @@ fma_boxed_get_boolean( const FMABoxed *boxed )
  * Returns: a const pointer to the data if @boxed is of %FMA_DATA_TYPE_POINTER
  * type, %NULL else.
  *
+ * Other types return their value as it is stored in @boxed, i.e. without
+ * any copy for strings and lists, or as GUINT_TO_POINTER() for booleans
+ * and unsigned integers. Strings and lists are owned by @boxed and should
+ * not be modified nor released by the caller.
+ *
  * Since: 3.1
  */
 gconstpointer
 fma_boxed_get_pointer( const FMABoxed *boxed )
 {
-	gconstpointer value;
-
 	g_return_val_if_fail( FMA_IS_BOXED( boxed ), NULL );
 	g_return_val_if_fail( boxed->private->dispose_has_run == FALSE, NULL );
-	g_return_val_if_fail( boxed->private->def, NULL );
-	g_return_val_if_fail( boxed->private->def->to_pointer, NULL );
-
-	value = ( *boxed->private->def->to_pointer )( boxed );
 
-	return( value );
+	return( fma_boxed_value_get_pointer( boxed->private->value ));
 }
 
 /**
@@ -684,16 +1231,10 @@ fma_boxed_get_pointer( const FMABoxed *boxed )
 gchar *
 fma_boxed_get_string( const FMABoxed *boxed )
 {
-	gchar *value;
-
 	g_return_val_if_fail( FMA_IS_BOXED( boxed ), NULL );
 	g_return_val_if_fail( boxed->private->dispose_has_run == FALSE, NULL );
-	g_return_val_if_fail( boxed->private->def, NULL );
-	g_return_val_if_fail( boxed->private->def->to_string, NULL );
-
-	value = ( *boxed->private->def->to_string )( boxed );
 
-	return( value );
+	return( fma_boxed_value_get_string( boxed->private->value ));
 }
 
 /**
@@ -708,17 +1249,16 @@ fma_boxed_get_string( const FMABoxed *boxed )
 GSList *
 fma_boxed_get_string_list( const FMABoxed *boxed )
 {
-	GSList *value;
+	const FMABoxedValue *value;
 
 	g_return_val_if_fail( FMA_IS_BOXED( boxed ), NULL );
 	g_return_val_if_fail( boxed->private->dispose_has_run == FALSE, NULL );
-	g_return_val_if_fail( boxed->private->def, NULL );
-	g_return_val_if_fail( boxed->private->def->type == FMA_DATA_TYPE_STRING_LIST, NULL );
-	g_return_val_if_fail( boxed->private->def->to_string_list, NULL );
 
-	value = ( *boxed->private->def->to_string_list )( boxed );
+	value = boxed->private->value;
 
-	return( value );
+	g_return_val_if_fail( value->type == FMA_DATA_TYPE_STRING_LIST, NULL );
+
+	return( string_list_to_string_list( value ));
 }
 
 /**
@@ -733,17 +1273,16 @@ fma_boxed_get_string_list( const FMABoxed *boxed )
 guint
 fma_boxed_get_uint( const FMABoxed *boxed )
 {
-	guint value;
+	const FMABoxedValue *value;
 
 	g_return_val_if_fail( FMA_IS_BOXED( boxed ), 0 );
 	g_return_val_if_fail( boxed->private->dispose_has_run == FALSE, 0 );
-	g_return_val_if_fail( boxed->private->def, 0 );
-	g_return_val_if_fail( boxed->private->def->type == FMA_DATA_TYPE_UINT, 0 );
-	g_return_val_if_fail( boxed->private->def->to_uint, 0 );
 
-	value = ( *boxed->private->def->to_uint )( boxed );
+	value = boxed->private->value;
 
-	return( value );
+	g_return_val_if_fail( value->type == FMA_DATA_TYPE_UINT, 0 );
+
+	return( uint_to_uint( value ));
 }
 
 /**
@@ -758,17 +1297,16 @@ fma_boxed_get_uint( const FMABoxed *boxed )
 GList *
 fma_boxed_get_uint_list( const FMABoxed *boxed )
 {
-	GList *value;
+	const FMABoxedValue *value;
 
 	g_return_val_if_fail( FMA_IS_BOXED( boxed ), NULL );
 	g_return_val_if_fail( boxed->private->dispose_has_run == FALSE, NULL );
-	g_return_val_if_fail( boxed->private->def, NULL );
-	g_return_val_if_fail( boxed->private->def->type == FMA_DATA_TYPE_UINT_LIST, NULL );
-	g_return_val_if_fail( boxed->private->def->to_uint_list, NULL );
 
-	value = ( *boxed->private->def->to_uint_list )( boxed );
+	value = boxed->private->value;
 
-	return( value );
+	g_return_val_if_fail( value->type == FMA_DATA_TYPE_UINT_LIST, NULL );
+
+	return( uint_list_to_uint_list( value ));
 }
 
 /**
@@ -785,10 +1323,8 @@ fma_boxed_get_as_value( const FMABoxed *boxed, GValue *value )
 {
 	g_return_if_fail( FMA_IS_BOXED( boxed ));
 	g_return_if_fail( boxed->private->dispose_has_run == FALSE );
-	g_return_if_fail( boxed->private->def );
-	g_return_if_fail( boxed->private->def->to_value );
 
-	( *boxed->private->def->to_value )( boxed, value );
+	fma_boxed_value_get_as_value( boxed->private->value, value );
 }
 
 /**
@@ -809,10 +1345,8 @@ fma_boxed_get_as_void( const FMABoxed *boxed )
 {
 	g_return_val_if_fail( FMA_IS_BOXED( boxed ), NULL );
 	g_return_val_if_fail( boxed->private->dispose_has_run == FALSE, NULL );
-	g_return_val_if_fail( boxed->private->def, NULL );
-	g_return_val_if_fail( boxed->private->def->to_void, NULL );
 
-	return(( *boxed->private->def->to_void )( boxed ));
+	return( fma_boxed_value_get_as_void( boxed->private->value ));
 }
 
 /**
@@ -831,14 +1365,10 @@ fma_boxed_set_from_boxed( FMABoxed *boxed, const FMABoxed *value )
 	g_return_if_fail( boxed->private->dispose_has_run == FALSE );
 	g_return_if_fail( FMA_IS_BOXED( value ));
 	g_return_if_fail( value->private->dispose_has_run == FALSE );
-	g_return_if_fail( boxed->private->def );
-	g_return_if_fail( boxed->private->def == value->private->def );
-	g_return_if_fail( boxed->private->def->copy );
-	g_return_if_fail( boxed->private->def->free );
+	g_return_if_fail( boxed->private->value->type );
+	g_return_if_fail( boxed->private->value->type == value->private->value->type );
 
-	( *boxed->private->def->free )( boxed );
-	( *boxed->private->def->copy )( boxed, value );
-	boxed->private->is_set = TRUE;
+	fma_boxed_value_copy( boxed->private->value, value->private->value );
 }
 
 /**
@@ -855,13 +1385,8 @@ fma_boxed_set_from_string( FMABoxed *boxed, const gchar *value )
 {
 	g_return_if_fail( FMA_IS_BOXED( boxed ));
 	g_return_if_fail( boxed->private->dispose_has_run == FALSE );
-	g_return_if_fail( boxed->private->def );
-	g_return_if_fail( boxed->private->def->free );
-	g_return_if_fail( boxed->private->def->from_string );
 
-	( *boxed->private->def->free )( boxed );
-	( *boxed->private->def->from_string )( boxed, value );
-	boxed->private->is_set = TRUE;
+	fma_boxed_value_set_from_string( boxed->private->value, value );
 }
 
 /**
@@ -878,13 +1403,8 @@ fma_boxed_set_from_value( FMABoxed *boxed, const GValue *value )
 {
 	g_return_if_fail( FMA_IS_BOXED( boxed ));
 	g_return_if_fail( boxed->private->dispose_has_run == FALSE );
-	g_return_if_fail( boxed->private->def );
-	g_return_if_fail( boxed->private->def->free );
-	g_return_if_fail( boxed->private->def->from_value );
 
-	( *boxed->private->def->free )( boxed );
-	( *boxed->private->def->from_value )( boxed, value );
-	boxed->private->is_set = TRUE;
+	fma_boxed_value_set_from_value( boxed->private->value, value );
 }
 
 /**
@@ -901,208 +1421,231 @@ fma_boxed_set_from_void( FMABoxed *boxed, const void *value )
 {
 	g_return_if_fail( FMA_IS_BOXED( boxed ));
 	g_return_if_fail( boxed->private->dispose_has_run == FALSE );
-	g_return_if_fail( boxed->private->def );
-	g_return_if_fail( boxed->private->def->free );
-	g_return_if_fail( boxed->private->def->from_void );
 
-	( *boxed->private->def->free )( boxed );
-	( *boxed->private->def->from_void )( boxed, value );
-	boxed->private->is_set = TRUE;
+	fma_boxed_value_set_from_void( boxed->private->value, value );
 }
 
 static gboolean
-bool_are_equal( const FMABoxed *a, const FMABoxed *b )
+bool_are_equal( const FMABoxedValue *a, const FMABoxedValue *b )
 {
-	return( a->private->u.boolean == b->private->u.boolean );
+	return( a->u.boolean == b->u.boolean );
 }
 
 static void
-bool_copy( FMABoxed *dest, const FMABoxed *src )
+bool_copy( FMABoxedValue *dest, const FMABoxedValue *src )
 {
-	dest->private->u.boolean = src->private->u.boolean;
+	dest->u.boolean = src->u.boolean;
 }
 
 static void
-bool_free( FMABoxed *boxed )
+bool_free( FMABoxedValue *boxed )
 {
-	boxed->private->u.boolean = FALSE;
-	boxed->private->is_set = FALSE;
+	boxed->u.boolean = FALSE;
+	boxed->is_set = FALSE;
 }
 
 static void
-bool_from_string( FMABoxed *boxed, const gchar *string )
+bool_from_string( FMABoxedValue *boxed, const gchar *string )
 {
-	boxed->private->u.boolean = fma_core_utils_boolean_from_string( string );
+	boxed->u.boolean = fma_core_utils_boolean_from_string( string );
 }
 
 static void
-bool_from_value( FMABoxed *boxed, const GValue *value )
+bool_from_value( FMABoxedValue *boxed, const GValue *value )
 {
-	boxed->private->u.boolean = g_value_get_boolean( value );
+	boxed->u.boolean = g_value_get_boolean( value );
 }
 
 static void
-bool_from_void( FMABoxed *boxed, const void *value )
+bool_from_void( FMABoxedValue *boxed, const void *value )
 {
-	boxed->private->u.boolean = GPOINTER_TO_UINT( value );
+	boxed->u.boolean = GPOINTER_TO_UINT( value );
 }
 
 static gboolean
-bool_to_bool( const FMABoxed *boxed )
+bool_to_bool( const FMABoxedValue *boxed )
 {
-	return( boxed->private->u.boolean );
+	return( boxed->u.boolean );
 }
 
 static gconstpointer
-bool_to_pointer( const FMABoxed *boxed )
+bool_to_pointer( const FMABoxedValue *boxed )
 {
-	return(( gconstpointer ) GUINT_TO_POINTER( boxed->private->u.boolean ));
+	return(( gconstpointer ) GUINT_TO_POINTER( boxed->u.boolean ));
 }
 
 static gchar *
-bool_to_string( const FMABoxed *boxed )
+bool_to_string( const FMABoxedValue *boxed )
 {
-	return( g_strdup_printf( "%s", boxed->private->u.boolean ? "true":"false" ));
+	return( g_strdup_printf( "%s", boxed->u.boolean ? "true":"false" ));
 }
 
 static void
-bool_to_value( const FMABoxed *boxed, GValue *value )
+bool_to_value( const FMABoxedValue *boxed, GValue *value )
 {
-	g_value_set_boolean( value, boxed->private->u.boolean );
+	g_value_set_boolean( value, boxed->u.boolean );
 }
 
 static void *
-bool_to_void( const FMABoxed *boxed )
+bool_to_void( const FMABoxedValue *boxed )
 {
-	return( GUINT_TO_POINTER( boxed->private->u.boolean ));
+	return( GUINT_TO_POINTER( boxed->u.boolean ));
 }
 
 static gboolean
-pointer_are_equal( const FMABoxed *a, const FMABoxed *b )
+pointer_are_equal( const FMABoxedValue *a, const FMABoxedValue *b )
 {
-	return( a->private->u.pointer == b->private->u.pointer );
+	return( a->u.pointer == b->u.pointer );
 }
 
 /*
  * note that copying a pointer is not safe
  */
 static void
-pointer_copy( FMABoxed *dest, const FMABoxed *src )
+pointer_copy( FMABoxedValue *dest, const FMABoxedValue *src )
 {
-	dest->private->u.pointer = src->private->u.pointer;
+	dest->u.pointer = src->u.pointer;
 }
 
 static void
-pointer_free( FMABoxed *boxed )
+pointer_free( FMABoxedValue *boxed )
 {
-	boxed->private->u.pointer = NULL;
-	boxed->private->is_set = FALSE;
+	boxed->u.pointer = NULL;
+	boxed->is_set = FALSE;
 }
 
 static void
-pointer_from_string( FMABoxed *boxed, const gchar *pointer )
+pointer_from_string( FMABoxedValue *boxed, const gchar *pointer )
 {
 	g_warning( "fma_boxed_pointer_from_string: unrelevant function call" );
 }
 
 static void
-pointer_from_value( FMABoxed *boxed, const GValue *value )
+pointer_from_value( FMABoxedValue *boxed, const GValue *value )
 {
-	boxed->private->u.pointer = g_value_get_pointer( value );
+	boxed->u.pointer = g_value_get_pointer( value );
 }
 
 static void
-pointer_from_void( FMABoxed *boxed, const void *value )
+pointer_from_void( FMABoxedValue *boxed, const void *value )
 {
-	boxed->private->u.pointer = ( void * ) value;
+	boxed->u.pointer = ( void * ) value;
 }
 
 static gconstpointer
-pointer_to_pointer( const FMABoxed *boxed )
+pointer_to_pointer( const FMABoxedValue *boxed )
 {
-	return( boxed->private->u.pointer );
+	return( boxed->u.pointer );
 }
 
 static gchar *
-pointer_to_string( const FMABoxed *boxed )
+pointer_to_string( const FMABoxedValue *boxed )
 {
-	return( g_strdup_printf( "%p", boxed->private->u.pointer ));
+	return( g_strdup_printf( "%p", boxed->u.pointer ));
 }
 
 static void
-pointer_to_value( const FMABoxed *boxed, GValue *value )
+pointer_to_value( const FMABoxedValue *boxed, GValue *value )
 {
-	g_value_set_pointer( value, boxed->private->u.pointer );
+	g_value_set_pointer( value, boxed->u.pointer );
 }
 
 static void *
-pointer_to_void( const FMABoxed *boxed )
+pointer_to_void( const FMABoxedValue *boxed )
 {
-	return( boxed->private->u.pointer );
+	return( boxed->u.pointer );
 }
 
+/*
+ * two interned strings are equal if and only if they are the same
+ */
 static gboolean
-string_are_equal( const FMABoxed *a, const FMABoxed *b )
+string_are_equal( const FMABoxedValue *a, const FMABoxedValue *b )
 {
-	if( a->private->u.string && b->private->u.string ){
-		return( strcmp( a->private->u.string, b->private->u.string ) == 0 );
+	if( a->u.string == b->u.string ){
+		return( TRUE );
+	}
+	if( a->is_interned && b->is_interned ){
+		return( FALSE );
+	}
+	if( a->u.string && b->u.string ){
+		return( strcmp( a->u.string, b->u.string ) == 0 );
 	}
-	if( !a->private->u.string && !b->private->u.string ){
+	if( !a->u.string && !b->u.string ){
 		return( TRUE );
 	}
 	return( FALSE );
 }
 
+/*
+ * an interned string is shared rather than copied
+ */
 static void
-string_copy( FMABoxed *dest, const FMABoxed *src )
+string_copy( FMABoxedValue *dest, const FMABoxedValue *src )
 {
-	dest->private->u.string = g_strdup( src->private->u.string );
+	if( src->is_interned ){
+		G_LOCK( st_interned );
+		dest->u.string = ( gchar * ) intern_string_locked( src->u.string );
+		G_UNLOCK( st_interned );
+		dest->is_interned = TRUE;
+
+	} else {
+		dest->u.string = g_strdup( src->u.string );
+	}
 }
 
 static void
-string_free( FMABoxed *boxed )
+string_free( FMABoxedValue *boxed )
 {
-	g_free( boxed->private->u.string );
-	boxed->private->u.string = NULL;
-	boxed->private->is_set = FALSE;
+	if( boxed->is_interned ){
+		G_LOCK( st_interned );
+		release_string_locked( boxed->u.string );
+		G_UNLOCK( st_interned );
+
+	} else {
+		g_free( boxed->u.string );
+	}
+	boxed->u.string = NULL;
+	boxed->is_set = FALSE;
+	boxed->is_interned = FALSE;
 }
 
 static void
-string_from_string( FMABoxed *boxed, const gchar *string )
+string_from_string( FMABoxedValue *boxed, const gchar *string )
 {
-	boxed->private->u.string = g_strdup( string ? string : "" );
+	boxed->u.string = g_strdup( string ? string : "" );
 }
 
 static void
-string_from_value( FMABoxed *boxed, const GValue *value )
+string_from_value( FMABoxedValue *boxed, const GValue *value )
 {
 	if( g_value_get_string( value )){
-		boxed->private->u.string = g_value_dup_string( value );
+		boxed->u.string = g_value_dup_string( value );
 	} else {
-		boxed->private->u.string = g_strdup( "" );
+		boxed->u.string = g_strdup( "" );
 	}
 }
 
 static void
-string_from_void( FMABoxed *boxed, const void *value )
+string_from_void( FMABoxedValue *boxed, const void *value )
 {
-	boxed->private->u.string = g_strdup( value ? ( const gchar * ) value : "" );
+	boxed->u.string = g_strdup( value ? ( const gchar * ) value : "" );
 }
 
 static gconstpointer
-string_to_pointer( const FMABoxed *boxed )
+string_to_pointer( const FMABoxedValue *boxed )
 {
-	return(( gconstpointer ) boxed->private->u.string );
+	return(( gconstpointer ) boxed->u.string );
 }
 
 static gchar *
-string_to_string( const FMABoxed *boxed )
+string_to_string( const FMABoxedValue *boxed )
 {
-	return( g_strdup( boxed->private->u.string ));
+	return( g_strdup( boxed->u.string ));
 }
 
 static void
-string_to_value( const FMABoxed *boxed, GValue *value )
+string_to_value( const FMABoxedValue *boxed, GValue *value )
 {
 	gchar *str;
 
@@ -1112,26 +1655,34 @@ string_to_value( const FMABoxed *boxed, GValue *value )
 }
 
 static void *
-string_to_void( const FMABoxed *boxed )
+string_to_void( const FMABoxedValue *boxed )
 {
 	return(( void * ) string_to_string( boxed ));
 }
 
 /* the two string lists are equal if they have the same elements in the
- * same order
+ * same order; two interned lists are equal if and only if they are the
+ * same
  */
 static gboolean
-string_list_are_equal( const FMABoxed *a, const FMABoxed *b )
+string_list_are_equal( const FMABoxedValue *a, const FMABoxedValue *b )
 {
 	GSList *ia, *ib;
 	gboolean diff = FALSE;
 
-	guint na = g_slist_length( a->private->u.string_list );
-	guint nb = g_slist_length( b->private->u.string_list );
+	if( a->u.string_list == b->u.string_list ){
+		return( TRUE );
+	}
+	if( a->is_interned && b->is_interned ){
+		return( FALSE );
+	}
+
+	guint na = g_slist_length( a->u.string_list );
+	guint nb = g_slist_length( b->u.string_list );
 
 	if( na != nb ) return( FALSE );
 
-	for( ia=a->private->u.string_list, ib=b->private->u.string_list ; ia && ib && !diff ; ia=ia->next, ib=ib->next ){
+	for( ia=a->u.string_list, ib=b->u.string_list ; ia && ib && !diff ; ia=ia->next, ib=ib->next ){
 		if( strcmp( ia->data, ib->data ) != 0 ){
 			diff = TRUE;
 		}
@@ -1140,22 +1691,41 @@ string_list_are_equal( const FMABoxed *a, const FMABoxed *b )
 	return( !diff );
 }
 
+/*
+ * an interned list is shared rather than copied
+ */
 static void
-string_list_copy( FMABoxed *dest, const FMABoxed *src )
+string_list_copy( FMABoxedValue *dest, const FMABoxedValue *src )
 {
-	if( dest->private->is_set ){
+	if( dest->is_set ){
 		string_list_free( dest );
 	}
-	dest->private->u.string_list = fma_core_utils_slist_duplicate( src->private->u.string_list );
-	dest->private->is_set = TRUE;
+	if( src->is_interned ){
+		G_LOCK( st_interned );
+		dest->u.string_list = intern_string_list_locked( src->u.string_list );
+		G_UNLOCK( st_interned );
+		dest->is_interned = TRUE;
+
+	} else {
+		dest->u.string_list = fma_core_utils_slist_duplicate( src->u.string_list );
+	}
+	dest->is_set = TRUE;
 }
 
 static void
-string_list_free( FMABoxed *boxed )
+string_list_free( FMABoxedValue *boxed )
 {
-	fma_core_utils_slist_free( boxed->private->u.string_list );
-	boxed->private->u.string_list = NULL;
-	boxed->private->is_set = FALSE;
+	if( boxed->is_interned ){
+		G_LOCK( st_interned );
+		release_string_list_locked( boxed->u.string_list );
+		G_UNLOCK( st_interned );
+
+	} else {
+		fma_core_utils_slist_free( boxed->u.string_list );
+	}
+	boxed->u.string_list = NULL;
+	boxed->is_set = FALSE;
+	boxed->is_interned = FALSE;
 }
 
 /*
@@ -1164,7 +1734,7 @@ string_list_free( FMABoxed *boxed )
  * - as a comma-separated list of string, between two square brackets (à la GConf)
  */
 static void
-string_list_from_string( FMABoxed *boxed, const gchar *string )
+string_list_from_string( FMABoxedValue *boxed, const gchar *string )
 {
 	gchar **array;
 	gchar **i;
@@ -1174,53 +1744,53 @@ string_list_from_string( FMABoxed *boxed, const gchar *string )
 	if( array ){
 		i = ( gchar ** ) array;
 		while( *i ){
-			if( !fma_core_utils_slist_count( boxed->private->u.string_list, ( const gchar * )( *i ))){
-				boxed->private->u.string_list = g_slist_prepend( boxed->private->u.string_list, g_strdup( *i ));
+			if( !fma_core_utils_slist_count( boxed->u.string_list, ( const gchar * )( *i ))){
+				boxed->u.string_list = g_slist_prepend( boxed->u.string_list, g_strdup( *i ));
 			}
 			i++;
 		}
-		boxed->private->u.string_list = g_slist_reverse( boxed->private->u.string_list );
+		boxed->u.string_list = g_slist_reverse( boxed->u.string_list );
 	}
 
 	g_strfreev( array );
 }
 
 static void
-string_list_from_value( FMABoxed *boxed, const GValue *value )
+string_list_from_value( FMABoxedValue *boxed, const GValue *value )
 {
 	string_list_from_void( boxed, ( const void * ) g_value_get_pointer( value ));
 }
 
 static void
-string_list_from_void( FMABoxed *boxed, const void *value )
+string_list_from_void( FMABoxedValue *boxed, const void *value )
 {
 	GSList *value_slist;
 	GSList *it;
 
 	value_slist = ( GSList * ) value;
 	for( it = value_slist ; it ; it = it->next ){
-		if( !fma_core_utils_slist_count( boxed->private->u.string_list, ( const gchar * ) it->data )){
-			boxed->private->u.string_list = g_slist_prepend( boxed->private->u.string_list, g_strdup(( const gchar * ) it->data ));
+		if( !fma_core_utils_slist_count( boxed->u.string_list, ( const gchar * ) it->data )){
+			boxed->u.string_list = g_slist_prepend( boxed->u.string_list, g_strdup(( const gchar * ) it->data ));
 		}
 	}
-	boxed->private->u.string_list = g_slist_reverse( boxed->private->u.string_list );
+	boxed->u.string_list = g_slist_reverse( boxed->u.string_list );
 }
 
 static gconstpointer
-string_list_to_pointer( const FMABoxed *boxed )
+string_list_to_pointer( const FMABoxedValue *boxed )
 {
-	return(( gconstpointer ) boxed->private->u.string_list );
+	return(( gconstpointer ) boxed->u.string_list );
 }
 
 static gchar *
-string_list_to_string( const FMABoxed *boxed )
+string_list_to_string( const FMABoxedValue *boxed )
 {
 	GSList *is;
 	GString *str = g_string_new( "" );
 	gboolean first;
 
 	first = TRUE;
-	for( is = boxed->private->u.string_list ; is ; is = is->next ){
+	for( is = boxed->u.string_list ; is ; is = is->next ){
 		if( !first ){
 			str = g_string_append( str, LIST_SEPARATOR );
 		}
@@ -1232,107 +1802,107 @@ string_list_to_string( const FMABoxed *boxed )
 }
 
 static GSList *
-string_list_to_string_list( const FMABoxed *boxed )
+string_list_to_string_list( const FMABoxedValue *boxed )
 {
-	return( fma_core_utils_slist_duplicate( boxed->private->u.string_list ));
+	return( fma_core_utils_slist_duplicate( boxed->u.string_list ));
 }
 
 static void
-string_list_to_value( const FMABoxed *boxed, GValue *value )
+string_list_to_value( const FMABoxedValue *boxed, GValue *value )
 {
-	g_value_set_pointer( value, fma_core_utils_slist_duplicate( boxed->private->u.string_list ));
+	g_value_set_pointer( value, fma_core_utils_slist_duplicate( boxed->u.string_list ));
 }
 
 static void *
-string_list_to_void( const FMABoxed *boxed )
+string_list_to_void( const FMABoxedValue *boxed )
 {
 	void *value = NULL;
 
-	if( boxed->private->u.string_list ){
-		value = fma_core_utils_slist_duplicate( boxed->private->u.string_list );
+	if( boxed->u.string_list ){
+		value = fma_core_utils_slist_duplicate( boxed->u.string_list );
 	}
 
 	return( value );
 }
 
 static gboolean
-locale_are_equal( const FMABoxed *a, const FMABoxed *b )
+locale_are_equal( const FMABoxedValue *a, const FMABoxedValue *b )
 {
-	if( !a->private->u.string && !b->private->u.string ){
+	if( !a->u.string && !b->u.string ){
 		return( TRUE );
 	}
-	if( !a->private->u.string || !b->private->u.string ){
+	if( !a->u.string || !b->u.string ){
 		return( FALSE );
 	}
-	return( fma_core_utils_str_collate( a->private->u.string, b->private->u.string ) == 0 );
+	return( fma_core_utils_str_collate( a->u.string, b->u.string ) == 0 );
 }
 
 static gboolean
-uint_are_equal( const FMABoxed *a, const FMABoxed *b )
+uint_are_equal( const FMABoxedValue *a, const FMABoxedValue *b )
 {
-	return( a->private->u.uint == b->private->u.uint );
+	return( a->u.uint == b->u.uint );
 }
 
 static void
-uint_copy( FMABoxed *dest, const FMABoxed *src )
+uint_copy( FMABoxedValue *dest, const FMABoxedValue *src )
 {
-	dest->private->u.uint = src->private->u.uint;
-	dest->private->is_set = TRUE;
+	dest->u.uint = src->u.uint;
+	dest->is_set = TRUE;
 }
 
 static void
-uint_free( FMABoxed *boxed )
+uint_free( FMABoxedValue *boxed )
 {
-	boxed->private->u.uint = 0;
-	boxed->private->is_set = FALSE;
+	boxed->u.uint = 0;
+	boxed->is_set = FALSE;
 }
 
 static void
-uint_from_string( FMABoxed *boxed, const gchar *string )
+uint_from_string( FMABoxedValue *boxed, const gchar *string )
 {
-	boxed->private->u.uint = string ? atoi( string ) : 0;
+	boxed->u.uint = string ? atoi( string ) : 0;
 }
 
 static void
-uint_from_value( FMABoxed *boxed, const GValue *value )
+uint_from_value( FMABoxedValue *boxed, const GValue *value )
 {
-	boxed->private->u.uint = g_value_get_uint( value );
+	boxed->u.uint = g_value_get_uint( value );
 }
 
 static void
-uint_from_void( FMABoxed *boxed, const void *value )
+uint_from_void( FMABoxedValue *boxed, const void *value )
 {
-	boxed->private->u.uint = GPOINTER_TO_UINT( value );
+	boxed->u.uint = GPOINTER_TO_UINT( value );
 }
 
 static gconstpointer
-uint_to_pointer( const FMABoxed *boxed )
+uint_to_pointer( const FMABoxedValue *boxed )
 {
-	return(( gconstpointer ) GUINT_TO_POINTER( boxed->private->u.uint ));
+	return(( gconstpointer ) GUINT_TO_POINTER( boxed->u.uint ));
 }
 
 static gchar *
-uint_to_string( const FMABoxed *boxed )
+uint_to_string( const FMABoxedValue *boxed )
 {
-	return( g_strdup_printf( "%u", boxed->private->u.uint ));
+	return( g_strdup_printf( "%u", boxed->u.uint ));
 }
 
 static guint
-uint_to_uint( const FMABoxed *boxed )
+uint_to_uint( const FMABoxedValue *boxed )
 {
-	return( boxed->private->u.uint );
+	return( boxed->u.uint );
 }
 
 static void
-uint_to_value( const FMABoxed *boxed, GValue *value )
+uint_to_value( const FMABoxedValue *boxed, GValue *value )
 {
-	g_value_set_uint( value, boxed->private->u.uint );
+	g_value_set_uint( value, boxed->u.uint );
 }
 
 static void *
-uint_to_void( const FMABoxed *boxed )
+uint_to_void( const FMABoxedValue *boxed )
 {
-	return( GUINT_TO_POINTER( boxed->private->u.uint ));
+	return( GUINT_TO_POINTER( boxed->u.uint ));
 }
 
 /* compare uint list as string list:
@@ -1341,17 +1911,17 @@ uint_to_void( const FMABoxed *boxed )
  * else just arbitrarily return -1
  */
 static gboolean
-uint_list_are_equal( const FMABoxed *a, const FMABoxed *b )
+uint_list_are_equal( const FMABoxedValue *a, const FMABoxedValue *b )
 {
 	GList *ia, *ib;
 	gboolean diff = FALSE;
 
-	guint na = g_list_length( a->private->u.uint_list );
-	guint nb = g_list_length( b->private->u.uint_list );
+	guint na = g_list_length( a->u.uint_list );
+	guint nb = g_list_length( b->u.uint_list );
 
 	if( na != nb ) return( FALSE );
 
-	for( ia=a->private->u.uint_list, ib=b->private->u.uint_list ; ia && ib && !diff ; ia=ia->next, ib=ib->next ){
+	for( ia=a->u.uint_list, ib=b->u.uint_list ; ia && ib && !diff ; ia=ia->next, ib=ib->next ){
 		if( GPOINTER_TO_UINT( ia->data ) != GPOINTER_TO_UINT( ib->data )){
 			diff = TRUE;
 		}
@@ -1361,27 +1931,27 @@ uint_list_are_equal( const FMABoxed *a, const FMABoxed *b )
 }
 
 static void
-uint_list_copy( FMABoxed *dest, const FMABoxed *src )
+uint_list_copy( FMABoxedValue *dest, const FMABoxedValue *src )
 {
 	GList *isrc;
 
-	dest->private->u.uint_list = NULL;
-	for( isrc = src->private->u.uint_list ; isrc ; isrc = isrc->next ){
-		dest->private->u.uint_list = g_list_prepend( dest->private->u.uint_list, isrc->data );
+	dest->u.uint_list = NULL;
+	for( isrc = src->u.uint_list ; isrc ; isrc = isrc->next ){
+		dest->u.uint_list = g_list_prepend( dest->u.uint_list, isrc->data );
 	}
-	dest->private->u.uint_list = g_list_reverse( dest->private->u.uint_list );
+	dest->u.uint_list = g_list_reverse( dest->u.uint_list );
 }
 
 static void
-uint_list_free( FMABoxed *boxed )
+uint_list_free( FMABoxedValue *boxed )
 {
-	g_list_free( boxed->private->u.uint_list );
-	boxed->private->u.uint_list = NULL;
-	boxed->private->is_set = FALSE;
+	g_list_free( boxed->u.uint_list );
+	boxed->u.uint_list = NULL;
+	boxed->is_set = FALSE;
 }
 
 static void
-uint_list_from_string( FMABoxed *boxed, const gchar *string )
+uint_list_from_string( FMABoxedValue *boxed, const gchar *string )
 {
 	gchar **array;
 	gchar **i;
@@ -1391,48 +1961,48 @@ uint_list_from_string( FMABoxed *boxed, const gchar *string )
 	if( array ){
 		i = ( gchar ** ) array;
 		while( *i ){
-			boxed->private->u.uint_list = g_list_prepend( boxed->private->u.uint_list, GINT_TO_POINTER( atoi( *i )));
+			boxed->u.uint_list = g_list_prepend( boxed->u.uint_list, GINT_TO_POINTER( atoi( *i )));
 			i++;
 		}
-		boxed->private->u.uint_list = g_list_reverse( boxed->private->u.uint_list );
+		boxed->u.uint_list = g_list_reverse( boxed->u.uint_list );
 	} else {
-		boxed->private->u.uint_list = NULL;
+		boxed->u.uint_list = NULL;
 	}
 
 	g_strfreev( array );
 }
 
 static void
-uint_list_from_value( FMABoxed *boxed, const GValue *value )
+uint_list_from_value( FMABoxedValue *boxed, const GValue *value )
 {
 	if( g_value_get_pointer( value )){
-		boxed->private->u.uint_list = g_list_copy( g_value_get_pointer( value ));
+		boxed->u.uint_list = g_list_copy( g_value_get_pointer( value ));
 	}
 }
 
 static void
-uint_list_from_void( FMABoxed *boxed, const void *value )
+uint_list_from_void( FMABoxedValue *boxed, const void *value )
 {
 	if( value ){
-		boxed->private->u.uint_list = g_list_copy(( GList * ) value );
+		boxed->u.uint_list = g_list_copy(( GList * ) value );
 	}
 }
 
 static gconstpointer
-uint_list_to_pointer( const FMABoxed *boxed )
+uint_list_to_pointer( const FMABoxedValue *boxed )
 {
-	return(( gconstpointer ) boxed->private->u.uint_list );
+	return(( gconstpointer ) boxed->u.uint_list );
 }
 
 static gchar *
-uint_list_to_string( const FMABoxed *boxed )
+uint_list_to_string( const FMABoxedValue *boxed )
 {
 	GList *is;
 	GString *str = g_string_new( "" );
 	gboolean first;
 
 	first = TRUE;
-	for( is = boxed->private->u.uint_list ; is ; is = is->next ){
+	for( is = boxed->u.uint_list ; is ; is = is->next ){
 		if( !first ){
 			str = g_string_append( str, LIST_SEPARATOR );
 		}
@@ -1444,24 +2014,24 @@ uint_list_to_string( const FMABoxed *boxed )
 }
 
 static GList *
-uint_list_to_uint_list( const FMABoxed *boxed )
+uint_list_to_uint_list( const FMABoxedValue *boxed )
 {
-	return( g_list_copy( boxed->private->u.uint_list ));
+	return( g_list_copy( boxed->u.uint_list ));
 }
 
 static void
-uint_list_to_value( const FMABoxed *boxed, GValue *value )
+uint_list_to_value( const FMABoxedValue *boxed, GValue *value )
 {
-	g_value_set_pointer( value, g_list_copy( boxed->private->u.uint_list ));
+	g_value_set_pointer( value, g_list_copy( boxed->u.uint_list ));
 }
 
 static void *
-uint_list_to_void( const FMABoxed *boxed )
+uint_list_to_void( const FMABoxedValue *boxed )
 {
 	void *value = NULL;
 
-	if( boxed->private->u.uint_list ){
-		value = g_list_copy( boxed->private->u.uint_list );
+	if( boxed->u.uint_list ){
+		value = g_list_copy( boxed->u.uint_list );
 	}
 
 	return( value );
@@ -0,0 +1,520 @@
+/*
+ * FileManager-Actions
+ * A file-manager extension which offers configurable context menu actions.
+ *
+ * Copyright (C) 2005 The GNOME Foundation
+ * Copyright (C) 2006-2008 Frederic Ruaudel and others (see AUTHORS)
+ * Copyright (C) 2009-2015 Pierre Wieser and others (see AUTHORS)
+ *
+ * FileManager-Actions is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * FileManager-Actions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FileManager-Actions; see the file COPYING. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Authors:
+ *   Frederic Ruaudel <grumz@grumz.net>
+ *   Rodrigo Moya <rodrigo@gnome-db.org>
+ *   Pierre Wieser <pwieser@trychlos.org>
+ *   ... and many others (see AUTHORS)
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "fma-command-probe.h"
+#include "fma-settings.h"
+
+/* a probe is the cached state of a command
+ * the table of probes holds one reference, and each run, or each
+ * waiting caller, holds another one
+ */
+typedef struct {
+	gint                 ref_count;
+	gchar               *command;
+	gboolean             running;
+	gboolean             has_result;
+	gboolean             result;
+	gint64               expires;			/* monotonic time, in usec */
+	guint                timeout;			/* of the current run, in msec */
+	guint                ttl;				/* of the current run, in sec */
+	GCond                cond;
+	FMACommandProbeStats stats;
+}
+	sProbe;
+
+#define PROBE_CACHE_MAX					256
+#define PROBE_MAX_THREADS				4
+#define PROBE_OUTPUT_MAX				64
+
+static GHashTable  *st_probes = NULL;
+static GMutex       st_mutex;
+
+static sProbe      *get_probe( const gchar *command );
+static void         purge_probes( gboolean all );
+static GThreadPool *get_pool( void );
+static void         on_pool_thread( sProbe *probe, gpointer pool_data );
+static void         probe_start( sProbe *probe, guint timeout, guint ttl );
+static gboolean     probe_spawn( const gchar *command, gint64 deadline, gboolean *timed_out );
+static gboolean     probe_wait_child( GPid pid, gint64 deadline );
+static sProbe      *probe_ref( sProbe *probe );
+static void         probe_unref( sProbe *probe );
+static gint         cmp_stats( const FMACommandProbeStats *a, const FMACommandProbeStats *b );
+
+/*
+ * fma_command_probe_is_true:
+ * @command: the command to be run, with its parameters already expanded.
+ *
+ * Returns: %TRUE if the @command outputs 'true', %FALSE else, or if it
+ * did not terminate before the deadline.
+ */
+gboolean
+fma_command_probe_is_true( const gchar *command )
+{
+	static const gchar *thisfn = "fma_command_probe_is_true";
+	sProbe *probe;
+	gboolean result;
+	guint timeout, ttl;
+	gboolean refresh;
+	gint64 now, deadline;
+
+	g_return_val_if_fail( command && strlen( command ), FALSE );
+
+	timeout = fma_settings_get_uint( IPREFS_SHOW_IF_TRUE_TIMEOUT, NULL, NULL );
+	ttl = fma_settings_get_uint( IPREFS_SHOW_IF_TRUE_TTL, NULL, NULL );
+	refresh = fma_settings_get_boolean( IPREFS_SHOW_IF_TRUE_REFRESH, NULL, NULL );
+
+	g_mutex_lock( &st_mutex );
+
+	probe = get_probe( command );
+	now = g_get_monotonic_time();
+
+	if( probe->has_result && now < probe->expires ){
+		probe->stats.hits += 1;
+		result = probe->result;
+
+	} else if( probe->has_result && refresh ){
+		probe->stats.stale_hits += 1;
+		result = probe->result;
+		probe_start( probe, timeout, ttl );
+
+	} else {
+		probe_start( probe, timeout, ttl );
+
+		/* the probe may be purged from the cache while we are waiting */
+		probe_ref( probe );
+		deadline = now + timeout * G_TIME_SPAN_MILLISECOND;
+		while( probe->running && g_cond_wait_until( &probe->cond, &st_mutex, deadline ))
+			;
+
+		if( probe->running ){
+			g_debug( "%s: command=%s: no result after %u msec", thisfn, command, timeout );
+			result = probe->has_result ? probe->result : FALSE;
+		} else {
+			result = probe->result;
+		}
+		probe_unref( probe );
+	}
+
+	g_mutex_unlock( &st_mutex );
+
+	return( result );
+}
+
+/*
+ * fma_command_probe_get_stats:
+ *
+ * Returns: the list of the #FMACommandProbeStats of the known commands,
+ * the slowest first. The returned list should be
+ * fma_command_probe_free_stats() by the caller.
+ */
+GList *
+fma_command_probe_get_stats( void )
+{
+	GList *list;
+	GHashTableIter iter;
+	sProbe *probe;
+	FMACommandProbeStats *stats;
+
+	list = NULL;
+
+	g_mutex_lock( &st_mutex );
+
+	if( st_probes ){
+		g_hash_table_iter_init( &iter, st_probes );
+		while( g_hash_table_iter_next( &iter, NULL, ( gpointer * ) &probe )){
+			stats = g_new0( FMACommandProbeStats, 1 );
+			*stats = probe->stats;
+			stats->command = g_strdup( probe->command );
+			list = g_list_prepend( list, stats );
+		}
+	}
+
+	g_mutex_unlock( &st_mutex );
+
+	return( g_list_sort( list, ( GCompareFunc ) cmp_stats ));
+}
+
+/*
+ * fma_command_probe_free_stats:
+ * @stats: a list as returned by fma_command_probe_get_stats().
+ *
+ * Releases the list.
+ */
+void
+fma_command_probe_free_stats( GList *stats )
+{
+	GList *it;
+
+	for( it = stats ; it ; it = it->next ){
+		g_free((( FMACommandProbeStats * ) it->data )->command );
+		g_free( it->data );
+	}
+
+	g_list_free( stats );
+}
+
+/*
+ * fma_command_probe_dump:
+ *
+ * Dumps the statistics of the known commands, the slowest first.
+ */
+void
+fma_command_probe_dump( void )
+{
+	static const gchar *thisfn = "fma_command_probe_dump";
+	GList *list, *it;
+	FMACommandProbeStats *stats;
+
+	list = fma_command_probe_get_stats();
+
+	for( it = list ; it ; it = it->next ){
+		stats = ( FMACommandProbeStats * ) it->data;
+		g_debug( "%s: command=%s, runs=%u, timeouts=%u, hits=%u, stale_hits=%u, last=%.1f ms, max=%.1f ms, mean=%.1f ms",
+				thisfn, stats->command, stats->runs, stats->timeouts, stats->hits, stats->stale_hits,
+				stats->last_usec / 1000.0, stats->max_usec / 1000.0,
+				stats->runs ? stats->total_usec / 1000.0 / stats->runs : 0.0 );
+	}
+
+	fma_command_probe_free_stats( list );
+}
+
+/*
+ * fma_command_probe_free:
+ *
+ * Releases the cache.
+ * Running commands are left to terminate (or to be killed) on their own.
+ */
+void
+fma_command_probe_free( void )
+{
+	g_mutex_lock( &st_mutex );
+
+	if( st_probes ){
+		g_hash_table_destroy( st_probes );
+		st_probes = NULL;
+	}
+
+	g_mutex_unlock( &st_mutex );
+}
+
+/*
+ * returns the probe of the command, allocating it if needed
+ *
+ * as parameters are expanded from the selection, the count of distinct
+ * commands is not bounded: when the cache is full, first release the
+ * expired results, and then all results if that was not enough
+ *
+ * st_mutex is expected to be held
+ */
+static sProbe *
+get_probe( const gchar *command )
+{
+	sProbe *probe;
+
+	if( !st_probes ){
+		st_probes = g_hash_table_new_full( g_str_hash, g_str_equal, NULL, ( GDestroyNotify ) probe_unref );
+	}
+
+	probe = ( sProbe * ) g_hash_table_lookup( st_probes, command );
+
+	if( !probe ){
+		if( g_hash_table_size( st_probes ) >= PROBE_CACHE_MAX ){
+			purge_probes( FALSE );
+			if( g_hash_table_size( st_probes ) >= PROBE_CACHE_MAX ){
+				purge_probes( TRUE );
+			}
+		}
+
+		probe = g_new0( sProbe, 1 );
+		probe->ref_count = 1;
+		probe->command = g_strdup( command );
+		g_cond_init( &probe->cond );
+		g_hash_table_insert( st_probes, probe->command, probe );
+	}
+
+	return( probe );
+}
+
+/*
+ * running probes are never purged
+ */
+static void
+purge_probes( gboolean all )
+{
+	GHashTableIter iter;
+	sProbe *probe;
+	gint64 now;
+
+	now = g_get_monotonic_time();
+	g_hash_table_iter_init( &iter, st_probes );
+
+	while( g_hash_table_iter_next( &iter, NULL, ( gpointer * ) &probe )){
+		if( !probe->running && ( all || now >= probe->expires )){
+			g_hash_table_iter_remove( &iter );
+		}
+	}
+}
+
+static GThreadPool *
+get_pool( void )
+{
+	static const gchar *thisfn = "fma_command_probe_get_pool";
+	static GThreadPool *st_pool = NULL;
+	static gsize initialized = 0;
+	GError *error;
+
+	if( g_once_init_enter( &initialized )){
+		error = NULL;
+		st_pool = g_thread_pool_new(( GFunc ) on_pool_thread, NULL, PROBE_MAX_THREADS, FALSE, &error );
+		if( error ){
+			g_warning( "%s: %s", thisfn, error->message );
+			g_error_free( error );
+		}
+		g_once_init_leave( &initialized, 1 );
+	}
+
+	return( st_pool );
+}
+
+/*
+ * run the command on a pool thread, and record its result
+ */
+static void
+on_pool_thread( sProbe *probe, gpointer pool_data )
+{
+	gboolean result, timed_out;
+	gint64 start, now;
+	guint64 elapsed;
+
+	start = g_get_monotonic_time();
+	result = probe_spawn( probe->command, start + probe->timeout * G_TIME_SPAN_MILLISECOND, &timed_out );
+	now = g_get_monotonic_time();
+	elapsed = ( guint64 )( now - start );
+
+	g_mutex_lock( &st_mutex );
+
+	probe->running = FALSE;
+	probe->has_result = TRUE;
+	probe->result = result;
+	probe->expires = now + probe->ttl * G_TIME_SPAN_SECOND;
+
+	probe->stats.runs += 1;
+	probe->stats.timeouts += timed_out ? 1 : 0;
+	probe->stats.last_usec = elapsed;
+	probe->stats.max_usec = MAX( probe->stats.max_usec, elapsed );
+	probe->stats.total_usec += elapsed;
+
+	g_cond_broadcast( &probe->cond );
+	probe_unref( probe );
+
+	g_mutex_unlock( &st_mutex );
+}
+
+/*
+ * starts a new run of the probe, unless it is already running
+ *
+ * st_mutex is expected to be held
+ */
+static void
+probe_start( sProbe *probe, guint timeout, guint ttl )
+{
+	static const gchar *thisfn = "fma_command_probe_start";
+	GThreadPool *pool;
+	GError *error;
+
+	if( !probe->running ){
+		pool = get_pool();
+		if( pool ){
+			probe->running = TRUE;
+			probe->timeout = timeout;
+			probe->ttl = ttl;
+			error = NULL;
+			g_thread_pool_push( pool, probe_ref( probe ), &error );
+			if( error ){
+				g_warning( "%s: %s", thisfn, error->message );
+				g_error_free( error );
+				probe->running = FALSE;
+				probe_unref( probe );
+			}
+		}
+	}
+}
+
+/*
+ * spawn the command, and read its standard output until either it is
+ * closed or the deadline is reached; in this later case, the command
+ * is killed
+ *
+ * Returns: %TRUE if the command outputs 'true'
+ */
+static gboolean
+probe_spawn( const gchar *command, gint64 deadline, gboolean *timed_out )
+{
+	static const gchar *thisfn = "fma_command_probe_spawn";
+	gchar **argv;
+	GPid pid;
+	gint fd_stdout;
+	GError *error;
+	GString *output;
+	gchar buffer[ PROBE_OUTPUT_MAX ];
+	struct pollfd pfd;
+	gint64 remaining;
+	gssize count;
+	gint ret;
+	gboolean eof, result;
+
+	*timed_out = FALSE;
+	argv = NULL;
+	error = NULL;
+
+	if( !g_shell_parse_argv( command, NULL, &argv, &error ) ||
+		!g_spawn_async_with_pipes( NULL, argv, NULL,
+				G_SPAWN_SEARCH_PATH | G_SPAWN_DO_NOT_REAP_CHILD, NULL, NULL, &pid, NULL, &fd_stdout, NULL, &error )){
+		g_debug( "%s: command=%s: %s", thisfn, command, error->message );
+		g_error_free( error );
+		g_strfreev( argv );
+		return( FALSE );
+	}
+
+	g_strfreev( argv );
+
+	/* we only care of the first bytes of the output, but still have to
+	 * drain it so that the command is not blocked on a full pipe
+	 */
+	output = g_string_new( "" );
+	eof = FALSE;
+
+	while( !eof && !*timed_out ){
+		remaining = ( deadline - g_get_monotonic_time()) / G_TIME_SPAN_MILLISECOND;
+		if( remaining <= 0 ){
+			*timed_out = TRUE;
+			continue;
+		}
+		pfd.fd = fd_stdout;
+		pfd.events = POLLIN;
+		pfd.revents = 0;
+		ret = poll( &pfd, 1, ( gint ) remaining );
+		if( ret == 0 ){
+			*timed_out = TRUE;
+
+		} else if( ret > 0 ){
+			count = read( fd_stdout, buffer, sizeof( buffer ));
+			if( count > 0 ){
+				if( output->len < PROBE_OUTPUT_MAX ){
+					g_string_append_len( output, buffer, count );
+				}
+			} else if( count == 0 || errno != EINTR ){
+				eof = TRUE;
+			}
+
+		} else if( errno != EINTR ){
+			eof = TRUE;
+		}
+	}
+
+	close( fd_stdout );
+
+	if( !*timed_out ){
+		*timed_out = !probe_wait_child( pid, deadline );
+	}
+	if( *timed_out ){
+		g_debug( "%s: command=%s: killed after deadline", thisfn, command );
+		kill( pid, SIGKILL );
+		waitpid( pid, NULL, 0 );
+	}
+	g_spawn_close_pid( pid );
+
+	result = !*timed_out && !strcmp( output->str, "true" );
+	g_string_free( output, TRUE );
+
+	return( result );
+}
+
+/*
+ * the command may have closed its standard output while still running
+ *
+ * Returns: %TRUE if the child has terminated before the deadline
+ */
+static gboolean
+probe_wait_child( GPid pid, gint64 deadline )
+{
+	pid_t ret;
+
+	while( TRUE ){
+		ret = waitpid( pid, NULL, WNOHANG );
+		if( ret == pid || ( ret < 0 && errno != EINTR )){
+			return( TRUE );
+		}
+		if( g_get_monotonic_time() >= deadline ){
+			return( FALSE );
+		}
+		g_usleep( G_USEC_PER_SEC / 1000 );
+	}
+}
+
+static sProbe *
+probe_ref( sProbe *probe )
+{
+	probe->ref_count += 1;
+
+	return( probe );
+}
+
+/*
+ * st_mutex is expected to be held
+ */
+static void
+probe_unref( sProbe *probe )
+{
+	probe->ref_count -= 1;
+
+	if( !probe->ref_count ){
+		g_cond_clear( &probe->cond );
+		g_free( probe->command );
+		g_free( probe );
+	}
+}
+
+static gint
+cmp_stats( const FMACommandProbeStats *a, const FMACommandProbeStats *b )
+{
+	return( a->max_usec < b->max_usec ? 1 : ( a->max_usec > b->max_usec ? -1 : 0 ));
+}
@@ -0,0 +1,86 @@
+/*
+ * FileManager-Actions
+ * A file-manager extension which offers configurable context menu actions.
+ *
+ * Copyright (C) 2005 The GNOME Foundation
+ * Copyright (C) 2006-2008 Frederic Ruaudel and others (see AUTHORS)
+ * Copyright (C) 2009-2015 Pierre Wieser and others (see AUTHORS)
+ *
+ * FileManager-Actions is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * FileManager-Actions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FileManager-Actions; see the file COPYING. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Authors:
+ *   Frederic Ruaudel <grumz@grumz.net>
+ *   Rodrigo Moya <rodrigo@gnome-db.org>
+ *   Pierre Wieser <pwieser@trychlos.org>
+ *   ... and many others (see AUTHORS)
+ */
+
+#ifndef __CORE_FMA_COMMAND_PROBE_H__
+#define __CORE_FMA_COMMAND_PROBE_H__
+
+/* @title: Command Probes
+ * @short_description: The execution engine of the ShowIfTrue commands.
+ * @include: core/fma-command-probe.h
+ *
+ * A ShowIfTrue condition is satisfied when its command outputs 'true'.
+ * As this is checked while the file manager builds its context menu,
+ * a command which takes its time would freeze the file manager.
+ *
+ * Commands are so run on a dedicated pool of threads, and the caller
+ * only waits for them until a deadline. A command which has not
+ * terminated by this deadline is killed, and the condition is then
+ * considered as not satisfied.
+ *
+ * Results are kept in a process-wide cache, keyed by the command
+ * (after its parameters have been expanded), for a configurable
+ * time-to-live. On demand, an expired result may also be returned
+ * while the command is run again in the background.
+ *
+ * The behavior is driven by the following runtime preferences:
+ * - IPREFS_SHOW_IF_TRUE_TIMEOUT: the deadline, in msec;
+ * - IPREFS_SHOW_IF_TRUE_TTL: the time-to-live of a result, in sec;
+ * - IPREFS_SHOW_IF_TRUE_REFRESH: whether an expired result may be
+ *   returned while being refreshed.
+ */
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/* the execution statistics of a command
+ * latencies are in usec
+ */
+typedef struct {
+	gchar  *command;
+	guint   runs;
+	guint   timeouts;
+	guint   hits;
+	guint   stale_hits;
+	guint64 last_usec;
+	guint64 max_usec;
+	guint64 total_usec;
+}
+	FMACommandProbeStats;
+
+gboolean fma_command_probe_is_true   ( const gchar *command );
+
+GList   *fma_command_probe_get_stats ( void );
+void     fma_command_probe_free_stats( GList *stats );
+void     fma_command_probe_dump      ( void );
+void     fma_command_probe_free      ( void );
+
+G_END_DECLS
+
+#endif /* __CORE_FMA_COMMAND_PROBE_H__ */
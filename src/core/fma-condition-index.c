@@ -0,0 +1,567 @@
+/*
+ * FileManager-Actions
+ * A file-manager extension which offers configurable context menu actions.
+ *
+ * Copyright (C) 2005 The GNOME Foundation
+ * Copyright (C) 2006-2008 Frederic Ruaudel and others (see AUTHORS)
+ * Copyright (C) 2009-2015 Pierre Wieser and others (see AUTHORS)
+ *
+ * FileManager-Actions is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * FileManager-Actions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FileManager-Actions; see the file COPYING. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Authors:
+ *   Frederic Ruaudel <grumz@grumz.net>
+ *   Rodrigo Moya <rodrigo@gnome-db.org>
+ *   Pierre Wieser <pwieser@trychlos.org>
+ *   ... and many others (see AUTHORS)
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <gio/gio.h>
+#include <string.h>
+
+#include <api/fma-core-utils.h>
+#include <api/fma-object-api.h>
+
+#include "fma-condition-index.h"
+#include "fma-mimetype-cache.h"
+#include "fma-selected-info.h"
+
+/* an indexed FMAIContext
+ * targets: a bitmask of the ITEM_TARGET_xxx this context may be displayed in
+ * schemes: the list of positive schemes, or NULL if any scheme may match
+ * majors: a bitmask of the major types of the positive mimetypes conditions,
+ *  or zero if any mimetype may match
+ */
+typedef struct {
+	FMAObject *context;
+	guint      targets;
+	GSList    *schemes;
+	guint64    majors;
+}
+	sEntry;
+
+/* the entries which are candidate for a given target
+ * an entry which has explicit schemes is registered once for each of
+ * these schemes in the 'by_scheme' hash table
+ */
+typedef struct {
+	GHashTable *by_scheme;
+	GList      *any_scheme;
+}
+	sBucket;
+
+#define BUCKETS_COUNT					( ITEM_TARGET_ANY+1 )
+#define MAJORS_MAX						64
+
+struct _FMAConditionIndex {
+	GList      *entries;
+	GHashTable *majors;
+	guint       majors_count;
+	guint       attributes;
+	sBucket     buckets[ BUCKETS_COUNT ];
+};
+
+static void     index_tree_rec( FMAConditionIndex *index, GList *tree );
+static sEntry  *entry_new( FMAConditionIndex *index, FMAObject *context );
+static void     entry_free( sEntry *entry );
+static guint    entry_get_targets( FMAObject *context );
+static GSList  *entry_get_schemes( FMAObject *context );
+static guint64  entry_get_majors( FMAConditionIndex *index, FMAObject *context );
+static guint    entry_get_attributes( FMAObject *context );
+static gboolean is_wildcard_mimetype( const gchar *mimetype );
+static void     bucket_add_entry( sBucket *bucket, sEntry *entry );
+static gboolean entry_is_candidate( const sEntry *entry, GSList *schemes, GSList *masks );
+static guint64  selection_get_mask( const FMAConditionIndex *index, const gchar *mimetype );
+
+/*
+ * fma_condition_index_new:
+ * @tree: the tree of items as loaded by FMAPivot.
+ *
+ * Returns: a newly allocated #FMAConditionIndex which should be
+ * fma_condition_index_free() by the caller.
+ */
+FMAConditionIndex *
+fma_condition_index_new( GList *tree )
+{
+	static const gchar *thisfn = "fma_condition_index_new";
+	FMAConditionIndex *index;
+	guint i;
+
+	index = g_new0( FMAConditionIndex, 1 );
+	index->majors = g_hash_table_new_full( g_str_hash, g_str_equal, g_free, NULL );
+
+	for( i = 0 ; i < BUCKETS_COUNT ; ++i ){
+		index->buckets[i].by_scheme = g_hash_table_new_full( g_str_hash, g_str_equal, g_free, ( GDestroyNotify ) g_list_free );
+	}
+
+	index_tree_rec( index, tree );
+
+	g_debug( "%s: tree=%p, indexed=%u, majors=%u, attributes=%u",
+			thisfn, ( void * ) tree, g_list_length( index->entries ), index->majors_count, index->attributes );
+
+	return( index );
+}
+
+/*
+ * fma_condition_index_free:
+ * @index: this #FMAConditionIndex.
+ *
+ * Releases the resources allocated to the @index.
+ */
+void
+fma_condition_index_free( FMAConditionIndex *index )
+{
+	guint i;
+
+	if( index ){
+		for( i = 0 ; i < BUCKETS_COUNT ; ++i ){
+			g_hash_table_destroy( index->buckets[i].by_scheme );
+			g_list_free( index->buckets[i].any_scheme );
+		}
+		g_hash_table_destroy( index->majors );
+		g_list_free_full( index->entries, ( GDestroyNotify ) entry_free );
+		g_free( index );
+	}
+}
+
+/*
+ * fma_condition_index_dump:
+ * @index: this #FMAConditionIndex.
+ *
+ * Dumps the content of the @index.
+ */
+void
+fma_condition_index_dump( const FMAConditionIndex *index )
+{
+	static const gchar *thisfn = "fma_condition_index_dump";
+	guint i;
+
+	if( index ){
+		g_debug( "%s:      entries=%u", thisfn, g_list_length( index->entries ));
+		g_debug( "%s:       majors=%u", thisfn, index->majors_count );
+		g_debug( "%s:   attributes=%u", thisfn, index->attributes );
+
+		for( i = ITEM_TARGET_SELECTION ; i < BUCKETS_COUNT ; ++i ){
+			g_debug( "%s:    target=%u: schemes=%u, any_scheme=%u", thisfn, i,
+					g_hash_table_size( index->buckets[i].by_scheme ),
+					g_list_length( index->buckets[i].any_scheme ));
+		}
+	}
+}
+
+/*
+ * fma_condition_index_get_candidates:
+ * @index: this #FMAConditionIndex.
+ * @target: the targeted file manager UI.
+ * @selection: the current selection, as a #GList of #FMASelectedInfo.
+ *
+ * Returns: a set of the #FMAIContext objects which may be candidate
+ * to the @selection, or %NULL if the @index is not able to pre-filter
+ * the contexts.
+ *
+ * The returned hash table should be g_hash_table_destroy() by the caller.
+ */
+GHashTable *
+fma_condition_index_get_candidates( const FMAConditionIndex *index, guint target, GList *selection )
+{
+	static const gchar *thisfn = "fma_condition_index_get_candidates";
+	GHashTable *candidates;
+	const sBucket *bucket;
+	const FMASelectionSummary *summary;
+	GSList *schemes, *masks, *is;
+	GList *it, *entries;
+	guint64 *mask;
+	guint count;
+
+	if( !index || !selection || target < ITEM_TARGET_SELECTION || target >= BUCKETS_COUNT ){
+		return( NULL );
+	}
+
+	/* distinct schemes and mimetypes of the selection
+	 * items without mimetype may still be queried later, and so are not
+	 * able to restrict the candidates
+	 */
+	summary = fma_selected_info_get_summary( selection, SELECTION_SUMMARY_SCHEMES | SELECTION_SUMMARY_MIMETYPES );
+	schemes = summary->schemes;
+	masks = NULL;
+
+	for( is = summary->mimetypes ; is ; is = is->next ){
+		mask = g_new0( guint64, 1 );
+		*mask = selection_get_mask( index, (( const FMASelectionMimetype * ) is->data )->mimetype );
+		masks = g_slist_prepend( masks, mask );
+	}
+
+	/* only the entries registered for the first scheme, plus those
+	 * which accept any scheme, have to be examined
+	 */
+	candidates = g_hash_table_new( g_direct_hash, g_direct_equal );
+	bucket = &index->buckets[target];
+	count = 0;
+
+	entries = schemes ? g_hash_table_lookup( bucket->by_scheme, schemes->data ) : NULL;
+	for( it = entries ; it ; it = it->next, ++count ){
+		if( entry_is_candidate(( const sEntry * ) it->data, schemes, masks )){
+			g_hash_table_add( candidates, (( const sEntry * ) it->data )->context );
+		}
+	}
+	for( it = bucket->any_scheme ; it ; it = it->next, ++count ){
+		if( entry_is_candidate(( const sEntry * ) it->data, schemes, masks )){
+			g_hash_table_add( candidates, (( const sEntry * ) it->data )->context );
+		}
+	}
+
+	g_debug( "%s: target=%u, selection_count=%u, examined=%u, candidates=%u",
+			thisfn, target, summary->count, count, g_hash_table_size( candidates ));
+
+	g_slist_free_full( masks, ( GDestroyNotify ) g_free );
+
+	return( candidates );
+}
+
+/*
+ * fma_condition_index_get_attributes:
+ * @index: this #FMAConditionIndex.
+ *
+ * Returns: the set of #FMASelectedInfoAttribute file attributes which
+ * are needed to evaluate the conditions of the indexed contexts.
+ *
+ * The content type attribute is never returned here, as the file
+ * manager is expected to already provide the mimetype of the selected
+ * items.
+ */
+guint
+fma_condition_index_get_attributes( const FMAConditionIndex *index )
+{
+	return( index ? index->attributes : SELECTED_INFO_ATTRIBUTE_ALL );
+}
+
+static void
+index_tree_rec( FMAConditionIndex *index, GList *tree )
+{
+	GList *it;
+	sEntry *entry;
+	guint i;
+
+	for( it = tree ; it ; it = it->next ){
+		if( FMA_IS_ICONTEXT( it->data )){
+			entry = entry_new( index, FMA_OBJECT( it->data ));
+			index->entries = g_list_prepend( index->entries, entry );
+			index->attributes |= entry_get_attributes( FMA_OBJECT( it->data ));
+
+			for( i = ITEM_TARGET_SELECTION ; i < BUCKETS_COUNT ; ++i ){
+				if( entry->targets & ( 1 << i )){
+					bucket_add_entry( &index->buckets[i], entry );
+				}
+			}
+		}
+
+		/* the items of a menu, or the profiles of an action
+		 */
+		if( FMA_IS_OBJECT_ITEM( it->data )){
+			index_tree_rec( index, fma_object_get_items( it->data ));
+		}
+	}
+}
+
+static sEntry *
+entry_new( FMAConditionIndex *index, FMAObject *context )
+{
+	sEntry *entry;
+
+	entry = g_new0( sEntry, 1 );
+	entry->context = context;
+	entry->targets = entry_get_targets( context );
+	entry->schemes = entry_get_schemes( context );
+	entry->majors = entry_get_majors( index, context );
+
+	return( entry );
+}
+
+static void
+entry_free( sEntry *entry )
+{
+	fma_core_utils_slist_free( entry->schemes );
+	g_free( entry );
+}
+
+/*
+ * only actions are concerned by the target
+ * a ITEM_TARGET_ANY target accepts all actions
+ */
+static guint
+entry_get_targets( FMAObject *context )
+{
+	guint targets;
+
+	targets = ( 1 << ITEM_TARGET_ANY );
+
+	if( FMA_IS_OBJECT_ACTION( context )){
+		if( fma_object_is_target_selection( context )){
+			targets |= ( 1 << ITEM_TARGET_SELECTION );
+		}
+		if( fma_object_is_target_location( context )){
+			targets |= ( 1 << ITEM_TARGET_LOCATION );
+		}
+		if( fma_object_is_target_toolbar( context )){
+			targets |= ( 1 << ITEM_TARGET_TOOLBAR );
+		}
+
+	} else {
+		targets |= ( 1 << ITEM_TARGET_SELECTION ) | ( 1 << ITEM_TARGET_LOCATION ) | ( 1 << ITEM_TARGET_TOOLBAR );
+	}
+
+	return( targets );
+}
+
+/*
+ * negative assertions are ignored here: they are only able to reject
+ * a context, and will be checked by fma_icontext_is_candidate()
+ *
+ * Returns: the list of positive schemes, or NULL if any scheme may match.
+ */
+static GSList *
+entry_get_schemes( FMAObject *context )
+{
+	GSList *schemes, *is, *positives;
+	const gchar *pattern;
+	gboolean any;
+
+	schemes = fma_object_get_schemes( context );
+	positives = NULL;
+	any = ( schemes == NULL );
+
+	for( is = schemes ; is && !any ; is = is->next ){
+		pattern = ( const gchar * ) is->data;
+		if( pattern[0] == '!' ){
+			continue;
+		}
+		if( !strcmp( pattern, "*" )){
+			any = TRUE;
+		} else {
+			positives = g_slist_prepend( positives, g_strdup( pattern ));
+		}
+	}
+
+	fma_core_utils_slist_free( schemes );
+
+	if( any || !positives ){
+		fma_core_utils_slist_free( positives );
+		positives = NULL;
+	}
+
+	return( positives );
+}
+
+/*
+ * Returns: a bitmask of the major types of the positive mimetypes, or
+ * zero if any mimetype may match.
+ */
+static guint64
+entry_get_majors( FMAConditionIndex *index, FMAObject *context )
+{
+	GSList *mimetypes, *im;
+	const gchar *mimetype;
+	gchar **split;
+	guint64 majors;
+	gboolean any;
+	guint bit;
+
+	if( fma_object_get_all_mimetypes( context )){
+		return( 0 );
+	}
+
+	mimetypes = fma_object_get_mimetypes( context );
+	majors = 0;
+	any = FALSE;
+
+	for( im = mimetypes ; im && !any ; im = im->next ){
+		mimetype = ( const gchar * ) im->data;
+		if( !mimetype || mimetype[0] == '!' ){
+			continue;
+		}
+		if( is_wildcard_mimetype( mimetype )){
+			any = TRUE;
+			continue;
+		}
+		split = g_strsplit( mimetype, "/", 2 );
+		bit = GPOINTER_TO_UINT( g_hash_table_lookup( index->majors, split[0] ));
+		if( !bit ){
+			if( index->majors_count < MAJORS_MAX ){
+				index->majors_count += 1;
+				bit = index->majors_count;
+				g_hash_table_insert( index->majors, g_strdup( split[0] ), GUINT_TO_POINTER( bit ));
+			} else {
+				any = TRUE;
+			}
+		}
+		if( bit ){
+			majors |= (( guint64 ) 1 << ( bit-1 ));
+		}
+		g_strfreev( split );
+	}
+
+	fma_core_utils_slist_free( mimetypes );
+
+	return( any ? 0 : majors );
+}
+
+/*
+ * Returns: the file attributes which have to be queried in order to
+ * evaluate the conditions of the @context.
+ *
+ * Only 'allfiles' mimetypes rely on the type of the file, while the
+ * 'Local' capability only relies on the URI scheme.
+ */
+static guint
+entry_get_attributes( FMAObject *context )
+{
+	GSList *list, *it;
+	const gchar *condition;
+	guint attributes;
+
+	attributes = SELECTED_INFO_ATTRIBUTE_NONE;
+
+	list = fma_object_get_mimetypes( context );
+	for( it = list ; it ; it = it->next ){
+		condition = ( const gchar * ) it->data;
+		if( condition[0] == '!' ){
+			condition += 1;
+		}
+		if( g_str_has_prefix( condition, "allfiles" )){
+			attributes |= SELECTED_INFO_ATTRIBUTE_TYPE;
+		}
+	}
+	fma_core_utils_slist_free( list );
+
+	list = fma_object_get_capabilities( context );
+	for( it = list ; it ; it = it->next ){
+		condition = ( const gchar * ) it->data;
+		if( condition[0] == '!' ){
+			condition += 1;
+		}
+		if( !strcmp( condition, "Owner" )){
+			attributes |= SELECTED_INFO_ATTRIBUTE_OWNER;
+		} else if( strcmp( condition, "Local" )){
+			attributes |= SELECTED_INFO_ATTRIBUTE_ACCESS;
+		}
+	}
+	fma_core_utils_slist_free( list );
+
+	return( attributes );
+}
+
+/*
+ * these mimetypes may match files whatever be their major type
+ * 'application/octet-stream' is a parent of all non-inode types
+ */
+static gboolean
+is_wildcard_mimetype( const gchar *mimetype )
+{
+	return( !strchr( mimetype, '/' ) ||
+			mimetype[0] == '*' ||
+			g_str_has_prefix( mimetype, "all/" ) ||
+			g_str_has_prefix( mimetype, "allfiles/" ) ||
+			!strcmp( mimetype, "application/octet-stream" ));
+}
+
+static void
+bucket_add_entry( sBucket *bucket, sEntry *entry )
+{
+	GSList *is;
+	GList *list;
+
+	if( !entry->schemes ){
+		bucket->any_scheme = g_list_prepend( bucket->any_scheme, entry );
+
+	} else {
+		for( is = entry->schemes ; is ; is = is->next ){
+			list = g_hash_table_lookup( bucket->by_scheme, is->data );
+			if( list ){
+				g_hash_table_steal( bucket->by_scheme, is->data );
+			}
+			list = g_list_prepend( list, entry );
+			g_hash_table_insert( bucket->by_scheme, g_strdup( is->data ), list );
+		}
+	}
+}
+
+/*
+ * each distinct scheme of the selection must be accepted by the entry,
+ * and each distinct mimetype must share at least one major type with
+ * the positive mimetypes of the entry
+ */
+static gboolean
+entry_is_candidate( const sEntry *entry, GSList *schemes, GSList *masks )
+{
+	GSList *it;
+
+	if( entry->schemes ){
+		for( it = schemes ; it ; it = it->next ){
+			if( !fma_core_utils_slist_count( entry->schemes, it->data )){
+				return( FALSE );
+			}
+		}
+	}
+
+	if( entry->majors ){
+		for( it = masks ; it ; it = it->next ){
+			if(( entry->majors & *( guint64 * ) it->data ) == 0 ){
+				return( FALSE );
+			}
+		}
+	}
+
+	return( TRUE );
+}
+
+/*
+ * Returns: the bitmask of the indexed major types the @mimetype is a
+ * sort of - taking into account the subclassing of the mimetypes, e.g.
+ * 'application/x-shellscript' is both an 'application' and a 'text'.
+ */
+static guint64
+selection_get_mask( const FMAConditionIndex *index, const gchar *mimetype )
+{
+	GHashTableIter iter;
+	gpointer key, value;
+	gchar *file_type, *major_type, *major;
+	guint64 mask;
+
+	mask = 0;
+	file_type = g_content_type_from_mime_type( mimetype );
+
+	if( file_type ){
+		g_hash_table_iter_init( &iter, index->majors );
+
+		while( g_hash_table_iter_next( &iter, &key, &value )){
+			major = g_strdup_printf( "%s/*", ( const gchar * ) key );
+			major_type = g_content_type_from_mime_type( major );
+
+			if( major_type && fma_mimetype_cache_is_a( file_type, major_type )){
+				mask |= (( guint64 ) 1 << ( GPOINTER_TO_UINT( value )-1 ));
+			}
+
+			g_free( major_type );
+			g_free( major );
+		}
+
+		g_free( file_type );
+	}
+
+	return( mask );
+}
@@ -0,0 +1,67 @@
+/*
+ * FileManager-Actions
+ * A file-manager extension which offers configurable context menu actions.
+ *
+ * Copyright (C) 2005 The GNOME Foundation
+ * Copyright (C) 2006-2008 Frederic Ruaudel and others (see AUTHORS)
+ * Copyright (C) 2009-2015 Pierre Wieser and others (see AUTHORS)
+ *
+ * FileManager-Actions is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * FileManager-Actions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FileManager-Actions; see the file COPYING. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Authors:
+ *   Frederic Ruaudel <grumz@grumz.net>
+ *   Rodrigo Moya <rodrigo@gnome-db.org>
+ *   Pierre Wieser <pwieser@trychlos.org>
+ *   ... and many others (see AUTHORS)
+ */
+
+#ifndef __CORE_FMA_CONDITION_INDEX_H__
+#define __CORE_FMA_CONDITION_INDEX_H__
+
+/* @title: FMAConditionIndex
+ * @short_description: A pre-compiled index of the FMAIContext conditions.
+ * @include: core/fma-condition-index.h
+ *
+ * The condition index is built once each time the FMAPivot tree of items
+ * is (re)loaded. It buckets each FMAIContext (menus, actions and profiles)
+ * by target, by scheme and by the major type of its positive mimetype
+ * conditions, so that building a file manager menu only has to evaluate
+ * the full set of conditions for the small subset of contexts which are
+ * actually able to match the current selection.
+ *
+ * The index only acts as a pre-filter: a context which is not found in
+ * the returned candidates set is known to fail fma_icontext_is_candidate(),
+ * while a context which is found still has to be fully checked.
+ *
+ * The index does not take any reference on the indexed objects: it must
+ * be rebuilt each time the tree it has been built from is released.
+ */
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+typedef struct _FMAConditionIndex FMAConditionIndex;
+
+FMAConditionIndex *fma_condition_index_new           ( GList *tree );
+void               fma_condition_index_free          ( FMAConditionIndex *index );
+void               fma_condition_index_dump          ( const FMAConditionIndex *index );
+
+GHashTable        *fma_condition_index_get_candidates( const FMAConditionIndex *index, guint target, GList *selection );
+guint              fma_condition_index_get_attributes( const FMAConditionIndex *index );
+
+G_END_DECLS
+
+#endif /* __CORE_FMA_CONDITION_INDEX_H__ */
@@ -129,6 +129,47 @@ text_to_string_list( const gchar *text, const gchar *separator, const gchar *def
 }
 #endif /* FMA_ENABLE_DEPRECATED */
 
+/**
+ * fma_core_utils_str_ascii_case_hash:
+ * @str: a nul-terminated string.
+ *
+ * Converts a string to a hash value, ignoring the case of ASCII
+ * characters, so that it may be used together with
+ * fma_core_utils_str_ascii_case_equal() as a #GHashTable hash function.
+ *
+ * Returns: the hash value of the string.
+ *
+ * Since: 3.5
+ */
+guint
+fma_core_utils_str_ascii_case_hash( gconstpointer str )
+{
+	const gchar *p;
+	guint32 h = 5381;
+
+	for( p = ( const gchar * ) str ; *p ; p++ ){
+		h = ( h << 5 ) + h + g_ascii_tolower( *p );
+	}
+
+	return( h );
+}
+
+/**
+ * fma_core_utils_str_ascii_case_equal:
+ * @str1: a nul-terminated string.
+ * @str2: another nul-terminated string.
+ *
+ * Returns: %TRUE if the two strings are equal, ignoring the case of
+ * ASCII characters, %FALSE else.
+ *
+ * Since: 3.5
+ */
+gboolean
+fma_core_utils_str_ascii_case_equal( gconstpointer str1, gconstpointer str2 )
+{
+	return( g_ascii_strcasecmp(( const gchar * ) str1, ( const gchar * ) str2 ) == 0 );
+}
+
 /**
  * fma_core_utils_str_collate:
  * @str1: an UTF-8 encoded string.
@@ -41,6 +41,8 @@
 #include <api/fma-data-types.h>
 #include <api/fma-data-boxed.h>
 
+#include "fma-boxed-value.h"
+
 /* private class data
  */
 struct _FMADataBoxedClassPrivate {
@@ -53,8 +55,8 @@ struct _FMADataBoxedClassPrivate {
 typedef struct {
 	guint           type;
 	GParamSpec * ( *spec )      ( const FMADataDef * );
-	gboolean     ( *is_default )( const FMADataBoxed * );
-	gboolean     ( *is_valid )  ( const FMADataBoxed * );
+	gboolean     ( *is_default )( const FMADataDef *, const FMABoxedValue * );
+	gboolean     ( *is_valid )  ( const FMADataDef *, const FMABoxedValue * );
 }
 	DataBoxedDef;
 
@@ -77,31 +79,31 @@ static void                instance_finalize( GObject *object );
 static const DataBoxedDef *get_data_boxed_def( guint type );
 
 static GParamSpec         *bool_spec( const FMADataDef *idtype );
-static gboolean            bool_is_default( const FMADataBoxed *boxed );
-static gboolean            bool_is_valid( const FMADataBoxed *boxed );
+static gboolean            bool_is_default( const FMADataDef *def, const FMABoxedValue *boxed );
+static gboolean            bool_is_valid( const FMADataDef *def, const FMABoxedValue *boxed );
 
 static GParamSpec         *pointer_spec( const FMADataDef *idtype );
-static gboolean            pointer_is_default( const FMADataBoxed *boxed );
-static gboolean            pointer_is_valid( const FMADataBoxed *boxed );
+static gboolean            pointer_is_default( const FMADataDef *def, const FMABoxedValue *boxed );
+static gboolean            pointer_is_valid( const FMADataDef *def, const FMABoxedValue *boxed );
 
 static GParamSpec         *string_spec( const FMADataDef *idtype );
-static gboolean            string_is_default( const FMADataBoxed *boxed );
-static gboolean            string_is_valid( const FMADataBoxed *boxed );
+static gboolean            string_is_default( const FMADataDef *def, const FMABoxedValue *boxed );
+static gboolean            string_is_valid( const FMADataDef *def, const FMABoxedValue *boxed );
 
 static GParamSpec         *string_list_spec( const FMADataDef *idtype );
-static gboolean            string_list_is_default( const FMADataBoxed *boxed );
-static gboolean            string_list_is_valid( const FMADataBoxed *boxed );
+static gboolean            string_list_is_default( const FMADataDef *def, const FMABoxedValue *boxed );
+static gboolean            string_list_is_valid( const FMADataDef *def, const FMABoxedValue *boxed );
 
-static gboolean            locale_is_default( const FMADataBoxed *boxed );
-static gboolean            locale_is_valid( const FMADataBoxed *boxed );
+static gboolean            locale_is_default( const FMADataDef *def, const FMABoxedValue *boxed );
+static gboolean            locale_is_valid( const FMADataDef *def, const FMABoxedValue *boxed );
 
 static GParamSpec         *uint_spec( const FMADataDef *idtype );
-static gboolean            uint_is_default( const FMADataBoxed *boxed );
-static gboolean            uint_is_valid( const FMADataBoxed *boxed );
+static gboolean            uint_is_default( const FMADataDef *def, const FMABoxedValue *boxed );
+static gboolean            uint_is_valid( const FMADataDef *def, const FMABoxedValue *boxed );
 
 static GParamSpec         *uint_list_spec( const FMADataDef *idtype );
-static gboolean            uint_list_is_default( const FMADataBoxed *boxed );
-static gboolean            uint_list_is_valid( const FMADataBoxed *boxed );
+static gboolean            uint_list_is_default( const FMADataDef *def, const FMABoxedValue *boxed );
+static gboolean            uint_list_is_valid( const FMADataDef *def, const FMABoxedValue *boxed );
 
 static DataBoxedDef st_data_boxed_def[] = {
 		{ FMA_DATA_TYPE_BOOLEAN,
@@ -249,16 +251,16 @@ instance_finalize( GObject *object )
 	}
 }
 
+/*
+ * the st_data_boxed_def array is ordered as the FMADataType enumeration
+ */
 static const DataBoxedDef *
 get_data_boxed_def( guint type )
 {
 	static const gchar *thisfn = "fma_data_boxed_get_data_boxed_def";
-	int i;
 
-	for( i = 0 ; st_data_boxed_def[i].type ; ++i ){
-		if( st_data_boxed_def[i].type == type ){
-			return(( const DataBoxedDef * ) st_data_boxed_def+i );
-		}
+	if( type > 0 && type < FMA_DATA_TYPE_N && st_data_boxed_def[type-1].type == type ){
+		return(( const DataBoxedDef * ) st_data_boxed_def+type-1 );
 	}
 
 	g_warning( "%s: unmanaged data type=%d", thisfn, type );
@@ -410,7 +412,8 @@ fma_data_boxed_is_default( const FMADataBoxed *boxed )
 
 	if( !boxed->private->dispose_has_run ){
 
-		is_default = ( *boxed->private->boxed_def->is_default )( boxed );
+		is_default = ( *boxed->private->boxed_def->is_default )(
+				boxed->private->data_def, fma_boxed_peek_value( FMA_BOXED( boxed )));
 	}
 
 	return( is_default );
@@ -437,12 +440,85 @@ fma_data_boxed_is_valid( const FMADataBoxed *boxed )
 
 	if( !boxed->private->dispose_has_run ){
 
-		is_valid = ( *boxed->private->boxed_def->is_valid )( boxed );
+		is_valid = ( *boxed->private->boxed_def->is_valid )(
+				boxed->private->data_def, fma_boxed_peek_value( FMA_BOXED( boxed )));
 	}
 
 	return( is_valid );
 }
 
+/*
+ * fma_data_boxed_new_for_value:
+ * @def: the #FMADataDef definition structure for this boxed.
+ * @storage: the #FMABoxedValue which stores the data.
+ *
+ * Returns: a newly allocated #FMADataBoxed, which is a facade over
+ * @storage: the value stays owned by the caller, and is not released
+ * when the returned object is finalized.
+ */
+FMADataBoxed *
+fma_data_boxed_new_for_value( const FMADataDef *def, FMABoxedValue *storage )
+{
+	FMADataBoxed *boxed;
+
+	g_return_val_if_fail( def != NULL, NULL );
+	g_return_val_if_fail( storage != NULL, NULL );
+	g_return_val_if_fail( storage->type == def->type, NULL );
+
+	boxed = g_object_new( FMA_TYPE_DATA_BOXED, NULL );
+	fma_boxed_set_value_storage( FMA_BOXED( boxed ), storage );
+	boxed->private->data_def = def;
+	boxed->private->boxed_def = get_data_boxed_def( def->type );
+
+	return( boxed );
+}
+
+/*
+ * fma_data_boxed_value_is_default:
+ * @def: the #FMADataDef definition structure of the @value.
+ * @value: the #FMABoxedValue to be checked.
+ *
+ * Returns: %TRUE if the @value is the default of @def, %FALSE else.
+ */
+gboolean
+fma_data_boxed_value_is_default( const FMADataDef *def, const FMABoxedValue *value )
+{
+	const DataBoxedDef *fn;
+
+	g_return_val_if_fail( def != NULL, FALSE );
+	g_return_val_if_fail( value != NULL, FALSE );
+
+	fn = get_data_boxed_def( def->type );
+
+	g_return_val_if_fail( fn, FALSE );
+	g_return_val_if_fail( fn->is_default, FALSE );
+
+	return(( *fn->is_default )( def, value ));
+}
+
+/*
+ * fma_data_boxed_value_is_valid:
+ * @def: the #FMADataDef definition structure of the @value.
+ * @value: the #FMABoxedValue to be checked.
+ *
+ * Returns: %TRUE if the @value is valid, %FALSE else.
+ */
+gboolean
+fma_data_boxed_value_is_valid( const FMADataDef *def, const FMABoxedValue *value )
+{
+	const DataBoxedDef *fn;
+
+	g_return_val_if_fail( def != NULL, FALSE );
+	g_return_val_if_fail( value != NULL, FALSE );
+
+	fn = get_data_boxed_def( def->type );
+
+	g_return_val_if_fail( fn, FALSE );
+	g_return_val_if_fail( fn->is_valid, FALSE );
+
+	return(( *fn->is_valid )( def, value ));
+}
+
 #ifdef FMA_ENABLE_DEPRECATED
 /**
  * fma_data_boxed_dump:
@@ -587,21 +663,21 @@ bool_spec( const FMADataDef *def )
 }
 
 static gboolean
-bool_is_default( const FMADataBoxed *boxed )
+bool_is_default( const FMADataDef *def, const FMABoxedValue *boxed )
 {
 	gboolean is_default = FALSE;
 	gboolean default_value;
 
-	if( boxed->private->data_def->default_value && strlen( boxed->private->data_def->default_value )){
-		default_value = fma_core_utils_boolean_from_string( boxed->private->data_def->default_value );
-		is_default = ( default_value == fma_boxed_get_boolean( FMA_BOXED( boxed )));
+	if( def->default_value && strlen( def->default_value )){
+		default_value = fma_core_utils_boolean_from_string( def->default_value );
+		is_default = ( default_value == boxed->u.boolean);
 	}
 
 	return( is_default );
 }
 
 static gboolean
-bool_is_valid( const FMADataBoxed *boxed )
+bool_is_valid( const FMADataDef *def, const FMABoxedValue *boxed )
 {
 	return( TRUE );
 }
@@ -622,21 +698,21 @@ pointer_spec( const FMADataDef *def )
  *  default value for a pointer)
  */
 static gboolean
-pointer_is_default( const FMADataBoxed *boxed )
+pointer_is_default( const FMADataDef *def, const FMABoxedValue *boxed )
 {
 	return( FALSE );
 }
 
 static gboolean
-pointer_is_valid( const FMADataBoxed *boxed )
+pointer_is_valid( const FMADataDef *def, const FMABoxedValue *boxed )
 {
 	gboolean is_valid = TRUE;
 	gconstpointer pointer;
 
-	if( boxed->private->data_def->mandatory ){
-		pointer = fma_boxed_get_pointer( FMA_BOXED( boxed ));
+	if( def->mandatory ){
+		pointer = fma_boxed_value_get_pointer( boxed );
 		if( !pointer ){
-			g_debug( "fma_data_boxed_pointer_is_valid: invalid %s: mandatory but null", boxed->private->data_def->name );
+			g_debug( "fma_data_boxed_pointer_is_valid: invalid %s: mandatory but null", def->name );
 			is_valid = FALSE;
 		}
 	}
@@ -656,15 +732,15 @@ string_spec( const FMADataDef *def )
 }
 
 static gboolean
-string_is_default( const FMADataBoxed *boxed )
+string_is_default( const FMADataDef *def, const FMABoxedValue *boxed )
 {
 	gboolean is_default = FALSE;
-	gchar *value = fma_boxed_get_string( FMA_BOXED( boxed ));
+	gchar *value = fma_boxed_value_get_string( boxed );
 
-	if( boxed->private->data_def->default_value && strlen( boxed->private->data_def->default_value )){
+	if( def->default_value && strlen( def->default_value )){
 		if( value && strlen( value )){
 			/* default value is not null and string has something */
-			is_default = ( strcmp( value, boxed->private->data_def->default_value ) == 0 );
+			is_default = ( strcmp( value, def->default_value ) == 0 );
 
 		} else {
 			/* default value is not null, but string is null */
@@ -685,14 +761,14 @@ string_is_default( const FMADataBoxed *boxed )
 }
 
 static gboolean
-string_is_valid( const FMADataBoxed *boxed )
+string_is_valid( const FMADataDef *def, const FMABoxedValue *boxed )
 {
 	gboolean is_valid = TRUE;
 
-	if( boxed->private->data_def->mandatory ){
-		gchar *value = fma_boxed_get_string( FMA_BOXED( boxed ));
+	if( def->mandatory ){
+		gchar *value = fma_boxed_value_get_string( boxed );
 		if( !value || !strlen( value )){
-			g_debug( "fma_data_boxed_string_is_valid: invalid %s: mandatory but empty or null", boxed->private->data_def->name );
+			g_debug( "fma_data_boxed_string_is_valid: invalid %s: mandatory but empty or null", def->name );
 			is_valid = FALSE;
 		}
 		g_free( value );
@@ -712,14 +788,14 @@ string_list_spec( const FMADataDef *def )
 }
 
 static gboolean
-string_list_is_default( const FMADataBoxed *boxed )
+string_list_is_default( const FMADataDef *def, const FMABoxedValue *boxed )
 {
 	gboolean is_default = FALSE;
-	gchar *value = fma_boxed_get_string( FMA_BOXED( boxed ));
+	gchar *value = fma_boxed_value_get_string( boxed );
 
-	if( boxed->private->data_def->default_value && strlen( boxed->private->data_def->default_value )){
+	if( def->default_value && strlen( def->default_value )){
 		if( value && strlen( value )){
-			is_default = ( strcmp( value, boxed->private->data_def->default_value ) == 0 );
+			is_default = ( strcmp( value, def->default_value ) == 0 );
 		} else {
 			is_default = FALSE;
 		}
@@ -734,14 +810,14 @@ string_list_is_default( const FMADataBoxed *boxed )
 }
 
 static gboolean
-string_list_is_valid( const FMADataBoxed *boxed )
+string_list_is_valid( const FMADataDef *def, const FMABoxedValue *boxed )
 {
 	gboolean is_valid = TRUE;
 
-	if( boxed->private->data_def->mandatory ){
-		gchar *value = fma_boxed_get_string( FMA_BOXED( boxed ));
+	if( def->mandatory ){
+		gchar *value = fma_boxed_value_get_string( boxed );
 		if( !value || !strlen( value )){
-			g_debug( "fma_data_boxed_string_list_is_valid: invalid %s: mandatory but empty or null", boxed->private->data_def->name );
+			g_debug( "fma_data_boxed_string_list_is_valid: invalid %s: mandatory but empty or null", def->name );
 			is_valid = FALSE;
 		}
 	}
@@ -750,15 +826,15 @@ string_list_is_valid( const FMADataBoxed *boxed )
 }
 
 static gboolean
-locale_is_default( const FMADataBoxed *boxed )
+locale_is_default( const FMADataDef *def, const FMABoxedValue *boxed )
 {
 	gboolean is_default = FALSE;
-	gchar *value = fma_boxed_get_string( FMA_BOXED( boxed ));
+	gchar *value = fma_boxed_value_get_string( boxed );
 
-	if( boxed->private->data_def->default_value && g_utf8_strlen( boxed->private->data_def->default_value, -1 )){
+	if( def->default_value && g_utf8_strlen( def->default_value, -1 )){
 		if( value && strlen( value )){
 			/* default value is not null and string has something */
-			is_default = ( fma_core_utils_str_collate( value, boxed->private->data_def->default_value ) == 0 );
+			is_default = ( fma_core_utils_str_collate( value, def->default_value ) == 0 );
 
 		} else {
 			/* default value is not null, but string is null */
@@ -778,14 +854,14 @@ locale_is_default( const FMADataBoxed *boxed )
 }
 
 static gboolean
-locale_is_valid( const FMADataBoxed *boxed )
+locale_is_valid( const FMADataDef *def, const FMABoxedValue *boxed )
 {
 	gboolean is_valid = TRUE;
 
-	if( boxed->private->data_def->mandatory ){
-		gchar *value = fma_boxed_get_string( FMA_BOXED( boxed ));
+	if( def->mandatory ){
+		gchar *value = fma_boxed_value_get_string( boxed );
 		if( !value || !g_utf8_strlen( value, -1 )){
-			g_debug( "fma_data_boxed_locale_is_valid: invalid %s: mandatory but empty or null", boxed->private->data_def->name );
+			g_debug( "fma_data_boxed_locale_is_valid: invalid %s: mandatory but empty or null", def->name );
 			is_valid = FALSE;
 		}
 		g_free( value );
@@ -808,21 +884,21 @@ uint_spec( const FMADataDef *def )
 }
 
 static gboolean
-uint_is_default( const FMADataBoxed *boxed )
+uint_is_default( const FMADataDef *def, const FMABoxedValue *boxed )
 {
 	gboolean is_default = FALSE;
 	guint default_value;
 
-	if( boxed->private->data_def->default_value ){
-		default_value = atoi( boxed->private->data_def->default_value );
-		is_default = ( fma_boxed_get_uint( FMA_BOXED( boxed )) == default_value );
+	if( def->default_value ){
+		default_value = atoi( def->default_value );
+		is_default = ( boxed->u.uint == default_value );
 	}
 
 	return( is_default );
 }
 
 static gboolean
-uint_is_valid( const FMADataBoxed *boxed )
+uint_is_valid( const FMADataDef *def, const FMABoxedValue *boxed )
 {
 	return( TRUE );
 }
@@ -841,20 +917,20 @@ uint_list_spec( const FMADataDef *def )
  * we assume no default for uint list
  */
 static gboolean
-uint_list_is_default( const FMADataBoxed *boxed )
+uint_list_is_default( const FMADataDef *def, const FMABoxedValue *boxed )
 {
 	return( FALSE );
 }
 
 static gboolean
-uint_list_is_valid( const FMADataBoxed *boxed )
+uint_list_is_valid( const FMADataDef *def, const FMABoxedValue *boxed )
 {
 	gboolean is_valid = TRUE;
 
-	if( boxed->private->data_def->mandatory ){
-		gchar *value = fma_boxed_get_string( FMA_BOXED( boxed ));
+	if( def->mandatory ){
+		gchar *value = fma_boxed_value_get_string( boxed );
 		if( !value || !strlen( value )){
-			g_debug( "fma_data_boxed_uint_list_is_valid: invalid %s: mandatory but empty or null", boxed->private->data_def->name );
+			g_debug( "fma_data_boxed_uint_list_is_valid: invalid %s: mandatory but empty or null", def->name );
 			is_valid = FALSE;
 		}
 		g_free( value );
@@ -0,0 +1,394 @@
+/*
+ * FileManager-Actions
+ * A file-manager extension which offers configurable context menu actions.
+ *
+ * Copyright (C) 2005 The GNOME Foundation
+ * Copyright (C) 2006-2008 Frederic Ruaudel and others (see AUTHORS)
+ * Copyright (C) 2009-2015 Pierre Wieser and others (see AUTHORS)
+ *
+ * FileManager-Actions is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * FileManager-Actions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FileManager-Actions; see the file COPYING. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Authors:
+ *   Frederic Ruaudel <grumz@grumz.net>
+ *   Rodrigo Moya <rodrigo@gnome-db.org>
+ *   Pierre Wieser <pwieser@trychlos.org>
+ *   ... and many others (see AUTHORS)
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <gio/gio.h>
+#include <string.h>
+
+#include <api/fma-timeout.h>
+
+#include "fma-exec-cache.h"
+
+/* the results are stored as pointers, so that NULL means 'unknown'
+ */
+#define EXEC_NO							1
+#define EXEC_YES						2
+
+typedef struct {
+	GHashTable *results;				/* TryExec -> EXEC_NO/EXEC_YES */
+	GHashTable *monitors;				/* directory -> GFileMonitor */
+	gboolean    path_monitored;
+	guint       hits;
+	guint       resolutions;
+	guint       refreshes;
+}
+	sCache;
+
+static sCache    *st_cache   = NULL;
+static FMATimeout st_timeout = { 0 };
+
+static gint       st_burst_timeout     = 100;		/* burst timeout in msec */
+static gint       st_burst_max_latency = 1000;		/* max burst latency in msec */
+
+G_LOCK_DEFINE_STATIC( st_cache );
+
+static sCache  *cache_get( void );
+static void     cache_monitor_dir( sCache *cache, const gchar *dir );
+static void     cache_monitor_for( sCache *cache, const gchar *tryexec );
+static gboolean resolve( const gchar *tryexec );
+static void     on_dir_changed( GFileMonitor *monitor, GFile *file, GFile *other_file, GFileMonitorEvent event_type, void *empty );
+static void     on_dir_changed_timeout( void *empty );
+
+/*
+ * fma_exec_cache_add:
+ * @tryexec: the value of a TryExec key.
+ *
+ * Resolves @tryexec, records the result in the cache, and monitors the
+ * directories involved.
+ *
+ * This is the only function which queries the filesystem; it is
+ * expected to be called when the items are read.
+ *
+ * Returns: %TRUE if @tryexec is an installed program, %FALSE else.
+ */
+gboolean
+fma_exec_cache_add( const gchar *tryexec )
+{
+	gboolean ok;
+	sCache *cache;
+
+	g_return_val_if_fail( tryexec && strlen( tryexec ), FALSE );
+
+	ok = resolve( tryexec );
+
+	G_LOCK( st_cache );
+
+	cache = cache_get();
+	cache->resolutions += 1;
+
+	if( !g_hash_table_lookup( cache->results, tryexec )){
+		cache_monitor_for( cache, tryexec );
+	}
+	g_hash_table_insert( cache->results, g_strdup( tryexec ), GUINT_TO_POINTER( ok ? EXEC_YES : EXEC_NO ));
+
+	G_UNLOCK( st_cache );
+
+	return( ok );
+}
+
+/*
+ * fma_exec_cache_is_executable:
+ * @tryexec: the value of a TryExec key.
+ *
+ * Returns: %TRUE if @tryexec is an installed program, %FALSE else.
+ *
+ * If @tryexec has not been resolved yet, this is done now.
+ */
+gboolean
+fma_exec_cache_is_executable( const gchar *tryexec )
+{
+	gpointer found;
+
+	g_return_val_if_fail( tryexec && strlen( tryexec ), FALSE );
+
+	G_LOCK( st_cache );
+
+	found = st_cache ? g_hash_table_lookup( st_cache->results, tryexec ) : NULL;
+	if( found ){
+		st_cache->hits += 1;
+	}
+
+	G_UNLOCK( st_cache );
+
+	if( found ){
+		return( GPOINTER_TO_UINT( found ) == EXEC_YES );
+	}
+
+	return( fma_exec_cache_add( tryexec ));
+}
+
+/*
+ * fma_exec_cache_get_stats:
+ * @hits: [out]: the count of lookups answered by the cache.
+ * @resolutions: [out]: the count of resolutions of a new key.
+ * @refreshes: [out]: the count of times the known keys have been resolved
+ *  again after a directory has changed.
+ *
+ * Each of the output parameters may be %NULL.
+ */
+void
+fma_exec_cache_get_stats( guint *hits, guint *resolutions, guint *refreshes )
+{
+	G_LOCK( st_cache );
+
+	if( hits ){
+		*hits = st_cache ? st_cache->hits : 0;
+	}
+	if( resolutions ){
+		*resolutions = st_cache ? st_cache->resolutions : 0;
+	}
+	if( refreshes ){
+		*refreshes = st_cache ? st_cache->refreshes : 0;
+	}
+
+	G_UNLOCK( st_cache );
+}
+
+/*
+ * fma_exec_cache_dump:
+ *
+ * Dumps the statistics of the cache.
+ */
+void
+fma_exec_cache_dump( void )
+{
+	static const gchar *thisfn = "fma_exec_cache_dump";
+	guint hits, resolutions, refreshes;
+
+	fma_exec_cache_get_stats( &hits, &resolutions, &refreshes );
+
+	g_debug( "%s: entries=%u, monitors=%u, hits=%u, resolutions=%u, refreshes=%u",
+			thisfn,
+			st_cache ? g_hash_table_size( st_cache->results ) : 0,
+			st_cache ? g_hash_table_size( st_cache->monitors ) : 0,
+			hits, resolutions, refreshes );
+}
+
+/*
+ * fma_exec_cache_free:
+ *
+ * Releases the cache and its monitors.
+ */
+void
+fma_exec_cache_free( void )
+{
+	G_LOCK( st_cache );
+
+	if( st_cache ){
+		g_hash_table_destroy( st_cache->monitors );
+		g_hash_table_destroy( st_cache->results );
+		g_free( st_cache );
+		st_cache = NULL;
+	}
+
+	G_UNLOCK( st_cache );
+}
+
+/*
+ * st_cache is expected to be locked
+ */
+static sCache *
+cache_get( void )
+{
+	if( !st_cache ){
+		st_cache = g_new0( sCache, 1 );
+		st_cache->results = g_hash_table_new_full( g_str_hash, g_str_equal, g_free, NULL );
+		st_cache->monitors = g_hash_table_new_full( g_str_hash, g_str_equal, g_free, g_object_unref );
+
+		st_timeout.timeout = st_burst_timeout;
+		st_timeout.max_latency = st_burst_max_latency;
+		st_timeout.handler = ( FMATimeoutFunc ) on_dir_changed_timeout;
+		st_timeout.user_data = NULL;
+	}
+
+	return( st_cache );
+}
+
+/*
+ * a directory which does not exist yet may be created later: its nearest
+ * existing ancestor is then monitored instead, so that the creation of
+ * the missing directories is seen, and the keys are resolved again (see
+ * on_dir_changed_timeout())
+ */
+static void
+cache_monitor_dir( sCache *cache, const gchar *dir )
+{
+	static const gchar *thisfn = "fma_exec_cache_monitor_dir";
+	GFile *file;
+	GFileMonitor *monitor;
+	GError *error;
+	gchar *existing, *parent;
+
+	existing = g_strdup( dir );
+
+	while( !g_file_test( existing, G_FILE_TEST_IS_DIR )){
+		parent = g_path_get_dirname( existing );
+		if( !strcmp( parent, existing )){
+			g_free( parent );
+			g_free( existing );
+			return;
+		}
+		g_free( existing );
+		existing = parent;
+	}
+
+	if( !g_hash_table_lookup( cache->monitors, existing )){
+		error = NULL;
+		file = g_file_new_for_path( existing );
+		monitor = g_file_monitor_directory( file, G_FILE_MONITOR_NONE, NULL, &error );
+
+		if( error ){
+			g_debug( "%s: %s: %s", thisfn, existing, error->message );
+			g_error_free( error );
+
+		} else {
+			g_signal_connect( monitor, "changed", G_CALLBACK( on_dir_changed ), NULL );
+			g_hash_table_insert( cache->monitors, g_strdup( existing ), monitor );
+		}
+
+		g_object_unref( file );
+	}
+
+	g_free( existing );
+}
+
+/*
+ * a path is only looked for in its directory, while a bare program name
+ * may be found in any directory of $PATH
+ */
+static void
+cache_monitor_for( sCache *cache, const gchar *tryexec )
+{
+	const gchar *path;
+	gchar **dirs;
+	gchar *dir;
+	guint i;
+
+	if( strchr( tryexec, G_DIR_SEPARATOR )){
+		dir = g_path_get_dirname( tryexec );
+		cache_monitor_dir( cache, dir );
+		g_free( dir );
+
+	} else if( !cache->path_monitored ){
+		path = g_getenv( "PATH" );
+		if( path ){
+			dirs = g_strsplit( path, G_SEARCHPATH_SEPARATOR_S, -1 );
+			for( i = 0 ; dirs[i] ; ++i ){
+				if( strlen( dirs[i] )){
+					cache_monitor_dir( cache, dirs[i] );
+				}
+			}
+			g_strfreev( dirs );
+		}
+		cache->path_monitored = TRUE;
+	}
+}
+
+/*
+ * the Desktop Entry Specification says that a TryExec which is not an
+ * absolute path is looked up in $PATH
+ *
+ * a relative path (which is not a bare name) is still searched for
+ * relatively to the current directory, as it always has been
+ */
+static gboolean
+resolve( const gchar *tryexec )
+{
+	gchar *program;
+	gboolean ok;
+
+	if( strchr( tryexec, G_DIR_SEPARATOR )){
+		ok = g_file_test( tryexec, G_FILE_TEST_IS_EXECUTABLE );
+
+	} else {
+		program = g_find_program_in_path( tryexec );
+		ok = ( program != NULL );
+		g_free( program );
+	}
+
+	return( ok );
+}
+
+/*
+ * the content of a file does not change whether it is executable
+ */
+static void
+on_dir_changed( GFileMonitor *monitor, GFile *file, GFile *other_file, GFileMonitorEvent event_type, void *empty )
+{
+	if( event_type != G_FILE_MONITOR_EVENT_CHANGED &&
+		event_type != G_FILE_MONITOR_EVENT_CHANGES_DONE_HINT ){
+
+		fma_timeout_event( &st_timeout );
+	}
+}
+
+/*
+ * a burst of changes has ended: resolve again all the known keys
+ * the filesystem is queried without holding the lock
+ *
+ * the monitors are then set up again, as some of the missing directories
+ * may have been created, and have now to be monitored themselves
+ */
+static void
+on_dir_changed_timeout( void *empty )
+{
+	static const gchar *thisfn = "fma_exec_cache_on_dir_changed_timeout";
+	GList *keys, *it;
+	GSList *results, *ir;
+
+	keys = NULL;
+
+	G_LOCK( st_cache );
+
+	if( st_cache ){
+		for( it = g_hash_table_get_keys( st_cache->results ) ; it ; it = g_list_delete_link( it, it )){
+			keys = g_list_prepend( keys, g_strdup(( const gchar * ) it->data ));
+		}
+	}
+
+	G_UNLOCK( st_cache );
+
+	results = NULL;
+	for( it = keys ; it ; it = it->next ){
+		results = g_slist_prepend( results, GUINT_TO_POINTER( resolve(( const gchar * ) it->data ) ? EXEC_YES : EXEC_NO ));
+	}
+	results = g_slist_reverse( results );
+
+	G_LOCK( st_cache );
+
+	if( st_cache ){
+		st_cache->path_monitored = FALSE;
+		for( it = keys, ir = results ; it ; it = it->next, ir = ir->next ){
+			if( g_hash_table_lookup( st_cache->results, it->data )){
+				g_hash_table_insert( st_cache->results, g_strdup(( const gchar * ) it->data ), ir->data );
+				cache_monitor_for( st_cache, ( const gchar * ) it->data );
+			}
+		}
+		st_cache->refreshes += 1;
+		g_debug( "%s: %u keys resolved again", thisfn, g_list_length( keys ));
+	}
+
+	G_UNLOCK( st_cache );
+
+	g_slist_free( results );
+	g_list_free_full( keys, g_free );
+}
@@ -0,0 +1,62 @@
+/*
+ * FileManager-Actions
+ * A file-manager extension which offers configurable context menu actions.
+ *
+ * Copyright (C) 2005 The GNOME Foundation
+ * Copyright (C) 2006-2008 Frederic Ruaudel and others (see AUTHORS)
+ * Copyright (C) 2009-2015 Pierre Wieser and others (see AUTHORS)
+ *
+ * FileManager-Actions is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * FileManager-Actions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FileManager-Actions; see the file COPYING. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Authors:
+ *   Frederic Ruaudel <grumz@grumz.net>
+ *   Rodrigo Moya <rodrigo@gnome-db.org>
+ *   Pierre Wieser <pwieser@trychlos.org>
+ *   ... and many others (see AUTHORS)
+ */
+
+#ifndef __CORE_FMA_EXEC_CACHE_H__
+#define __CORE_FMA_EXEC_CACHE_H__
+
+/* @title: TryExec Cache
+ * @short_description: A cache of the resolution of the TryExec keys.
+ * @include: core/fma-exec-cache.h
+ *
+ * A TryExec condition is satisfied when the given program is installed,
+ * i.e. when the path is an executable file or, for a bare program name,
+ * when an executable file of this name is found in $PATH.
+ *
+ * The TryExec keys are resolved when the items are read, and the
+ * results are kept in a process-wide cache, so that building a menu
+ * does not have to query the filesystem. The directories involved in
+ * the resolutions are monitored, or their nearest existing ancestor
+ * when they do not exist yet: when one of them changes, all the known
+ * keys are resolved again.
+ */
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+gboolean fma_exec_cache_add          ( const gchar *tryexec );
+gboolean fma_exec_cache_is_executable( const gchar *tryexec );
+
+void     fma_exec_cache_get_stats    ( guint *hits, guint *resolutions, guint *refreshes );
+void     fma_exec_cache_dump         ( void );
+void     fma_exec_cache_free         ( void );
+
+G_END_DECLS
+
+#endif /* __CORE_FMA_EXEC_CACHE_H__ */
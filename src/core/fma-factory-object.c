@@ -42,6 +42,7 @@
 #include <api/fma-ifactory-provider.h>
 #include <api/fma-object-api.h>
 
+#include "fma-boxed-value.h"
 #include "fma-factory-object.h"
 #include "fma-factory-provider.h"
 
@@ -89,6 +90,96 @@ typedef struct {
 }
 	NafoDefaultIter;
 
+/* the FMADataDef index of a FMADataGroup list
+ * defs: the FMADataDef of each slot
+ * pos: the position of each slot in the values of the object, or
+ *  NAFO_NO_POS if the slot is not defined for this class
+ * count: the count of defined slots
+ */
+typedef struct {
+	FMADataDef *defs[FMAFO_N_SLOTS];
+	guint8      pos[FMAFO_N_SLOTS];
+	guint       count;
+}
+	NafoDefsIndex;
+
+#define NAFO_NO_POS						0xff
+
+/* the elementary data attached to an object, allocated in one block
+ * index: as returned by get_defs_index() for the class of the object
+ * facades: the FMADataBoxed's which have been asked for, allocated on
+ *  demand and indexed as the values
+ * values: one FMABoxedValue for each slot defined by the class, a zero
+ *  type meaning that the data is not set
+ */
+typedef struct {
+	const NafoDefsIndex *index;
+	FMADataBoxed       **facades;
+	FMABoxedValue        values[];
+}
+	NafoSlots;
+
+/* the name of each slot
+ */
+static const gchar *st_slot_names[FMAFO_N_SLOTS] = {
+	[FMAFO_SLOT_ID]                 = FMAFO_DATA_ID,
+	[FMAFO_SLOT_LABEL]              = FMAFO_DATA_LABEL,
+	[FMAFO_SLOT_PARENT]             = FMAFO_DATA_PARENT,
+	[FMAFO_SLOT_CONDITIONS]         = FMAFO_DATA_CONDITIONS,
+	[FMAFO_SLOT_IVERSION]           = FMAFO_DATA_IVERSION,
+	[FMAFO_SLOT_TYPE]               = FMAFO_DATA_TYPE,
+	[FMAFO_SLOT_TOOLTIP]            = FMAFO_DATA_TOOLTIP,
+	[FMAFO_SLOT_ICON]               = FMAFO_DATA_ICON,
+	[FMAFO_SLOT_ICON_NOLOC]         = FMAFO_DATA_ICON_NOLOC,
+	[FMAFO_SLOT_DESCRIPTION]        = FMAFO_DATA_DESCRIPTION,
+	[FMAFO_SLOT_SHORTCUT]           = FMAFO_DATA_SHORTCUT,
+	[FMAFO_SLOT_SUBITEMS]           = FMAFO_DATA_SUBITEMS,
+	[FMAFO_SLOT_SUBITEMS_SLIST]     = FMAFO_DATA_SUBITEMS_SLIST,
+	[FMAFO_SLOT_ENABLED]            = FMAFO_DATA_ENABLED,
+	[FMAFO_SLOT_READONLY]           = FMAFO_DATA_READONLY,
+	[FMAFO_SLOT_PROVIDER]           = FMAFO_DATA_PROVIDER,
+	[FMAFO_SLOT_PROVIDER_DATA]      = FMAFO_DATA_PROVIDER_DATA,
+	[FMAFO_SLOT_VERSION]            = FMAFO_DATA_VERSION,
+	[FMAFO_SLOT_TARGET_SELECTION]   = FMAFO_DATA_TARGET_SELECTION,
+	[FMAFO_SLOT_TARGET_LOCATION]    = FMAFO_DATA_TARGET_LOCATION,
+	[FMAFO_SLOT_TARGET_TOOLBAR]     = FMAFO_DATA_TARGET_TOOLBAR,
+	[FMAFO_SLOT_TOOLBAR_LABEL]      = FMAFO_DATA_TOOLBAR_LABEL,
+	[FMAFO_SLOT_TOOLBAR_SAME_LABEL] = FMAFO_DATA_TOOLBAR_SAME_LABEL,
+	[FMAFO_SLOT_LAST_ALLOCATED]     = FMAFO_DATA_LAST_ALLOCATED,
+	[FMAFO_SLOT_DESCNAME]           = FMAFO_DATA_DESCNAME,
+	[FMAFO_SLOT_DESCNAME_NOLOC]     = FMAFO_DATA_DESCNAME_NOLOC,
+	[FMAFO_SLOT_PATH]               = FMAFO_DATA_PATH,
+	[FMAFO_SLOT_PARAMETERS]         = FMAFO_DATA_PARAMETERS,
+	[FMAFO_SLOT_WORKING_DIR]        = FMAFO_DATA_WORKING_DIR,
+	[FMAFO_SLOT_EXECUTION_MODE]     = FMAFO_DATA_EXECUTION_MODE,
+	[FMAFO_SLOT_STARTUP_NOTIFY]     = FMAFO_DATA_STARTUP_NOTIFY,
+	[FMAFO_SLOT_STARTUP_WMCLASS]    = FMAFO_DATA_STARTUP_WMCLASS,
+	[FMAFO_SLOT_EXECUTE_AS]         = FMAFO_DATA_EXECUTE_AS,
+	[FMAFO_SLOT_BASENAMES]          = FMAFO_DATA_BASENAMES,
+	[FMAFO_SLOT_MATCHCASE]          = FMAFO_DATA_MATCHCASE,
+	[FMAFO_SLOT_MIMETYPES]          = FMAFO_DATA_MIMETYPES,
+	[FMAFO_SLOT_MIMETYPES_IS_ALL]   = FMAFO_DATA_MIMETYPES_IS_ALL,
+	[FMAFO_SLOT_ISFILE]             = FMAFO_DATA_ISFILE,
+	[FMAFO_SLOT_ISDIR]              = FMAFO_DATA_ISDIR,
+	[FMAFO_SLOT_MULTIPLE]           = FMAFO_DATA_MULTIPLE,
+	[FMAFO_SLOT_SCHEMES]            = FMAFO_DATA_SCHEMES,
+	[FMAFO_SLOT_FOLDERS]            = FMAFO_DATA_FOLDERS,
+	[FMAFO_SLOT_SELECTION_COUNT]    = FMAFO_DATA_SELECTION_COUNT,
+	[FMAFO_SLOT_ONLY_SHOW]          = FMAFO_DATA_ONLY_SHOW,
+	[FMAFO_SLOT_NOT_SHOW]           = FMAFO_DATA_NOT_SHOW,
+	[FMAFO_SLOT_TRY_EXEC]           = FMAFO_DATA_TRY_EXEC,
+	[FMAFO_SLOT_SHOW_IF_REGISTERED] = FMAFO_DATA_SHOW_IF_REGISTERED,
+	[FMAFO_SLOT_SHOW_IF_TRUE]       = FMAFO_DATA_SHOW_IF_TRUE,
+	[FMAFO_SLOT_SHOW_IF_RUNNING]    = FMAFO_DATA_SHOW_IF_RUNNING,
+	[FMAFO_SLOT_CAPABILITITES]      = FMAFO_DATA_CAPABILITITES,
+};
+
+/* the FMADataDef index of each FMADataGroup list, built on demand, and
+ * shared between the threads which may read items
+ */
+static GHashTable *st_defs_indexes = NULL;
+G_LOCK_DEFINE_STATIC( st_defs_indexes );
+
 extern gboolean                   ifactory_object_initialized;
 extern gboolean                   ifactory_object_finalized;
 
@@ -107,9 +198,16 @@ static void          v_read_done( FMAIFactoryObject *serializable, const FMAIFac
 static guint         v_write_start( FMAIFactoryObject *serializable, const FMAIFactoryProvider *reader, void *reader_data, GSList **messages );
 static guint         v_write_done( FMAIFactoryObject *serializable, const FMAIFactoryProvider *reader, void *reader_data, GSList **messages );
 
-static void          attach_boxed_to_object( FMAIFactoryObject *object, FMADataBoxed *boxed );
-static void          free_data_boxed_list( FMAIFactoryObject *object );
-static void          iter_on_data_defs( const FMADataGroup *idgroups, guint mode, FMADataDefIterFunc pfn, void *user_data );
+static GQuark               get_slots_quark( void );
+static GHashTable          *get_slots_names( void );
+static const NafoDefsIndex *get_defs_index( const FMADataGroup *groups );
+static NafoSlots           *get_slots( const FMAIFactoryObject *object, gboolean create );
+static FMABoxedValue       *get_value( const FMAIFactoryObject *object, const gchar *name, gboolean create );
+static FMADataBoxed        *get_facade( NafoSlots *slots, guint slot );
+static void                 release_facade( NafoSlots *slots, guint pos );
+static void                 free_data_boxed_list( FMAIFactoryObject *object );
+static void                 iter_on_data_defs( const FMADataGroup *idgroups, guint mode, FMADataDefIterFunc pfn, void *user_data );
+static void                 data_changed( FMAIFactoryObject *object, const gchar *name );
 
 /*
  * fma_factory_object_define_properties:
@@ -167,30 +265,65 @@ FMADataDef *
 fma_factory_object_get_data_def( const FMAIFactoryObject *object, const gchar *name )
 {
 	FMADataDef *def;
+	NafoSlots *slots;
+	guint slot;
 
 	g_return_val_if_fail( FMA_IS_IFACTORY_OBJECT( object ), NULL );
 
 	def = NULL;
+	slot = fma_factory_object_get_slot( name );
 
-	FMADataGroup *groups = v_get_groups( object );
-	while( groups->group ){
-
-		FMADataDef *def = groups->def;
-		if( def ){
-			while( def->name ){
-
-				if( !strcmp( def->name, name )){
-					return( def );
-				}
-				def++;
-			}
+	if( slot < FMAFO_N_SLOTS ){
+		slots = get_slots( object, TRUE );
+		if( slots->index ){
+			def = slots->index->defs[slot];
 		}
-		groups++;
 	}
 
 	return( def );
 }
 
+/*
+ * fma_factory_object_get_data_boxed:
+ * @object: this #FMAIFactoryObject object.
+ * @name: the searched name.
+ *
+ * Returns: the #FMADataBoxed attached to @object for this @name, or %NULL.
+ */
+FMADataBoxed *
+fma_factory_object_get_data_boxed( const FMAIFactoryObject *object, const gchar *name )
+{
+	NafoSlots *slots;
+	FMADataBoxed *boxed;
+
+	boxed = NULL;
+
+	if( get_value( object, name, FALSE )){
+		slots = get_slots( object, FALSE );
+		boxed = get_facade( slots, fma_factory_object_get_slot( name ));
+	}
+
+	return( boxed );
+}
+
+/*
+ * fma_factory_object_get_slot:
+ * @name: the name of an elementary data.
+ *
+ * Returns: the slot of this data, or FMAFO_N_SLOTS if @name is unknown.
+ */
+guint
+fma_factory_object_get_slot( const gchar *name )
+{
+	gpointer slot;
+
+	if( name && g_hash_table_lookup_extended( get_slots_names(), name, NULL, &slot )){
+		return( GPOINTER_TO_UINT( slot ));
+	}
+
+	return( FMAFO_N_SLOTS );
+}
+
 /*
  * fma_factory_object_get_data_groups:
  * @object: the #FMAIFactoryObject instance.
@@ -222,17 +355,35 @@ fma_factory_object_get_data_groups( const FMAIFactoryObject *object )
 void
 fma_factory_object_iter_on_boxed( const FMAIFactoryObject *object, FMAFactoryObjectIterBoxedFn pfn, void *user_data )
 {
-	GList *list, *ibox;
+	NafoSlots *slots;
+	FMADataBoxed *boxed;
 	gboolean stop;
+	guint i, pos;
 
 	g_return_if_fail( FMA_IS_IFACTORY_OBJECT( object ));
 
-	list = g_object_get_data( G_OBJECT( object ), FMA_IFACTORY_OBJECT_PROP_DATA );
-	/*g_debug( "list=%p (count=%u)", ( void * ) list, g_list_length( list ));*/
+	slots = get_slots( object, FALSE );
 	stop = FALSE;
 
-	for( ibox = list ; ibox && !stop ; ibox = ibox->next ){
-		stop = ( *pfn )( object, FMA_DATA_BOXED( ibox->data ), user_data );
+	for( i = 0 ; slots && slots->index && i < FMAFO_N_SLOTS && !stop ; ++i ){
+		pos = slots->index->pos[i];
+		if( pos != NAFO_NO_POS && slots->values[pos].type ){
+
+			/* do not keep a facade for each data of each iterated object,
+			 * but only use the one which may already exist
+			 */
+			if( slots->facades && slots->facades[pos] ){
+				stop = ( *pfn )( object, slots->facades[pos], user_data );
+
+			} else {
+				boxed = fma_data_boxed_new_for_value( slots->index->defs[i], &slots->values[pos] );
+				stop = ( *pfn )( object, boxed, user_data );
+				if( G_OBJECT( boxed )->ref_count > 1 ){
+					fma_boxed_set_value_storage( FMA_BOXED( boxed ), NULL );
+				}
+				g_object_unref( boxed );
+			}
+		}
 	}
 }
 
@@ -305,12 +456,15 @@ fma_factory_object_set_defaults( FMAIFactoryObject *object )
 static gboolean
 set_defaults_iter( FMADataDef *def, NafoDefaultIter *data )
 {
-	FMADataBoxed *boxed = fma_ifactory_object_get_data_boxed( data->object, def->name );
-
-	if( !boxed ){
-		boxed = fma_data_boxed_new( def );
-		attach_boxed_to_object( data->object, boxed );
-		fma_boxed_set_from_string( FMA_BOXED( boxed ), def->default_value );
+	FMABoxedValue *value;
+
+	if( !get_value( data->object, def->name, FALSE )){
+		value = get_value( data->object, def->name, TRUE );
+		if( value ){
+			fma_boxed_value_set_from_string( value, def->default_value );
+			fma_boxed_value_intern( value );
+			data_changed( data->object, def->name );
+		}
 	}
 
 	/* do not stop */
@@ -329,20 +483,43 @@ set_defaults_iter( FMADataDef *def, NafoDefaultIter *data )
 void
 fma_factory_object_move_boxed( FMAIFactoryObject *target, const FMAIFactoryObject *source, FMADataBoxed *boxed )
 {
+	NafoSlots *src_slots, *tgt_slots;
+	const FMADataDef *src_def;
+	FMABoxedValue *src_value, *tgt_value;
+	guint slot, src_pos, tgt_pos;
+
 	g_return_if_fail( FMA_IS_IFACTORY_OBJECT( target ));
 	g_return_if_fail( FMA_IS_IFACTORY_OBJECT( source ));
 
-	GList *src_list = g_object_get_data( G_OBJECT( source ), FMA_IFACTORY_OBJECT_PROP_DATA );
-
-	if( g_list_find( src_list, boxed )){
-		src_list = g_list_remove( src_list, boxed );
-		g_object_set_data( G_OBJECT( source ), FMA_IFACTORY_OBJECT_PROP_DATA, src_list );
-
-		attach_boxed_to_object( target, boxed );
+	src_def = fma_data_boxed_get_data_def( boxed );
+	slot = fma_factory_object_get_slot( src_def->name );
+	src_value = get_value( source, src_def->name, FALSE );
+	tgt_value = get_value( target, src_def->name, TRUE );
+
+	if( src_value && src_value == fma_boxed_peek_value( FMA_BOXED( boxed )) && tgt_value ){
+		src_slots = get_slots( source, FALSE );
+		tgt_slots = get_slots( target, FALSE );
+		src_pos = src_slots->index->pos[slot];
+		tgt_pos = tgt_slots->index->pos[slot];
+
+		release_facade( tgt_slots, tgt_pos );
+		fma_boxed_value_move( tgt_value, src_value );
+
+		/* the facade follows its value
+		 */
+		fma_boxed_set_value_storage( FMA_BOXED( boxed ), tgt_value );
+		fma_data_boxed_set_data_def( boxed, tgt_slots->index->defs[slot] );
+
+		if( src_slots->facades && src_slots->facades[src_pos] == boxed ){
+			src_slots->facades[src_pos] = NULL;
+			if( !tgt_slots->facades ){
+				tgt_slots->facades = g_new0( FMADataBoxed *, tgt_slots->index->count );
+			}
+			tgt_slots->facades[tgt_pos] = boxed;
+		}
 
-		const FMADataDef *src_def = fma_data_boxed_get_data_def( boxed );
-		FMADataDef *tgt_def = fma_factory_object_get_data_def( target, src_def->name );
-		fma_data_boxed_set_data_def( boxed, tgt_def );
+		data_changed( target, src_def->name );
+		data_changed(( FMAIFactoryObject * ) source, src_def->name );
 	}
 }
 
@@ -358,11 +535,10 @@ void
 fma_factory_object_copy( FMAIFactoryObject *target, const FMAIFactoryObject *source )
 {
 	static const gchar *thisfn = "fma_factory_object_copy";
-	GList *dest_list, *idest, *inext;
-	GList *src_list, *isrc;
-	FMADataBoxed *boxed;
+	NafoSlots *tgt_slots, *src_slots;
 	const FMADataDef *def;
 	void *provider, *provider_data;
+	guint i, tgt_pos, src_pos;
 
 	g_return_if_fail( FMA_IS_IFACTORY_OBJECT( target ));
 	g_return_if_fail( FMA_IS_IFACTORY_OBJECT( source ));
@@ -377,32 +553,33 @@ fma_factory_object_copy( FMAIFactoryObject *target, const FMAIFactoryObject *sou
 	provider = fma_object_get_provider( target );
 	provider_data = fma_object_get_provider_data( target );
 
-	idest = dest_list = g_object_get_data( G_OBJECT( target ), FMA_IFACTORY_OBJECT_PROP_DATA );
-	while( idest ){
-		boxed = FMA_DATA_BOXED( idest->data );
-		inext = idest->next;
-		def = fma_data_boxed_get_data_def( boxed );
-		if( def->copyable ){
-			dest_list = g_list_remove_link( dest_list, idest );
-			g_object_unref( idest->data );
+	tgt_slots = get_slots( target, TRUE );
+	if( !tgt_slots->index ){
+		return;
+	}
+
+	for( i = 0 ; i < FMAFO_N_SLOTS ; ++i ){
+		tgt_pos = tgt_slots->index->pos[i];
+		if( tgt_pos != NAFO_NO_POS && tgt_slots->values[tgt_pos].type ){
+			def = tgt_slots->index->defs[i];
+			if( def->copyable ){
+				release_facade( tgt_slots, tgt_pos );
+				fma_boxed_value_clear( &tgt_slots->values[tgt_pos] );
+			}
 		}
-		idest = inext;
 	}
-	g_object_set_data( G_OBJECT( target ), FMA_IFACTORY_OBJECT_PROP_DATA, dest_list );
 
 	/* only then copy copyable data from source
 	 */
-	src_list = g_object_get_data( G_OBJECT( source ), FMA_IFACTORY_OBJECT_PROP_DATA );
-	for( isrc = src_list ; isrc ; isrc = isrc->next ){
-		boxed = FMA_DATA_BOXED( isrc->data );
-		def = fma_data_boxed_get_data_def( boxed );
-		if( def->copyable ){
-			FMADataBoxed *tgt_boxed = fma_ifactory_object_get_data_boxed( target, def->name );
-			if( !tgt_boxed ){
-				tgt_boxed = fma_data_boxed_new( def );
-				attach_boxed_to_object( target, tgt_boxed );
+	src_slots = get_slots( source, FALSE );
+	for( i = 0 ; src_slots && src_slots->index && i < FMAFO_N_SLOTS ; ++i ){
+		src_pos = src_slots->index->pos[i];
+		tgt_pos = tgt_slots->index->pos[i];
+		if( src_pos != NAFO_NO_POS && src_slots->values[src_pos].type && tgt_pos != NAFO_NO_POS ){
+			def = src_slots->index->defs[i];
+			if( def->copyable ){
+				fma_boxed_value_copy( &tgt_slots->values[tgt_pos], &src_slots->values[src_pos] );
 			}
-			fma_boxed_set_from_boxed( FMA_BOXED( tgt_boxed ), FMA_BOXED( boxed ));
 		}
 	}
 
@@ -428,46 +605,67 @@ fma_factory_object_are_equal( const FMAIFactoryObject *a, const FMAIFactoryObjec
 {
 	static const gchar *thisfn = "fma_factory_object_are_equal";
 	gboolean are_equal;
-	GList *a_list, *b_list, *ia, *ib;
+	NafoSlots *a_slots, *b_slots;
+	const FMABoxedValue *a_value, *b_value;
+	const FMADataDef *def;
+	guint i;
 
 	are_equal = FALSE;
 
-	a_list = g_object_get_data( G_OBJECT( a ), FMA_IFACTORY_OBJECT_PROP_DATA );
-	b_list = g_object_get_data( G_OBJECT( b ), FMA_IFACTORY_OBJECT_PROP_DATA );
+	a_slots = get_slots( a, FALSE );
+	b_slots = get_slots( b, FALSE );
 
 	g_debug( "%s: a=%p, b=%p", thisfn, ( void * ) a, ( void * ) b );
 
 	are_equal = TRUE;
-	for( ia = a_list ; ia && are_equal ; ia = ia->next ){
+	for( i = 0 ; a_slots && a_slots->index && i < FMAFO_N_SLOTS && are_equal ; ++i ){
 
-		FMADataBoxed *a_boxed = FMA_DATA_BOXED( ia->data );
-		const FMADataDef *a_def = fma_data_boxed_get_data_def( a_boxed );
-		if( a_def->comparable ){
+		if( a_slots->index->pos[i] == NAFO_NO_POS ){
+			continue;
+		}
+		a_value = &a_slots->values[a_slots->index->pos[i]];
+		if( !a_value->type ){
+			continue;
+		}
+		def = a_slots->index->defs[i];
+		if( def->comparable ){
 
-			FMADataBoxed *b_boxed = fma_ifactory_object_get_data_boxed( b, a_def->name );
-			if( b_boxed ){
-				are_equal = fma_boxed_are_equal( FMA_BOXED( a_boxed ), FMA_BOXED( b_boxed ));
+			b_value = NULL;
+			if( b_slots && b_slots->index && b_slots->index->pos[i] != NAFO_NO_POS ){
+				b_value = &b_slots->values[b_slots->index->pos[i]];
+			}
+			if( b_value && b_value->type ){
+				are_equal = fma_boxed_value_are_equal( a_value, b_value );
 				if( !are_equal ){
-					g_debug( "%s: %s not equal as %s different", thisfn, G_OBJECT_TYPE_NAME( a ), a_def->name );
+					g_debug( "%s: %s not equal as %s different", thisfn, G_OBJECT_TYPE_NAME( a ), def->name );
 				}
 
 			} else {
 				are_equal = FALSE;
-				g_debug( "%s: %s not equal as %s has disappeared", thisfn, G_OBJECT_TYPE_NAME( a ), a_def->name );
+				g_debug( "%s: %s not equal as %s has disappeared", thisfn, G_OBJECT_TYPE_NAME( a ), def->name );
 			}
 		}
 	}
 
-	for( ib = b_list ; ib && are_equal ; ib = ib->next ){
+	for( i = 0 ; b_slots && b_slots->index && i < FMAFO_N_SLOTS && are_equal ; ++i ){
 
-		FMADataBoxed *b_boxed = FMA_DATA_BOXED( ib->data );
-		const FMADataDef *b_def = fma_data_boxed_get_data_def( b_boxed );
-		if( b_def->comparable ){
+		if( b_slots->index->pos[i] == NAFO_NO_POS ){
+			continue;
+		}
+		b_value = &b_slots->values[b_slots->index->pos[i]];
+		if( !b_value->type ){
+			continue;
+		}
+		def = b_slots->index->defs[i];
+		if( def->comparable ){
 
-			FMADataBoxed *a_boxed = fma_ifactory_object_get_data_boxed( a, b_def->name );
-			if( !a_boxed ){
+			a_value = NULL;
+			if( a_slots && a_slots->index && a_slots->index->pos[i] != NAFO_NO_POS ){
+				a_value = &a_slots->values[a_slots->index->pos[i]];
+			}
+			if( !a_value || !a_value->type ){
 				are_equal = FALSE;
-				g_debug( "%s: %s not equal as %s was not set", thisfn, G_OBJECT_TYPE_NAME( a ), b_def->name );
+				g_debug( "%s: %s not equal as %s was not set", thisfn, G_OBJECT_TYPE_NAME( a ), def->name );
 			}
 		}
 	}
@@ -489,13 +687,14 @@ fma_factory_object_is_valid( const FMAIFactoryObject *object )
 	static const gchar *thisfn = "fma_factory_object_is_valid";
 	gboolean is_valid;
 	FMADataGroup *groups;
-	GList *list, *iv;
+	NafoSlots *slots;
+	guint i, pos;
 
 	g_return_val_if_fail( FMA_IS_IFACTORY_OBJECT( object ), FALSE );
 
 	g_debug( "%s: object=%p (%s)", thisfn, ( void * ) object, G_OBJECT_TYPE_NAME( object ));
 
-	list = g_object_get_data( G_OBJECT( object ), FMA_IFACTORY_OBJECT_PROP_DATA );
+	slots = get_slots( object, FALSE );
 	is_valid = TRUE;
 
 	/* mandatory data must be set
@@ -510,8 +709,11 @@ fma_factory_object_is_valid( const FMAIFactoryObject *object )
 	}
 	is_valid = iter_data.is_valid;
 
-	for( iv = list ; iv && is_valid ; iv = iv->next ){
-		is_valid = fma_data_boxed_is_valid( FMA_DATA_BOXED( iv->data ));
+	for( i = 0 ; slots && slots->index && i < FMAFO_N_SLOTS && is_valid ; ++i ){
+		pos = slots->index->pos[i];
+		if( pos != NAFO_NO_POS && slots->values[pos].type ){
+			is_valid = fma_data_boxed_value_is_valid( slots->index->defs[i], &slots->values[pos] );
+		}
 	}
 
 	is_valid &= v_is_valid( object );
@@ -522,11 +724,8 @@ fma_factory_object_is_valid( const FMAIFactoryObject *object )
 static gboolean
 is_valid_mandatory_iter( const FMADataDef *def, NafoValidIter *data )
 {
-	FMADataBoxed *boxed;
-
 	if( def->mandatory ){
-		boxed = fma_ifactory_object_get_data_boxed( data->object, def->name );
-		if( !boxed ){
+		if( !get_value( data->object, def->name, FALSE )){
 			g_debug( "fma_factory_object_is_valid_mandatory_iter: invalid %s: mandatory but not set", def->name );
 			data->is_valid = FALSE;
 		}
@@ -547,27 +746,36 @@ fma_factory_object_dump( const FMAIFactoryObject *object )
 {
 	static const gchar *thisfn = "fma_factory_object_dump";
 	static const gchar *prefix = "factory-data-";
-	GList *list, *it;
+	NafoSlots *slots;
 	guint length;
 	guint l_prefix;
+	guint i, pos;
 
 	length = 0;
 	l_prefix = strlen( prefix );
-	list = g_object_get_data( G_OBJECT( object ), FMA_IFACTORY_OBJECT_PROP_DATA );
+	slots = get_slots( object, FALSE );
+
+	if( !slots || !slots->index ){
+		return;
+	}
 
-	for( it = list ; it ; it = it->next ){
-		FMADataBoxed *boxed = FMA_DATA_BOXED( it->data );
-		const FMADataDef *def = fma_data_boxed_get_data_def( boxed );
-		length = MAX( length, strlen( def->name ));
+	for( i = 0 ; i < FMAFO_N_SLOTS ; ++i ){
+		pos = slots->index->pos[i];
+		if( pos != NAFO_NO_POS && slots->values[pos].type ){
+			length = MAX( length, strlen( slots->index->defs[i]->name ));
+		}
 	}
 
 	length -= l_prefix;
 	length += 1;
 
-	for( it = list ; it ; it = it->next ){
-		FMADataBoxed *boxed = FMA_DATA_BOXED( it->data );
-		const FMADataDef *def = fma_data_boxed_get_data_def( boxed );
-		gchar *value = fma_boxed_get_string( FMA_BOXED( boxed ));
+	for( i = 0 ; i < FMAFO_N_SLOTS ; ++i ){
+		pos = slots->index->pos[i];
+		if( pos == NAFO_NO_POS || !slots->values[pos].type ){
+			continue;
+		}
+		const FMADataDef *def = slots->index->defs[i];
+		gchar *value = fma_boxed_value_get_string( &slots->values[pos] );
 		g_debug( "| %s: %*s=%s", thisfn, length, def->name+l_prefix, value );
 		g_free( value );
 	}
@@ -626,25 +834,29 @@ fma_factory_object_read_item( FMAIFactoryObject *object, const FMAIFactoryProvid
 	}
 }
 
+/*
+ * the value read by the provider is moved to the storage of the object,
+ * so that the provider FMADataBoxed may be released without any copy;
+ * it is then interned, as most profiles share the same conditions
+ */
 static gboolean
 read_data_iter( FMADataDef *def, NafoReadIter *iter )
 {
 	gboolean stop;
+	FMABoxedValue *value;
 
 	stop = FALSE;
 
 	FMADataBoxed *boxed = fma_factory_provider_read_data( iter->reader, iter->reader_data, iter->object, def, iter->messages );
 
 	if( boxed ){
-		FMADataBoxed *exist = fma_ifactory_object_get_data_boxed( iter->object, def->name );
-
-		if( exist ){
-			fma_boxed_set_from_boxed( FMA_BOXED( exist ), FMA_BOXED( boxed ));
-			g_object_unref( boxed );
-
-		} else {
-			attach_boxed_to_object( iter->object, boxed );
+		value = get_value( iter->object, def->name, TRUE );
+		if( value ){
+			fma_boxed_value_move( value, fma_boxed_peek_value( FMA_BOXED( boxed )));
+			fma_boxed_value_intern( value );
+			data_changed( iter->object, def->name );
 		}
+		g_object_unref( boxed );
 	}
 
 	return( stop );
@@ -735,15 +947,15 @@ write_data_iter( const FMAIFactoryObject *object, FMADataBoxed *boxed, NafoWrite
 void
 fma_factory_object_get_as_value( const FMAIFactoryObject *object, const gchar *name, GValue *value )
 {
-	FMADataBoxed *boxed;
+	const FMABoxedValue *boxed;
 
 	g_return_if_fail( FMA_IS_IFACTORY_OBJECT( object ));
 
 	g_value_unset( value );
 
-	boxed = fma_ifactory_object_get_data_boxed( object, name );
+	boxed = get_value( object, name, FALSE );
 	if( boxed ){
-		fma_boxed_get_as_value( FMA_BOXED( boxed ), value );
+		fma_boxed_value_get_as_value( boxed, value );
 	}
 }
 
@@ -763,15 +975,43 @@ void *
 fma_factory_object_get_as_void( const FMAIFactoryObject *object, const gchar *name )
 {
 	void *value;
-	FMADataBoxed *boxed;
+	const FMABoxedValue *boxed;
 
 	g_return_val_if_fail( FMA_IS_IFACTORY_OBJECT( object ), NULL );
 
 	value = NULL;
 
-	boxed = fma_ifactory_object_get_data_boxed( object, name );
+	boxed = get_value( object, name, FALSE );
 	if( boxed ){
-		value = fma_boxed_get_as_void( FMA_BOXED( boxed ));
+		value = fma_boxed_value_get_as_void( boxed );
+	}
+
+	return( value );
+}
+
+/*
+ * fma_factory_object_peek:
+ * @object: this #FMAIFactoryObject instance.
+ * @name: the elementary data whose value is to be got.
+ *
+ * Returns: the value stored in the #FMADataBoxed, without any copy, or %NULL.
+ *
+ * The returned value is owned by @object, and is only valid until this
+ * same elementary data be set again.
+ */
+gconstpointer
+fma_factory_object_peek( const FMAIFactoryObject *object, const gchar *name )
+{
+	gconstpointer value;
+	const FMABoxedValue *boxed;
+
+	g_return_val_if_fail( FMA_IS_IFACTORY_OBJECT( object ), NULL );
+
+	value = NULL;
+
+	boxed = get_value( object, name, FALSE );
+	if( boxed ){
+		value = fma_boxed_value_get_pointer( boxed );
 	}
 
 	return( value );
@@ -787,13 +1027,9 @@ fma_factory_object_get_as_void( const FMAIFactoryObject *object, const gchar *na
 gboolean
 fma_factory_object_is_set( const FMAIFactoryObject *object, const gchar *name )
 {
-	FMADataBoxed *boxed;
-
 	g_return_val_if_fail( FMA_IS_IFACTORY_OBJECT( object ), FALSE );
 
-	boxed = fma_ifactory_object_get_data_boxed( object, name );
-
-	return( boxed != NULL );
+	return( get_value( object, name, FALSE ) != NULL );
 }
 
 /*
@@ -809,24 +1045,19 @@ void
 fma_factory_object_set_from_value( FMAIFactoryObject *object, const gchar *name, const GValue *value )
 {
 	static const gchar *thisfn = "fma_factory_object_set_from_value";
+	FMABoxedValue *boxed;
 
 	g_return_if_fail( FMA_IS_IFACTORY_OBJECT( object ));
 
-	FMADataBoxed *boxed = fma_ifactory_object_get_data_boxed( object, name );
+	boxed = get_value( object, name, TRUE );
 	if( boxed ){
-		fma_boxed_set_from_value( FMA_BOXED( boxed ), value );
+		fma_boxed_value_set_from_value( boxed, value );
 
 	} else {
-		FMADataDef *def = fma_factory_object_get_data_def( object, name );
-		if( !def ){
-			g_warning( "%s: unknown FMADataDef %s", thisfn, name );
-
-		} else {
-			boxed = fma_data_boxed_new( def );
-			fma_boxed_set_from_value( FMA_BOXED( boxed ), value );
-			attach_boxed_to_object( object, boxed );
-		}
+		g_warning( "%s: unknown FMADataDef %s", thisfn, name );
 	}
+
+	data_changed( object, name );
 }
 
 /*
@@ -841,24 +1072,19 @@ void
 fma_factory_object_set_from_void( FMAIFactoryObject *object, const gchar *name, const void *data )
 {
 	static const gchar *thisfn = "fma_factory_object_set_from_void";
+	FMABoxedValue *boxed;
 
 	g_return_if_fail( FMA_IS_IFACTORY_OBJECT( object ));
 
-	FMADataBoxed *boxed = fma_ifactory_object_get_data_boxed( object, name );
+	boxed = get_value( object, name, TRUE );
 	if( boxed ){
-		fma_boxed_set_from_void( FMA_BOXED( boxed ), data );
+		fma_boxed_value_set_from_void( boxed, data );
 
 	} else {
-		FMADataDef *def = fma_factory_object_get_data_def( object, name );
-		if( !def ){
-			g_warning( "%s: unknown FMADataDef %s for %s", thisfn, name, G_OBJECT_TYPE_NAME( object ));
-
-		} else {
-			boxed = fma_data_boxed_new( def );
-			fma_boxed_set_from_void( FMA_BOXED( boxed ), data );
-			attach_boxed_to_object( object, boxed );
-		}
+		g_warning( "%s: unknown FMADataDef %s for %s", thisfn, name, G_OBJECT_TYPE_NAME( object ));
 	}
+
+	data_changed( object, name );
 }
 
 static FMADataGroup *
@@ -939,25 +1165,204 @@ v_write_done( FMAIFactoryObject *serializable, const FMAIFactoryProvider *writer
 	return( code );
 }
 
+static GQuark
+get_slots_quark( void )
+{
+	static gsize quark = 0;
+
+	if( g_once_init_enter( &quark )){
+		g_once_init_leave( &quark, g_quark_from_static_string( FMA_IFACTORY_OBJECT_PROP_DATA ));
+	}
+
+	return(( GQuark ) quark );
+}
+
+/*
+ * the name -> slot hash table, built once from the static list of names
+ */
+static GHashTable *
+get_slots_names( void )
+{
+	static const gchar *thisfn = "fma_factory_object_get_slots_names";
+	static gsize initialized = 0;
+	static GHashTable *names = NULL;
+	guint i;
+
+	if( g_once_init_enter( &initialized )){
+		names = g_hash_table_new( g_str_hash, g_str_equal );
+		for( i = 0 ; i < FMAFO_N_SLOTS ; ++i ){
+			if( st_slot_names[i] ){
+				g_hash_table_insert( names, ( gpointer ) st_slot_names[i], GUINT_TO_POINTER( i ));
+			} else {
+				g_warning( "%s: slot %u doesn't have any name", thisfn, i );
+			}
+		}
+		g_once_init_leave( &initialized, 1 );
+	}
+
+	return( names );
+}
+
+/*
+ * returns the slot -> FMADataDef index for these groups, the first
+ * definition of a name being the one used, as when walking the groups
+ */
+static const NafoDefsIndex *
+get_defs_index( const FMADataGroup *groups )
+{
+	static const gchar *thisfn = "fma_factory_object_get_defs_index";
+	NafoDefsIndex *index;
+	FMADataDef *def;
+	guint slot;
+
+	G_LOCK( st_defs_indexes );
+
+	if( !st_defs_indexes ){
+		st_defs_indexes = g_hash_table_new( g_direct_hash, g_direct_equal );
+	}
+
+	index = g_hash_table_lookup( st_defs_indexes, groups );
+
+	if( !index ){
+		index = g_new0( NafoDefsIndex, 1 );
+		memset( index->pos, NAFO_NO_POS, sizeof( index->pos ));
+
+		for( ; groups->group ; groups++ ){
+			for( def = groups->def ; def && def->name ; def++ ){
+				slot = fma_factory_object_get_slot( def->name );
+				if( slot == FMAFO_N_SLOTS ){
+					g_warning( "%s: %s: unknown data name", thisfn, def->name );
+				} else if( !index->defs[slot] ){
+					index->defs[slot] = def;
+					index->pos[slot] = index->count++;
+				}
+			}
+		}
+
+		g_hash_table_insert( st_defs_indexes, ( gpointer ) groups, index );
+	}
+
+	G_UNLOCK( st_defs_indexes );
+
+	return( index );
+}
+
+/*
+ * returns the slots of the object, allocating them if asked for
+ */
+static NafoSlots *
+get_slots( const FMAIFactoryObject *object, gboolean create )
+{
+	NafoSlots *slots;
+	FMADataGroup *groups;
+	const NafoDefsIndex *index;
+
+	slots = g_object_get_qdata( G_OBJECT( object ), get_slots_quark());
+
+	if( !slots && create ){
+		groups = v_get_groups( object );
+		index = groups ? get_defs_index( groups ) : NULL;
+		slots = g_malloc0( sizeof( NafoSlots ) + ( index ? index->count : 0 ) * sizeof( FMABoxedValue ));
+		slots->index = index;
+		g_object_set_qdata( G_OBJECT( object ), get_slots_quark(), slots );
+	}
+
+	return( slots );
+}
+
+/*
+ * returns the storage of the named data, or %NULL if it is not set
+ *
+ * when asked for creation, the storage of a data defined for the class
+ * of the object is always returned, initialized as unset if needed
+ */
+static FMABoxedValue *
+get_value( const FMAIFactoryObject *object, const gchar *name, gboolean create )
+{
+	NafoSlots *slots;
+	FMABoxedValue *value;
+	guint slot, pos;
+
+	value = NULL;
+	slot = fma_factory_object_get_slot( name );
+	slots = get_slots( object, create );
+
+	if( slots && slots->index && slot < FMAFO_N_SLOTS ){
+		pos = slots->index->pos[slot];
+		if( pos != NAFO_NO_POS ){
+			value = &slots->values[pos];
+			if( !value->type ){
+				if( create ){
+					fma_boxed_value_init( value, slots->index->defs[slot]->type );
+				} else {
+					value = NULL;
+				}
+			}
+		}
+	}
+
+	return( value );
+}
+
+/*
+ * returns the FMADataBoxed facade of the set value of this slot,
+ * allocating it if needed; it is owned by the object
+ */
+static FMADataBoxed *
+get_facade( NafoSlots *slots, guint slot )
+{
+	guint pos;
+
+	pos = slots->index->pos[slot];
+
+	if( !slots->facades ){
+		slots->facades = g_new0( FMADataBoxed *, slots->index->count );
+	}
+
+	if( !slots->facades[pos] ){
+		slots->facades[pos] = fma_data_boxed_new_for_value( slots->index->defs[slot], &slots->values[pos] );
+	}
+
+	return( slots->facades[pos] );
+}
+
+/*
+ * releases the facade of the value at this position, before the value
+ * itself be cleared; a facade still referenced elsewhere keeps a copy
+ * of the value
+ */
 static void
-attach_boxed_to_object( FMAIFactoryObject *object, FMADataBoxed *boxed )
+release_facade( NafoSlots *slots, guint pos )
 {
-	GList *list = g_object_get_data( G_OBJECT( object ), FMA_IFACTORY_OBJECT_PROP_DATA );
-	list = g_list_prepend( list, boxed );
-	g_object_set_data( G_OBJECT( object ), FMA_IFACTORY_OBJECT_PROP_DATA, list );
+	FMADataBoxed *boxed;
+
+	if( slots->facades && slots->facades[pos] ){
+		boxed = slots->facades[pos];
+		slots->facades[pos] = NULL;
+		if( G_OBJECT( boxed )->ref_count > 1 ){
+			fma_boxed_set_value_storage( FMA_BOXED( boxed ), NULL );
+		}
+		g_object_unref( boxed );
+	}
 }
 
 static void
 free_data_boxed_list( FMAIFactoryObject *object )
 {
-	GList *list;
-
-	list = g_object_get_data( G_OBJECT( object ), FMA_IFACTORY_OBJECT_PROP_DATA );
+	NafoSlots *slots;
+	guint i;
 
-	g_list_foreach( list, ( GFunc ) g_object_unref, NULL );
-	g_list_free( list );
+	slots = get_slots( object, FALSE );
 
-	g_object_set_data( G_OBJECT( object ), FMA_IFACTORY_OBJECT_PROP_DATA, NULL );
+	if( slots ){
+		for( i = 0 ; slots->index && i < slots->index->count ; ++i ){
+			release_facade( slots, i );
+			fma_boxed_value_clear( &slots->values[i] );
+		}
+		g_free( slots->facades );
+		g_free( slots );
+		g_object_set_qdata( G_OBJECT( object ), get_slots_quark(), NULL );
+	}
 }
 
 /*
@@ -1016,3 +1421,15 @@ iter_on_data_defs( const FMADataGroup *groups, guint mode, FMADataDefIterFunc pf
 		groups++;
 	}
 }
+
+/*
+ * all the paths which modify the elementary data of an object end up
+ * here, so that the data derived from them may be invalidated
+ */
+static void
+data_changed( FMAIFactoryObject *object, const gchar *name )
+{
+	if( FMA_IS_ICONTEXT( object )){
+		fma_icontext_data_changed( FMA_ICONTEXT( object ), name );
+	}
+}
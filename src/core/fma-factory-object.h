@@ -46,8 +46,68 @@ typedef gboolean ( *FMAFactoryObjectIterBoxedFn )( const FMAIFactoryObject *obje
 
 #define FMA_IFACTORY_OBJECT_PROP_DATA			"fma-ifactory-object-prop-data"
 
+/* the compile-time ordinal of each elementary data, in the order of
+ * api/fma-ifactory-object-data.h, which is used as an index in the
+ * array of the FMADataBoxed attached to an object
+ */
+enum {
+	FMAFO_SLOT_ID = 0,
+	FMAFO_SLOT_LABEL,
+	FMAFO_SLOT_PARENT,
+	FMAFO_SLOT_CONDITIONS,
+	FMAFO_SLOT_IVERSION,
+	FMAFO_SLOT_TYPE,
+	FMAFO_SLOT_TOOLTIP,
+	FMAFO_SLOT_ICON,
+	FMAFO_SLOT_ICON_NOLOC,
+	FMAFO_SLOT_DESCRIPTION,
+	FMAFO_SLOT_SHORTCUT,
+	FMAFO_SLOT_SUBITEMS,
+	FMAFO_SLOT_SUBITEMS_SLIST,
+	FMAFO_SLOT_ENABLED,
+	FMAFO_SLOT_READONLY,
+	FMAFO_SLOT_PROVIDER,
+	FMAFO_SLOT_PROVIDER_DATA,
+	FMAFO_SLOT_VERSION,
+	FMAFO_SLOT_TARGET_SELECTION,
+	FMAFO_SLOT_TARGET_LOCATION,
+	FMAFO_SLOT_TARGET_TOOLBAR,
+	FMAFO_SLOT_TOOLBAR_LABEL,
+	FMAFO_SLOT_TOOLBAR_SAME_LABEL,
+	FMAFO_SLOT_LAST_ALLOCATED,
+	FMAFO_SLOT_DESCNAME,
+	FMAFO_SLOT_DESCNAME_NOLOC,
+	FMAFO_SLOT_PATH,
+	FMAFO_SLOT_PARAMETERS,
+	FMAFO_SLOT_WORKING_DIR,
+	FMAFO_SLOT_EXECUTION_MODE,
+	FMAFO_SLOT_STARTUP_NOTIFY,
+	FMAFO_SLOT_STARTUP_WMCLASS,
+	FMAFO_SLOT_EXECUTE_AS,
+	FMAFO_SLOT_BASENAMES,
+	FMAFO_SLOT_MATCHCASE,
+	FMAFO_SLOT_MIMETYPES,
+	FMAFO_SLOT_MIMETYPES_IS_ALL,
+	FMAFO_SLOT_ISFILE,
+	FMAFO_SLOT_ISDIR,
+	FMAFO_SLOT_MULTIPLE,
+	FMAFO_SLOT_SCHEMES,
+	FMAFO_SLOT_FOLDERS,
+	FMAFO_SLOT_SELECTION_COUNT,
+	FMAFO_SLOT_ONLY_SHOW,
+	FMAFO_SLOT_NOT_SHOW,
+	FMAFO_SLOT_TRY_EXEC,
+	FMAFO_SLOT_SHOW_IF_REGISTERED,
+	FMAFO_SLOT_SHOW_IF_TRUE,
+	FMAFO_SLOT_SHOW_IF_RUNNING,
+	FMAFO_SLOT_CAPABILITITES,
+	FMAFO_N_SLOTS
+};
+
 void          fma_factory_object_define_properties( GObjectClass *class, const FMADataGroup *groups );
 FMADataDef   *fma_factory_object_get_data_def     ( const FMAIFactoryObject *object, const gchar *name );
+FMADataBoxed *fma_factory_object_get_data_boxed   ( const FMAIFactoryObject *object, const gchar *name );
+guint         fma_factory_object_get_slot         ( const gchar *name );
 FMADataGroup *fma_factory_object_get_data_groups  ( const FMAIFactoryObject *object );
 void          fma_factory_object_iter_on_boxed    ( const FMAIFactoryObject *object, FMAFactoryObjectIterBoxedFn pfn, void *user_data );
 
@@ -66,6 +126,7 @@ void          fma_factory_object_read_item        ( FMAIFactoryObject *object, c
 guint         fma_factory_object_write_item       ( FMAIFactoryObject *object, const FMAIFactoryProvider *writer, void *writer_data, GSList **messages );
 
 void         *fma_factory_object_get_as_void      ( const FMAIFactoryObject *object, const gchar *name );
+gconstpointer fma_factory_object_peek             ( const FMAIFactoryObject *object, const gchar *name );
 void          fma_factory_object_get_as_value     ( const FMAIFactoryObject *object, const gchar *name, GValue *value );
 gboolean      fma_factory_object_is_set           ( const FMAIFactoryObject *object, const gchar *name );
 
@@ -42,18 +42,22 @@
 #include <string.h>
 #include <sys/types.h>
 #include <unistd.h>
-#include <glibtop/proclist.h>
-#include <glibtop/procstate.h>
 
 #include <libnautilus-extension/nautilus-file-info.h>
 
 #include <api/fma-core-utils.h>
 #include <api/fma-object-api.h>
 
+#include "fma-boxed-value.h"
+#include "fma-command-probe.h"
 #include "fma-desktop-environment.h"
+#include "fma-exec-cache.h"
 #include "fma-gnome-vfs-uri.h"
+#include "fma-mimetype-cache.h"
+#include "fma-process-cache.h"
 #include "fma-selected-info.h"
 #include "fma-settings.h"
+#include "fma-tokens.h"
 
 /* private interface data
  */
@@ -61,37 +65,249 @@ struct _FMAIContextInterfacePrivate {
 	void *empty;						/* so that gcc -pedantic is happy */
 };
 
+/* a compiled condition
+ * pattern is the assertion, stripped from its negation prefix
+ */
+typedef struct {
+	gchar        *pattern;
+	guint         kind;
+	gchar        *content_type;
+	GPatternSpec *spec;
+}
+	sCondition;
+
+enum {
+	CONDITION_NONE = 0,
+	CONDITION_MIMETYPE_ALL,
+	CONDITION_MIMETYPE_ALLFILES,
+	CONDITION_MIMETYPE_TYPE,
+	CONDITION_SCHEME_ALL,
+	CONDITION_CAPABILITY_OWNER,
+	CONDITION_CAPABILITY_READABLE,
+	CONDITION_CAPABILITY_WRITABLE,
+	CONDITION_CAPABILITY_EXECUTABLE,
+	CONDITION_CAPABILITY_LOCAL,
+};
+
+/* a compiled list of conditions
+ * a set compiled from an interned list is shared between all the
+ * matchers which are compiled from this same list, and holds a
+ * reference on it
+ */
+typedef struct {
+	gint          ref_count;
+	const GSList *list;				/* the interned list, or NULL */
+	gpointer      fn;
+	gboolean      matchcase;
+	guint         positives_count;
+	sCondition   *positives;
+	guint         negatives_count;
+	sCondition   *negatives;
+}
+	sConditionSet;
+
+/* the checks done by fma_icontext_is_candidate()
+ */
+enum {
+	CHECK_TARGET = 0,
+	CHECK_SHOW_IN,
+	CHECK_SHOW_IF_REGISTERED,
+	CHECK_SELECTION_COUNT,
+	CHECK_SCHEMES,
+	CHECK_BASENAMES,
+	CHECK_MIMETYPES,
+	CHECK_FOLDERS,
+	CHECK_CAPABILITIES,
+	CHECK_TRY_EXEC,
+	CHECK_SHOW_IF_RUNNING,
+	CHECK_SHOW_IF_TRUE,
+	CHECK_N
+};
+
+/* the static cost classes of the checks
+ */
+enum {
+	COST_CONTEXT = 0,					/* only looks at the context itself */
+	COST_SELECTION,						/* iterates on the selection */
+	COST_CACHE,							/* queries a process-wide cache, which may have to be filled */
+	COST_COMMAND						/* may have to run an external command */
+};
+
+typedef struct {
+	const gchar *name;
+	guint        cost;
+}
+	sCheckDef;
+
+static const sCheckDef st_checks[ CHECK_N ] = {
+	{ "target",             COST_CONTEXT },
+	{ "show-in",            COST_CONTEXT },
+	{ "show-if-registered", COST_CONTEXT },
+	{ "selection-count",    COST_CONTEXT },
+	{ "schemes",            COST_SELECTION },
+	{ "basenames",          COST_SELECTION },
+	{ "mimetypes",          COST_SELECTION },
+	{ "folders",            COST_SELECTION },
+	{ "capabilities",       COST_SELECTION },
+	{ "try-exec",           COST_CACHE },
+	{ "show-if-running",    COST_CACHE },
+	{ "show-if-true",       COST_COMMAND }
+};
+
+/* the process-wide statistics of each check
+ */
+typedef struct {
+	guint64 evaluations;
+	guint64 rejections;
+	guint64 total_usec;
+	guint64 max_usec;
+}
+	sCheckStats;
+
+/* the evaluation order of the checks is recomputed each time the
+ * context has been evaluated this count of times
+ */
+#define MATCHER_REORDER_PERIOD			16
+
+/* the results of the per-file checks are only kept for selections of
+ * at most this count of files, larger selections being evaluated as a
+ * whole; this is also the maximal count of files interned per view, and
+ * of results kept per matcher
+ */
+#define MATCHER_FILES_MAX				10000
+
+/* the per-file results of the checks for a file of the view are kept
+ * as a bitmask of the evaluated checks and of their results
+ */
+#define FILE_KNOWN( check )				( 1U << ( 2*( check )))
+#define FILE_TRUE( check )				( 1U << ( 2*( check )+1 ))
+
+G_STATIC_ASSERT( 2*CHECK_N <= 32 );
+
+/* the compiled form of the per-file conditions of a context
+ *
+ * the compiled conditions are immutable; the evaluation order of the
+ * checks and the statistics it is computed from are protected by the
+ * st_checks lock; the per-file results of the checks for the current
+ * view, indexed by the id of the file in this view, are protected by
+ * the own lock of the matcher
+ */
+typedef struct {
+	gint          ref_count;
+	gboolean       all_mimetypes;
+	sConditionSet *mimetypes;
+	gboolean       all_basenames;
+	gboolean       matchcase;
+	sConditionSet *basenames;
+	gboolean       all_schemes;
+	sConditionSet *schemes;
+	gboolean       all_folders;
+	sConditionSet *folders;
+	sConditionSet *capabilities;
+	gchar          count_ope;
+	guint          count_limit;
+	guint8         order[ CHECK_N ];
+	guint          evaluations[ CHECK_N ];
+	guint          rejections[ CHECK_N ];
+	guint          runs;
+	GMutex         files_mutex;
+	GHashTable    *files;
+	guint          files_view;
+}
+	sMatcher;
+
+typedef void ( *CompileFn )( sCondition *, const sMatcher * );
+
+#define ICONTEXT_MATCHER				"fma-icontext-matcher"
+
 static guint st_initializations = 0;	/* interface initialization count */
 
+/* the condition sets compiled from interned lists, shared between the
+ * threads which may compile matchers
+ */
+static GHashTable *st_shared_sets = NULL;
+G_LOCK_DEFINE_STATIC( st_shared_sets );
+
+static sCheckStats st_check_stats[ CHECK_N ];
+G_LOCK_DEFINE_STATIC( st_checks );
+
+/* the matcher attached to a context may be compiled on first use by
+ * any thread, while being released by a modification of the context
+ */
+G_LOCK_DEFINE_STATIC( st_matchers );
+
+/* the current view, and the ids of its files, also protected by the
+ * st_checks lock
+ */
+static gchar      *st_view_uri   = NULL;
+static guint       st_view       = 0;
+static GHashTable *st_view_files = NULL;	/* uri+mimetype -> id */
+
 static GType        register_type( void );
 static void         interface_base_init( FMAIContextInterface *klass );
 static void         interface_base_finalize( FMAIContextInterface *klass );
 
 static gboolean     v_is_candidate( FMAIContext *object, guint target, GList *selection );
 
+static gboolean     is_candidate_for_check( guint check, const FMAIContext *object, sMatcher *matcher, guint target, GList *files );
+static gboolean     is_candidate_for_files( guint check, sMatcher *matcher, GList *files, const guint *ids, guint view );
+static gboolean     is_file_candidate( guint check, const sMatcher *matcher, const FMASelectedInfo *info );
 static gboolean     is_candidate_for_target( const FMAIContext *object, guint target, GList *files );
 static gboolean     is_candidate_for_show_in( const FMAIContext *object, guint target, GList *files );
 static gboolean     is_candidate_for_try_exec( const FMAIContext *object, guint target, GList *files );
 static gboolean     is_candidate_for_show_if_registered( const FMAIContext *object, guint target, GList *files );
 static gboolean     is_candidate_for_show_if_true( const FMAIContext *object, guint target, GList *files );
 static gboolean     is_candidate_for_show_if_running( const FMAIContext *object, guint target, GList *files );
-static gboolean     is_candidate_for_mimetypes( const FMAIContext *object, guint target, GList *files );
+static gboolean     is_candidate_for_mimetypes( const sMatcher *matcher, guint target, GList *files );
 static gboolean     is_all_mimetype( const gchar *mimetype );
 static gboolean     is_file_mimetype( const gchar *mimetype );
-static gboolean     is_mimetype_of( const gchar *file_type, const gchar *ftype, gboolean is_regular );
-static gboolean     is_candidate_for_basenames( const FMAIContext *object, guint target, GList *files );
-static gboolean     is_candidate_for_selection_count( const FMAIContext *object, guint target, GList *files );
-static gboolean     is_candidate_for_schemes( const FMAIContext *object, guint target, GList *files );
-static gboolean     is_compatible_scheme( const gchar *pattern, const gchar *scheme );
-static gboolean     is_candidate_for_folders( const FMAIContext *object, guint target, GList *files );
-static gboolean     is_candidate_for_capabilities( const FMAIContext *object, guint target, GList *files );
+static gboolean     is_mimetype_candidate( const sMatcher *matcher, const gchar *ftype, gboolean regular );
+static gboolean     is_mimetype_of( const sCondition *condition, const gchar *ftype, gboolean is_regular );
+static gboolean     is_candidate_for_basenames( const sMatcher *matcher, guint target, GList *files );
+static gboolean     is_basename_candidate( const sMatcher *matcher, const FMASelectedInfo *info );
+static gboolean     is_candidate_for_selection_count( const sMatcher *matcher, guint target, GList *files );
+static gboolean     is_candidate_for_schemes( const sMatcher *matcher, guint target, GList *files );
+static gboolean     is_scheme_candidate( const sMatcher *matcher, const gchar *scheme );
+static gboolean     is_compatible_scheme( const sCondition *condition, const gchar *scheme );
+static gboolean     is_candidate_for_folders( const sMatcher *matcher, guint target, GList *files );
+static gboolean     is_folder_candidate( const sMatcher *matcher, const gchar *dirname );
+static gboolean     is_folder_of( const sCondition *condition, const gchar *dirname );
+static gboolean     is_candidate_for_capabilities( const sMatcher *matcher, guint target, GList *files );
+static gboolean     has_capabilities( const sMatcher *matcher, const FMASelectedInfo *info );
+static gboolean     has_capability( const sCondition *condition, const FMASelectedInfo *info );
+
+static const guint *view_get_file_ids( GList *files, guint *view );
+
+static sMatcher    *context_get_matcher( const FMAIContext *context );
+static void         context_set_matcher( const FMAIContext *context, sMatcher *matcher );
+
+static sMatcher    *matcher_new( const FMAIContext *context );
+static sMatcher    *matcher_ref( sMatcher *matcher );
+static void         matcher_unref( sMatcher *matcher );
+static void         matcher_order_checks( sMatcher *matcher );
+static gint         matcher_cmp_checks( const sMatcher *matcher, guint a, guint b );
+static gboolean     matcher_caches_check( const sMatcher *matcher, guint check );
+static void         matcher_files_set_view( sMatcher *matcher, guint view );
+static guint        matcher_files_lookup( const sMatcher *matcher, guint id );
+static void         matcher_files_store( sMatcher *matcher, guint id, guint bits );
+static sConditionSet *matcher_get_set( const GSList *list, const sMatcher *matcher, CompileFn fn );
+static void         matcher_unref_set( sConditionSet *set );
+static guint        matcher_shared_set_hash( gconstpointer set );
+static gboolean     matcher_shared_set_equal( gconstpointer a, gconstpointer b );
+static void         matcher_compile_set( sConditionSet *set, const GSList *list, const sMatcher *matcher, CompileFn fn );
+static void         matcher_free_set( sConditionSet *set );
+static void         matcher_free_condition( sCondition *condition );
+static void         matcher_compile_mimetype( sCondition *condition, const sMatcher *matcher );
+static void         matcher_compile_basename( sCondition *condition, const sMatcher *matcher );
+static void         matcher_compile_scheme( sCondition *condition, const sMatcher *matcher );
+static void         matcher_compile_folder( sCondition *condition, const sMatcher *matcher );
+static void         matcher_compile_capability( sCondition *condition, const sMatcher *matcher );
 
 static gboolean     is_valid_basenames( const FMAIContext *object );
 static gboolean     is_valid_mimetypes( const FMAIContext *object );
 static gboolean     is_valid_schemes( const FMAIContext *object );
 static gboolean     is_valid_folders( const FMAIContext *object );
 
-static gboolean     is_positive_assertion( const gchar *assertion );
 
 /**
  * fma_icontext_get_type:
@@ -169,6 +385,15 @@ interface_base_finalize( FMAIContextInterface *klass )
 		g_debug( "%s: klass=%p", thisfn, ( void * ) klass );
 
 		g_free( klass->private );
+
+		G_LOCK( st_checks );
+		g_free( st_view_uri );
+		st_view_uri = NULL;
+		if( st_view_files ){
+			g_hash_table_destroy( st_view_files );
+			st_view_files = NULL;
+		}
+		G_UNLOCK( st_checks );
 	}
 }
 
@@ -222,6 +447,11 @@ fma_icontext_is_candidate( const FMAIContext *context, guint target, GList *sele
 {
 	static const gchar *thisfn = "fma_icontext_is_candidate";
 	gboolean is_candidate;
+	sMatcher *matcher;
+	guint8 order[ CHECK_N ];
+	gint64 elapsed[ CHECK_N ];
+	gint64 start;
+	guint i, count, check;
 
 	g_return_val_if_fail( FMA_IS_ICONTEXT( context ), FALSE );
 
@@ -231,24 +461,157 @@ fma_icontext_is_candidate( const FMAIContext *context, guint target, GList *sele
 	is_candidate = v_is_candidate( FMA_ICONTEXT( context ), target, selection );
 
 	if( is_candidate ){
-		is_candidate =
-				is_candidate_for_target( context, target, selection ) &&
-				is_candidate_for_show_in( context, target, selection ) &&
-				is_candidate_for_try_exec( context, target, selection ) &&
-				is_candidate_for_show_if_registered( context, target, selection ) &&
-				is_candidate_for_show_if_true( context, target, selection ) &&
-				is_candidate_for_show_if_running( context, target, selection ) &&
-				is_candidate_for_mimetypes( context, target, selection ) &&
-				is_candidate_for_basenames( context, target, selection ) &&
-				is_candidate_for_selection_count( context, target, selection ) &&
-				is_candidate_for_schemes( context, target, selection ) &&
-				is_candidate_for_folders( context, target, selection ) &&
-				is_candidate_for_capabilities( context, target, selection );
+
+		matcher = context_get_matcher( context );
+
+		/* checks are evaluated by increasing cost, and then the most
+		 * often rejecting first, until one rejects the context
+		 */
+		G_LOCK( st_checks );
+		memcpy( order, matcher->order, sizeof( order ));
+		G_UNLOCK( st_checks );
+
+		is_candidate = TRUE;
+		for( count = 0 ; count < CHECK_N && is_candidate ; ++count ){
+			start = g_get_monotonic_time();
+			is_candidate = is_candidate_for_check( order[count], context, matcher, target, selection );
+			elapsed[count] = g_get_monotonic_time() - start;
+		}
+
+		G_LOCK( st_checks );
+		for( i = 0 ; i < count ; ++i ){
+			check = order[i];
+			matcher->evaluations[check] += 1;
+			st_check_stats[check].evaluations += 1;
+			st_check_stats[check].total_usec += elapsed[i];
+			st_check_stats[check].max_usec = MAX( st_check_stats[check].max_usec, ( guint64 ) elapsed[i] );
+		}
+		if( !is_candidate ){
+			check = order[count-1];
+			matcher->rejections[check] += 1;
+			st_check_stats[check].rejections += 1;
+		}
+		matcher->runs += 1;
+		if( matcher->runs >= MATCHER_REORDER_PERIOD ){
+			matcher_order_checks( matcher );
+			matcher->runs = 0;
+		}
+		G_UNLOCK( st_checks );
+
+		matcher_unref( matcher );
 	}
 
 	return( is_candidate );
 }
 
+/**
+ * fma_icontext_dump_stats:
+ *
+ * Dumps the process-wide statistics of the checks done by
+ * fma_icontext_is_candidate(), the most time-consuming first.
+ *
+ * Since: 3.5
+ */
+void
+fma_icontext_dump_stats( void )
+{
+	static const gchar *thisfn = "fma_icontext_dump_stats";
+	sCheckStats stats[ CHECK_N ];
+	guint order[ CHECK_N ];
+	guint i, j, check;
+
+	G_LOCK( st_checks );
+	memcpy( stats, st_check_stats, sizeof( stats ));
+	G_UNLOCK( st_checks );
+
+	for( i = 0 ; i < CHECK_N ; ++i ){
+		for( j = i ; j > 0 && stats[order[j-1]].total_usec < stats[i].total_usec ; --j ){
+			order[j] = order[j-1];
+		}
+		order[j] = i;
+	}
+
+	for( i = 0 ; i < CHECK_N ; ++i ){
+		check = order[i];
+		if( stats[check].evaluations ){
+			g_debug( "%s: %-18s evaluations=%" G_GUINT64_FORMAT ", rejections=%" G_GUINT64_FORMAT
+					", total=%.3f ms, mean=%.1f us, max=%.1f us",
+					thisfn, st_checks[check].name, stats[check].evaluations, stats[check].rejections,
+					stats[check].total_usec / 1000.0,
+					( gdouble ) stats[check].total_usec / stats[check].evaluations,
+					( gdouble ) stats[check].max_usec );
+		}
+	}
+}
+
+/**
+ * fma_icontext_is_dynamic:
+ * @context: the #FMAIContext to be checked.
+ *
+ * Returns: %TRUE if the @context has a condition whose result may
+ * change while the selection stays the same, i.e. a TryExec,
+ * ShowIfRunning, ShowIfTrue or Capabilities condition, %FALSE else.
+ *
+ * Since: 3.5
+ */
+gboolean
+fma_icontext_is_dynamic( const FMAIContext *context )
+{
+	const gchar *str;
+
+	g_return_val_if_fail( FMA_IS_ICONTEXT( context ), FALSE );
+
+	str = fma_object_peek_try_exec( context );
+	if( str && strlen( str )){
+		return( TRUE );
+	}
+
+	str = fma_object_peek_show_if_running( context );
+	if( str && strlen( str )){
+		return( TRUE );
+	}
+
+	str = fma_object_peek_show_if_true( context );
+	if( str && strlen( str )){
+		return( TRUE );
+	}
+
+	return( fma_object_peek_capabilities( context ) != NULL );
+}
+
+/**
+ * fma_icontext_set_view:
+ * @view: the URI of the location the next selections are made in.
+ *
+ * Each context keeps the results of its per-file checks while the
+ * view stays the same, so that a selection which grows file by file
+ * only has the new files to be evaluated by fma_icontext_is_candidate().
+ *
+ * These results are discarded when the view changes, and when the
+ * conditions of the context are modified or reloaded. They are only
+ * kept for the selections which have been registered with
+ * fma_selected_info_begin_query().
+ *
+ * Since: 3.5
+ */
+void
+fma_icontext_set_view( const gchar *view )
+{
+	static const gchar *thisfn = "fma_icontext_set_view";
+
+	G_LOCK( st_checks );
+	if( g_strcmp0( view, st_view_uri )){
+		g_debug( "%s: view=%s", thisfn, view );
+		g_free( st_view_uri );
+		st_view_uri = g_strdup( view );
+		st_view += 1;
+		if( st_view_files ){
+			g_hash_table_remove_all( st_view_files );
+		}
+	}
+	G_UNLOCK( st_checks );
+}
+
 /**
  * fma_icontext_is_valid:
  * @context: the #FMAIContext to be checked.
@@ -296,12 +659,12 @@ fma_icontext_check_mimetypes( const FMAIContext *context )
 {
 	static const gchar *thisfn = "fma_icontext_check_mimetypes";
 	gboolean is_all;
-	GSList *mimetypes, *im;
+	const GSList *mimetypes, *im;
 
 	g_return_if_fail( FMA_IS_ICONTEXT( context ));
 
 	is_all = TRUE;
-	mimetypes = fma_object_get_mimetypes( context );
+	mimetypes = fma_object_peek_mimetypes( context );
 
 	for( im = mimetypes ; im ; im = im->next ){
 		if( !im->data || !strlen( im->data )){
@@ -317,8 +680,6 @@ fma_icontext_check_mimetypes( const FMAIContext *context )
 	}
 
 	fma_object_set_all_mimetypes( context, is_all );
-
-	fma_core_utils_slist_free( mimetypes );
 }
 
 /**
@@ -333,7 +694,47 @@ fma_icontext_check_mimetypes( const FMAIContext *context )
 void
 fma_icontext_copy( FMAIContext *context, const FMAIContext *source )
 {
-	/* nothing to do for now */
+	sMatcher *matcher;
+
+	g_return_if_fail( FMA_IS_ICONTEXT( context ));
+	g_return_if_fail( FMA_IS_ICONTEXT( source ));
+
+	/* the compiled conditions are immutable, and so may be shared
+	 */
+	G_LOCK( st_matchers );
+	matcher = g_object_get_data( G_OBJECT( source ), ICONTEXT_MATCHER );
+	matcher = matcher ? matcher_ref( matcher ) : NULL;
+	G_UNLOCK( st_matchers );
+
+	context_set_matcher( context, matcher );
+}
+
+/**
+ * fma_icontext_data_changed:
+ * @context: the #FMAIContext context.
+ * @name: the name of the modified data.
+ *
+ * Releases the compiled conditions of the @context when one of the
+ * data they have been compiled from is modified.
+ *
+ * Since: 3.5
+ */
+void
+fma_icontext_data_changed( FMAIContext *context, const gchar *name )
+{
+	g_return_if_fail( FMA_IS_ICONTEXT( context ));
+
+	if( !strcmp( name, FMAFO_DATA_MIMETYPES ) ||
+		!strcmp( name, FMAFO_DATA_MIMETYPES_IS_ALL ) ||
+		!strcmp( name, FMAFO_DATA_BASENAMES ) ||
+		!strcmp( name, FMAFO_DATA_MATCHCASE ) ||
+		!strcmp( name, FMAFO_DATA_SCHEMES ) ||
+		!strcmp( name, FMAFO_DATA_FOLDERS ) ||
+		!strcmp( name, FMAFO_DATA_SELECTION_COUNT ) ||
+		!strcmp( name, FMAFO_DATA_CAPABILITITES )){
+
+		context_set_matcher( context, NULL );
+	}
 }
 
 /**
@@ -349,6 +750,19 @@ fma_icontext_copy( FMAIContext *context, const FMAIContext *source )
  *       in order to optimize computation time;
  *     </para>
  *   </listitem>
+ *   <listitem>
+ *     <para>
+ *       This compiles the per-file conditions into an immutable matcher,
+ *       so that fma_icontext_is_candidate() does not have to parse them
+ *       again on each call.
+ *     </para>
+ *   </listitem>
+ *   <listitem>
+ *     <para>
+ *       This resolves the TryExec key, so that fma_icontext_is_candidate()
+ *       does not have to query the filesystem.
+ *     </para>
+ *   </listitem>
  * </itemizedlist>
  *
  * Since: 2.30
@@ -356,7 +770,16 @@ fma_icontext_copy( FMAIContext *context, const FMAIContext *source )
 void
 fma_icontext_read_done( FMAIContext *context )
 {
+	const gchar *tryexec;
+
 	fma_object_check_mimetypes( context );
+
+	tryexec = fma_object_peek_try_exec( context );
+	if( tryexec && strlen( tryexec )){
+		fma_exec_cache_add( tryexec );
+	}
+
+	context_set_matcher( context, matcher_new( context ));
 }
 
 /**
@@ -471,6 +894,141 @@ v_is_candidate( FMAIContext *context, guint target, GList *selection )
  * target is context menu for location, context menu for selection or toolbar for location
  * only actions are concerned by this check
  */
+static gboolean
+is_candidate_for_check( guint check, const FMAIContext *object, sMatcher *matcher, guint target, GList *files )
+{
+	gboolean ok = TRUE;
+	const guint *ids;
+	guint view;
+
+	if( files && matcher_caches_check( matcher, check )){
+		ids = view_get_file_ids( files, &view );
+		if( ids ){
+			return( is_candidate_for_files( check, matcher, files, ids, view ));
+		}
+	}
+
+	switch( check ){
+		case CHECK_TARGET:
+			ok = is_candidate_for_target( object, target, files );
+			break;
+		case CHECK_SHOW_IN:
+			ok = is_candidate_for_show_in( object, target, files );
+			break;
+		case CHECK_SHOW_IF_REGISTERED:
+			ok = is_candidate_for_show_if_registered( object, target, files );
+			break;
+		case CHECK_SELECTION_COUNT:
+			ok = is_candidate_for_selection_count( matcher, target, files );
+			break;
+		case CHECK_SCHEMES:
+			ok = is_candidate_for_schemes( matcher, target, files );
+			break;
+		case CHECK_BASENAMES:
+			ok = is_candidate_for_basenames( matcher, target, files );
+			break;
+		case CHECK_MIMETYPES:
+			ok = is_candidate_for_mimetypes( matcher, target, files );
+			break;
+		case CHECK_FOLDERS:
+			ok = is_candidate_for_folders( matcher, target, files );
+			break;
+		case CHECK_CAPABILITIES:
+			ok = is_candidate_for_capabilities( matcher, target, files );
+			break;
+		case CHECK_TRY_EXEC:
+			ok = is_candidate_for_try_exec( object, target, files );
+			break;
+		case CHECK_SHOW_IF_RUNNING:
+			ok = is_candidate_for_show_if_running( object, target, files );
+			break;
+		case CHECK_SHOW_IF_TRUE:
+			ok = is_candidate_for_show_if_true( object, target, files );
+			break;
+	}
+
+	return( ok );
+}
+
+/*
+ * the per-file checks are evaluated once per file of the view, their
+ * results being kept in the matcher: when the selection grows, only
+ * the new files have to be evaluated, and ANDed with the cached
+ * results of the other files
+ *
+ * the files are looked up, and then the results stored, under the lock
+ * of the matcher, while the evaluations themselves are done outside of it
+ */
+static gboolean
+is_candidate_for_files( guint check, sMatcher *matcher, GList *files, const guint *ids, guint view )
+{
+	static const gchar *thisfn = "fma_icontext_is_candidate_for_files";
+	guint *states;
+	guint length, count, misses, i;
+	gboolean ok;
+	GList *it;
+
+	length = fma_selected_info_get_summary( files, SELECTION_SUMMARY_COUNT )->count;
+	states = g_new( guint, length );
+	ok = TRUE;
+	misses = 0;
+
+	g_mutex_lock( &matcher->files_mutex );
+	matcher_files_set_view( matcher, view );
+	for( count = 0 ; count < length && ok ; ++count ){
+		states[count] = matcher_files_lookup( matcher, ids[count] );
+		if( states[count] & FILE_KNOWN( check )){
+			ok = (( states[count] & FILE_TRUE( check )) != 0 );
+		} else {
+			misses += 1;
+		}
+	}
+	g_mutex_unlock( &matcher->files_mutex );
+
+	if( ok && misses ){
+		for( it = files, count = 0 ; it && ok ; it = it->next, ++count ){
+			if( !( states[count] & FILE_KNOWN( check ))){
+				ok = is_file_candidate( check, matcher, FMA_SELECTED_INFO( it->data ));
+				states[count] = FILE_KNOWN( check ) | ( ok ? FILE_TRUE( check ) : 0 );
+			} else {
+				states[count] = 0;
+			}
+		}
+
+		g_mutex_lock( &matcher->files_mutex );
+		matcher_files_set_view( matcher, view );
+		for( i = 0 ; i < count ; ++i ){
+			if( states[i] ){
+				matcher_files_store( matcher, ids[i], states[i] );
+			}
+		}
+		g_mutex_unlock( &matcher->files_mutex );
+	}
+
+	g_debug( "%s: check=%s, files=%u, misses=%u, ok=%s",
+			thisfn, st_checks[check].name, length, misses, ok ? "True":"False" );
+
+	g_free( states );
+	return( ok );
+}
+
+static gboolean
+is_file_candidate( guint check, const sMatcher *matcher, const FMASelectedInfo *info )
+{
+	gboolean ok = TRUE;
+
+	switch( check ){
+		case CHECK_BASENAMES:
+			ok = is_basename_candidate( matcher, info );
+			break;
+		case CHECK_CAPABILITIES:
+			ok = has_capabilities( matcher, info );
+			break;
+	}
+
+	return( ok );
+}
+
 static gboolean
 is_candidate_for_target( const FMAIContext *object, guint target, GList *files )
 {
@@ -518,8 +1076,8 @@ is_candidate_for_show_in( const FMAIContext *object, guint target, GList *files
 {
 	static const gchar *thisfn = "fma_icontext_is_candidate_for_show_in";
 	gboolean ok = TRUE;
-	GSList *only_in = fma_object_get_only_show_in( object );
-	GSList *not_in = fma_object_get_not_show_in( object );
+	GSList *only_in = ( GSList * ) fma_object_peek_only_show_in( object );
+	GSList *not_in = ( GSList * ) fma_object_peek_not_show_in( object );
 	static gchar *environment = NULL;
 
 	/* there is a memory leak here when desktop comes from user preferences
@@ -548,48 +1106,30 @@ is_candidate_for_show_in( const FMAIContext *object, guint target, GList *files
 		g_free( only_str );
 	}
 
-	fma_core_utils_slist_free( not_in );
-	fma_core_utils_slist_free( only_in );
-
 	return( ok );
 }
 
 /*
- * if the data is set, it should be the path of an executable file
+ * if the data is set, it should be the path of an executable file,
+ * or the name of a program to be searched for in $PATH
+ *
+ * the key has usually been resolved when the context has been read
  */
 static gboolean
 is_candidate_for_try_exec( const FMAIContext *object, guint target, GList *files )
 {
 	static const gchar *thisfn = "fma_icontext_is_candidate_for_try_exec";
 	gboolean ok = TRUE;
-	GError *error = NULL;
-	gchar *tryexec = fma_object_get_try_exec( object );
+	const gchar *tryexec = fma_object_peek_try_exec( object );
 
 	if( tryexec && strlen( tryexec )){
-		ok = FALSE;
-		GFile *file = g_file_new_for_path( tryexec );
-		GFileInfo *info = g_file_query_info( file, G_FILE_ATTRIBUTE_ACCESS_CAN_EXECUTE, G_FILE_QUERY_INFO_NONE, NULL, &error );
-		if( error ){
-			g_debug( "%s: %s", thisfn, error->message );
-			g_error_free( error );
-
-		} else {
-			ok = g_file_info_get_attribute_boolean( info, G_FILE_ATTRIBUTE_ACCESS_CAN_EXECUTE );
-		}
-
-		if( info ){
-			g_object_unref( info );
-		}
-
-		g_object_unref( file );
+		ok = fma_exec_cache_is_executable( tryexec );
 	}
 
 	if( !ok ){
 		g_debug( "%s: object is not candidate because TryExec=%s", thisfn, tryexec );
 	}
 
-	g_free( tryexec );
-
 	return( ok );
 }
 
@@ -598,7 +1138,7 @@ is_candidate_for_show_if_registered( const FMAIContext *object, guint target, GL
 {
 	static const gchar *thisfn = "fma_icontext_is_candidate_for_show_if_registered";
 	gboolean ok = TRUE;
-	gchar *name = fma_object_get_show_if_registered( object );
+	const gchar *name = fma_object_peek_show_if_registered( object );
 
 	if( name && strlen( name )){
 		ok = FALSE;
@@ -608,8 +1148,6 @@ is_candidate_for_show_if_registered( const FMAIContext *object, guint target, GL
 		g_debug( "%s: object is not candidate because ShowIfRegistered=%s", thisfn, name );
 	}
 
-	g_free( name );
-
 	return( ok );
 }
 
@@ -618,26 +1156,35 @@ is_candidate_for_show_if_true( const FMAIContext *object, guint target, GList *f
 {
 	static const gchar *thisfn = "fma_icontext_is_candidate_for_show_if_true";
 	gboolean ok = TRUE;
-	gchar *command = fma_object_get_show_if_true( object );
+	FMATokens *tokens;
+	gchar *expanded;
+	const gchar *command = fma_object_peek_show_if_true( object );
 
 	if( command && strlen( command )){
-		ok = FALSE;
-		gchar *stdout = NULL;
-		g_spawn_command_line_sync( command, &stdout, NULL, NULL, NULL );
 
-		if( stdout && !strcmp( stdout, "true" )){
-			ok = TRUE;
+		/* parameters are expanded against the current selection;
+		 * the tokens of a registered selection are shared by all the
+		 * contexts, else per-item tokens are only computed on demand
+		 */
+		if( strchr( command, '%' )){
+			tokens = FMA_TOKENS( fma_selected_info_get_query_tokens( files ));
+			if( !tokens ){
+				tokens = fma_tokens_new_from_selection_used( files, 0 );
+			}
+			expanded = fma_tokens_parse_for_command( tokens, command );
+			g_object_unref( tokens );
+		} else {
+			expanded = g_strdup( command );
 		}
 
-		g_free( stdout );
+		ok = fma_command_probe_is_true( expanded );
+		g_free( expanded );
 	}
 
 	if( !ok ){
 		g_debug( "%s: object is not candidate because ShowIfTrue=%s", thisfn, command );
 	}
 
-	g_free( command );
-
 	return( ok );
 }
 
@@ -647,27 +1194,11 @@ is_candidate_for_show_if_running( const FMAIContext *object, guint target, GList
 	static const gchar *thisfn = "fma_icontext_is_candidate_for_show_if_running";
 	gboolean ok = TRUE;
 	gchar *searched;
-	glibtop_proclist proclist;
-	glibtop_proc_state procstate;
-	pid_t *pid_list;
-	guint i;
-	gchar *running = fma_object_get_show_if_running( object );
+	const gchar *running = fma_object_peek_show_if_running( object );
 
 	if( running && strlen( running )){
-		ok = FALSE;
 		searched = g_path_get_basename( running );
-		pid_list = glibtop_get_proclist( &proclist, GLIBTOP_KERN_PROC_ALL, 0 );
-
-		for( i=0 ; i<proclist.number && !ok ; ++i ){
-			glibtop_get_proc_state( &procstate, pid_list[i] );
-			/*g_debug( "%s: i=%d, cmd=%s", thisfn, i, procstate.cmd );*/
-			if( strcmp( procstate.cmd, searched ) == 0 ){
-				g_debug( "%s: i=%d, cmd=%s", thisfn, i, procstate.cmd );
-				ok = TRUE;
-			}
-		}
-
-		g_free( pid_list );
+		ok = fma_process_cache_is_running( searched );
 		g_free( searched );
 	}
 
@@ -675,8 +1206,6 @@ is_candidate_for_show_if_running( const FMAIContext *object, guint target, GList
 		g_debug( "%s: object is not candidate because ShowIfRunning=%s", thisfn, running );
 	}
 
-	g_free( running );
-
 	return( ok );
 }
 
@@ -693,77 +1222,76 @@ is_candidate_for_show_if_running( const FMAIContext *object, guint target, GList
  * (they are ORed), while not being of any negative assertions (they are
  * ANDed)
  *
- * here, for each mimetype of the selection, do
- * . match is FALSE while this mimetype has not matched a positive assertion
- * . nomatch is FALSE while this mimetype has not matched a negative assertion
- * we are going to check each mimetype filter
- *  while we have not found a match among positive conditions (i.e. while !match)
- *  we have to check all negative conditions to verify that the current
- *  examined mimetype never match these
+ * positive and negative assertions have been split at compile time, so
+ * we just have to find a positive match, and then to check that no
+ * negative assertion matches
+ *
+ * the check is only done once per distinct mimetype of the selection,
+ * and per distinct regular/non-regular file type of this mimetype
  */
 static gboolean
-is_candidate_for_mimetypes( const FMAIContext *object, guint target, GList *files )
+is_candidate_for_mimetypes( const sMatcher *matcher, guint target, GList *files )
 {
 	static const gchar *thisfn = "fma_icontext_is_candidate_for_mimetypes";
 	gboolean ok = TRUE;
-	gboolean all = fma_object_get_all_mimetypes( object );
+	const FMASelectionSummary *summary;
+	const FMASelectionMimetype *histo;
+	GSList *it;
 
-	g_debug( "%s: all=%s", thisfn, all ? "True":"False" );
+	if( !matcher->all_mimetypes ){
+		summary = fma_selected_info_get_summary( files, SELECTION_SUMMARY_MIMETYPES );
 
-	if( !all ){
-		GSList *mimetypes = fma_object_get_mimetypes( object );
-		GSList *im;
-		GList *it;
+		if( summary ){
+			if( summary->unknown_mimetypes ){
+				g_warning( "%s: null mimetype found for %u item(s)", thisfn, summary->unknown_mimetypes );
+				ok = FALSE;
+			}
 
-		for( it = files ; it && ok ; it = it->next ){
-			gchar *ftype;
-			gboolean regular, match, positive;
-
-			match = FALSE;
-			ftype = fma_selected_info_get_mime_type( FMA_SELECTED_INFO( it->data ));
-			regular = fma_selected_info_is_regular( FMA_SELECTED_INFO( it->data ));
-
-			if( ftype ){
-				for( im = mimetypes ; im && ok ; im = im->next ){
-					const gchar *imtype = ( const gchar * ) im->data;
-					positive = is_positive_assertion( imtype );
-
-					if( !positive || !match ){
-						if( is_mimetype_of( positive ? imtype : imtype+1, ftype, regular )){
-							g_debug( "%s: condition=%s, positive=%s, ftype=%s, matched",
-									thisfn, imtype, positive ? "True":"False", ftype );
-							if( positive ){
-								match = TRUE;
-							} else {
-								ok = FALSE;
-							}
-						}
-					}
-				}
+			for( it = summary->mimetypes ; it && ok ; it = it->next ){
+				histo = ( const FMASelectionMimetype * ) it->data;
 
-				if( !match ){
-					gchar *mimetypes_str = fma_core_utils_slist_to_text( mimetypes );
-					g_debug( "%s: no positive match found for Mimetypes=%s", thisfn, mimetypes_str );
-					g_free( mimetypes_str );
-					ok = FALSE;
+				if( histo->regulars ){
+					ok = is_mimetype_candidate( matcher, histo->mimetype, TRUE );
+				}
+				if( ok && histo->regulars < histo->count ){
+					ok = is_mimetype_candidate( matcher, histo->mimetype, FALSE );
 				}
-
-			} else {
-				gchar *uri = fma_selected_info_get_uri( FMA_SELECTED_INFO( it->data ));
-				g_warning( "%s: null mimetype found for %s", thisfn, uri );
-				g_free( uri );
-				ok = FALSE;
 			}
-
-			g_free( ftype );
 		}
-
-		fma_core_utils_slist_free( mimetypes );
 	}
 
 	return( ok );
 }
 
+static gboolean
+is_mimetype_candidate( const sMatcher *matcher, const gchar *ftype, gboolean regular )
+{
+	static const gchar *thisfn = "fma_icontext_is_mimetype_candidate";
+	gboolean match;
+	guint i;
+
+	match = FALSE;
+
+	for( i = 0 ; i < matcher->mimetypes->positives_count && !match ; ++i ){
+		match = is_mimetype_of( &matcher->mimetypes->positives[i], ftype, regular );
+	}
+
+	if( !match ){
+		g_debug( "%s: no positive match found for mimetype=%s", thisfn, ftype );
+		return( FALSE );
+	}
+
+	for( i = 0 ; i < matcher->mimetypes->negatives_count ; ++i ){
+		if( is_mimetype_of( &matcher->mimetypes->negatives[i], ftype, regular )){
+			g_debug( "%s: condition=!%s, ftype=%s, matched",
+					thisfn, matcher->mimetypes->negatives[i].pattern, ftype );
+			return( FALSE );
+		}
+	}
+
+	return( TRUE );
+}
+
 static gboolean
 is_all_mimetype( const gchar *mimetype )
 {
@@ -791,211 +1319,160 @@ is_file_mimetype( const gchar *mimetype )
  * for example, "image/jpeg" is clearly a sort of "image/ *"
  *
  * content type if the same as the mime type in *nix;
- * this is not true on Win32 platforms
+ * this is not true on Win32 platforms - the content type of the
+ * condition has been resolved at compile time
+ *
+ * as a selection usually only involves a few distinct mimetypes, the
+ * result of the database lookup is memoized
  */
 static gboolean
-is_mimetype_of( const gchar *mimetype, const gchar *ftype, gboolean is_regular )
+is_mimetype_of( const sCondition *condition, const gchar *ftype, gboolean is_regular )
 {
-	static const gchar *thisfn = "fma_icontext_is_mimetype_of";
-	gboolean is_type_of;
-	gchar *file_content_type, *def_content_type;
+	switch( condition->kind ){
+		case CONDITION_MIMETYPE_ALL:
+			return( TRUE );
 
-	if( is_all_mimetype( mimetype )){
-		return( TRUE );
-	}
+		case CONDITION_MIMETYPE_ALLFILES:
+			return( is_regular );
 
-	if( is_file_mimetype( mimetype ) && is_regular ){
-		return( TRUE );
+		default:
+			break;
 	}
 
-	is_type_of = FALSE;
-	file_content_type = g_content_type_from_mime_type( ftype );
-	def_content_type = g_content_type_from_mime_type( mimetype );
+	return( condition->content_type && fma_mimetype_cache_is_a( ftype, condition->content_type ));
+}
 
-	if( file_content_type && def_content_type ){
-		is_type_of = g_content_type_is_a( file_content_type, def_content_type );
-		g_debug( "%s: def_mimetype=%s content_type=%s file_mimetype=%s content_type=%s is_a=%s",
-				thisfn, mimetype, def_content_type, ftype, file_content_type,
-				is_type_of ? "True":"False" );
-	}
+/*
+ * basenames have been converted to UTF-8, and lowercased if the match
+ * is case insensitive, at compile time
+ * we only have to convert the basename of the file if it is not valid
+ * UTF-8, or if the match is case insensitive
+ */
+static gboolean
+is_candidate_for_basenames( const sMatcher *matcher, guint target, GList *files )
+{
+	gboolean ok = TRUE;
+	GList *it;
+
+	if( !matcher->all_basenames ){
 
-	g_free( file_content_type );
-	g_free( def_content_type );
+		for( it = files ; it && ok ; it = it->next ){
+			ok = is_basename_candidate( matcher, FMA_SELECTED_INFO( it->data ));
+		}
+	}
 
-	return( is_type_of );
+	return( ok );
 }
 
 static gboolean
-is_candidate_for_basenames( const FMAIContext *object, guint target, GList *files )
+is_basename_candidate( const sMatcher *matcher, const FMASelectedInfo *info )
 {
-	static const gchar *thisfn = "fma_icontext_is_candidate_for_basenames";
+	static const gchar *thisfn = "fma_icontext_is_basename_candidate";
 	gboolean ok = TRUE;
-	GSList *basenames = fma_object_get_basenames( object );
-
-	if( basenames ){
-		if( strcmp( basenames->data, "*" ) != 0 || g_slist_length( basenames ) > 1 ){
-			gboolean matchcase = fma_object_get_matchcase( object );
-			GSList *ib;
-			GList *it;
-			gchar *tmp;
-
-			for( it = files ; it && ok ; it = it->next ){
-				gchar *pattern, *bname, *bname_utf8;
-				gboolean match, positive;
-				gchar *pattern_utf8;
-
-				bname = fma_selected_info_get_basename( FMA_SELECTED_INFO( it->data ));
-				bname_utf8 = g_filename_to_utf8( bname, -1, NULL, NULL, NULL );
-				if( !matchcase ){
-					tmp = g_utf8_strdown( bname_utf8, -1 );
-					g_free( bname_utf8 );
-					bname_utf8 = tmp;
-				}
-				match = FALSE;
-
-				for( ib = basenames ; ib && ok ; ib = ib->next ){
-					pattern = matchcase ?
-						g_strdup(( gchar * ) ib->data ) :
-						g_utf8_strdown(( gchar * ) ib->data, -1 );
-					positive = is_positive_assertion( pattern );
-					pattern_utf8 = g_filename_to_utf8( positive ? pattern : pattern+1, -1, NULL, NULL, NULL );
-
-					if( !positive || !match ){
-						if( g_pattern_match_simple( pattern_utf8, bname_utf8 )){
-							g_debug( "%s: condition=%s, positive=%s, basename=%s: matched",
-									thisfn, pattern_utf8, positive ? "True":"False", bname_utf8 );
-							if( positive ){
-								match = TRUE;
-							} else {
-								ok = FALSE;
-							}
-						}
-					}
-
-					g_free( pattern_utf8 );
-					g_free( pattern );
-				}
+	const gchar *bname;
+	gchar *bname_utf8, *tmp;
+	gboolean match;
+	guint i;
 
-				if( !match ){
-					gchar *basenames_str = fma_core_utils_slist_to_text( basenames );
-					g_debug( "%s: no positive match found for Basenames=%s", thisfn, basenames_str );
-					g_free( basenames_str );
-					ok = FALSE;
-				}
+	bname = fma_selected_info_peek_basename( info );
+	bname_utf8 = NULL;
 
-				g_free( bname_utf8 );
-				g_free( bname );
-			}
-		}
+	if( !bname ){
+		return( FALSE );
+	}
+	if( !g_utf8_validate( bname, -1, NULL )){
+		bname_utf8 = g_filename_to_utf8( bname, -1, NULL, NULL, NULL );
+		bname = bname_utf8 ? bname_utf8 : "";
+	}
+	if( !matcher->matchcase ){
+		tmp = g_utf8_strdown( bname, -1 );
+		g_free( bname_utf8 );
+		bname = bname_utf8 = tmp;
+	}
+
+	match = FALSE;
+
+	for( i = 0 ; i < matcher->basenames->positives_count && !match ; ++i ){
+		match = g_pattern_match_string( matcher->basenames->positives[i].spec, bname );
+	}
 
-		fma_core_utils_slist_free( basenames );
+	if( !match ){
+		g_debug( "%s: no positive match found for basename=%s", thisfn, bname );
+		ok = FALSE;
+	}
+
+	for( i = 0 ; i < matcher->basenames->negatives_count && ok ; ++i ){
+		if( g_pattern_match_string( matcher->basenames->negatives[i].spec, bname )){
+			g_debug( "%s: condition=!%s, basename=%s: matched",
+					thisfn, matcher->basenames->negatives[i].pattern, bname );
+			ok = FALSE;
+		}
 	}
 
+	g_free( bname_utf8 );
+
 	return( ok );
 }
 
 static gboolean
-is_candidate_for_selection_count( const FMAIContext *object, guint target, GList *files )
+is_candidate_for_selection_count( const sMatcher *matcher, guint target, GList *files )
 {
 	static const gchar *thisfn = "fma_icontext_is_candidate_for_selection_count";
 	gboolean ok = TRUE;
-	gint limit;
 	guint count;
-	gchar *selection_count = fma_object_get_selection_count( object );
 
-	if( selection_count && strlen( selection_count )){
-		limit = atoi( selection_count+1 );
-		count = g_list_length( files );
+	if( matcher->count_ope ){
+		count = files ? fma_selected_info_get_summary( files, SELECTION_SUMMARY_COUNT )->count : 0;
 		ok = FALSE;
 
-		switch( selection_count[0] ){
+		switch( matcher->count_ope ){
 			case '<':
-				ok = ( count < limit );
+				ok = ( count < matcher->count_limit );
 				break;
 			case '=':
-				ok = ( count == limit );
+				ok = ( count == matcher->count_limit );
 				break;
 			case '>':
-				ok = ( count > limit );
+				ok = ( count > matcher->count_limit );
 				break;
 			default:
 				break;
 		}
-	}
 
-	if( !ok ){
-		g_debug( "%s: object is not candidate because SelectionCount=%s", thisfn, selection_count );
+		if( !ok ){
+			g_debug( "%s: object is not candidate because SelectionCount=%c%d",
+					thisfn, matcher->count_ope, matcher->count_limit );
+		}
 	}
 
-	g_free( selection_count );
-
 	return( ok );
 }
 
 /*
  * it is likely that all selected items have the same scheme, because they
  * are all in the same location and the scheme mainly depends on location
- * so we have here a great possible optimization by only testing the
- * first selected item.
- * note that this optimization may be wrong, for example when ran from the
- * command-line with a random set of pseudo-selected items
- * so we take care of only checking _distincts_ schemes of provided selection
- * against schemes conditions.
+ * so we only check each distinct scheme of the selection once - this is
+ * still right when ran from the command-line with a random set of
+ * pseudo-selected items
  */
 static gboolean
-is_candidate_for_schemes( const FMAIContext *object, guint target, GList *files )
+is_candidate_for_schemes( const sMatcher *matcher, guint target, GList *files )
 {
 	static const gchar *thisfn = "fma_icontext_is_candidate_for_schemes";
 	gboolean ok = TRUE;
-	GSList *schemes = fma_object_get_schemes( object );
-
-	if( schemes ){
-		if( strcmp( schemes->data, "*" ) != 0 || g_slist_length( schemes ) > 1 ){
-			GSList *distincts = NULL;
-			GList *it;
-
-			for( it = files ; it && ok ; it = it->next ){
-				gchar *scheme = fma_selected_info_get_uri_scheme( FMA_SELECTED_INFO( it->data ));
-
-				if( fma_core_utils_slist_count( distincts, scheme ) == 0 ){
-					GSList *is;
-					gchar *pattern;
-					gboolean match, positive;
-
-					match = FALSE;
-					distincts = g_slist_prepend( distincts, g_strdup( scheme ));
-
-					for( is = schemes ; is && ok ; is = is->next ){
-						pattern = ( gchar * ) is->data;
-						positive = is_positive_assertion( pattern );
-
-						if( !positive || !match ){
-							if( is_compatible_scheme( positive ? pattern : pattern+1, scheme )){
-								if( positive ){
-									match = TRUE;
-								} else {
-									ok = FALSE;
-								}
-							}
-						}
-					}
-
-					ok &= match;
-				}
+	const FMASelectionSummary *summary;
+	GSList *it;
 
-				g_free( scheme );
-			}
+	if( !matcher->all_schemes ){
+		summary = fma_selected_info_get_summary( files, SELECTION_SUMMARY_SCHEMES );
 
-			fma_core_utils_slist_free( distincts );
+		for( it = summary ? summary->schemes : NULL ; it && ok ; it = it->next ){
+			ok = is_scheme_candidate( matcher, ( const gchar * ) it->data );
 		}
 
 		if( !ok ){
-			gchar *schemes_str = fma_core_utils_slist_to_text( schemes );
-			g_debug( "%s: object is not candidate because Schemes=%s", thisfn, schemes_str );
-			g_free( schemes_str );
+			g_debug( "%s: object is not candidate because of Schemes", thisfn );
 		}
-
-		fma_core_utils_slist_free( schemes );
 	}
 
 	g_debug( "%s: ok=%s", thisfn, ok ? "True":"False" );
@@ -1003,154 +1480,723 @@ is_candidate_for_schemes( const FMAIContext *object, guint target, GList *files
 }
 
 static gboolean
-is_compatible_scheme( const gchar *pattern, const gchar *scheme )
+is_scheme_candidate( const sMatcher *matcher, const gchar *scheme )
 {
-	gboolean compatible;
+	gboolean match;
+	guint i;
 
-	compatible = FALSE;
+	match = FALSE;
 
-	if( strcmp( pattern, "*" ) == 0 ){
-		compatible = TRUE;
-	} else {
-		compatible = ( strcmp( pattern, scheme ) == 0 );
+	for( i = 0 ; i < matcher->schemes->positives_count && !match ; ++i ){
+		match = is_compatible_scheme( &matcher->schemes->positives[i], scheme );
 	}
+	for( i = 0 ; i < matcher->schemes->negatives_count && match ; ++i ){
+		match = !is_compatible_scheme( &matcher->schemes->negatives[i], scheme );
+	}
+
+	return( match );
+}
 
-	return( compatible );
+static gboolean
+is_compatible_scheme( const sCondition *condition, const gchar *scheme )
+{
+	return( condition->kind == CONDITION_SCHEME_ALL || !strcmp( condition->pattern, scheme ));
 }
 
 /*
  * assuming here the same sort of optimization than for schemes
  * i.e. we assume that all selected items are most probably located
  * in the same dirname
- * so we take care of only checking _distinct_ dirnames against folder
- * conditions
+ * so we only check each distinct dirname of the selection once
+ *
+ * note that all positive folders must match, while no negative folder
+ * must match
  */
 static gboolean
-is_candidate_for_folders( const FMAIContext *object, guint target, GList *files )
+is_candidate_for_folders( const sMatcher *matcher, guint target, GList *files )
 {
 	static const gchar *thisfn = "fma_icontext_is_candidate_for_folders";
 	gboolean ok = TRUE;
-	GSList *folders = fma_object_get_folders( object );
+	const FMASelectionSummary *summary;
+	GSList *it;
 
-	if( folders ){
-		if( strcmp( folders->data, "/" ) != 0 || g_slist_length( folders ) > 1 ){
-			GSList *distincts = NULL;
-			GList *it;
+	if( !matcher->all_folders ){
+		summary = fma_selected_info_get_summary( files, SELECTION_SUMMARY_DIRNAMES );
 
-			for( it = files ; it && ok ; it = it->next ){
-				gchar *dirname = fma_selected_info_get_dirname( FMA_SELECTED_INFO( it->data ));
+		for( it = summary ? summary->dirnames : NULL ; it && ok ; it = it->next ){
+			g_debug( "%s: examining new distinct selected dirname=%s", thisfn, ( const gchar * ) it->data );
+			ok = is_folder_candidate( matcher, ( const gchar * ) it->data );
+		}
 
-				if( fma_core_utils_slist_count( distincts, dirname ) == 0 ){
-					g_debug( "%s: examining new distinct selected dirname=%s", thisfn, dirname );
+		if( !ok ){
+			g_debug( "%s: object is not candidate because of Folders", thisfn );
+		}
+	}
+
+	return( ok );
+}
+
+static gboolean
+is_folder_candidate( const sMatcher *matcher, const gchar *dirname )
+{
+	gchar *dirname_utf8;
+	gboolean ok = TRUE;
+	guint i;
 
-					GSList *id;
-					gchar *dirname_utf8, *pattern_utf8;
-					const gchar *pattern;
-					gboolean match, positive;
-					gboolean has_pattern;
+	dirname_utf8 = NULL;
 
-					distincts = g_slist_prepend( distincts, g_strdup( dirname ));
-					dirname_utf8 = g_filename_to_utf8( dirname, -1, NULL, NULL, NULL );
+	if( !g_utf8_validate( dirname, -1, NULL )){
+		dirname_utf8 = g_filename_to_utf8( dirname, -1, NULL, NULL, NULL );
+		dirname = dirname_utf8 ? dirname_utf8 : "";
+	}
 
-					for( id = folders ; id && ok ; id = id->next ){
-						pattern = ( const gchar * ) id->data;
-						g_debug( "%s: examining new condition pattern=%s", thisfn, pattern );
-						positive = is_positive_assertion( pattern );
-						pattern_utf8 = g_filename_to_utf8( positive ? pattern : pattern+1, -1, NULL, NULL, NULL );
-						has_pattern = ( g_strstr_len( pattern_utf8, -1, "*" ) != NULL );
+	for( i = 0 ; i < matcher->folders->positives_count && ok ; ++i ){
+		ok = is_folder_of( &matcher->folders->positives[i], dirname );
+	}
+	for( i = 0 ; i < matcher->folders->negatives_count && ok ; ++i ){
+		ok = !is_folder_of( &matcher->folders->negatives[i], dirname );
+	}
 
-						match = ( has_pattern && g_pattern_match_simple( pattern_utf8, dirname_utf8 )) ||
-								g_str_has_prefix( dirname_utf8, pattern_utf8 );
+	g_free( dirname_utf8 );
 
-						ok &= ( match && positive ) || ( !match && !positive );
+	return( ok );
+}
 
-						g_free( pattern_utf8 );
-					}
+static gboolean
+is_folder_of( const sCondition *condition, const gchar *dirname )
+{
+	return(( condition->spec && g_pattern_match_string( condition->spec, dirname )) ||
+			g_str_has_prefix( dirname, condition->pattern ));
+}
 
-					g_free( dirname_utf8 );
-				}
+static gboolean
+is_candidate_for_capabilities( const sMatcher *matcher, guint target, GList *files )
+{
+	static const gchar *thisfn = "fma_icontext_is_candidate_for_capabilities";
+	gboolean ok = TRUE;
+	GList *it;
 
-				g_free( dirname );
-			}
+	if( matcher->capabilities->positives_count || matcher->capabilities->negatives_count ){
 
-			fma_core_utils_slist_free( distincts );
+		for( it = files ; it && ok ; it = it->next ){
+			ok = has_capabilities( matcher, FMA_SELECTED_INFO( it->data ));
 		}
 
 		if( !ok ){
-			gchar *folders_str = fma_core_utils_slist_to_text( folders );
-			g_debug( "%s: object is not candidate because Folders=%s", thisfn, folders_str );
-			g_free( folders_str );
+			g_debug( "%s: object is not candidate because of Capabilities", thisfn );
 		}
-
-		fma_core_utils_slist_free( folders );
 	}
 
 	return( ok );
 }
 
 static gboolean
-is_candidate_for_capabilities( const FMAIContext *object, guint target, GList *files )
+has_capabilities( const sMatcher *matcher, const FMASelectedInfo *info )
 {
-	static const gchar *thisfn = "fma_icontext_is_candidate_for_capabilities";
 	gboolean ok = TRUE;
-	GSList *capabilities = fma_object_get_capabilities( object );
+	guint i;
 
-	if( capabilities ){
-		GSList *ic;
-		GList *it;
-		const gchar *cap;
-		gboolean match, positive;
+	for( i = 0 ; i < matcher->capabilities->positives_count && ok ; ++i ){
+		ok = has_capability( &matcher->capabilities->positives[i], info );
+	}
+	for( i = 0 ; i < matcher->capabilities->negatives_count && ok ; ++i ){
+		ok = !has_capability( &matcher->capabilities->negatives[i], info );
+	}
 
-		for( it = files ; it && ok ; it = it->next ){
-			for( ic = capabilities ; ic && ok ; ic = ic->next ){
-				cap = ( const gchar * ) ic->data;
-				positive = is_positive_assertion( cap );
-				match = FALSE;
+	return( ok );
+}
 
-				if( !strcmp( positive ? cap : cap+1, "Owner" )){
-					match = fma_selected_info_is_owner( FMA_SELECTED_INFO( it->data ), getlogin());
+static gboolean
+has_capability( const sCondition *condition, const FMASelectedInfo *info )
+{
+	switch( condition->kind ){
+		case CONDITION_CAPABILITY_OWNER:
+			return( fma_selected_info_is_owner( info, getlogin()));
 
-				} else if( !strcmp( positive ? cap : cap+1, "Readable" )){
-					match = fma_selected_info_is_readable( FMA_SELECTED_INFO( it->data ));
+		case CONDITION_CAPABILITY_READABLE:
+			return( fma_selected_info_is_readable( info ));
 
-				} else if( !strcmp( positive ? cap : cap+1, "Writable" )){
-					match = fma_selected_info_is_writable( FMA_SELECTED_INFO( it->data ));
+		case CONDITION_CAPABILITY_WRITABLE:
+			return( fma_selected_info_is_writable( info ));
 
-				} else if( !strcmp( positive ? cap : cap+1, "Executable" )){
-					match = fma_selected_info_is_executable( FMA_SELECTED_INFO( it->data ));
+		case CONDITION_CAPABILITY_EXECUTABLE:
+			return( fma_selected_info_is_executable( info ));
 
-				} else if( !strcmp( positive ? cap : cap+1, "Local" )){
-					match = fma_selected_info_is_local( FMA_SELECTED_INFO( it->data ));
+		case CONDITION_CAPABILITY_LOCAL:
+			return( fma_selected_info_is_local( info ));
 
-				} else {
-					g_warning( "%s: unknown capability %s", thisfn, cap );
-				}
+		default:
+			break;
+	}
+
+	return( FALSE );
+}
+
+/*
+ * returns the ids of the files of the selection in the current view, or
+ * NULL if the per-file results of this selection are not to be kept
+ *
+ * a file is identified by its URI and its mimetype; its id is only
+ * valid in the view it has been interned in, which is returned in @view
+ *
+ * the ids are interned once per registered selection and per view, and
+ * kept with the summary of the selection; at most MATCHER_FILES_MAX
+ * files are interned per view, the next ones getting a zero id, so that
+ * their results are not recorded
+ */
+static const guint *
+view_get_file_ids( GList *files, guint *view )
+{
+	FMASelectionSummary *summary;
+	const gchar *uri, *mimetype;
+	GString *key;
+	guint i, id;
+	GList *it;
+
+	summary = ( FMASelectionSummary * ) fma_selected_info_get_summary( files, SELECTION_SUMMARY_COUNT );
 
-				ok &= (( positive && match ) || ( !positive && !match ));
+	if( !summary || !summary->registered || summary->count > MATCHER_FILES_MAX ){
+		return( NULL );
+	}
+
+	G_LOCK( st_checks );
+
+	if( !summary->file_ids || summary->file_ids_view != st_view ){
+		if( !st_view_files ){
+			st_view_files = g_hash_table_new_full( g_str_hash, g_str_equal, g_free, NULL );
+		}
+		g_free( summary->file_ids );
+		summary->file_ids = g_new( guint, summary->count );
+		key = g_string_new( "" );
+
+		for( it = files, i = 0 ; it ; it = it->next, ++i ){
+			id = 0;
+			uri = fma_selected_info_peek_uri( FMA_SELECTED_INFO( it->data ));
+			if( uri ){
+				mimetype = fma_selected_info_peek_mime_type( FMA_SELECTED_INFO( it->data ));
+				g_string_printf( key, "%s\n%s", uri, mimetype ? mimetype : "" );
+				id = GPOINTER_TO_UINT( g_hash_table_lookup( st_view_files, key->str ));
+				if( !id && g_hash_table_size( st_view_files ) < MATCHER_FILES_MAX ){
+					id = g_hash_table_size( st_view_files )+1;
+					g_hash_table_insert( st_view_files, g_strdup( key->str ), GUINT_TO_POINTER( id ));
+				}
 			}
+			summary->file_ids[i] = id;
 		}
 
-		if( !ok ){
-			gchar *capabilities_str = fma_core_utils_slist_to_text( capabilities );
-			g_debug( "%s: object is not candidate because Capabilities=%s", thisfn, capabilities_str );
-			g_free( capabilities_str );
+		g_string_free( key, TRUE );
+		summary->file_ids_view = st_view;
+	}
+
+	*view = summary->file_ids_view;
+
+	G_UNLOCK( st_checks );
+
+	return( summary->file_ids );
+}
+
+/*
+ * returns a new reference on the matcher of the context
+ *
+ * the matcher is usually compiled when the context is read, but contexts
+ * which have not been read from an i/o provider, or which have been
+ * modified since, have their matcher compiled on first use
+ */
+static sMatcher *
+context_get_matcher( const FMAIContext *context )
+{
+	sMatcher *matcher;
+
+	G_LOCK( st_matchers );
+	matcher = g_object_get_data( G_OBJECT( context ), ICONTEXT_MATCHER );
+	if( !matcher ){
+		matcher = matcher_new( context );
+		g_object_set_data_full( G_OBJECT( context ), ICONTEXT_MATCHER, matcher, ( GDestroyNotify ) matcher_unref );
+	}
+	matcher_ref( matcher );
+	G_UNLOCK( st_matchers );
+
+	return( matcher );
+}
+
+/*
+ * attaches the matcher to the context, taking ownership of the given
+ * reference, and releasing the previous one
+ */
+static void
+context_set_matcher( const FMAIContext *context, sMatcher *matcher )
+{
+	G_LOCK( st_matchers );
+	if( matcher ){
+		g_object_set_data_full( G_OBJECT( context ), ICONTEXT_MATCHER, matcher, ( GDestroyNotify ) matcher_unref );
+	} else {
+		g_object_set_data( G_OBJECT( context ), ICONTEXT_MATCHER, NULL );
+	}
+	G_UNLOCK( st_matchers );
+}
+
+/*
+ * the matcher is compiled once from the conditions of a context, and
+ * is then shared by the duplicates of this context, until one of the
+ * compiled conditions is modified
+ */
+static sMatcher *
+matcher_new( const FMAIContext *context )
+{
+	sMatcher *matcher;
+	const GSList *list;
+	const gchar *str;
+	guint i;
+
+	matcher = g_new0( sMatcher, 1 );
+	matcher->ref_count = 1;
+	g_mutex_init( &matcher->files_mutex );
+
+	matcher->all_mimetypes = fma_object_get_all_mimetypes( context );
+	if( !matcher->all_mimetypes ){
+		list = fma_object_peek_mimetypes( context );
+		matcher->mimetypes = matcher_get_set( list, matcher, matcher_compile_mimetype );
+	}
+
+	matcher->matchcase = fma_object_get_matchcase( context );
+	list = fma_object_peek_basenames( context );
+	matcher->all_basenames = !list || ( !strcmp( list->data, "*" ) && !list->next );
+	if( !matcher->all_basenames ){
+		matcher->basenames = matcher_get_set( list, matcher, matcher_compile_basename );
+	}
+
+	list = fma_object_peek_schemes( context );
+	matcher->all_schemes = !list || ( !strcmp( list->data, "*" ) && !list->next );
+	if( !matcher->all_schemes ){
+		matcher->schemes = matcher_get_set( list, matcher, matcher_compile_scheme );
+	}
+
+	list = fma_object_peek_folders( context );
+	matcher->all_folders = !list || ( !strcmp( list->data, "/" ) && !list->next );
+	if( !matcher->all_folders ){
+		matcher->folders = matcher_get_set( list, matcher, matcher_compile_folder );
+	}
+
+	list = fma_object_peek_capabilities( context );
+	matcher->capabilities = matcher_get_set( list, matcher, matcher_compile_capability );
+
+	/* an unknown operator is kept as is so that the condition fails
+	 */
+	str = fma_object_peek_selection_count( context );
+	if( str && strlen( str )){
+		matcher->count_ope = str[0];
+		matcher->count_limit = atoi( str+1 );
+	}
+
+	for( i = 0 ; i < CHECK_N ; ++i ){
+		matcher->order[i] = i;
+	}
+	matcher_order_checks( matcher );
+
+	return( matcher );
+}
+
+static sMatcher *
+matcher_ref( sMatcher *matcher )
+{
+	g_atomic_int_inc( &matcher->ref_count );
+
+	return( matcher );
+}
+
+static void
+matcher_unref( sMatcher *matcher )
+{
+	if( matcher && g_atomic_int_dec_and_test( &matcher->ref_count )){
+		matcher_unref_set( matcher->mimetypes );
+		matcher_unref_set( matcher->basenames );
+		matcher_unref_set( matcher->schemes );
+		matcher_unref_set( matcher->folders );
+		matcher_unref_set( matcher->capabilities );
+		if( matcher->files ){
+			g_hash_table_destroy( matcher->files );
 		}
+		g_mutex_clear( &matcher->files_mutex );
+		g_free( matcher );
+	}
+}
+
+/*
+ * sort the checks by cost class, and then by decreasing rejection rate
+ * as observed on this context
+ *
+ * the sort is stable, so that the initial order is kept for equivalent
+ * checks
+ */
+static void
+matcher_order_checks( sMatcher *matcher )
+{
+	guint i, j;
+	guint8 check;
 
-		fma_core_utils_slist_free( capabilities );
+	for( i = 1 ; i < CHECK_N ; ++i ){
+		check = matcher->order[i];
+		for( j = i ; j > 0 && matcher_cmp_checks( matcher, matcher->order[j-1], check ) > 0 ; --j ){
+			matcher->order[j] = matcher->order[j-1];
+		}
+		matcher->order[j] = check;
 	}
+}
 
-	return( ok );
+/*
+ * the rejection rate is estimated as ( rejections+1 )/( evaluations+2 ),
+ * so that a check which has never been evaluated is not considered as
+ * never rejecting
+ */
+static gint
+matcher_cmp_checks( const sMatcher *matcher, guint a, guint b )
+{
+	gdouble rate_a, rate_b;
+
+	if( st_checks[a].cost != st_checks[b].cost ){
+		return( st_checks[a].cost < st_checks[b].cost ? -1 : 1 );
+	}
+
+	rate_a = ( matcher->rejections[a] + 1.0 ) / ( matcher->evaluations[a] + 2.0 );
+	rate_b = ( matcher->rejections[b] + 1.0 ) / ( matcher->evaluations[b] + 2.0 );
+
+	return( rate_a > rate_b ? -1 : ( rate_a < rate_b ? 1 : 0 ));
+}
+
+/*
+ * whether the per-file results of this check are worth being cached,
+ * i.e. whether the check actually depends on each selected file
+ *
+ * the schemes, folders and mimetypes are rather checked once per
+ * distinct value of the selection summary
+ *
+ * the capabilities are never cached, as the attributes of a file may
+ * change while staying in the same view (see fma_icontext_is_dynamic())
+ */
+static gboolean
+matcher_caches_check( const sMatcher *matcher, guint check )
+{
+	switch( check ){
+		case CHECK_BASENAMES:
+			return( !matcher->all_basenames );
+	}
+
+	return( FALSE );
+}
+
+/*
+ * discards the per-file results which have been computed in another
+ * view, as the capabilities of the files may have changed since, and
+ * the ids of the files have been reset
+ *
+ * must be called with the lock of the matcher held
+ */
+static void
+matcher_files_set_view( sMatcher *matcher, guint view )
+{
+	if( matcher->files_view != view ){
+		if( matcher->files ){
+			g_hash_table_remove_all( matcher->files );
+		}
+		matcher->files_view = view;
+	}
+}
+
+/*
+ * returns the per-file results known for this file, or zero
+ * a zero id identifies a file without URI, which is never recorded
+ *
+ * must be called with the lock of the matcher held
+ */
+static guint
+matcher_files_lookup( const sMatcher *matcher, guint id )
+{
+	if( !matcher->files || !id ){
+		return( 0 );
+	}
+
+	return( GPOINTER_TO_UINT( g_hash_table_lookup( matcher->files, GUINT_TO_POINTER( id ))));
+}
+
+/*
+ * adds these per-file results to the ones already known for this file
+ *
+ * new files are no more recorded once the table is full: they will
+ * just be evaluated again
+ *
+ * must be called with the lock of the matcher held
+ */
+static void
+matcher_files_store( sMatcher *matcher, guint id, guint bits )
+{
+	if( !id ){
+		return;
+	}
+
+	if( !matcher->files ){
+		matcher->files = g_hash_table_new( g_direct_hash, g_direct_equal );
+	}
+
+	if( !g_hash_table_contains( matcher->files, GUINT_TO_POINTER( id )) &&
+			g_hash_table_size( matcher->files ) >= MATCHER_FILES_MAX ){
+		return;
+	}
+
+	bits |= matcher_files_lookup( matcher, id );
+	g_hash_table_insert( matcher->files, GUINT_TO_POINTER( id ), GUINT_TO_POINTER( bits ));
+}
+
+/*
+ * returns the set compiled from this list of assertions
+ *
+ * interned lists being shared by all identical conditions, the compiled
+ * set is looked up on the address of the list, and only compiled once
+ */
+static sConditionSet *
+matcher_get_set( const GSList *list, const sMatcher *matcher, CompileFn fn )
+{
+	sConditionSet key;
+	sConditionSet *set;
+
+	memset( &key, '\0', sizeof( sConditionSet ));
+	key.list = list;
+	key.fn = ( gpointer ) fn;
+	key.matchcase = ( fn == matcher_compile_basename ) ? matcher->matchcase : FALSE;
+
+	if( !fma_boxed_interned_list_ref( list )){
+		set = g_new0( sConditionSet, 1 );
+		set->ref_count = 1;
+		matcher_compile_set( set, list, matcher, fn );
+		return( set );
+	}
+
+	G_LOCK( st_shared_sets );
+
+	if( !st_shared_sets ){
+		st_shared_sets = g_hash_table_new( matcher_shared_set_hash, matcher_shared_set_equal );
+	}
+
+	set = g_hash_table_lookup( st_shared_sets, &key );
+
+	if( set ){
+		set->ref_count += 1;
+
+	} else {
+		set = g_new0( sConditionSet, 1 );
+		*set = key;
+		set->ref_count = 1;
+		matcher_compile_set( set, list, matcher, fn );
+		g_hash_table_insert( st_shared_sets, set, set );
+		list = NULL;
+	}
+
+	G_UNLOCK( st_shared_sets );
+
+	/* the shared set already holds its own reference on the list
+	 */
+	if( list ){
+		fma_boxed_interned_list_unref( list );
+	}
+
+	return( set );
+}
+
+static void
+matcher_unref_set( sConditionSet *set )
+{
+	gboolean last;
+
+	if( !set ){
+		return;
+	}
+
+	if( set->list ){
+		G_LOCK( st_shared_sets );
+		set->ref_count -= 1;
+		last = ( set->ref_count == 0 );
+		if( last ){
+			g_hash_table_remove( st_shared_sets, set );
+		}
+		G_UNLOCK( st_shared_sets );
+
+	} else {
+		last = TRUE;
+	}
+
+	if( last ){
+		matcher_free_set( set );
+		if( set->list ){
+			fma_boxed_interned_list_unref( set->list );
+		}
+		g_free( set );
+	}
+}
+
+static guint
+matcher_shared_set_hash( gconstpointer set )
+{
+	const sConditionSet *s = ( const sConditionSet * ) set;
+
+	return( g_direct_hash( s->list ) ^ g_direct_hash( s->fn ) ^ s->matchcase );
+}
+
+static gboolean
+matcher_shared_set_equal( gconstpointer a, gconstpointer b )
+{
+	const sConditionSet *sa = ( const sConditionSet * ) a;
+	const sConditionSet *sb = ( const sConditionSet * ) b;
+
+	return( sa->list == sb->list && sa->fn == sb->fn && sa->matchcase == sb->matchcase );
+}
+
+/*
+ * split the list of assertions between positive and negative ones,
+ * compiling each of them with the provided function
+ */
+static void
+matcher_compile_set( sConditionSet *set, const GSList *list, const sMatcher *matcher, CompileFn fn )
+{
+	const GSList *it;
+	gchar *assertion;
+	sCondition *condition;
+	guint count;
+
+	count = g_slist_length(( GSList * ) list );
+	set->positives = g_new0( sCondition, count );
+	set->negatives = g_new0( sCondition, count );
+
+	for( it = list ; it ; it = it->next ){
+		assertion = g_strstrip( g_strdup(( const gchar * ) it->data ));
+
+		if( assertion[0] == '!' ){
+			condition = &set->negatives[ set->negatives_count++ ];
+			condition->pattern = g_strdup( assertion+1 );
+		} else {
+			condition = &set->positives[ set->positives_count++ ];
+			condition->pattern = g_strdup( assertion );
+		}
+
+		fn( condition, matcher );
+		g_free( assertion );
+	}
+}
+
+static void
+matcher_free_set( sConditionSet *set )
+{
+	guint i;
+
+	for( i = 0 ; i < set->positives_count ; ++i ){
+		matcher_free_condition( &set->positives[i] );
+	}
+	for( i = 0 ; i < set->negatives_count ; ++i ){
+		matcher_free_condition( &set->negatives[i] );
+	}
+
+	g_free( set->positives );
+	g_free( set->negatives );
+}
+
+static void
+matcher_free_condition( sCondition *condition )
+{
+	g_free( condition->pattern );
+	g_free( condition->content_type );
+	if( condition->spec ){
+		g_pattern_spec_free( condition->spec );
+	}
+}
+
+static void
+matcher_compile_mimetype( sCondition *condition, const sMatcher *matcher )
+{
+	if( is_all_mimetype( condition->pattern )){
+		condition->kind = CONDITION_MIMETYPE_ALL;
+
+	} else if( is_file_mimetype( condition->pattern )){
+		condition->kind = CONDITION_MIMETYPE_ALLFILES;
+
+	} else {
+		condition->kind = CONDITION_MIMETYPE_TYPE;
+		condition->content_type = g_content_type_from_mime_type( condition->pattern );
+	}
+}
+
+static void
+matcher_compile_basename( sCondition *condition, const sMatcher *matcher )
+{
+	gchar *pattern_utf8, *tmp;
+
+	pattern_utf8 = g_filename_to_utf8( condition->pattern, -1, NULL, NULL, NULL );
+	if( !pattern_utf8 ){
+		pattern_utf8 = g_strdup( condition->pattern );
+	}
+	if( !matcher->matchcase ){
+		tmp = g_utf8_strdown( pattern_utf8, -1 );
+		g_free( pattern_utf8 );
+		pattern_utf8 = tmp;
+	}
+
+	condition->spec = g_pattern_spec_new( pattern_utf8 );
+	g_free( condition->pattern );
+	condition->pattern = pattern_utf8;
+}
+
+static void
+matcher_compile_scheme( sCondition *condition, const sMatcher *matcher )
+{
+	condition->kind = strcmp( condition->pattern, "*" ) ? CONDITION_NONE : CONDITION_SCHEME_ALL;
+}
+
+static void
+matcher_compile_folder( sCondition *condition, const sMatcher *matcher )
+{
+	gchar *pattern_utf8;
+
+	pattern_utf8 = g_filename_to_utf8( condition->pattern, -1, NULL, NULL, NULL );
+	if( pattern_utf8 ){
+		g_free( condition->pattern );
+		condition->pattern = pattern_utf8;
+	}
+
+	if( strchr( condition->pattern, '*' )){
+		condition->spec = g_pattern_spec_new( condition->pattern );
+	}
+}
+
+static void
+matcher_compile_capability( sCondition *condition, const sMatcher *matcher )
+{
+	static const gchar *thisfn = "fma_icontext_matcher_compile_capability";
+
+	if( !strcmp( condition->pattern, "Owner" )){
+		condition->kind = CONDITION_CAPABILITY_OWNER;
+
+	} else if( !strcmp( condition->pattern, "Readable" )){
+		condition->kind = CONDITION_CAPABILITY_READABLE;
+
+	} else if( !strcmp( condition->pattern, "Writable" )){
+		condition->kind = CONDITION_CAPABILITY_WRITABLE;
+
+	} else if( !strcmp( condition->pattern, "Executable" )){
+		condition->kind = CONDITION_CAPABILITY_EXECUTABLE;
+
+	} else if( !strcmp( condition->pattern, "Local" )){
+		condition->kind = CONDITION_CAPABILITY_LOCAL;
+
+	} else {
+		g_warning( "%s: unknown capability %s", thisfn, condition->pattern );
+	}
 }
 
 static gboolean
 is_valid_basenames( const FMAIContext *object )
 {
 	gboolean valid;
-	GSList *basenames;
+	const GSList *basenames;
 
-	basenames = fma_object_get_basenames( object );
-	valid = basenames && g_slist_length( basenames ) > 0;
-	fma_core_utils_slist_free( basenames );
+	basenames = fma_object_peek_basenames( object );
+	valid = basenames != NULL;
 
 	if( !valid ){
 		fma_object_debug_invalid( object, "basenames" );
@@ -1170,11 +2216,11 @@ is_valid_mimetypes( const FMAIContext *object )
 {
 	static const gchar *thisfn = "fma_icontext_is_valid_mimetypes";
 	gboolean valid;
-	GSList *mimetypes, *it;
+	const GSList *mimetypes, *it;
 	guint count_ok, count_errs;
 	const gchar *imtype;
 
-	mimetypes = fma_object_get_mimetypes( object );
+	mimetypes = fma_object_peek_mimetypes( object );
 	count_ok = 0;
 	count_errs = 0;
 
@@ -1210,8 +2256,6 @@ is_valid_mimetypes( const FMAIContext *object )
 		fma_object_debug_invalid( object, "mimetypes" );
 	}
 
-	fma_core_utils_slist_free( mimetypes );
-
 	return( valid );
 }
 
@@ -1219,11 +2263,10 @@ static gboolean
 is_valid_schemes( const FMAIContext *object )
 {
 	gboolean valid;
-	GSList *schemes;
+	const GSList *schemes;
 
-	schemes = fma_object_get_schemes( object );
-	valid = schemes && g_slist_length( schemes ) > 0;
-	fma_core_utils_slist_free( schemes );
+	schemes = fma_object_peek_schemes( object );
+	valid = schemes != NULL;
 
 	if( !valid ){
 		fma_object_debug_invalid( object, "schemes" );
@@ -1236,11 +2279,10 @@ static gboolean
 is_valid_folders( const FMAIContext *object )
 {
 	gboolean valid;
-	GSList *folders;
+	const GSList *folders;
 
-	folders = fma_object_get_folders( object );
-	valid = folders && g_slist_length( folders ) > 0;
-	fma_core_utils_slist_free( folders );
+	folders = fma_object_peek_folders( object );
+	valid = folders != NULL;
 
 	if( !valid ){
 		fma_object_debug_invalid( object, "folders" );
@@ -1248,24 +2290,3 @@ is_valid_folders( const FMAIContext *object )
 
 	return( valid );
 }
-
-/*
- * "image/ *" is a positive assertion
- * "!image/jpeg" is a negative one
- */
-static gboolean
-is_positive_assertion( const gchar *assertion )
-{
-	gboolean positive = TRUE;
-
-	if( assertion ){
-		gchar *dupped = g_strdup( assertion );
-		const gchar *stripped = g_strstrip( dupped );
-		if( stripped ){
-			positive = ( stripped[0] != '!' );
-		}
-		g_free( dupped );
-	}
-
-	return( positive );
-}
@@ -31,8 +31,6 @@
 #include <config.h>
 #endif
 
-#include <string.h>
-
 #include <api/fma-ifactory-object.h>
 
 #include "fma-factory-object.h"
@@ -155,23 +153,9 @@ ifactory_object_get_version( const FMAIFactoryObject *instance )
 FMADataBoxed *
 fma_ifactory_object_get_data_boxed( const FMAIFactoryObject *object, const gchar *name )
 {
-	GList *list, *ip;
-
 	g_return_val_if_fail( FMA_IS_IFACTORY_OBJECT( object ), NULL );
 
-	list = g_object_get_data( G_OBJECT( object ), FMA_IFACTORY_OBJECT_PROP_DATA );
-	/*g_debug( "list=%p (count=%u)", ( void * ) list, g_list_length( list ));*/
-
-	for( ip = list ; ip ; ip = ip->next ){
-		FMADataBoxed *boxed = FMA_DATA_BOXED( ip->data );
-		const FMADataDef *def = fma_data_boxed_get_data_def( boxed );
-
-		if( !strcmp( def->name, name )){
-			return( boxed );
-		}
-	}
-
-	return( NULL );
+	return( fma_factory_object_get_data_boxed( object, name ));
 }
 
 /**
@@ -223,6 +207,29 @@ fma_ifactory_object_get_as_void( const FMAIFactoryObject *object, const gchar *n
 	return( fma_factory_object_get_as_void( object, name ));
 }
 
+/**
+ * fma_ifactory_object_peek:
+ * @object: this #FMAIFactoryObject instance.
+ * @name: the elementary data whose value is to be got.
+ *
+ * This is the borrowing counterpart of fma_ifactory_object_get_as_void():
+ * strings and lists are returned as they are stored in @object, without
+ * being copied.
+ *
+ * Returns: the searched value, which is owned by @object and should not
+ * be modified nor released by the caller. It is only valid until this
+ * same elementary data be set again, or @object be finalized.
+ *
+ * Since: 3.5
+ */
+gconstpointer
+fma_ifactory_object_peek( const FMAIFactoryObject *object, const gchar *name )
+{
+	g_return_val_if_fail( FMA_IS_IFACTORY_OBJECT( object ), NULL );
+
+	return( fma_factory_object_peek( object, name ));
+}
+
 /**
  * fma_ifactory_object_set_from_void:
  * @object: this #FMAIFactoryObject instance.
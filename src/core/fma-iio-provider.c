@@ -45,6 +45,7 @@ struct _FMAIIOProviderInterfacePrivate {
  */
 enum {
 	ITEM_CHANGED,
+	PATHS_CHANGED,
 	LAST_SIGNAL
 };
 
@@ -126,6 +127,9 @@ interface_base_init( FMAIIOProviderInterface *klass )
 		klass->write_item = NULL;
 		klass->delete_item = NULL;
 		klass->duplicate_data = NULL;
+		klass->get_sources = NULL;
+		klass->read_item_from_path = NULL;
+		klass->is_able_to_read_concurrently = NULL;
 
 		/**
 		 * FMAIIOProvider::io-provider-item-changed:
@@ -150,6 +154,34 @@ interface_base_init( FMAIIOProviderInterface *klass )
 					g_cclosure_marshal_VOID__VOID,
 					G_TYPE_NONE,
 					0 );
+
+		/**
+		 * FMAIIOProvider::io-provider-paths-changed:
+		 * @provider: the #FMAIIOProvider which has called the
+		 *  fma_iio_provider_paths_changed() function.
+		 * @paths: the #GSList list of changed paths.
+		 *
+		 * This signal is registered without any default handler.
+		 *
+		 * This signal is not meant to be directly sent by a plugin.
+		 * Instead, the plugin should call the fma_iio_provider_paths_changed()
+		 * function.
+		 *
+		 * See also fma_iio_provider_paths_changed().
+		 *
+		 * Since: 3.5
+		 */
+		st_signals[ PATHS_CHANGED ] = g_signal_new(
+					IO_PROVIDER_SIGNAL_PATHS_CHANGED,
+					FMA_TYPE_IIO_PROVIDER,
+					G_SIGNAL_RUN_LAST | G_SIGNAL_ACTION,
+					0,									/* class offset */
+					NULL,								/* accumulator */
+					NULL,								/* accumulator data */
+					g_cclosure_marshal_VOID__POINTER,
+					G_TYPE_NONE,
+					1,
+					G_TYPE_POINTER );
 	}
 
 	st_initializations += 1;
@@ -216,3 +248,32 @@ fma_iio_provider_item_changed( const FMAIIOProvider *instance )
 
 	g_signal_emit_by_name(( gpointer ) instance, IO_PROVIDER_SIGNAL_ITEM_CHANGED );
 }
+
+/**
+ * fma_iio_provider_paths_changed:
+ * @instance: the calling #FMAIIOProvider.
+ * @paths: a #GSList list of the paths which have been modified,
+ *  created or deleted.
+ *
+ * Informs &prodname; that this #FMAIIOProvider @instance has detected
+ * a modification on the given @paths.
+ *
+ * This is a more precise version of fma_iio_provider_item_changed():
+ * if the I/O provider implements the read_item_from_path() method,
+ * the currently running program may choose to only re-read the items
+ * the @paths refer to, instead of reloading the whole list of items.
+ *
+ * The @paths list is not modified, and stays owned by the caller.
+ *
+ * Since: 3.5
+ */
+void
+fma_iio_provider_paths_changed( const FMAIIOProvider *instance, GSList *paths )
+{
+	static const gchar *thisfn = "fma_iio_provider_paths_changed";
+
+	g_debug( "%s: instance=%p, paths=%p (count=%d)",
+			thisfn, ( void * ) instance, ( void * ) paths, g_slist_length( paths ));
+
+	g_signal_emit_by_name(( gpointer ) instance, IO_PROVIDER_SIGNAL_PATHS_CHANGED, paths );
+}
@@ -37,6 +37,7 @@
 #include <api/fma-iio-provider.h>
 #include <api/fma-object-api.h>
 #include <api/fma-core-utils.h>
+#include <api/fma-worker-pool.h>
 
 #include "fma-iprefs.h"
 #include "fma-io-provider.h"
@@ -54,6 +55,7 @@ struct _FMAIOProviderPrivate {
 	gchar          *id;
 	FMAIIOProvider *provider;
 	gulong          item_changed_handler;
+	gulong          paths_changed_handler;
 	gboolean        writable;
 	guint           reason;
 };
@@ -66,6 +68,16 @@ enum {
 
 #define IO_PROVIDER_PROP_ID				"fma-io-provider-prop-id"
 
+/* reading the items of an i/o provider, maybe concurrently with others
+ */
+typedef struct {
+	const FMAIOProvider *provider;
+	gboolean             concurrent;
+	GList               *items;
+	GSList              *messages;
+}
+	sReadTask;
+
 static const gchar   *st_enter_bug    = N_( "Please, be kind enough to fill out a bug report on "
 											"https://gitlab.gnome.org/GNOME/filemanager-actions/issues." );
 
@@ -97,10 +109,16 @@ static gboolean       is_finally_writable( const FMAIOProvider *provider, const
 static GList         *load_items_filter_unwanted_items( const FMAPivot *pivot, GList *merged, guint loadable_set );
 static GList         *load_items_filter_unwanted_items_rec( GList *merged, guint loadable_set );
 static GList         *load_items_get_merged_list( const FMAPivot *pivot, guint loadable_set, GSList **messages );
-static GList         *load_items_hierarchy_build( GList **tree, GSList *level_zero, gboolean list_if_empty, FMAObjectItem *parent );
+static void           load_items_read_provider( sReadTask *task, void *empty );
+static GList         *load_items_hierarchy_build( GList **tree, GHashTable *index, GSList *level_zero, gboolean list_if_empty, FMAObjectItem *parent );
+static GHashTable    *load_items_hierarchy_index( GList *tree );
 static GList         *load_items_hierarchy_sort( const FMAPivot *pivot, GList *tree, GCompareFunc fn );
 static gint           peek_item_by_id_compare( const FMAObject *obj, const gchar *id );
 static FMAIOProvider *peek_provider_by_id( const GList *providers, const gchar *id );
+static FMAIOProvider *peek_provider_by_module( const GList *providers, const FMAIIOProvider *module );
+static gboolean       update_items_has_other_readers( const FMAPivot *pivot, const FMAIOProvider *provider );
+static gboolean       update_items_replace( const FMAIOProvider *provider, guint loadable_set, GList **tree, const gchar *id, FMAObjectItem *item, gboolean alone, GList **levels );
+static GList         *update_items_find_link( GList *items, const gchar *id, FMAObjectItem *parent, FMAObjectItem **found_parent );
 
 GType
 fma_io_provider_get_type( void )
@@ -186,6 +204,7 @@ instance_init( GTypeInstance *instance, gpointer klass )
 	self->private->id = NULL;
 	self->private->provider = NULL;
 	self->private->item_changed_handler = 0;
+	self->private->paths_changed_handler = 0;
 	self->private->writable = FALSE;
 	self->private->reason = IIO_PROVIDER_STATUS_UNAVAILABLE;
 }
@@ -275,6 +294,9 @@ instance_dispose( GObject *object )
 			if( g_signal_handler_is_connected( self->private->provider, self->private->item_changed_handler )){
 				g_signal_handler_disconnect( self->private->provider, self->private->item_changed_handler );
 			}
+			if( g_signal_handler_is_connected( self->private->provider, self->private->paths_changed_handler )){
+				g_signal_handler_disconnect( self->private->provider, self->private->paths_changed_handler );
+			}
 			g_object_unref( self->private->provider );
 		}
 
@@ -562,6 +584,21 @@ io_providers_list_append_object( const FMAPivot *pivot, GList *list, FMAIIOProvi
 	return( merged );
 }
 
+static FMAIOProvider *
+peek_provider_by_module( const GList *providers, const FMAIIOProvider *module )
+{
+	FMAIOProvider *provider = NULL;
+	const GList *ip;
+
+	for( ip = providers ; ip && !provider ; ip = ip->next ){
+		if( FMA_IO_PROVIDER( ip->data )->private->provider == module ){
+			provider = FMA_IO_PROVIDER( ip->data );
+		}
+	}
+
+	return( provider );
+}
+
 static FMAIOProvider *
 peek_provider_by_id( const GList *providers, const gchar *id )
 {
@@ -601,7 +638,8 @@ io_provider_new( const FMAPivot *pivot, FMAIIOProvider *module, const gchar *id
 
 /*
  * when a IIOProvider plugin is associated with the FMAIOProvider object,
- * we connect the FMAPivot callback to the 'item-changed' signal
+ * we connect the FMAPivot callbacks to the 'item-changed' and
+ * 'paths-changed' signals
  */
 static void
 io_providers_list_set_module( const FMAPivot *pivot, FMAIOProvider *provider_object, FMAIIOProvider *provider_module )
@@ -613,6 +651,11 @@ io_providers_list_set_module( const FMAPivot *pivot, FMAIOProvider *provider_obj
 					provider_module, IO_PROVIDER_SIGNAL_ITEM_CHANGED,
 					( GCallback ) fma_pivot_on_item_changed_handler, ( gpointer ) pivot );
 
+	provider_object->private->paths_changed_handler =
+			g_signal_connect(
+					provider_module, IO_PROVIDER_SIGNAL_PATHS_CHANGED,
+					( GCallback ) fma_pivot_on_paths_changed_handler, ( gpointer ) pivot );
+
 	provider_object->private->writable =
 			is_finally_writable( provider_object, pivot, &provider_object->private->reason );
 
@@ -852,6 +895,7 @@ fma_io_provider_load_items( const FMAPivot *pivot, guint loadable_set, GSList **
 	static const gchar *thisfn = "fma_io_provider_load_items";
 	GList *flat, *hierarchy, *filtered;
 	GSList *level_zero;
+	GHashTable *index;
 	guint order_mode;
 
 	g_return_val_if_fail( FMA_IS_PIVOT( pivot ), NULL );
@@ -868,7 +912,9 @@ fma_io_provider_load_items( const FMAPivot *pivot, guint loadable_set, GSList **
 	 */
 	level_zero = fma_settings_get_string_list( IPREFS_ITEMS_LEVEL_ZERO_ORDER, NULL, NULL );
 
-	hierarchy = load_items_hierarchy_build( &flat, level_zero, TRUE, NULL );
+	index = load_items_hierarchy_index( flat );
+	hierarchy = load_items_hierarchy_build( &flat, index, level_zero, TRUE, NULL );
+	g_hash_table_destroy( index );
 
 	/* items that stay left in the global flat list are simply appended
 	 * to the built hierarchy, and level zero is updated accordingly
@@ -916,6 +962,312 @@ fma_io_provider_load_items( const FMAPivot *pivot, guint loadable_set, GSList **
 	return( filtered );
 }
 
+/*
+ * fma_io_provider_get_sources:
+ * @pivot: the #FMAPivot object which owns the list of registered i/o
+ *  storage providers.
+ * @sources: [out]: a pointer to a #GSList which will be set to the list
+ *  of the paths the readable i/o providers read their items from; this
+ *  list should be fma_core_utils_slist_free() by the caller.
+ *
+ * Returns: %TRUE if each available and readable i/o provider has been
+ * able to list its sources, %FALSE else; in this later case, @sources
+ * is set to %NULL.
+ */
+gboolean
+fma_io_provider_get_sources( const FMAPivot *pivot, GSList **sources )
+{
+	static const gchar *thisfn = "fma_io_provider_get_sources";
+	const GList *providers, *ip;
+	const FMAIOProvider *provider_object;
+	const FMAIIOProvider *provider_module;
+	gboolean ok;
+
+	g_return_val_if_fail( FMA_IS_PIVOT( pivot ), FALSE );
+	g_return_val_if_fail( sources, FALSE );
+
+	ok = TRUE;
+	*sources = NULL;
+	providers = fma_io_provider_get_io_providers_list( pivot );
+
+	for( ip = providers ; ip && ok ; ip = ip->next ){
+		provider_object = FMA_IO_PROVIDER( ip->data );
+		provider_module = provider_object->private->provider;
+
+		if( provider_module &&
+			FMA_IIO_PROVIDER_GET_INTERFACE( provider_module )->read_items &&
+			fma_io_provider_is_conf_readable( provider_object, pivot, NULL )){
+
+			if( FMA_IIO_PROVIDER_GET_INTERFACE( provider_module )->get_sources ){
+				*sources = g_slist_concat( *sources,
+						FMA_IIO_PROVIDER_GET_INTERFACE( provider_module )->get_sources( provider_module ));
+
+			} else {
+				g_debug( "%s: %s: unable to list its sources", thisfn, provider_object->private->id );
+				ok = FALSE;
+			}
+		}
+	}
+
+	if( !ok ){
+		fma_core_utils_slist_free( *sources );
+		*sources = NULL;
+	}
+
+	return( ok );
+}
+
+/*
+ * fma_io_provider_update_items:
+ * @pivot: the #FMAPivot object which owns the list of registered i/o
+ *  storage providers.
+ * @loadable_set: the population of items to be loaded.
+ * @tree: [in/out]: the current tree of items, as returned by
+ *  fma_io_provider_load_items().
+ * @module: the #FMAIIOProvider which has reported the changes.
+ * @paths: the #GSList list of the changed paths.
+ * @messages: error messages.
+ *
+ * Only re-reads the items the changed @paths refer to, replacing them in
+ * the @tree or removing them from it, then re-sorts the levels of the
+ * @tree which have been modified.
+ *
+ * Menus, as well as new items, may change the whole hierarchy: they are
+ * not handled here.
+ *
+ * Returns: %TRUE if the @tree has been updated, or %FALSE if the whole
+ * tree must be reloaded; in this later case, the @tree may have been
+ * partially updated.
+ */
+gboolean
+fma_io_provider_update_items( const FMAPivot *pivot, guint loadable_set, GList **tree, const FMAIIOProvider *module, GSList *paths, GSList **messages )
+{
+	static const gchar *thisfn = "fma_io_provider_update_items";
+	const FMAIOProvider *provider_object;
+	GSList *ip;
+	GList *levels, *il, *items;
+	FMAObjectItem *item;
+	GCompareFunc sort_fn;
+	gboolean ok, alone;
+	gchar *id;
+
+	g_return_val_if_fail( FMA_IS_PIVOT( pivot ), FALSE );
+	g_return_val_if_fail( tree, FALSE );
+
+	g_debug( "%s: pivot=%p, loadable_set=%d, module=%p, paths=%p (count=%d)",
+			thisfn, ( void * ) pivot, loadable_set, ( void * ) module, ( void * ) paths, g_slist_length( paths ));
+
+	provider_object = peek_provider_by_module( fma_io_provider_get_io_providers_list( pivot ), module );
+
+	ok = ( provider_object &&
+			FMA_IIO_PROVIDER_GET_INTERFACE( module )->read_item_from_path &&
+			fma_io_provider_is_conf_readable( provider_object, pivot, NULL ));
+
+	/* an item removed from this provider may reveal an item of the same
+	 * id which was shadowed by it in another provider
+	 */
+	alone = ok && !update_items_has_other_readers( pivot, provider_object );
+
+	/* the list of the modified levels, where a NULL data stands for the
+	 * level zero
+	 */
+	levels = NULL;
+
+	for( ip = paths ; ip && ok ; ip = ip->next ){
+		id = NULL;
+		item = NULL;
+		ok = FMA_IIO_PROVIDER_GET_INTERFACE( module )->read_item_from_path(
+				module, ( const gchar * ) ip->data, &id, &item, messages );
+
+		if( ok && id ){
+			ok = update_items_replace( provider_object, loadable_set, tree, id, item, alone, &levels );
+
+		} else if( item ){
+			fma_object_unref( item );
+		}
+
+		g_free( id );
+	}
+
+	if( ok ){
+		switch( fma_iprefs_get_order_mode( NULL )){
+			case IPREFS_ORDER_ALPHA_ASCENDING:
+				sort_fn = ( GCompareFunc ) fma_object_id_sort_alpha_asc;
+				break;
+
+			case IPREFS_ORDER_ALPHA_DESCENDING:
+				sort_fn = ( GCompareFunc ) fma_object_id_sort_alpha_desc;
+				break;
+
+			case IPREFS_ORDER_MANUAL:
+			default:
+				sort_fn = NULL;
+				break;
+		}
+
+		for( il = levels ; il && sort_fn ; il = il->next ){
+			if( il->data ){
+				items = fma_object_get_items( il->data );
+				items = g_list_sort( items, sort_fn );
+				fma_object_set_items( il->data, items );
+			} else {
+				*tree = g_list_sort( *tree, sort_fn );
+			}
+		}
+	}
+
+	g_list_free( levels );
+
+	g_debug( "%s: ok=%s", thisfn, ok ? "True":"False" );
+
+	return( ok );
+}
+
+/*
+ * whether another provider than @provider reads items, and so may
+ * provide an item with the same id
+ */
+static gboolean
+update_items_has_other_readers( const FMAPivot *pivot, const FMAIOProvider *provider )
+{
+	GList *ip;
+	FMAIOProvider *other;
+	gboolean found;
+
+	found = FALSE;
+
+	for( ip = fma_io_provider_get_io_providers_list( pivot ) ; ip && !found ; ip = ip->next ){
+		other = FMA_IO_PROVIDER( ip->data );
+		found = ( other != provider &&
+				other->private->provider &&
+				FMA_IIO_PROVIDER_GET_INTERFACE( other->private->provider )->read_items &&
+				fma_io_provider_is_conf_readable( other, pivot, NULL ));
+	}
+
+	return( found );
+}
+
+/*
+ * replaces the item identified by @id with the new @item, or removes it
+ * if @item is NULL, registering the modified level in @levels
+ *
+ * the current item must have been read from the same @provider; an item
+ * is only removed when the @provider is @alone to read items, as another
+ * provider may else supply an item with the same id: in these cases,
+ * the whole tree is reloaded
+ *
+ * takes the ownership of @item
+ */
+static gboolean
+update_items_replace( const FMAIOProvider *provider, guint loadable_set, GList **tree, const gchar *id, FMAObjectItem *item, gboolean alone, GList **levels )
+{
+	static const gchar *thisfn = "fma_io_provider_update_items_replace";
+	GList *link, *single, *filtered, *items;
+	FMAObjectItem *parent;
+	FMAObject *existing;
+
+	if( item ){
+		if( FMA_IS_OBJECT_MENU( item )){
+			g_debug( "%s: id=%s: menu, reloading", thisfn, id );
+			fma_object_unref( item );
+			return( FALSE );
+		}
+
+		fma_object_set_provider( item, provider );
+		fma_object_check_status( item );
+
+		single = g_list_append( NULL, item );
+		filtered = load_items_filter_unwanted_items_rec( single, loadable_set );
+		item = filtered ? FMA_OBJECT_ITEM( filtered->data ) : NULL;
+		g_list_free( filtered );
+		g_list_free( single );
+	}
+
+	parent = NULL;
+	link = update_items_find_link( *tree, id, NULL, &parent );
+
+	if( !link ){
+		if( item ){
+			g_debug( "%s: id=%s: new item, reloading", thisfn, id );
+			fma_object_unref( item );
+			return( FALSE );
+		}
+		return( TRUE );
+	}
+
+	existing = FMA_OBJECT( link->data );
+
+	if( FMA_IS_OBJECT_MENU( existing )){
+		g_debug( "%s: id=%s: menu, reloading", thisfn, id );
+		if( item ){
+			fma_object_unref( item );
+		}
+		return( FALSE );
+	}
+
+	if( fma_object_get_provider( existing ) != ( FMAIOProvider * ) provider ){
+		g_debug( "%s: id=%s: read from another provider, reloading", thisfn, id );
+		if( item ){
+			fma_object_unref( item );
+		}
+		return( FALSE );
+	}
+
+	if( !item && !alone ){
+		g_debug( "%s: id=%s: may be provided by another provider, reloading", thisfn, id );
+		return( FALSE );
+	}
+
+	if( item ){
+		g_debug( "%s: id=%s: replacing %p with %p", thisfn, id, ( void * ) existing, ( void * ) item );
+		link->data = item;
+		fma_object_set_parent( item, parent );
+
+		if( !g_list_find( *levels, parent )){
+			*levels = g_list_prepend( *levels, parent );
+		}
+
+	} else {
+		g_debug( "%s: id=%s: removing %p", thisfn, id, ( void * ) existing );
+		if( parent ){
+			items = fma_object_get_items( parent );
+			items = g_list_delete_link( items, link );
+			fma_object_set_items( parent, items );
+		} else {
+			*tree = g_list_delete_link( *tree, link );
+		}
+	}
+
+	fma_object_unref( existing );
+
+	return( TRUE );
+}
+
+/*
+ * recursively searches the menus and actions of the tree for the given
+ * @id, returning the found link and its parent (NULL for level zero)
+ */
+static GList *
+update_items_find_link( GList *items, const gchar *id, FMAObjectItem *parent, FMAObjectItem **found_parent )
+{
+	GList *it, *link;
+
+	link = g_list_find_custom( items, id, ( GCompareFunc ) peek_item_by_id_compare );
+
+	if( link ){
+		*found_parent = parent;
+	}
+
+	for( it = items ; it && !link ; it = it->next ){
+		if( FMA_IS_OBJECT_MENU( it->data )){
+			link = update_items_find_link(
+					fma_object_get_items( it->data ), id, FMA_OBJECT_ITEM( it->data ), found_parent );
+		}
+	}
+
+	return( link );
+}
+
 #if 0
 static void
 dump( const FMAIOProvider *provider )
@@ -1063,7 +1415,7 @@ load_items_filter_unwanted_items_rec( GList *hierarchy, guint loadable_set )
 
 		if( FMA_IS_OBJECT_PROFILE( it->data )){
 			if( is_valid || load_invalid ){
-				filtered = g_list_append( filtered, it->data );
+				filtered = g_list_prepend( filtered, it->data );
 				selected = TRUE;
 			}
 		}
@@ -1075,7 +1427,7 @@ load_items_filter_unwanted_items_rec( GList *hierarchy, guint loadable_set )
 				subitems = fma_object_get_items( it->data );
 				subitems_f = load_items_filter_unwanted_items_rec( subitems, loadable_set );
 				fma_object_set_items( it->data, subitems_f );
-				filtered = g_list_append( filtered, it->data );
+				filtered = g_list_prepend( filtered, it->data );
 				selected = TRUE;
 			}
 		}
@@ -1090,7 +1442,7 @@ load_items_filter_unwanted_items_rec( GList *hierarchy, guint loadable_set )
 		}
 	}
 
-	return( filtered );
+	return( g_list_reverse( filtered ));
 }
 
 /*
@@ -1099,18 +1451,29 @@ load_items_filter_unwanted_items_rec( GList *hierarchy, guint loadable_set )
  * - i/o providers which appear unavailable at runtime
  * - i/o providers marked as unreadable
  * - items (actions or menus) which do not satisfy the defined loadable set
+ *
+ * the i/o providers which are able to read concurrently are read on the
+ * worker pool, while the others are read in turn on the calling thread;
+ * the items are then merged in the order of the providers
  */
 static GList *
 load_items_get_merged_list( const FMAPivot *pivot, guint loadable_set, GSList **messages )
 {
+	static const gchar *thisfn = "fma_io_provider_load_items_get_merged_list";
 	const GList *providers;
 	const GList *ip;
-	GList *merged, *items, *it;
+	GList *merged, *it;
 	const FMAIOProvider *provider_object;
 	const FMAIIOProvider *provider_module;
+	GPtrArray *tasks, *concurrent;
+	FMAWorkerBatch *batch;
+	sReadTask *task;
+	guint i;
 
 	merged = NULL;
 	providers = fma_io_provider_get_io_providers_list( pivot );
+	tasks = g_ptr_array_new_with_free_func( g_free );
+	concurrent = g_ptr_array_new();
 
 	for( ip = providers ; ip ; ip = ip->next ){
 		provider_object = FMA_IO_PROVIDER( ip->data );
@@ -1120,58 +1483,111 @@ load_items_get_merged_list( const FMAPivot *pivot, guint loadable_set, GSList **
 			FMA_IIO_PROVIDER_GET_INTERFACE( provider_module )->read_items &&
 			fma_io_provider_is_conf_readable( provider_object, pivot, NULL )){
 
-			items = FMA_IIO_PROVIDER_GET_INTERFACE( provider_module )->read_items( provider_module, messages );
+			task = g_new0( sReadTask, 1 );
+			task->provider = provider_object;
+			task->concurrent =
+					FMA_IIO_PROVIDER_GET_INTERFACE( provider_module )->is_able_to_read_concurrently &&
+					FMA_IIO_PROVIDER_GET_INTERFACE( provider_module )->is_able_to_read_concurrently( provider_module );
+			g_ptr_array_add( tasks, task );
 
-			for( it = items ; it ; it = it->next ){
-				fma_object_set_provider( it->data, provider_object );
-				fma_object_dump( it->data );
+			if( task->concurrent ){
+				g_ptr_array_add( concurrent, task );
 			}
+		}
+	}
+
+	g_debug( "%s: providers=%u, concurrent=%u", thisfn, tasks->len, concurrent->len );
+
+	batch = fma_worker_pool_start( concurrent, ( FMAWorkerFunc ) load_items_read_provider, NULL );
 
-			merged = g_list_concat( merged, items );
+	for( i = 0 ; i < tasks->len ; ++i ){
+		task = ( sReadTask * ) g_ptr_array_index( tasks, i );
+		if( !task->concurrent ){
+			load_items_read_provider( task, NULL );
 		}
 	}
 
+	fma_worker_pool_wait( batch );
+
+	for( i = 0 ; i < tasks->len ; ++i ){
+		task = ( sReadTask * ) g_ptr_array_index( tasks, i );
+
+		for( it = task->items ; it ; it = it->next ){
+			fma_object_set_provider( it->data, task->provider );
+			fma_object_dump( it->data );
+		}
+
+		merged = g_list_concat( merged, task->items );
+
+		if( messages ){
+			*messages = g_slist_concat( *messages, task->messages );
+		} else {
+			fma_core_utils_slist_free( task->messages );
+		}
+	}
+
+	g_ptr_array_free( concurrent, TRUE );
+	g_ptr_array_free( tasks, TRUE );
+
 	return( merged );
 }
 
+/*
+ * reads the items of one i/o provider, maybe on a worker thread
+ */
+static void
+load_items_read_provider( sReadTask *task, void *empty )
+{
+	const FMAIIOProvider *provider_module;
+
+	provider_module = task->provider->private->provider;
+
+	task->items = FMA_IIO_PROVIDER_GET_INTERFACE( provider_module )->read_items( provider_module, &task->messages );
+}
+
 /*
  * builds the hierarchy
  *
  * this is a recursive function which _moves_ items from input 'tree' to
- * output list.
+ * output list; the links of the input 'tree' are found through the
+ * 'index' built by load_items_hierarchy_index().
  */
 static GList *
-load_items_hierarchy_build( GList **tree, GSList *level_zero, gboolean list_if_empty, FMAObjectItem *parent )
+load_items_hierarchy_build( GList **tree, GHashTable *index, GSList *level_zero, gboolean list_if_empty, FMAObjectItem *parent )
 {
 	static const gchar *thisfn = "fma_io_provider_load_items_hierarchy_build";
 	GList *hierarchy, *it;
 	GSList *ilevel;
 	GSList *subitems_ids;
 	GList *subitems;
+	GQueue *links;
+	FMAObjectItem *item;
 
 	hierarchy = NULL;
 
-	if( g_slist_length( level_zero )){
+	if( level_zero ){
 		for( ilevel = level_zero ; ilevel ; ilevel = ilevel->next ){
 			/*g_debug( "%s: id=%s", thisfn, ( gchar * ) ilevel->data );*/
-			it = g_list_find_custom( *tree, ilevel->data, ( GCompareFunc ) peek_item_by_id_compare );
+			links = g_hash_table_lookup( index, ilevel->data );
+			it = links ? g_queue_pop_head( links ) : NULL;
 			if( it ){
-				hierarchy = g_list_append( hierarchy, it->data );
-				fma_object_set_parent( it->data, parent );
+				item = FMA_OBJECT_ITEM( it->data );
+				*tree = g_list_delete_link( *tree, it );
 
-				g_debug( "%s: id=%s: %s (%p) appended to hierarchy %p",
-						thisfn, ( gchar * ) ilevel->data, G_OBJECT_TYPE_NAME( it->data ), ( void * ) it->data, ( void * ) hierarchy );
+				hierarchy = g_list_prepend( hierarchy, item );
+				fma_object_set_parent( item, parent );
 
-				*tree = g_list_remove_link( *tree, it );
+				g_debug( "%s: id=%s: %s (%p) appended to hierarchy %p",
+						thisfn, ( gchar * ) ilevel->data, G_OBJECT_TYPE_NAME( item ), ( void * ) item, ( void * ) hierarchy );
 
-				if( FMA_IS_OBJECT_MENU( it->data )){
-					subitems_ids = fma_object_get_items_slist( it->data );
-					subitems = load_items_hierarchy_build( tree, subitems_ids, FALSE, FMA_OBJECT_ITEM( it->data ));
-					fma_object_set_items( it->data, subitems );
-					fma_core_utils_slist_free( subitems_ids );
+				if( FMA_IS_OBJECT_MENU( item )){
+					subitems_ids = ( GSList * ) fma_object_peek_items_slist( item );
+					subitems = load_items_hierarchy_build( tree, index, subitems_ids, FALSE, item );
+					fma_object_set_items( item, subitems );
 				}
 			}
 		}
+		hierarchy = g_list_reverse( hierarchy );
 	}
 
 	/* if level-zero list is empty,
@@ -1179,16 +1595,52 @@ load_items_hierarchy_build( GList **tree, GSList *level_zero, gboolean list_if_e
 	 */
 	else if( list_if_empty ){
 		for( it = *tree ; it ; it = it->next ){
-			hierarchy = g_list_append( hierarchy, it->data );
 			fma_object_set_parent( it->data, parent );
 		}
-		g_list_free( *tree );
+		hierarchy = *tree;
 		*tree = NULL;
 	}
 
 	return( hierarchy );
 }
 
+/*
+ * index the links of the flat list of items by the id of the items
+ *
+ * as several i/o providers may provide an item with the same id, each
+ * id is associated with the queue of its links, in the order of the list,
+ * the first one being taken first
+ */
+static GHashTable *
+load_items_hierarchy_index( GList *tree )
+{
+	GHashTable *index;
+	GQueue *links;
+	GList *it;
+	const gchar *id;
+
+	/* ids are borrowed from the items, which are not modified while the
+	 * index is alive
+	 */
+	index = g_hash_table_new_full( g_str_hash, g_str_equal, NULL, ( GDestroyNotify ) g_queue_free );
+
+	for( it = tree ; it ; it = it->next ){
+		if( FMA_IS_OBJECT_ITEM( it->data )){
+			id = fma_object_peek_id( it->data );
+			links = g_hash_table_lookup( index, id );
+
+			if( !links ){
+				links = g_queue_new();
+				g_hash_table_insert( index, ( gpointer ) id, links );
+			}
+
+			g_queue_push_tail( links, it );
+		}
+	}
+
+	return( index );
+}
+
 static GList *
 load_items_hierarchy_sort( const FMAPivot *pivot, GList *tree, GCompareFunc fn )
 {
@@ -1216,13 +1668,10 @@ load_items_hierarchy_sort( const FMAPivot *pivot, GList *tree, GCompareFunc fn )
 static gint
 peek_item_by_id_compare( const FMAObject *obj, const gchar *id )
 {
-	gchar *obj_id;
 	gint ret = 1;
 
 	if( FMA_IS_OBJECT_ITEM( obj )){
-		obj_id = fma_object_get_id( obj );
-		ret = strcmp( obj_id, id );
-		g_free( obj_id );
+		ret = strcmp( fma_object_peek_id( obj ), id );
 	}
 
 	return( ret );
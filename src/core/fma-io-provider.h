@@ -93,6 +93,11 @@ typedef struct {
  */
 #define IO_PROVIDER_SIGNAL_ITEM_CHANGED		"io-provider-item-changed"
 
+/* signal sent from a FMAIIOProvider
+ * via the fma_iio_provider_paths_changed() function
+ */
+#define IO_PROVIDER_SIGNAL_PATHS_CHANGED	"io-provider-paths-changed"
+
 GType          fma_io_provider_get_type                 ( void );
 
 FMAIOProvider *fma_io_provider_find_writable_io_provider( const FMAPivot *pivot );
@@ -108,6 +113,8 @@ gboolean       fma_io_provider_is_conf_writable         ( const FMAIOProvider *p
 gboolean       fma_io_provider_is_finally_writable      ( const FMAIOProvider *provider, guint *reason );
 
 GList         *fma_io_provider_load_items               ( const FMAPivot *pivot, guint loadable_set, GSList **messages );
+gboolean       fma_io_provider_get_sources              ( const FMAPivot *pivot, GSList **sources );
+gboolean       fma_io_provider_update_items             ( const FMAPivot *pivot, guint loadable_set, GList **tree, const FMAIIOProvider *module, GSList *paths, GSList **messages );
 
 guint          fma_io_provider_write_item               ( const FMAIOProvider *provider, const FMAObjectItem *item, GSList **messages );
 guint          fma_io_provider_delete_item              ( const FMAIOProvider *provider, const FMAObjectItem *item, GSList **messages );
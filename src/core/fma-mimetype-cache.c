@@ -0,0 +1,308 @@
+/*
+ * FileManager-Actions
+ * A file-manager extension which offers configurable context menu actions.
+ *
+ * Copyright (C) 2005 The GNOME Foundation
+ * Copyright (C) 2006-2008 Frederic Ruaudel and others (see AUTHORS)
+ * Copyright (C) 2009-2015 Pierre Wieser and others (see AUTHORS)
+ *
+ * FileManager-Actions is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * FileManager-Actions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FileManager-Actions; see the file COPYING. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Authors:
+ *   Frederic Ruaudel <grumz@grumz.net>
+ *   Rodrigo Moya <rodrigo@gnome-db.org>
+ *   Pierre Wieser <pwieser@trychlos.org>
+ *   ... and many others (see AUTHORS)
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <gio/gio.h>
+#include <string.h>
+
+#include "fma-mimetype-cache.h"
+
+/* the key of the cache
+ * def_type is the content type of the condition
+ * file_type is the mimetype of the file
+ */
+typedef struct {
+	gchar *def_type;
+	gchar *file_type;
+}
+	sKey;
+
+typedef struct {
+	GHashTable *results;
+	GList      *monitors;
+	guint       hits;
+	guint       misses;
+	guint       invalidations;
+}
+	sCache;
+
+static sCache *st_cache = NULL;
+
+G_LOCK_DEFINE_STATIC( st_cache );
+
+static sCache  *cache_new( void );
+static GList   *cache_monitor_dir( GList *monitors, const gchar *datadir );
+static void     on_mime_database_changed( GFileMonitor *monitor, GFile *file, GFile *other_file, GFileMonitorEvent event_type, void *empty );
+static guint    key_hash( const sKey *key );
+static gboolean key_equal( const sKey *a, const sKey *b );
+static void     key_free( sKey *key );
+
+/*
+ * fma_mimetype_cache_init:
+ *
+ * Initializes the cache and the monitors of the shared-mime-info
+ * database.
+ *
+ * This should be called from the main thread, so that the monitors
+ * are attached to the main context. Until then, the subsumption checks
+ * are not cached.
+ */
+void
+fma_mimetype_cache_init( void )
+{
+	G_LOCK( st_cache );
+
+	if( !st_cache ){
+		st_cache = cache_new();
+	}
+
+	G_UNLOCK( st_cache );
+}
+
+/*
+ * fma_mimetype_cache_is_a:
+ * @file_type: the mimetype of the file.
+ * @def_type: the content type of the condition.
+ *
+ * Returns: %TRUE if @file_type is a sort of @def_type, %FALSE else.
+ *
+ * Content type is the same as the mime type in *nix.
+ */
+gboolean
+fma_mimetype_cache_is_a( const gchar *file_type, const gchar *def_type )
+{
+	sKey lookup, *key;
+	gpointer found;
+	gboolean is_a;
+
+	g_return_val_if_fail( file_type && def_type, FALSE );
+
+	lookup.def_type = ( gchar * ) def_type;
+	lookup.file_type = ( gchar * ) file_type;
+
+	G_LOCK( st_cache );
+
+	if( !st_cache ){
+		G_UNLOCK( st_cache );
+		return( g_content_type_is_a( file_type, def_type ));
+	}
+
+	found = g_hash_table_lookup( st_cache->results, &lookup );
+
+	if( found ){
+		st_cache->hits += 1;
+		is_a = ( GPOINTER_TO_UINT( found ) == 2 );
+
+	} else {
+		st_cache->misses += 1;
+		is_a = g_content_type_is_a( file_type, def_type );
+
+		key = g_new0( sKey, 1 );
+		key->def_type = g_strdup( def_type );
+		key->file_type = g_strdup( file_type );
+		g_hash_table_insert( st_cache->results, key, GUINT_TO_POINTER( is_a ? 2 : 1 ));
+	}
+
+	G_UNLOCK( st_cache );
+
+	return( is_a );
+}
+
+/*
+ * fma_mimetype_cache_get_stats:
+ * @hits: [out]: the count of lookups answered by the cache.
+ * @misses: [out]: the count of lookups which had to query the database.
+ * @invalidations: [out]: the count of times the cache has been cleared.
+ *
+ * Each of the output parameters may be %NULL.
+ */
+void
+fma_mimetype_cache_get_stats( guint *hits, guint *misses, guint *invalidations )
+{
+	G_LOCK( st_cache );
+
+	if( hits ){
+		*hits = st_cache ? st_cache->hits : 0;
+	}
+	if( misses ){
+		*misses = st_cache ? st_cache->misses : 0;
+	}
+	if( invalidations ){
+		*invalidations = st_cache ? st_cache->invalidations : 0;
+	}
+
+	G_UNLOCK( st_cache );
+}
+
+/*
+ * fma_mimetype_cache_dump:
+ *
+ * Dumps the statistics of the cache.
+ */
+void
+fma_mimetype_cache_dump( void )
+{
+	static const gchar *thisfn = "fma_mimetype_cache_dump";
+	guint entries, hits, misses, invalidations;
+
+	fma_mimetype_cache_get_stats( &hits, &misses, &invalidations );
+
+	G_LOCK( st_cache );
+	entries = st_cache ? g_hash_table_size( st_cache->results ) : 0;
+	G_UNLOCK( st_cache );
+
+	g_debug( "%s: entries=%u, hits=%u, misses=%u, invalidations=%u",
+			thisfn, entries, hits, misses, invalidations );
+}
+
+/*
+ * fma_mimetype_cache_free:
+ *
+ * Releases the cache and its monitors.
+ */
+void
+fma_mimetype_cache_free( void )
+{
+	G_LOCK( st_cache );
+
+	if( st_cache ){
+		g_list_free_full( st_cache->monitors, ( GDestroyNotify ) g_object_unref );
+		g_hash_table_destroy( st_cache->results );
+		g_free( st_cache );
+		st_cache = NULL;
+	}
+
+	G_UNLOCK( st_cache );
+}
+
+/*
+ * monitor the 'mime' subdirectory of each XDG data directory, as this
+ * is where update-mime-database writes the shared-mime-info database
+ */
+static sCache *
+cache_new( void )
+{
+	sCache *cache;
+	const gchar * const *dirs;
+	guint i;
+
+	cache = g_new0( sCache, 1 );
+	cache->results = g_hash_table_new_full(
+			( GHashFunc ) key_hash, ( GEqualFunc ) key_equal, ( GDestroyNotify ) key_free, NULL );
+
+	cache->monitors = cache_monitor_dir( cache->monitors, g_get_user_data_dir());
+
+	dirs = g_get_system_data_dirs();
+	for( i = 0 ; dirs[i] ; ++i ){
+		cache->monitors = cache_monitor_dir( cache->monitors, dirs[i] );
+	}
+
+	return( cache );
+}
+
+static GList *
+cache_monitor_dir( GList *monitors, const gchar *datadir )
+{
+	static const gchar *thisfn = "fma_mimetype_cache_monitor_dir";
+	gchar *path;
+	GFile *file;
+	GFileMonitor *monitor;
+	GError *error;
+
+	path = g_build_filename( datadir, "mime", NULL );
+
+	if( g_file_test( path, G_FILE_TEST_IS_DIR )){
+		error = NULL;
+		file = g_file_new_for_path( path );
+		monitor = g_file_monitor_directory( file, G_FILE_MONITOR_NONE, NULL, &error );
+
+		if( error ){
+			g_debug( "%s: %s: %s", thisfn, path, error->message );
+			g_error_free( error );
+
+		} else {
+			g_signal_connect( monitor, "changed", G_CALLBACK( on_mime_database_changed ), NULL );
+			monitors = g_list_prepend( monitors, monitor );
+		}
+
+		g_object_unref( file );
+	}
+
+	g_free( path );
+
+	return( monitors );
+}
+
+/*
+ * the database files are rewritten as a whole by update-mime-database:
+ * just clear the cache
+ */
+static void
+on_mime_database_changed( GFileMonitor *monitor, GFile *file, GFile *other_file, GFileMonitorEvent event_type, void *empty )
+{
+	static const gchar *thisfn = "fma_mimetype_cache_on_mime_database_changed";
+
+	if( event_type == G_FILE_MONITOR_EVENT_CHANGES_DONE_HINT ||
+		event_type == G_FILE_MONITOR_EVENT_CREATED ||
+		event_type == G_FILE_MONITOR_EVENT_DELETED ){
+
+		G_LOCK( st_cache );
+
+		if( st_cache && g_hash_table_size( st_cache->results )){
+			g_debug( "%s: clearing %u entries", thisfn, g_hash_table_size( st_cache->results ));
+			g_hash_table_remove_all( st_cache->results );
+			st_cache->invalidations += 1;
+		}
+
+		G_UNLOCK( st_cache );
+	}
+}
+
+static guint
+key_hash( const sKey *key )
+{
+	return( g_str_hash( key->def_type ) * 31 + g_str_hash( key->file_type ));
+}
+
+static gboolean
+key_equal( const sKey *a, const sKey *b )
+{
+	return( !strcmp( a->def_type, b->def_type ) && !strcmp( a->file_type, b->file_type ));
+}
+
+static void
+key_free( sKey *key )
+{
+	g_free( key->def_type );
+	g_free( key->file_type );
+	g_free( key );
+}
@@ -0,0 +1,60 @@
+/*
+ * FileManager-Actions
+ * A file-manager extension which offers configurable context menu actions.
+ *
+ * Copyright (C) 2005 The GNOME Foundation
+ * Copyright (C) 2006-2008 Frederic Ruaudel and others (see AUTHORS)
+ * Copyright (C) 2009-2015 Pierre Wieser and others (see AUTHORS)
+ *
+ * FileManager-Actions is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * FileManager-Actions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FileManager-Actions; see the file COPYING. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Authors:
+ *   Frederic Ruaudel <grumz@grumz.net>
+ *   Rodrigo Moya <rodrigo@gnome-db.org>
+ *   Pierre Wieser <pwieser@trychlos.org>
+ *   ... and many others (see AUTHORS)
+ */
+
+#ifndef __CORE_FMA_MIMETYPE_CACHE_H__
+#define __CORE_FMA_MIMETYPE_CACHE_H__
+
+/* @title: Mimetype Cache
+ * @short_description: A memoized mimetype subsumption cache.
+ * @include: core/fma-mimetype-cache.h
+ *
+ * Checking if the mimetype of a file is 'a sort of' the mimetype of a
+ * condition goes through the shared-mime-info database. As a selection
+ * usually involves only a few distinct mimetypes, the same pairs are
+ * checked again and again when building a menu.
+ *
+ * The cache is process-wide. It is cleared each time the shared-mime-info
+ * database is updated on the disk, and so has to be initialized from the
+ * main thread.
+ */
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+void     fma_mimetype_cache_init     ( void );
+gboolean fma_mimetype_cache_is_a     ( const gchar *file_type, const gchar *def_type );
+
+void     fma_mimetype_cache_get_stats( guint *hits, guint *misses, guint *invalidations );
+void     fma_mimetype_cache_dump     ( void );
+void     fma_mimetype_cache_free     ( void );
+
+G_END_DECLS
+
+#endif /* __CORE_FMA_MIMETYPE_CACHE_H__ */
@@ -404,13 +404,14 @@ ifactory_object_read_done( FMAIFactoryObject *instance, const FMAIFactoryProvide
 	 */
 	read_done_deals_with_toolbar_label( instance );
 
-	/* prepare the context after the reading
+	/* set action defaults
 	 */
-	fma_icontext_read_done( FMA_ICONTEXT( instance ));
+	fma_factory_object_set_defaults( instance );
 
-	/* last, set action defaults
+	/* last, prepare the context after the reading, so that its
+	 * conditions are compiled with their default values
 	 */
-	fma_factory_object_set_defaults( instance );
+	fma_icontext_read_done( FMA_ICONTEXT( instance ));
 }
 
 static guint
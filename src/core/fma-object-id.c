@@ -201,18 +201,7 @@ instance_finalize( GObject *object )
 gint
 fma_object_id_sort_alpha_asc( const FMAObjectId *a, const FMAObjectId *b )
 {
-	gchar *label_a, *label_b;
-	gint compare;
-
-	label_a = fma_object_get_label( a );
-	label_b = fma_object_get_label( b );
-
-	compare = fma_core_utils_str_collate( label_a, label_b );
-
-	g_free( label_b );
-	g_free( label_a );
-
-	return( compare );
+	return( fma_core_utils_str_collate( fma_object_peek_label( a ), fma_object_peek_label( b )));
 }
 
 /**
@@ -421,7 +421,6 @@ fma_object_item_get_item( const FMAObjectItem *item, const gchar *id )
 	GList *children, *it;
 	FMAObjectId *found = NULL;
 	FMAObjectId *isub;
-	gchar *isubid;
 
 	g_return_val_if_fail( FMA_IS_OBJECT_ITEM( item ), NULL );
 
@@ -430,11 +429,9 @@ fma_object_item_get_item( const FMAObjectItem *item, const gchar *id )
 		children = fma_object_get_items( item );
 		for( it = children ; it && !found ; it = it->next ){
 			isub = FMA_OBJECT_ID( it->data );
-			isubid = fma_object_get_id( isub );
-			if( !strcmp( id, isubid )){
+			if( !strcmp( id, fma_object_peek_id( isub ))){
 				found = isub;
 			}
-			g_free( isubid );
 		}
 	}
 
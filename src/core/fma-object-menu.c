@@ -298,13 +298,14 @@ ifactory_object_read_done( FMAIFactoryObject *instance, const FMAIFactoryProvide
 
 	fma_object_item_deals_with_version( FMA_OBJECT_ITEM( instance ));
 
-	/* prepare the context after the reading
+	/* set menu defaults
 	 */
-	fma_icontext_read_done( FMA_ICONTEXT( instance ));
+	fma_factory_object_set_defaults( instance );
 
-	/* last, set menu defaults
+	/* last, prepare the context after the reading, so that its
+	 * conditions are compiled with their default values
 	 */
-	fma_factory_object_set_defaults( instance );
+	fma_icontext_read_done( FMA_ICONTEXT( instance ));
 }
 
 static guint
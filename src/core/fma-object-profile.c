@@ -641,13 +641,14 @@ read_done_ending( FMAObjectProfile *profile )
 	 */
 	split_path_parameters( profile );
 
-	/* prepare the context after the reading
+	/* set profile defaults
 	 */
-	fma_icontext_read_done( FMA_ICONTEXT( profile ));
+	fma_factory_object_set_defaults( FMA_IFACTORY_OBJECT( profile ));
 
-	/* last, set profile defaults
+	/* last, prepare the context after the reading, so that its
+	 * conditions are compiled with their default values
 	 */
-	fma_factory_object_set_defaults( FMA_IFACTORY_OBJECT( profile ));
+	fma_icontext_read_done( FMA_ICONTEXT( profile ));
 }
 
 /*
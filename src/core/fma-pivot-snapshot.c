@@ -0,0 +1,646 @@
+/*
+ * FileManager-Actions
+ * A file-manager extension which offers configurable context menu actions.
+ *
+ * Copyright (C) 2005 The GNOME Foundation
+ * Copyright (C) 2006-2008 Frederic Ruaudel and others (see AUTHORS)
+ * Copyright (C) 2009-2015 Pierre Wieser and others (see AUTHORS)
+ *
+ * FileManager-Actions is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * FileManager-Actions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FileManager-Actions; see the file COPYING. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Authors:
+ *   Frederic Ruaudel <grumz@grumz.net>
+ *   Rodrigo Moya <rodrigo@gnome-db.org>
+ *   Pierre Wieser <pwieser@trychlos.org>
+ *   ... and many others (see AUTHORS)
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <glib/gstdio.h>
+#include <string.h>
+
+#include <api/fma-core-utils.h>
+#include <api/fma-data-types.h>
+#include <api/fma-object-api.h>
+
+#include "fma-factory-object.h"
+#include "fma-io-provider.h"
+#include "fma-pivot-snapshot.h"
+#include "fma-settings.h"
+
+/* the snapshot is a GVariant of type SNAPSHOT_TYPE, which holds:
+ * - the version of the snapshot format,
+ * - the key the snapshot has been computed for,
+ * - the flat list of records, in depth-first order, each record being:
+ *   > the kind of the object (menu, action or profile),
+ *   > the identifier of the i/o provider (empty for profiles),
+ *   > the index of the parent record, or NO_PARENT for level zero,
+ *   > the dictionary of the non-pointer FMADataBoxed of the object.
+ *
+ * SNAPSHOT_VERSION must be incremented each time the format changes,
+ * or the serialization of an elementary data type is modified.
+ */
+#define SNAPSHOT_VERSION				1
+#define SNAPSHOT_TYPE					"(usa(ysua{sv}))"
+#define SNAPSHOT_RECORD_TYPE			"(ysua{sv})"
+
+#define NO_PARENT						G_MAXUINT
+
+enum {
+	KIND_MENU    = 'm',
+	KIND_ACTION  = 'a',
+	KIND_PROFILE = 'p',
+};
+
+static gchar     *get_snapshot_fname( guint loadable_set );
+static void       checksum_path( GChecksum *checksum, const gchar *path, gboolean list_dir );
+static void       checksum_stat( GChecksum *checksum, const gchar *name, const gchar *path );
+static GList     *tree_from_records( const FMAPivot *pivot, GVariant *records );
+static FMAObject *object_from_record( const FMAPivot *pivot, GVariant *record, GPtrArray *objects, guint *parent );
+static void       set_from_variant( FMAObject *object, const gchar *name, GVariant *value );
+static void       records_from_tree( GVariantBuilder *builder, GList *tree, guint parent, guint *count );
+static gboolean   records_add_data( const FMAIFactoryObject *object, FMADataBoxed *boxed, GVariantBuilder *builder );
+static GVariant  *variant_from_boxed( const FMABoxed *boxed, guint type );
+
+/*
+ * fma_pivot_snapshot_get_key:
+ * @pivot: the #FMAPivot object which owns the list of i/o providers.
+ * @loadable_set: the population of items to be loaded.
+ *
+ * Returns: the key which identifies the current state of the sources
+ * of the items, as a newly allocated string which should be g_free()
+ * by the caller, or %NULL if a snapshot cannot be used.
+ */
+gchar *
+fma_pivot_snapshot_get_key( const FMAPivot *pivot, guint loadable_set )
+{
+	static const gchar *thisfn = "fma_pivot_snapshot_get_key";
+	GSList *sources, *is;
+	GChecksum *checksum;
+	gchar *header, *languages;
+	gchar *key;
+
+	if( !fma_io_provider_get_sources( pivot, &sources )){
+		g_debug( "%s: pivot=%p: sources are not available", thisfn, ( void * ) pivot );
+		return( NULL );
+	}
+
+	checksum = g_checksum_new( G_CHECKSUM_SHA256 );
+
+	header = g_strdup_printf( "%s:%d:%u\n", PACKAGE_VERSION, SNAPSHOT_VERSION, loadable_set );
+	g_checksum_update( checksum, ( const guchar * ) header, -1 );
+	g_free( header );
+
+	/* the localized strings are read for the current locale only
+	 */
+	languages = g_strjoinv( ":", ( gchar ** ) g_get_language_names());
+	g_checksum_update( checksum, ( const guchar * ) languages, -1 );
+	g_checksum_update( checksum, ( const guchar * ) "\n", -1 );
+	g_free( languages );
+
+	for( is = sources ; is ; is = is->next ){
+		checksum_path( checksum, ( const gchar * ) is->data, TRUE );
+	}
+	fma_core_utils_slist_free( sources );
+
+	/* the configuration notably drives the readability of the
+	 * providers, the level-zero and the sort order of the items
+	 */
+	sources = fma_settings_get_files();
+	for( is = sources ; is ; is = is->next ){
+		checksum_path( checksum, ( const gchar * ) is->data, FALSE );
+	}
+	fma_core_utils_slist_free( sources );
+
+	key = g_strdup( g_checksum_get_string( checksum ));
+	g_checksum_free( checksum );
+
+	g_debug( "%s: pivot=%p, key=%s", thisfn, ( void * ) pivot, key );
+
+	return( key );
+}
+
+static gchar *
+get_snapshot_fname( guint loadable_set )
+{
+	gchar *bname;
+	gchar *fname;
+
+	bname = g_strdup_printf( "pivot-%u.snapshot", loadable_set );
+	fname = g_build_filename( g_get_user_cache_dir(), PACKAGE, bname, NULL );
+	g_free( bname );
+
+	return( fname );
+}
+
+/*
+ * a directory is identified by its own status, plus the status of each
+ * of its entries, so that an in-place modification of a file is detected
+ * even if it has not modified the directory itself
+ *
+ * the modification times are taken with their nanoseconds, so that two
+ * modifications in the same second are not seen as the same status
+ */
+static void
+checksum_path( GChecksum *checksum, const gchar *path, gboolean list_dir )
+{
+	GDir *dir;
+	const gchar *name;
+	gchar *entry;
+
+	checksum_stat( checksum, path, path );
+
+	if( list_dir && g_file_test( path, G_FILE_TEST_IS_DIR )){
+		dir = g_dir_open( path, 0, NULL );
+		if( dir ){
+			while(( name = g_dir_read_name( dir ))){
+				entry = g_build_filename( path, name, NULL );
+				checksum_stat( checksum, name, entry );
+				g_free( entry );
+			}
+			g_dir_close( dir );
+		}
+	}
+}
+
+static void
+checksum_stat( GChecksum *checksum, const gchar *name, const gchar *path )
+{
+	GStatBuf st;
+	gchar *line;
+
+	if( g_stat( path, &st ) == 0 ){
+		line = g_strdup_printf( "%s\t%" G_GINT64_FORMAT ".%09ld\t%" G_GINT64_FORMAT "\t%" G_GUINT64_FORMAT "\n",
+				name, ( gint64 ) st.st_mtim.tv_sec, ( long ) st.st_mtim.tv_nsec, ( gint64 ) st.st_size, ( guint64 ) st.st_ino );
+	} else {
+		line = g_strdup_printf( "%s\t-\n", name );
+	}
+
+	g_checksum_update( checksum, ( const guchar * ) line, -1 );
+	g_free( line );
+}
+
+/*
+ * fma_pivot_snapshot_load:
+ * @pivot: the #FMAPivot object which owns the list of i/o providers.
+ * @loadable_set: the population of items to be loaded.
+ * @key: the key computed by fma_pivot_snapshot_get_key().
+ * @tree: [out]: a pointer to a #GList which will be set to the tree of
+ *  items rebuilt from the snapshot.
+ *
+ * Returns: %TRUE if an up to date snapshot has been found, %FALSE else.
+ *
+ * The snapshot file is mapped in memory, and only read if its version
+ * and its key are the expected ones.
+ */
+gboolean
+fma_pivot_snapshot_load( const FMAPivot *pivot, guint loadable_set, const gchar *key, GList **tree )
+{
+	static const gchar *thisfn = "fma_pivot_snapshot_load";
+	gchar *fname;
+	GMappedFile *mapped;
+	GBytes *bytes;
+	GVariant *snapshot, *records;
+	guint version;
+	const gchar *snapshot_key;
+	GError *error;
+	gboolean ok;
+
+	g_return_val_if_fail( key, FALSE );
+	g_return_val_if_fail( tree, FALSE );
+
+	ok = FALSE;
+	*tree = NULL;
+	error = NULL;
+	fname = get_snapshot_fname( loadable_set );
+	mapped = g_mapped_file_new( fname, FALSE, &error );
+
+	if( !mapped ){
+		g_debug( "%s: %s: %s", thisfn, fname, error->message );
+		g_error_free( error );
+
+	} else {
+		bytes = g_mapped_file_get_bytes( mapped );
+		g_mapped_file_unref( mapped );
+
+		/* GVariant is safe against a truncated or a corrupted file:
+		 * invalid data are just read as default values
+		 */
+		snapshot = g_variant_ref_sink( g_variant_new_from_bytes( G_VARIANT_TYPE( SNAPSHOT_TYPE ), bytes, FALSE ));
+		g_bytes_unref( bytes );
+
+		g_variant_get_child( snapshot, 0, "u", &version );
+		g_variant_get_child( snapshot, 1, "&s", &snapshot_key );
+
+		if( version != SNAPSHOT_VERSION || strcmp( snapshot_key, key )){
+			g_debug( "%s: %s: outdated snapshot", thisfn, fname );
+
+		} else {
+			records = g_variant_get_child_value( snapshot, 2 );
+			*tree = tree_from_records( pivot, records );
+			ok = ( *tree != NULL || g_variant_n_children( records ) == 0 );
+			g_variant_unref( records );
+
+			g_debug( "%s: %s: ok=%s, count=%u",
+					thisfn, fname, ok ? "True":"False", g_list_length( *tree ));
+		}
+
+		g_variant_unref( snapshot );
+	}
+
+	g_free( fname );
+
+	return( ok );
+}
+
+/*
+ * rebuilds the tree from the flat list of records
+ * returns NULL if the records are not consistent
+ */
+static GList *
+tree_from_records( const FMAPivot *pivot, GVariant *records )
+{
+	static const gchar *thisfn = "fma_pivot_snapshot_tree_from_records";
+	GPtrArray *objects;
+	GList *tree, *it;
+	GVariant *record;
+	FMAObject *object, *parent_object;
+	guint i, count, parent;
+	gboolean ok;
+
+	ok = TRUE;
+	tree = NULL;
+	count = g_variant_n_children( records );
+	objects = g_ptr_array_sized_new( count );
+
+	for( i = 0 ; i < count && ok ; ++i ){
+		record = g_variant_get_child_value( records, i );
+		object = object_from_record( pivot, record, objects, &parent );
+		g_variant_unref( record );
+
+		if( !object ){
+			ok = FALSE;
+
+		} else if( parent == NO_PARENT ){
+			if( FMA_IS_OBJECT_ITEM( object )){
+				tree = g_list_prepend( tree, object );
+				g_ptr_array_add( objects, object );
+			} else {
+				g_object_unref( object );
+				ok = FALSE;
+			}
+
+		} else {
+			parent_object = ( FMAObject * ) g_ptr_array_index( objects, parent );
+
+			if( FMA_IS_OBJECT_PROFILE( object ) && FMA_IS_OBJECT_ACTION( parent_object )){
+				fma_object_attach_profile( parent_object, object );
+				g_ptr_array_add( objects, object );
+
+			} else if( FMA_IS_OBJECT_ITEM( object ) && FMA_IS_OBJECT_MENU( parent_object )){
+				fma_object_append_item( parent_object, object );
+				fma_object_set_parent( object, parent_object );
+				g_ptr_array_add( objects, object );
+
+			} else {
+				g_object_unref( object );
+				ok = FALSE;
+			}
+		}
+	}
+
+	g_ptr_array_free( objects, TRUE );
+	tree = g_list_reverse( tree );
+
+	if( !ok ){
+		g_warning( "%s: inconsistent snapshot record #%u", thisfn, i-1 );
+		fma_object_free_items( tree );
+		tree = NULL;
+	}
+
+	/* the validity status is not part of the snapshot
+	 */
+	for( it = tree ; it ; it = it->next ){
+		fma_object_check_status( it->data );
+	}
+
+	return( tree );
+}
+
+/*
+ * returns a new object, or NULL if the record is not valid
+ * the parent index is only checked against the already built objects
+ */
+static FMAObject *
+object_from_record( const FMAPivot *pivot, GVariant *record, GPtrArray *objects, guint *parent )
+{
+	FMAObject *object;
+	guchar kind;
+	const gchar *provider_id;
+	GVariant *data, *value;
+	GVariantIter iter;
+	const gchar *name;
+	FMAIOProvider *provider;
+
+	object = NULL;
+	g_variant_get( record, "(y&su@a{sv})", &kind, &provider_id, parent, &data );
+
+	if( *parent == NO_PARENT || *parent < objects->len ){
+		switch( kind ){
+			case KIND_MENU:
+				object = FMA_OBJECT( fma_object_menu_new());
+				break;
+
+			case KIND_ACTION:
+				object = FMA_OBJECT( fma_object_action_new());
+				break;
+
+			case KIND_PROFILE:
+				object = FMA_OBJECT( fma_object_profile_new());
+				break;
+		}
+	}
+
+	if( object ){
+		g_variant_iter_init( &iter, data );
+		while( g_variant_iter_loop( &iter, "{&sv}", &name, &value )){
+			set_from_variant( object, name, value );
+		}
+
+		if( strlen( provider_id )){
+			provider = fma_io_provider_find_io_provider_by_id( pivot, provider_id );
+			if( provider ){
+				fma_object_set_provider( object, provider );
+			}
+		}
+
+		/* the restored object goes through the same post-read step
+		 * than an object read from its provider: the mimetypes are
+		 * checked, the TryExec key is resolved and the conditions are
+		 * compiled with their default values
+		 */
+		fma_factory_object_set_defaults( FMA_IFACTORY_OBJECT( object ));
+		fma_icontext_read_done( FMA_ICONTEXT( object ));
+	}
+
+	g_variant_unref( data );
+
+	return( object );
+}
+
+/*
+ * the variant type must match the type of the data definition, or the
+ * value is just ignored
+ */
+static void
+set_from_variant( FMAObject *object, const gchar *name, GVariant *value )
+{
+	static const gchar *thisfn = "fma_pivot_snapshot_set_from_variant";
+	const FMADataDef *def;
+	GVariantIter iter;
+	const gchar *str;
+	guint32 num;
+	GSList *slist;
+	GList *list;
+
+	def = fma_factory_object_get_data_def( FMA_IFACTORY_OBJECT( object ), name );
+	if( !def ){
+		g_debug( "%s: %s: unknown data for %s", thisfn, name, G_OBJECT_TYPE_NAME( object ));
+		return;
+	}
+
+	switch( def->type ){
+		case FMA_DATA_TYPE_BOOLEAN:
+			if( g_variant_is_of_type( value, G_VARIANT_TYPE_BOOLEAN )){
+				fma_ifactory_object_set_from_void( FMA_IFACTORY_OBJECT( object ), name,
+						GUINT_TO_POINTER( g_variant_get_boolean( value )));
+			}
+			break;
+
+		case FMA_DATA_TYPE_STRING:
+		case FMA_DATA_TYPE_LOCALE_STRING:
+			if( g_variant_is_of_type( value, G_VARIANT_TYPE_STRING )){
+				fma_ifactory_object_set_from_void( FMA_IFACTORY_OBJECT( object ), name,
+						g_variant_get_string( value, NULL ));
+			}
+			break;
+
+		case FMA_DATA_TYPE_STRING_LIST:
+			if( g_variant_is_of_type( value, G_VARIANT_TYPE_STRING_ARRAY )){
+				slist = NULL;
+				g_variant_iter_init( &iter, value );
+				while( g_variant_iter_next( &iter, "&s", &str )){
+					slist = g_slist_prepend( slist, ( gpointer ) str );
+				}
+				slist = g_slist_reverse( slist );
+				fma_ifactory_object_set_from_void( FMA_IFACTORY_OBJECT( object ), name, slist );
+				g_slist_free( slist );
+			}
+			break;
+
+		case FMA_DATA_TYPE_UINT:
+			if( g_variant_is_of_type( value, G_VARIANT_TYPE_UINT32 )){
+				fma_ifactory_object_set_from_void( FMA_IFACTORY_OBJECT( object ), name,
+						GUINT_TO_POINTER( g_variant_get_uint32( value )));
+			}
+			break;
+
+		case FMA_DATA_TYPE_UINT_LIST:
+			if( g_variant_is_of_type( value, G_VARIANT_TYPE( "au" ))){
+				list = NULL;
+				g_variant_iter_init( &iter, value );
+				while( g_variant_iter_next( &iter, "u", &num )){
+					list = g_list_prepend( list, GUINT_TO_POINTER( num ));
+				}
+				list = g_list_reverse( list );
+				fma_ifactory_object_set_from_void( FMA_IFACTORY_OBJECT( object ), name, list );
+				g_list_free( list );
+			}
+			break;
+	}
+}
+
+/*
+ * fma_pivot_snapshot_save:
+ * @tree: the tree of items which has just been loaded.
+ * @loadable_set: the population of items which has been loaded.
+ * @key: the key computed by fma_pivot_snapshot_get_key() before
+ *  the items have been loaded.
+ *
+ * Saves the @tree as a binary snapshot under $XDG_CACHE_HOME.
+ *
+ * The file is atomically replaced, so that a concurrent
+ * fma_pivot_snapshot_load() never sees a partially written snapshot.
+ */
+void
+fma_pivot_snapshot_save( GList *tree, guint loadable_set, const gchar *key )
+{
+	static const gchar *thisfn = "fma_pivot_snapshot_save";
+	GVariantBuilder builder;
+	GVariant *snapshot;
+	gchar *fname, *dir;
+	guint count;
+	GError *error;
+
+	g_return_if_fail( key );
+
+	count = 0;
+	g_variant_builder_init( &builder, G_VARIANT_TYPE( "a" SNAPSHOT_RECORD_TYPE ));
+	records_from_tree( &builder, tree, NO_PARENT, &count );
+
+	snapshot = g_variant_ref_sink(
+			g_variant_new( "(us@a" SNAPSHOT_RECORD_TYPE ")",
+					SNAPSHOT_VERSION, key, g_variant_builder_end( &builder )));
+
+	fname = get_snapshot_fname( loadable_set );
+	dir = g_path_get_dirname( fname );
+	g_mkdir_with_parents( dir, 0700 );
+	g_free( dir );
+
+	error = NULL;
+	if( !g_file_set_contents( fname, g_variant_get_data( snapshot ), g_variant_get_size( snapshot ), &error )){
+		g_warning( "%s: %s: %s", thisfn, fname, error->message );
+		g_error_free( error );
+
+	} else {
+		g_debug( "%s: %s: count=%u, size=%lu",
+				thisfn, fname, count, ( unsigned long ) g_variant_get_size( snapshot ));
+	}
+
+	g_free( fname );
+	g_variant_unref( snapshot );
+}
+
+static void
+records_from_tree( GVariantBuilder *builder, GList *tree, guint parent, guint *count )
+{
+	GList *it;
+	FMAObject *object;
+	FMAIOProvider *provider;
+	GVariantBuilder data;
+	guchar kind;
+	gchar *provider_id;
+	guint index;
+
+	for( it = tree ; it ; it = it->next ){
+		object = FMA_OBJECT( it->data );
+		provider_id = NULL;
+
+		if( FMA_IS_OBJECT_MENU( object )){
+			kind = KIND_MENU;
+		} else if( FMA_IS_OBJECT_ACTION( object )){
+			kind = KIND_ACTION;
+		} else {
+			kind = KIND_PROFILE;
+		}
+
+		if( FMA_IS_OBJECT_ITEM( object )){
+			provider = fma_object_get_provider( object );
+			if( provider ){
+				provider_id = fma_io_provider_get_id( provider );
+			}
+		}
+
+		g_variant_builder_init( &data, G_VARIANT_TYPE_VARDICT );
+		fma_factory_object_iter_on_boxed(
+				FMA_IFACTORY_OBJECT( object ), ( FMAFactoryObjectIterBoxedFn ) records_add_data, &data );
+
+		g_variant_builder_add( builder, "(ysu@a{sv})",
+				kind, provider_id ? provider_id : "", parent, g_variant_builder_end( &data ));
+
+		g_free( provider_id );
+
+		index = ( *count )++;
+
+		if( FMA_IS_OBJECT_ITEM( object )){
+			records_from_tree( builder, fma_object_get_items( object ), index, count );
+		}
+	}
+}
+
+static gboolean
+records_add_data( const FMAIFactoryObject *object, FMADataBoxed *boxed, GVariantBuilder *builder )
+{
+	const FMADataDef *def;
+	GVariant *value;
+
+	def = fma_data_boxed_get_data_def( boxed );
+	value = variant_from_boxed( FMA_BOXED( boxed ), def->type );
+
+	if( value ){
+		g_variant_builder_add( builder, "{sv}", def->name, value );
+	}
+
+	/* do not stop the iteration */
+	return( FALSE );
+}
+
+/*
+ * pointers (parent, subitems, provider and its data) cannot be saved:
+ * they are rebuilt when the snapshot is loaded
+ */
+static GVariant *
+variant_from_boxed( const FMABoxed *boxed, guint type )
+{
+	GVariant *value;
+	GVariantBuilder builder;
+	GSList *slist, *is;
+	GList *list, *il;
+	gchar *str;
+
+	value = NULL;
+
+	switch( type ){
+		case FMA_DATA_TYPE_BOOLEAN:
+			value = g_variant_new_boolean( fma_boxed_get_boolean( boxed ));
+			break;
+
+		case FMA_DATA_TYPE_STRING:
+		case FMA_DATA_TYPE_LOCALE_STRING:
+			str = fma_boxed_get_string( boxed );
+			value = g_variant_new_string( str ? str : "" );
+			g_free( str );
+			break;
+
+		case FMA_DATA_TYPE_STRING_LIST:
+			g_variant_builder_init( &builder, G_VARIANT_TYPE_STRING_ARRAY );
+			slist = fma_boxed_get_string_list( boxed );
+			for( is = slist ; is ; is = is->next ){
+				g_variant_builder_add( &builder, "s", ( const gchar * ) is->data );
+			}
+			fma_core_utils_slist_free( slist );
+			value = g_variant_builder_end( &builder );
+			break;
+
+		case FMA_DATA_TYPE_UINT:
+			value = g_variant_new_uint32( fma_boxed_get_uint( boxed ));
+			break;
+
+		case FMA_DATA_TYPE_UINT_LIST:
+			g_variant_builder_init( &builder, G_VARIANT_TYPE( "au" ));
+			list = fma_boxed_get_uint_list( boxed );
+			for( il = list ; il ; il = il->next ){
+				g_variant_builder_add( &builder, "u", GPOINTER_TO_UINT( il->data ));
+			}
+			g_list_free( list );
+			value = g_variant_builder_end( &builder );
+			break;
+	}
+
+	return( value );
+}
@@ -0,0 +1,63 @@
+/*
+ * FileManager-Actions
+ * A file-manager extension which offers configurable context menu actions.
+ *
+ * Copyright (C) 2005 The GNOME Foundation
+ * Copyright (C) 2006-2008 Frederic Ruaudel and others (see AUTHORS)
+ * Copyright (C) 2009-2015 Pierre Wieser and others (see AUTHORS)
+ *
+ * FileManager-Actions is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * FileManager-Actions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FileManager-Actions; see the file COPYING. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Authors:
+ *   Frederic Ruaudel <grumz@grumz.net>
+ *   Rodrigo Moya <rodrigo@gnome-db.org>
+ *   Pierre Wieser <pwieser@trychlos.org>
+ *   ... and many others (see AUTHORS)
+ */
+
+#ifndef __CORE_FMA_PIVOT_SNAPSHOT_H__
+#define __CORE_FMA_PIVOT_SNAPSHOT_H__
+
+/* @title: FMAPivotSnapshot
+ * @short_description: A persistent snapshot of the FMAPivot tree of items.
+ * @include: core/fma-pivot-snapshot.h
+ *
+ * Each time the tree of items is actually loaded from the i/o providers,
+ * a compiled binary copy of it may be saved under $XDG_CACHE_HOME. The
+ * next loads map this file and rebuild the tree from it without parsing
+ * any .desktop file, as long as nothing has changed.
+ *
+ * The snapshot is identified by a key which is computed from the
+ * modification times and sizes of the sources the i/o providers read
+ * their items from (and of the files contained in the source
+ * directories), and of the configuration files. An i/o provider which
+ * is not able to list its sources prevents the snapshot to be used.
+ *
+ * The items rebuilt from a snapshot do not have any provider-specific
+ * data attached to them: they are fine for displaying menus, but not
+ * for being edited.
+ */
+
+#include "fma-pivot.h"
+
+G_BEGIN_DECLS
+
+gchar   *fma_pivot_snapshot_get_key( const FMAPivot *pivot, guint loadable_set );
+gboolean fma_pivot_snapshot_load   ( const FMAPivot *pivot, guint loadable_set, const gchar *key, GList **tree );
+void     fma_pivot_snapshot_save   ( GList *tree, guint loadable_set, const gchar *key );
+
+G_END_DECLS
+
+#endif /* __CORE_FMA_PIVOT_SNAPSHOT_H__ */
@@ -36,9 +36,16 @@
 #include <api/fma-core-utils.h>
 #include <api/fma-timeout.h>
 
+#include "fma-command-probe.h"
+#include "fma-condition-index.h"
+#include "fma-exec-cache.h"
 #include "fma-io-provider.h"
+#include "fma-mimetype-cache.h"
 #include "fma-module.h"
 #include "fma-pivot.h"
+#include "fma-pivot-snapshot.h"
+#include "fma-process-cache.h"
+#include "fma-tokens.h"
 
 /* private class data
  */
@@ -61,6 +68,37 @@ struct _FMAPivotPrivate {
 	 */
 	GList      *tree;
 
+	/* pre-compiled index of the context conditions of the tree
+	 */
+	FMAConditionIndex *index;
+
+	/* case-insensitive index of the items of the tree by their id
+	 * the keys are owned by the hash table, the items are not reffed
+	 */
+	GHashTable *items_by_id;
+
+	/* incremented each time the tree is replaced
+	 */
+	guint       generation;
+
+	/* bitmask of the per-item tokens used by the items of the tree
+	 */
+	guint       used_tokens;
+
+	/* whether the tree may be loaded from (and saved to) a snapshot
+	 */
+	gboolean    use_snapshot;
+
+	/* whether the tree may be incrementally updated from the paths
+	 * reported as changed by the i/o providers, and whether the last
+	 * burst of changes requires instead a full reload
+	 * changed_paths: the paths reported during the current burst, as a
+	 *  hash table FMAIIOProvider -> hash table (set) of paths
+	 */
+	gboolean    incremental;
+	gboolean    reload_needed;
+	GHashTable *changed_paths;
+
 	/* timeout to manage i/o providers 'item-changed' burst
 	 */
 	FMATimeout  change_timeout;
@@ -87,6 +125,7 @@ enum {
 
 static GObjectClass  *st_parent_class           = NULL;
 static gint           st_burst_timeout          = 100;		/* burst timeout in msec */
+static gint           st_burst_max_latency      = 1000;		/* max burst latency in msec */
 static gint           st_signals[ LAST_SIGNAL ] = { 0 };
 
 static GType          register_type( void );
@@ -98,7 +137,10 @@ static void           instance_set_property( GObject *object, guint property_id,
 static void           instance_dispose( GObject *object );
 static void           instance_finalize( GObject *object );
 
-static FMAObjectItem *get_item_from_tree( const FMAPivot *pivot, GList *tree, const gchar *id );
+static void           index_items_rec( GHashTable *items_by_id, GList *tree );
+static void           set_tree( FMAPivot *pivot, GList *tree );
+static void           refresh_tree( FMAPivot *pivot );
+static gboolean       update_tree( FMAPivot *pivot );
 
 /* FMAIIOProvider management */
 static void           on_items_changed_timeout( FMAPivot *pivot );
@@ -213,10 +255,16 @@ instance_init( GTypeInstance *instance, gpointer klass )
 	self->private->loadable_set = PIVOT_LOAD_NONE;
 	self->private->modules = NULL;
 	self->private->tree = NULL;
+	self->private->index = NULL;
+	self->private->items_by_id = g_hash_table_new_full(
+			fma_core_utils_str_ascii_case_hash, fma_core_utils_str_ascii_case_equal, g_free, NULL );
+	self->private->changed_paths = g_hash_table_new_full(
+			g_direct_hash, g_direct_equal, NULL, ( GDestroyNotify ) g_hash_table_unref );
 
 	/* initialize timeout parameters for 'item-changed' handler
 	 */
 	self->private->change_timeout.timeout = st_burst_timeout;
+	self->private->change_timeout.max_latency = st_burst_max_latency;
 	self->private->change_timeout.handler = ( FMATimeoutFunc ) on_items_changed_timeout;
 	self->private->change_timeout.user_data = self;
 	self->private->change_timeout.source_id = 0;
@@ -293,6 +341,7 @@ instance_set_property( GObject *object, guint property_id, const GValue *value,
 
 			case PIVOT_PROP_TREE_ID:
 				self->private->tree = g_value_get_pointer( value );
+				refresh_tree( self );
 				break;
 
 			default:
@@ -326,11 +375,30 @@ instance_dispose( GObject *object )
 		g_debug( "%s: tree=%p (count=%u)", thisfn,
 				( void * ) self->private->tree, g_list_length( self->private->tree ));
 		fma_object_dump_tree( self->private->tree );
+		fma_condition_index_free( self->private->index );
+		self->private->index = NULL;
+		g_hash_table_remove_all( self->private->items_by_id );
 		self->private->tree = fma_object_free_items( self->private->tree );
+		g_hash_table_unref( self->private->items_by_id );
+		self->private->items_by_id = NULL;
+		g_hash_table_unref( self->private->changed_paths );
+		self->private->changed_paths = NULL;
 
 		/* release the settings */
 		fma_settings_free();
 
+		/* release the mimetype cache */
+		fma_mimetype_cache_free();
+
+		/* release the results of the ShowIfTrue commands */
+		fma_command_probe_free();
+
+		/* release the set of running processes */
+		fma_process_cache_free();
+
+		/* release the resolutions of the TryExec keys */
+		fma_exec_cache_free();
+
 		/* release the I/O Provider object list */
 		fma_io_provider_unref_io_providers_list();
 
@@ -413,11 +481,22 @@ fma_pivot_dump( const FMAPivot *pivot )
 		g_debug( "%s: loadable_set=%d", thisfn, pivot->private->loadable_set );
 		g_debug( "%s:      modules=%p (%d elts)", thisfn, ( void * ) pivot->private->modules, g_list_length( pivot->private->modules ));
 		g_debug( "%s:         tree=%p (%d elts)", thisfn, ( void * ) pivot->private->tree, g_list_length( pivot->private->tree ));
+		g_debug( "%s:   generation=%u", thisfn, pivot->private->generation );
+		g_debug( "%s:      changes=%u flushes, %u coalesced events", thisfn,
+				fma_timeout_get_flushes( &pivot->private->change_timeout ),
+				fma_timeout_get_coalesced( &pivot->private->change_timeout ));
 		/*g_debug( "%s:     monitors=%p (%d elts)", thisfn, ( void * ) pivot->private->monitors, g_list_length( pivot->private->monitors ));*/
 
 		for( it = pivot->private->tree, i = 0 ; it ; it = it->next ){
 			g_debug( "%s:     [%d]: %p", thisfn, i++, it->data );
 		}
+
+		fma_condition_index_dump( pivot->private->index );
+		fma_icontext_dump_stats();
+		fma_mimetype_cache_dump();
+		fma_command_probe_dump();
+		fma_process_cache_dump();
+		fma_exec_cache_dump();
 	}
 }
 
@@ -495,33 +574,38 @@ fma_pivot_get_item( const FMAPivot *pivot, const gchar *id )
 			return( NULL );
 		}
 
-		object = get_item_from_tree( pivot, pivot->private->tree, id );
+		object = g_hash_table_lookup( pivot->private->items_by_id, id );
 	}
 
 	return( object );
 }
 
-static FMAObjectItem *
-get_item_from_tree( const FMAPivot *pivot, GList *tree, const gchar *id )
+/*
+ * index the items of the tree by their id, recursing in menus
+ * in case of duplicate ids, the first found in the tree wins
+ */
+static void
+index_items_rec( GHashTable *items_by_id, GList *tree )
 {
-	GList *subitems, *ia;
-	FMAObjectItem *found = NULL;
+	GList *it;
+	gchar *id;
 
-	for( ia = tree ; ia && !found ; ia = ia->next ){
+	for( it = tree ; it ; it = it->next ){
 
-		gchar *i_id = fma_object_get_id( FMA_OBJECT( ia->data ));
+		if( FMA_IS_OBJECT_ITEM( it->data )){
+			id = fma_object_get_id( it->data );
 
-		if( !g_ascii_strcasecmp( id, i_id )){
-			found = FMA_OBJECT_ITEM( ia->data );
-		}
+			if( id && !g_hash_table_contains( items_by_id, id )){
+				g_hash_table_insert( items_by_id, id, it->data );
+			} else {
+				g_free( id );
+			}
 
-		if( !found && FMA_IS_OBJECT_ITEM( ia->data )){
-			subitems = fma_object_get_items( ia->data );
-			found = get_item_from_tree( pivot, subitems, id );
+			if( FMA_IS_OBJECT_MENU( it->data )){
+				index_items_rec( items_by_id, fma_object_get_items( it->data ));
+			}
 		}
 	}
-
-	return( found );
 }
 
 /*
@@ -561,22 +645,49 @@ fma_pivot_load_items( FMAPivot *pivot )
 {
 	static const gchar *thisfn = "fma_pivot_load_items";
 	GSList *messages, *im;
+	GList *tree;
+	gchar *key;
 
 	g_return_if_fail( FMA_IS_PIVOT( pivot ));
 
 	if( !pivot->private->dispose_has_run ){
 
-		g_debug( "%s: pivot=%p", thisfn, ( void * ) pivot );
+		g_debug( "%s: pivot=%p, use_snapshot=%s",
+				thisfn, ( void * ) pivot, pivot->private->use_snapshot ? "True":"False" );
+
+		/* the monitors of the mime database are attached to the
+		 * context of the loading thread
+		 */
+		fma_mimetype_cache_init();
+
+		/* the key is computed before loading the items, so that a
+		 * modification which happens while loading leads to a key
+		 * mismatch on next load
+		 */
+		key = NULL;
+		if( pivot->private->use_snapshot ){
+			key = fma_pivot_snapshot_get_key( pivot, pivot->private->loadable_set );
+		}
+
+		if( !key || !fma_pivot_snapshot_load( pivot, pivot->private->loadable_set, key, &tree )){
 
-		messages = NULL;
-		fma_object_free_items( pivot->private->tree );
-		pivot->private->tree = fma_io_provider_load_items( pivot, pivot->private->loadable_set, &messages );
+			messages = NULL;
+			tree = fma_io_provider_load_items( pivot, pivot->private->loadable_set, &messages );
 
-		for( im = messages ; im ; im = im->next ){
-			g_warning( "%s: %s", thisfn, ( const gchar * ) im->data );
+			for( im = messages ; im ; im = im->next ){
+				g_warning( "%s: %s", thisfn, ( const gchar * ) im->data );
+			}
+
+			fma_core_utils_slist_free( messages );
+
+			if( key ){
+				fma_pivot_snapshot_save( tree, pivot->private->loadable_set, key );
+			}
 		}
 
-		fma_core_utils_slist_free( messages );
+		set_tree( pivot, tree );
+		pivot->private->reload_needed = FALSE;
+		g_free( key );
 	}
 }
 
@@ -600,11 +711,226 @@ fma_pivot_set_new_items( FMAPivot *pivot, GList *items )
 		g_debug( "%s: pivot=%p, items=%p (count=%d)",
 				thisfn, ( void * ) pivot, ( void * ) items, items ? g_list_length( items ) : 0 );
 
-		fma_object_free_items( pivot->private->tree );
-		pivot->private->tree = items;
+		set_tree( pivot, items );
+	}
+}
+
+/*
+ * fma_pivot_items_changed_in_place:
+ * @pivot: this #FMAPivot instance.
+ *
+ * Must be called after the children of a menu of the tree have been
+ * modified in place, so that the items index, the condition index and
+ * the used tokens are rebuilt from the current tree.
+ */
+void
+fma_pivot_items_changed_in_place( FMAPivot *pivot )
+{
+	g_return_if_fail( FMA_IS_PIVOT( pivot ));
+
+	if( !pivot->private->dispose_has_run ){
+
+		refresh_tree( pivot );
 	}
 }
 
+/*
+ * replace the current tree with the new one, rebuilding the condition
+ * index accordingly
+ */
+static void
+set_tree( FMAPivot *pivot, GList *tree )
+{
+	fma_condition_index_free( pivot->private->index );
+	pivot->private->index = NULL;
+	g_hash_table_remove_all( pivot->private->items_by_id );
+	fma_object_free_items( pivot->private->tree );
+
+	pivot->private->tree = tree;
+	refresh_tree( pivot );
+}
+
+/*
+ * rebuild all what is computed from the current tree
+ */
+static void
+refresh_tree( FMAPivot *pivot )
+{
+	fma_condition_index_free( pivot->private->index );
+
+	pivot->private->index = fma_condition_index_new( pivot->private->tree );
+	g_hash_table_remove_all( pivot->private->items_by_id );
+	index_items_rec( pivot->private->items_by_id, pivot->private->tree );
+	pivot->private->used_tokens = fma_tokens_scan_items( pivot->private->tree );
+	pivot->private->generation += 1;
+}
+
+/*
+ * only re-read the items which are concerned by the paths reported as
+ * changed during the last burst
+ *
+ * Returns: %TRUE if the tree is up to date, %FALSE if it must be fully
+ * reloaded
+ */
+static gboolean
+update_tree( FMAPivot *pivot )
+{
+	static const gchar *thisfn = "fma_pivot_update_tree";
+	GHashTableIter iter;
+	gpointer module, paths_set;
+	GList *keys, *ik;
+	GSList *paths, *messages, *im;
+	gboolean ok;
+	gchar *key;
+
+	ok = TRUE;
+	messages = NULL;
+	g_hash_table_iter_init( &iter, pivot->private->changed_paths );
+
+	while( ok && g_hash_table_iter_next( &iter, &module, &paths_set )){
+		paths = NULL;
+		keys = g_hash_table_get_keys(( GHashTable * ) paths_set );
+		for( ik = keys ; ik ; ik = ik->next ){
+			paths = g_slist_prepend( paths, ik->data );
+		}
+		g_list_free( keys );
+
+		ok = fma_io_provider_update_items( pivot,
+				pivot->private->loadable_set, &pivot->private->tree, FMA_IIO_PROVIDER( module ), paths, &messages );
+
+		g_slist_free( paths );
+	}
+
+	for( im = messages ; im ; im = im->next ){
+		g_warning( "%s: %s", thisfn, ( const gchar * ) im->data );
+	}
+	fma_core_utils_slist_free( messages );
+
+	/* even a partial update must be reflected in the condition index,
+	 * which does not hold any reference on the items
+	 */
+	refresh_tree( pivot );
+
+	if( ok && pivot->private->use_snapshot ){
+		key = fma_pivot_snapshot_get_key( pivot, pivot->private->loadable_set );
+		if( key ){
+			fma_pivot_snapshot_save( pivot->private->tree, pivot->private->loadable_set, key );
+			g_free( key );
+		}
+	}
+
+	g_debug( "%s: pivot=%p, ok=%s", thisfn, ( void * ) pivot, ok ? "True":"False" );
+
+	return( ok );
+}
+
+/*
+ * fma_pivot_get_generation:
+ * @pivot: this #FMAPivot instance.
+ *
+ * Returns: a counter which is incremented each time the tree of items
+ * is replaced, so that consumers are able to detect that the results
+ * they have computed from a previous tree are stale.
+ */
+guint
+fma_pivot_get_generation( const FMAPivot *pivot )
+{
+	guint generation;
+
+	g_return_val_if_fail( FMA_IS_PIVOT( pivot ), 0 );
+
+	generation = 0;
+
+	if( !pivot->private->dispose_has_run ){
+
+		generation = pivot->private->generation;
+	}
+
+	return( generation );
+}
+
+/*
+ * fma_pivot_get_used_tokens:
+ * @pivot: this #FMAPivot instance.
+ *
+ * Returns: the bitmask of the per-item tokens which are used by the
+ * current tree of items, as computed by fma_tokens_scan_items() each
+ * time the tree is replaced.
+ */
+guint
+fma_pivot_get_used_tokens( const FMAPivot *pivot )
+{
+	guint used;
+
+	g_return_val_if_fail( FMA_IS_PIVOT( pivot ), 0 );
+
+	used = 0;
+
+	if( !pivot->private->dispose_has_run ){
+
+		used = pivot->private->used_tokens;
+	}
+
+	return( used );
+}
+
+/*
+ * fma_pivot_get_candidates:
+ * @pivot: this #FMAPivot instance.
+ * @target: the targeted file manager UI.
+ * @selection: the current selection, as a #GList of FMASelectedInfo items.
+ *
+ * Pre-filters the items of the tree against the condition index.
+ *
+ * Returns: the set of the #FMAIContext objects (menus, actions and
+ * profiles) which may be candidate to the @selection, or %NULL if the
+ * items cannot be pre-filtered. A context which is not in the set is
+ * known to fail fma_icontext_is_candidate().
+ *
+ * The returned hash table should be g_hash_table_destroy() by the caller.
+ */
+GHashTable *
+fma_pivot_get_candidates( const FMAPivot *pivot, guint target, GList *selection )
+{
+	GHashTable *candidates;
+
+	g_return_val_if_fail( FMA_IS_PIVOT( pivot ), NULL );
+
+	candidates = NULL;
+
+	if( !pivot->private->dispose_has_run ){
+
+		candidates = fma_condition_index_get_candidates( pivot->private->index, target, selection );
+	}
+
+	return( candidates );
+}
+
+/*
+ * fma_pivot_get_selection_attributes:
+ * @pivot: this #FMAPivot instance.
+ *
+ * Returns: the set of FMASelectedInfoAttribute file attributes which have
+ * to be queried for the selected items in order to evaluate the
+ * conditions of the currently loaded items.
+ */
+guint
+fma_pivot_get_selection_attributes( const FMAPivot *pivot )
+{
+	guint attributes;
+
+	g_return_val_if_fail( FMA_IS_PIVOT( pivot ), 0 );
+
+	attributes = 0;
+
+	if( !pivot->private->dispose_has_run ){
+
+		attributes = fma_condition_index_get_attributes( pivot->private->index );
+	}
+
+	return( attributes );
+}
+
 /*
  * fma_pivot_on_item_changed_handler:
  * @provider: the #FMAIIOProvider which has emitted the signal.
@@ -631,6 +957,48 @@ fma_pivot_on_item_changed_handler( FMAIIOProvider *provider, FMAPivot *pivot  )
 	if( !pivot->private->dispose_has_run ){
 		g_debug( "%s: provider=%p, pivot=%p", thisfn, ( void * ) provider, ( void * ) pivot );
 
+		pivot->private->reload_needed = TRUE;
+		fma_timeout_event( &pivot->private->change_timeout );
+	}
+}
+
+/*
+ * fma_pivot_on_paths_changed_handler:
+ * @provider: the #FMAIIOProvider which has emitted the signal.
+ * @paths: the list of changed paths.
+ * @pivot: this #FMAPivot instance.
+ *
+ * This handler is trigerred by #FMAIIOProvider providers which are able
+ * to report the paths which have changed in their underlying storage
+ * subsystems.
+ *
+ * The paths are accumulated until the end of the notifications serie,
+ * so that only the concerned items have then to be re-read.
+ */
+void
+fma_pivot_on_paths_changed_handler( FMAIIOProvider *provider, GSList *paths, FMAPivot *pivot )
+{
+	static const gchar *thisfn = "fma_pivot_on_paths_changed_handler";
+	GHashTable *paths_set;
+	GSList *ip;
+
+	g_return_if_fail( FMA_IS_IIO_PROVIDER( provider ));
+	g_return_if_fail( FMA_IS_PIVOT( pivot ));
+
+	if( !pivot->private->dispose_has_run ){
+		g_debug( "%s: provider=%p, paths=%p (count=%d), pivot=%p",
+				thisfn, ( void * ) provider, ( void * ) paths, g_slist_length( paths ), ( void * ) pivot );
+
+		paths_set = g_hash_table_lookup( pivot->private->changed_paths, provider );
+		if( !paths_set ){
+			paths_set = g_hash_table_new_full( g_str_hash, g_str_equal, g_free, NULL );
+			g_hash_table_insert( pivot->private->changed_paths, provider, paths_set );
+		}
+
+		for( ip = paths ; ip ; ip = ip->next ){
+			g_hash_table_add( paths_set, g_strdup(( const gchar * ) ip->data ));
+		}
+
 		fma_timeout_event( &pivot->private->change_timeout );
 	}
 }
@@ -648,10 +1016,91 @@ on_items_changed_timeout( FMAPivot *pivot )
 
 	g_return_if_fail( FMA_IS_PIVOT( pivot ));
 
+	if( !pivot->private->reload_needed ){
+		if( !pivot->private->incremental || !update_tree( pivot )){
+			pivot->private->reload_needed = TRUE;
+		}
+	}
+
+	g_hash_table_remove_all( pivot->private->changed_paths );
+
 	g_debug( "%s: emitting %s signal", thisfn, PIVOT_SIGNAL_ITEMS_CHANGED );
 	g_signal_emit_by_name(( gpointer ) pivot, PIVOT_SIGNAL_ITEMS_CHANGED );
 }
 
+/*
+ * fma_pivot_set_incremental_reload:
+ * @pivot: this #FMAPivot instance.
+ * @incremental: whether the tree of items may be incrementally updated.
+ *
+ * When set, and the i/o providers report which paths have changed, the
+ * pivot only re-reads the concerned items, and updates its tree before
+ * emitting its 'items-changed' signal. fma_pivot_is_reload_needed() then
+ * tells the consumers whether they still have to fully reload the items.
+ *
+ * As the tree is updated under the feet of the consumers, this should
+ * only be set by consumers which do not keep their own copy of the items.
+ */
+void
+fma_pivot_set_incremental_reload( FMAPivot *pivot, gboolean incremental )
+{
+	g_return_if_fail( FMA_IS_PIVOT( pivot ));
+
+	if( !pivot->private->dispose_has_run ){
+
+		pivot->private->incremental = incremental;
+	}
+}
+
+/*
+ * fma_pivot_is_reload_needed:
+ * @pivot: this #FMAPivot instance.
+ *
+ * Returns: %TRUE if the changes signaled by the last 'items-changed'
+ * signal have not been applied to the tree of items, and require a call
+ * to fma_pivot_load_items().
+ */
+gboolean
+fma_pivot_is_reload_needed( const FMAPivot *pivot )
+{
+	gboolean needed;
+
+	g_return_val_if_fail( FMA_IS_PIVOT( pivot ), TRUE );
+
+	needed = TRUE;
+
+	if( !pivot->private->dispose_has_run ){
+
+		needed = pivot->private->reload_needed;
+	}
+
+	return( needed );
+}
+
+/*
+ * fma_pivot_set_use_snapshot:
+ * @pivot: this #FMAPivot instance.
+ * @use_snapshot: whether the tree of items may be loaded from a snapshot.
+ *
+ * When set, fma_pivot_load_items() rebuilds the tree from the snapshot
+ * saved by a previous load as long as the sources of the items have not
+ * changed, and saves a new snapshot else.
+ *
+ * As the items rebuilt from a snapshot do not embed any i/o
+ * provider-specific data, this should only be set by consumers which
+ * do not update the items.
+ */
+void
+fma_pivot_set_use_snapshot( FMAPivot *pivot, gboolean use_snapshot )
+{
+	g_return_if_fail( FMA_IS_PIVOT( pivot ));
+
+	if( !pivot->private->dispose_has_run ){
+
+		pivot->private->use_snapshot = use_snapshot;
+	}
+}
+
 /*
  * fma_pivot_set_loadable:
  * @pivot: this #FMAPivot instance.
@@ -149,12 +149,21 @@ FMAObjectItem *fma_pivot_get_item               ( const FMAPivot *pivot, const g
 GList         *fma_pivot_get_items              ( const FMAPivot *pivot );
 void           fma_pivot_load_items             ( FMAPivot *pivot );
 void           fma_pivot_set_new_items          ( FMAPivot *pivot, GList *tree );
+void           fma_pivot_items_changed_in_place ( FMAPivot *pivot );
+guint          fma_pivot_get_generation         ( const FMAPivot *pivot );
+guint          fma_pivot_get_used_tokens        ( const FMAPivot *pivot );
+GHashTable    *fma_pivot_get_candidates         ( const FMAPivot *pivot, guint target, GList *selection );
+guint          fma_pivot_get_selection_attributes( const FMAPivot *pivot );
 
 void           fma_pivot_on_item_changed_handler( FMAIIOProvider *provider, FMAPivot *pivot  );
+void           fma_pivot_on_paths_changed_handler( FMAIIOProvider *provider, GSList *paths, FMAPivot *pivot );
+gboolean       fma_pivot_is_reload_needed       ( const FMAPivot *pivot );
 
 /* FMAPivot properties and configuration
  */
 void           fma_pivot_set_loadable           ( FMAPivot *pivot, guint loadable );
+void           fma_pivot_set_use_snapshot       ( FMAPivot *pivot, gboolean use_snapshot );
+void           fma_pivot_set_incremental_reload ( FMAPivot *pivot, gboolean incremental );
 
 G_END_DECLS
 
@@ -0,0 +1,221 @@
+/*
+ * FileManager-Actions
+ * A file-manager extension which offers configurable context menu actions.
+ *
+ * Copyright (C) 2005 The GNOME Foundation
+ * Copyright (C) 2006-2008 Frederic Ruaudel and others (see AUTHORS)
+ * Copyright (C) 2009-2015 Pierre Wieser and others (see AUTHORS)
+ *
+ * FileManager-Actions is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * FileManager-Actions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FileManager-Actions; see the file COPYING. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Authors:
+ *   Frederic Ruaudel <grumz@grumz.net>
+ *   Rodrigo Moya <rodrigo@gnome-db.org>
+ *   Pierre Wieser <pwieser@trychlos.org>
+ *   ... and many others (see AUTHORS)
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <sys/types.h>
+#include <glibtop/proclist.h>
+#include <glibtop/procstate.h>
+
+#include "fma-process-cache.h"
+#include "fma-settings.h"
+
+typedef struct {
+	GHashTable *names;
+	gint64      scanned_at;			/* monotonic time, in usec; zero if never scanned */
+	gboolean    round_pending;		/* a new evaluation round has begun */
+	guint       scans;
+	guint       lookups;
+}
+	sCache;
+
+/* the maximal age of the set when the refresh interval is zero, in msec
+ */
+#define PROCESS_CACHE_MAX_AGE			5000
+
+static sCache *st_cache = NULL;
+
+G_LOCK_DEFINE_STATIC( st_cache );
+
+static gboolean cache_is_stale( const sCache *cache, guint interval );
+static void     cache_scan( sCache *cache );
+
+/*
+ * fma_process_cache_is_running:
+ * @name: the name of the searched process.
+ *
+ * Returns: %TRUE if a process with this @name is running, %FALSE else.
+ */
+gboolean
+fma_process_cache_is_running( const gchar *name )
+{
+	guint interval;
+	gboolean running;
+
+	g_return_val_if_fail( name, FALSE );
+
+	interval = fma_settings_get_uint( IPREFS_SHOW_IF_RUNNING_INTERVAL, NULL, NULL );
+
+	G_LOCK( st_cache );
+
+	if( !st_cache ){
+		st_cache = g_new0( sCache, 1 );
+		st_cache->names = g_hash_table_new_full( g_str_hash, g_str_equal, g_free, NULL );
+	}
+
+	if( cache_is_stale( st_cache, interval )){
+		cache_scan( st_cache );
+	}
+
+	st_cache->lookups += 1;
+	running = ( g_hash_table_lookup( st_cache->names, name ) != NULL );
+
+	G_UNLOCK( st_cache );
+
+	return( running );
+}
+
+/*
+ * fma_process_cache_begin:
+ *
+ * Begins a new evaluation round, e.g. the build of a new menu.
+ */
+void
+fma_process_cache_begin( void )
+{
+	G_LOCK( st_cache );
+
+	if( st_cache ){
+		st_cache->round_pending = TRUE;
+	}
+
+	G_UNLOCK( st_cache );
+}
+
+/*
+ * fma_process_cache_get_stats:
+ * @scans: [out]: the count of scans of the process table.
+ * @lookups: [out]: the count of lookups.
+ * @processes: [out]: the count of distinct process names at last scan.
+ *
+ * Each of the output parameters may be %NULL.
+ */
+void
+fma_process_cache_get_stats( guint *scans, guint *lookups, guint *processes )
+{
+	G_LOCK( st_cache );
+
+	if( scans ){
+		*scans = st_cache ? st_cache->scans : 0;
+	}
+	if( lookups ){
+		*lookups = st_cache ? st_cache->lookups : 0;
+	}
+	if( processes ){
+		*processes = st_cache ? g_hash_table_size( st_cache->names ) : 0;
+	}
+
+	G_UNLOCK( st_cache );
+}
+
+/*
+ * fma_process_cache_dump:
+ *
+ * Dumps the statistics of the cache.
+ */
+void
+fma_process_cache_dump( void )
+{
+	static const gchar *thisfn = "fma_process_cache_dump";
+	guint scans, lookups, processes;
+
+	fma_process_cache_get_stats( &scans, &lookups, &processes );
+
+	g_debug( "%s: processes=%u, scans=%u, lookups=%u", thisfn, processes, scans, lookups );
+}
+
+/*
+ * fma_process_cache_free:
+ *
+ * Releases the cache.
+ */
+void
+fma_process_cache_free( void )
+{
+	G_LOCK( st_cache );
+
+	if( st_cache ){
+		g_hash_table_destroy( st_cache->names );
+		g_free( st_cache );
+		st_cache = NULL;
+	}
+
+	G_UNLOCK( st_cache );
+}
+
+static gboolean
+cache_is_stale( const sCache *cache, guint interval )
+{
+	gint64 age;
+
+	if( !cache->scanned_at ){
+		return( TRUE );
+	}
+
+	age = ( g_get_monotonic_time() - cache->scanned_at ) / G_TIME_SPAN_MILLISECOND;
+
+	if( interval ){
+		return( age >= interval );
+	}
+
+	return( cache->round_pending || age >= PROCESS_CACHE_MAX_AGE );
+}
+
+/*
+ * collect the names of the running processes
+ */
+static void
+cache_scan( sCache *cache )
+{
+	static const gchar *thisfn = "fma_process_cache_scan";
+	glibtop_proclist proclist;
+	glibtop_proc_state procstate;
+	pid_t *pid_list;
+	guint i;
+
+	g_hash_table_remove_all( cache->names );
+	pid_list = glibtop_get_proclist( &proclist, GLIBTOP_KERN_PROC_ALL, 0 );
+
+	for( i = 0 ; i < proclist.number ; ++i ){
+		glibtop_get_proc_state( &procstate, pid_list[i] );
+		if( procstate.cmd[0] ){
+			g_hash_table_insert( cache->names, g_strdup( procstate.cmd ), GUINT_TO_POINTER( 1 ));
+		}
+	}
+
+	g_free( pid_list );
+
+	cache->scanned_at = g_get_monotonic_time();
+	cache->round_pending = FALSE;
+	cache->scans += 1;
+
+	g_debug( "%s: %u processes, %u distinct names", thisfn, ( guint ) proclist.number, g_hash_table_size( cache->names ));
+}
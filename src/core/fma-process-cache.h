@@ -0,0 +1,63 @@
+/*
+ * FileManager-Actions
+ * A file-manager extension which offers configurable context menu actions.
+ *
+ * Copyright (C) 2005 The GNOME Foundation
+ * Copyright (C) 2006-2008 Frederic Ruaudel and others (see AUTHORS)
+ * Copyright (C) 2009-2015 Pierre Wieser and others (see AUTHORS)
+ *
+ * FileManager-Actions is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * FileManager-Actions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FileManager-Actions; see the file COPYING. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Authors:
+ *   Frederic Ruaudel <grumz@grumz.net>
+ *   Rodrigo Moya <rodrigo@gnome-db.org>
+ *   Pierre Wieser <pwieser@trychlos.org>
+ *   ... and many others (see AUTHORS)
+ */
+
+#ifndef __CORE_FMA_PROCESS_CACHE_H__
+#define __CORE_FMA_PROCESS_CACHE_H__
+
+/* @title: Process Cache
+ * @short_description: A shared set of the names of the running processes.
+ * @include: core/fma-process-cache.h
+ *
+ * A ShowIfRunning condition is satisfied when a process of the given
+ * name is running. Scanning the process table costs a system call per
+ * process, and this adds up quickly when each condition scans it again
+ * for each menu.
+ *
+ * The names of the running processes are rather collected in a set
+ * which is shared by all the conditions. The set is refreshed at most
+ * once per IPREFS_SHOW_IF_RUNNING_INTERVAL msec. When this interval is
+ * zero, the set is refreshed once per evaluation round, i.e. at the
+ * first lookup after fma_process_cache_begin() has been called; it is
+ * anyway never kept more than a few seconds.
+ */
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+gboolean fma_process_cache_is_running( const gchar *name );
+
+void     fma_process_cache_begin     ( void );
+void     fma_process_cache_get_stats ( guint *scans, guint *lookups, guint *processes );
+void     fma_process_cache_dump      ( void );
+void     fma_process_cache_free      ( void );
+
+G_END_DECLS
+
+#endif /* __CORE_FMA_PROCESS_CACHE_H__ */
@@ -49,6 +49,8 @@ struct _FMASelectedInfoClassPrivate {
 struct _FMASelectedInfoPrivate {
 	gboolean       dispose_has_run;
 	gchar         *uri;
+	guint          derived;
+	gchar         *vfs_path;
 	gchar         *filename;
 	gchar         *dirname;
 	gchar         *basename;
@@ -66,7 +68,47 @@ struct _FMASelectedInfoPrivate {
 };
 
 
+/* a batch of attribute probes
+ * the batch is shared between the caller and the worker threads, and
+ * survives the caller when some probes have not been completed before
+ * the deadline
+ */
+typedef struct {
+	gint          ref_count;
+	GAsyncQueue  *done;
+	GCancellable *cancellable;
+	gchar        *attributes;
+}
+	sProbeBatch;
+
+/* one probe per selected item
+ * the worker thread only touches the 'location', 'info' and 'error'
+ * members - the 'nsi' one is only used by the caller
+ */
+typedef struct {
+	sProbeBatch     *batch;
+	FMASelectedInfo *nsi;
+	GFile           *location;
+	GFileInfo       *info;
+	GError          *error;
+}
+	sProbeJob;
+
+#define PROBE_MAX_THREADS				8
+
+/* the fields which are lazily derived from the URI on first access
+ */
+enum {
+	DERIVED_URI_PARTS = 1 << 0,			/* vfs_path, hostname, username, scheme and port */
+	DERIVED_PATHS     = 1 << 1,			/* filename, dirname and basename */
+};
+
+#define SELECTED_INFO_SUMMARY			"fma-selected-info-summary"
+
 static GObjectClass *st_parent_class = NULL;
+static GThreadPool  *st_probe_pool   = NULL;
+
+G_LOCK_DEFINE_STATIC( st_probe_pool );
 
 static GType            register_type( void );
 static void             class_init( FMASelectedInfoClass *klass );
@@ -77,7 +119,21 @@ static void             instance_finalize( GObject *object );
 static void             dump( const FMASelectedInfo *nsi );
 static const char      *dump_file_type( GFileType type );
 static FMASelectedInfo *new_from_uri( const gchar *uri, const gchar *mimetype, gchar **errmsg );
+static FMASelectedInfo *new_from_uri_without_attributes( const gchar *uri, const gchar *mimetype );
+static void             derive_uri_parts( const FMASelectedInfo *nsi );
+static void             derive_paths( const FMASelectedInfo *nsi );
+static FMASelectionSummary *summary_new( GList *files, gboolean registered );
+static void             summary_build( FMASelectionSummary *summary, guint parts );
+static void             summary_clear( FMASelectionSummary *summary );
+static void             summary_free( FMASelectionSummary *summary );
 static void             query_file_attributes( FMASelectedInfo *info, GFile *location, gchar **errmsg );
+static void             set_file_attributes( FMASelectedInfo *nsi, GFileInfo *info );
+static gchar           *get_query_attributes( guint attributes );
+static GThreadPool     *probe_get_pool( void );
+static void             probe_run( sProbeJob *job, void *empty );
+static sProbeBatch     *probe_batch_ref( sProbeBatch *batch );
+static void             probe_batch_unref( sProbeBatch *batch );
+static void             probe_job_free( sProbeJob *job );
 
 GType
 fma_selected_info_get_type( void )
@@ -186,6 +242,7 @@ instance_finalize( GObject *object )
 	g_debug( "%s: object=%p (%s)", thisfn, ( void * ) object, G_OBJECT_TYPE_NAME( object ));
 
 	g_free( self->private->uri );
+	g_free( self->private->vfs_path );
 	g_free( self->private->filename );
 	g_free( self->private->dirname );
 	g_free( self->private->basename );
@@ -256,6 +313,7 @@ fma_selected_info_get_basename( const FMASelectedInfo *nsi )
 
 	if( !nsi->private->dispose_has_run ){
 
+		derive_paths( nsi );
 		basename = g_strdup( nsi->private->basename );
 	}
 
@@ -281,6 +339,7 @@ fma_selected_info_get_dirname( const FMASelectedInfo *nsi )
 
 	if( !nsi->private->dispose_has_run ){
 
+		derive_paths( nsi );
 		dirname = g_strdup( nsi->private->dirname );
 	}
 
@@ -331,6 +390,7 @@ fma_selected_info_get_path( const FMASelectedInfo *nsi )
 
 	if( !nsi->private->dispose_has_run ){
 
+		derive_paths( nsi );
 		path = g_strdup( nsi->private->filename );
 	}
 
@@ -379,6 +439,7 @@ fma_selected_info_get_uri_host( const FMASelectedInfo *nsi )
 
 	if( !nsi->private->dispose_has_run ){
 
+		derive_uri_parts( nsi );
 		host = g_strdup( nsi->private->hostname );
 	}
 
@@ -403,6 +464,7 @@ fma_selected_info_get_uri_user( const FMASelectedInfo *nsi )
 
 	if( !nsi->private->dispose_has_run ){
 
+		derive_uri_parts( nsi );
 		user = g_strdup( nsi->private->username );
 	}
 
@@ -426,6 +488,7 @@ fma_selected_info_get_uri_port( const FMASelectedInfo *nsi )
 
 	if( !nsi->private->dispose_has_run ){
 
+		derive_uri_parts( nsi );
 		port = nsi->private->port;
 	}
 
@@ -450,6 +513,7 @@ fma_selected_info_get_uri_scheme( const FMASelectedInfo *nsi )
 
 	if( !nsi->private->dispose_has_run ){
 
+		derive_uri_parts( nsi );
 		scheme = g_strdup( nsi->private->scheme );
 	}
 
@@ -535,7 +599,6 @@ gboolean
 fma_selected_info_is_local( const FMASelectedInfo *nsi )
 {
 	gboolean is_local;
-	gchar *scheme;
 
 	g_return_val_if_fail( FMA_IS_SELECTED_INFO( nsi ), FALSE );
 
@@ -543,9 +606,8 @@ fma_selected_info_is_local( const FMASelectedInfo *nsi )
 
 	if( !nsi->private->dispose_has_run ){
 
-		scheme = fma_selected_info_get_uri_scheme( nsi );
-		is_local = ( strcmp( scheme, "file" ) == 0 );
-		g_free( scheme );
+		derive_uri_parts( nsi );
+		is_local = ( g_strcmp0( nsi->private->scheme, "file" ) == 0 );
 	}
 
 	return( is_local );
@@ -569,7 +631,7 @@ fma_selected_info_is_owner( const FMASelectedInfo *nsi, const gchar *user )
 
 	if( !nsi->private->dispose_has_run ){
 
-		is_owner = ( strcmp( nsi->private->owner, user ) == 0 );
+		is_owner = ( g_strcmp0( nsi->private->owner, user ) == 0 );
 	}
 
 	return( is_owner );
@@ -621,6 +683,104 @@ fma_selected_info_is_writable( const FMASelectedInfo *nsi )
 	return( is_writable );
 }
 
+/*
+ * fma_selected_info_peek_basename:
+ * @nsi: this #FMASelectedInfo object.
+ *
+ * Returns: the basename of the file associated with this
+ * #FMASelectedInfo object. The returned string is owned by the @nsi
+ * object, and should not be released by the caller.
+ */
+const gchar *
+fma_selected_info_peek_basename( const FMASelectedInfo *nsi )
+{
+	g_return_val_if_fail( FMA_IS_SELECTED_INFO( nsi ), NULL );
+
+	if( nsi->private->dispose_has_run ){
+		return( NULL );
+	}
+
+	derive_paths( nsi );
+
+	return( nsi->private->basename );
+}
+
+/*
+ * fma_selected_info_peek_dirname:
+ * @nsi: this #FMASelectedInfo object.
+ *
+ * Returns: the dirname of the file associated with this
+ * #FMASelectedInfo object. The returned string is owned by the @nsi
+ * object, and should not be released by the caller.
+ */
+const gchar *
+fma_selected_info_peek_dirname( const FMASelectedInfo *nsi )
+{
+	g_return_val_if_fail( FMA_IS_SELECTED_INFO( nsi ), NULL );
+
+	if( nsi->private->dispose_has_run ){
+		return( NULL );
+	}
+
+	derive_paths( nsi );
+
+	return( nsi->private->dirname );
+}
+
+/*
+ * fma_selected_info_peek_mime_type:
+ * @nsi: this #FMASelectedInfo object.
+ *
+ * Returns: the mime type associated with this #FMASelectedInfo object.
+ * The returned string is owned by the @nsi object, and should not be
+ * released by the caller.
+ */
+const gchar *
+fma_selected_info_peek_mime_type( const FMASelectedInfo *nsi )
+{
+	g_return_val_if_fail( FMA_IS_SELECTED_INFO( nsi ), NULL );
+
+	return( nsi->private->dispose_has_run ? NULL : nsi->private->mimetype );
+}
+
+/*
+ * fma_selected_info_peek_uri:
+ * @nsi: this #FMASelectedInfo object.
+ *
+ * Returns: the URI associated with this #FMASelectedInfo object.
+ * The returned string is owned by the @nsi object, and should not be
+ * released by the caller.
+ */
+const gchar *
+fma_selected_info_peek_uri( const FMASelectedInfo *nsi )
+{
+	g_return_val_if_fail( FMA_IS_SELECTED_INFO( nsi ), NULL );
+
+	return( nsi->private->dispose_has_run ? NULL : nsi->private->uri );
+}
+
+/*
+ * fma_selected_info_peek_uri_scheme:
+ * @nsi: this #FMASelectedInfo object.
+ *
+ * Returns: the scheme associated to this @nsi object. The returned
+ * string is owned by the @nsi object, and should not be released by
+ * the caller.
+ */
+const gchar *
+fma_selected_info_peek_uri_scheme( const FMASelectedInfo *nsi )
+{
+	g_return_val_if_fail( FMA_IS_SELECTED_INFO( nsi ), NULL );
+
+	if( nsi->private->dispose_has_run ){
+		return( NULL );
+	}
+
+	derive_uri_parts( nsi );
+
+	return( nsi->private->scheme );
+}
+
 /*
  * fma_selected_info_create_for_uri:
  * @uri: an URI.
@@ -642,11 +802,383 @@ fma_selected_info_create_for_uri( const gchar *uri, const gchar *mimetype, gchar
 	return( obj );
 }
 
+/*
+ * fma_selected_info_new_from_file_manager:
+ * @uri: an URI.
+ * @mimetype: the corresponding mime type, as known by the file manager.
+ * @file_type: the type of the file, as known by the file manager.
+ * @can_write: whether the file manager says the file is writable.
+ *
+ * Returns: a newly allocated #FMASelectedInfo object for the given @uri.
+ *
+ * Contrarily to fma_selected_info_create_for_uri(), the file attributes
+ * are not queried here, but only initialized with the values provided
+ * by the file manager. They may later be updated for a whole selection
+ * at once with fma_selected_info_query_list().
+ */
+FMASelectedInfo *
+fma_selected_info_new_from_file_manager( const gchar *uri, const gchar *mimetype, GFileType file_type, gboolean can_write )
+{
+	FMASelectedInfo *info;
+
+	info = new_from_uri_without_attributes( uri, mimetype );
+
+	info->private->file_type = file_type;
+	info->private->can_read = TRUE;
+	info->private->can_write = can_write;
+
+	return( info );
+}
+
+/*
+ * fma_selected_info_query_list:
+ * @files: a #GList of #FMASelectedInfo items.
+ * @attributes: the set of needed #FMASelectedInfoAttribute.
+ * @deadline: the maximum time to wait for the results, in msec.
+ *
+ * Queries the needed file attributes for all items of the selection.
+ *
+ * Queries are run concurrently on a bounded pool of worker threads, so
+ * that a large selection on a slow filesystem does not serialize the
+ * individual round trips.
+ *
+ * When the @deadline expires, the remaining queries are cancelled, and
+ * the corresponding items just keep the values they have been
+ * initialized with (see fma_selected_info_new_from_file_manager()).
+ * Late results are silently dropped.
+ */
+void
+fma_selected_info_query_list( GList *files, guint attributes, guint deadline )
+{
+	static const gchar *thisfn = "fma_selected_info_query_list";
+	FMASelectionSummary *summary;
+	sProbeBatch *batch;
+	sProbeJob *job;
+	GThreadPool *pool;
+	GList *it;
+	guint pending, expected;
+	gint64 end_time;
+
+	if( !files ){
+		return;
+	}
+
+	/* an item without mimetype must at least query its content type
+	 */
+	for( it = files ; it ; it = it->next ){
+		if( !FMA_SELECTED_INFO( it->data )->private->mimetype ){
+			attributes |= SELECTED_INFO_ATTRIBUTE_CONTENT_TYPE;
+			break;
+		}
+	}
+
+	batch = g_new0( sProbeBatch, 1 );
+	batch->ref_count = 1;
+	batch->done = g_async_queue_new_full(( GDestroyNotify ) probe_job_free );
+	batch->cancellable = g_cancellable_new();
+	batch->attributes = get_query_attributes( attributes );
+
+	if( !batch->attributes ){
+		g_debug( "%s: no attribute is needed", thisfn );
+		probe_batch_unref( batch );
+		return;
+	}
+
+	pool = probe_get_pool();
+	pending = 0;
+
+	for( it = files ; it ; it = it->next ){
+		FMASelectedInfo *nsi = FMA_SELECTED_INFO( it->data );
+
+		job = g_new0( sProbeJob, 1 );
+		job->batch = probe_batch_ref( batch );
+		job->nsi = nsi;
+		job->location = g_file_new_for_uri( nsi->private->uri );
+
+		g_thread_pool_push( pool, job, NULL );
+		pending += 1;
+	}
+
+	expected = pending;
+	end_time = g_get_monotonic_time() + ( gint64 ) deadline * G_TIME_SPAN_MILLISECOND;
+
+	while( pending ){
+		job = g_async_queue_timeout_pop( batch->done, MAX( 0, end_time - g_get_monotonic_time()));
+		if( !job ){
+			break;
+		}
+		pending -= 1;
+
+		if( job->info ){
+			if( !job->nsi->private->mimetype ){
+				job->nsi->private->mimetype =
+						g_strdup( g_file_info_get_attribute_as_string( job->info, G_FILE_ATTRIBUTE_STANDARD_CONTENT_TYPE ));
+			}
+			set_file_attributes( job->nsi, job->info );
+
+		} else if( job->error ){
+			g_warning( "%s: uri=%s, g_file_query_info: %s", thisfn, job->nsi->private->uri, job->error->message );
+		}
+
+		probe_job_free( job );
+	}
+
+	if( pending ){
+		g_warning( "%s: deadline of %u msec expired, %u/%u queries not completed", thisfn, deadline, pending, expected );
+		g_cancellable_cancel( batch->cancellable );
+	}
+
+	g_debug( "%s: files=%u, queried=%u, completed=%u", thisfn, g_list_length( files ), expected, expected-pending );
+
+	/* mimetypes and file types may have changed
+	 */
+	summary = ( FMASelectionSummary * ) g_object_get_data( G_OBJECT( files->data ), SELECTED_INFO_SUMMARY );
+	if( summary ){
+		summary_clear( summary );
+	}
+
+	probe_batch_unref( batch );
+}
+
+/*
+ * fma_selected_info_begin_query:
+ * @files: a #GList of #FMASelectedInfo items.
+ * @tokens: [allow-none]: the FMATokens object which has been built for
+ *  this selection, if any.
+ *
+ * Registers @files as a new selection, which is going to be checked
+ * against the conditions of all the contexts.
+ *
+ * An empty summary is attached to the first item of the selection,
+ * which is then completed by fma_selected_info_get_summary() on demand,
+ * and released with this first item.
+ *
+ * The summary only keeps a weak reference on @tokens, as the tokens
+ * themselves hold a reference on the selected items.
+ *
+ * This must be called each time the list is built or modified, as the
+ * list itself cannot be tagged.
+ */
+void
+fma_selected_info_begin_query( GList *files, GObject *tokens )
+{
+	FMASelectionSummary *summary;
+
+	if( files ){
+		g_return_if_fail( FMA_IS_SELECTED_INFO( files->data ));
+
+		summary = summary_new( files, TRUE );
+		g_weak_ref_set( &summary->tokens, tokens );
+
+		g_object_set_data_full( G_OBJECT( files->data ), SELECTED_INFO_SUMMARY,
+				summary, ( GDestroyNotify ) summary_free );
+	}
+}
+
+/*
+ * fma_selected_info_get_query_tokens:
+ * @files: a #GList of #FMASelectedInfo items.
+ *
+ * Returns: a new reference on the FMATokens object which has been
+ * registered with @files by fma_selected_info_begin_query(), or %NULL
+ * if @files has not been registered, or if the tokens have since been
+ * released.
+ *
+ * The returned reference should be g_object_unref() by the caller.
+ */
+GObject *
+fma_selected_info_get_query_tokens( GList *files )
+{
+	FMASelectionSummary *summary;
+
+	if( !files ){
+		return( NULL );
+	}
+
+	g_return_val_if_fail( FMA_IS_SELECTED_INFO( files->data ), NULL );
+
+	summary = ( FMASelectionSummary * ) g_object_get_data( G_OBJECT( files->data ), SELECTED_INFO_SUMMARY );
+
+	if( !summary || !summary->registered || summary->files != files ){
+		return( NULL );
+	}
+
+	return( g_weak_ref_get( &summary->tokens ));
+}
+
+/*
+ * fma_selected_info_get_summary:
+ * @files: a #GList of #FMASelectedInfo items.
+ * @parts: the #FMASelectionSummaryPart's which are needed by the caller.
+ *
+ * Returns: the #FMASelectionSummary of the @files selection, with at
+ * least the requested @parts.
+ *
+ * When @files has been registered with fma_selected_info_begin_query(),
+ * the summary is shared by all the checks of all the contexts, each part
+ * being only built the first time it is requested. Else, the summary is
+ * rebuilt on each call.
+ *
+ * The returned summary is owned by the selection, and should not be
+ * modified nor released by the caller. It is only valid until the next
+ * call for another list.
+ */
+const FMASelectionSummary *
+fma_selected_info_get_summary( GList *files, guint parts )
+{
+	FMASelectionSummary *summary;
+
+	if( !files ){
+		return( NULL );
+	}
+
+	g_return_val_if_fail( FMA_IS_SELECTED_INFO( files->data ), NULL );
+
+	summary = ( FMASelectionSummary * ) g_object_get_data( G_OBJECT( files->data ), SELECTED_INFO_SUMMARY );
+
+	if( !summary || !summary->registered || summary->files != files ){
+		summary = summary_new( files, FALSE );
+		g_object_set_data_full( G_OBJECT( files->data ), SELECTED_INFO_SUMMARY, summary, ( GDestroyNotify ) summary_free );
+	}
+
+	if(( summary->parts & parts ) != parts ){
+		summary_build( summary, parts & ~summary->parts );
+	}
+
+	return( summary );
+}
+
+static FMASelectionSummary *
+summary_new( GList *files, gboolean registered )
+{
+	FMASelectionSummary *summary;
+
+	summary = g_new0( FMASelectionSummary, 1 );
+	summary->files = files;
+	summary->registered = registered;
+	summary->count = g_list_length( files );
+	g_weak_ref_init( &summary->tokens, NULL );
+
+	return( summary );
+}
+
+/*
+ * only derives from the URI the fields which are needed by the
+ * requested parts
+ */
+static void
+summary_build( FMASelectionSummary *summary, guint parts )
+{
+	static const gchar *thisfn = "fma_selected_info_summary_build";
+	FMASelectionMimetype *histo;
+	GHashTable *schemes, *dirnames, *mimetypes;
+	FMASelectedInfo *nsi;
+	const gchar *value;
+	GList *it;
+
+	schemes = ( parts & SELECTION_SUMMARY_SCHEMES ) ? g_hash_table_new( g_str_hash, g_str_equal ) : NULL;
+	dirnames = ( parts & SELECTION_SUMMARY_DIRNAMES ) ? g_hash_table_new( g_str_hash, g_str_equal ) : NULL;
+	mimetypes = ( parts & SELECTION_SUMMARY_MIMETYPES ) ? g_hash_table_new( g_str_hash, g_str_equal ) : NULL;
+
+	for( it = summary->files ; it ; it = it->next ){
+		nsi = FMA_SELECTED_INFO( it->data );
+
+		if( schemes ){
+			value = fma_selected_info_peek_uri_scheme( nsi );
+			if( value && !g_hash_table_contains( schemes, value )){
+				summary->schemes = g_slist_prepend( summary->schemes, g_strdup( value ));
+				g_hash_table_add( schemes, summary->schemes->data );
+			}
+		}
+
+		if( dirnames ){
+			value = fma_selected_info_peek_dirname( nsi );
+			if( value && !g_hash_table_contains( dirnames, value )){
+				summary->dirnames = g_slist_prepend( summary->dirnames, g_strdup( value ));
+				g_hash_table_add( dirnames, summary->dirnames->data );
+			}
+		}
+
+		if( mimetypes ){
+			value = fma_selected_info_peek_mime_type( nsi );
+			if( value ){
+				histo = ( FMASelectionMimetype * ) g_hash_table_lookup( mimetypes, value );
+				if( !histo ){
+					histo = g_new0( FMASelectionMimetype, 1 );
+					histo->mimetype = g_strdup( value );
+					summary->mimetypes = g_slist_prepend( summary->mimetypes, histo );
+					g_hash_table_insert( mimetypes, histo->mimetype, histo );
+				}
+				histo->count += 1;
+				if( nsi->private->file_type == G_FILE_TYPE_REGULAR ){
+					histo->regulars += 1;
+				}
+			} else {
+				summary->unknown_mimetypes += 1;
+			}
+		}
+	}
+
+	if( mimetypes ){
+		g_hash_table_destroy( mimetypes );
+	}
+	if( dirnames ){
+		g_hash_table_destroy( dirnames );
+	}
+	if( schemes ){
+		g_hash_table_destroy( schemes );
+	}
+
+	summary->parts |= parts;
+
+	g_debug( "%s: count=%u, parts=%u, schemes=%u, dirnames=%u, mimetypes=%u, unknown_mimetypes=%u",
+			thisfn, summary->count, summary->parts,
+			g_slist_length( summary->schemes ), g_slist_length( summary->dirnames ),
+			g_slist_length( summary->mimetypes ), summary->unknown_mimetypes );
+}
+
+/*
+ * releases the built parts, keeping the registration of the selection
+ */
+static void
+summary_clear( FMASelectionSummary *summary )
+{
+	GSList *it;
+
+	for( it = summary->mimetypes ; it ; it = it->next ){
+		g_free((( FMASelectionMimetype * ) it->data )->mimetype );
+		g_free( it->data );
+	}
+	g_slist_free( summary->mimetypes );
+	summary->mimetypes = NULL;
+	summary->unknown_mimetypes = 0;
+
+	g_slist_free_full( summary->dirnames, g_free );
+	summary->dirnames = NULL;
+
+	g_slist_free_full( summary->schemes, g_free );
+	summary->schemes = NULL;
+
+	summary->parts = 0;
+}
+
+static void
+summary_free( FMASelectionSummary *summary )
+{
+	summary_clear( summary );
+	g_weak_ref_clear( &summary->tokens );
+	g_free( summary->file_ids );
+	g_free( summary );
+}
+
 static void
 dump( const FMASelectedInfo *nsi )
 {
 	static const gchar *thisfn = "fma_selected_info_dump";
 
+	derive_paths( nsi );
+	derive_uri_parts( nsi );
+
 	g_debug( "%s:                uri=%s", thisfn, nsi->private->uri );
 	g_debug( "%s:           mimetype=%s", thisfn, nsi->private->mimetype );
 	g_debug( "%s:           filename=%s", thisfn, nsi->private->filename );
@@ -747,8 +1279,26 @@ static FMASelectedInfo *
 new_from_uri( const gchar *uri, const gchar *mimetype, gchar **errmsg )
 {
 	GFile *location;
-	FMAGnomeVFSURI *vfs;
+	FMASelectedInfo *info;
+
+	location = g_file_new_for_uri( uri );
+	info = new_from_uri_without_attributes( uri, mimetype );
+
+	query_file_attributes( info, location, errmsg );
+	g_object_unref( location );
 
+	dump( info );
+
+	return( info );
+}
+
+/*
+ * the fields which are derived from the URI are only computed on first
+ * access, as most of them are not used by the conditions of the items
+ */
+static FMASelectedInfo *
+new_from_uri_without_attributes( const gchar *uri, const gchar *mimetype )
+{
 	FMASelectedInfo *info = g_object_new( FMA_TYPE_SELECTED_INFO, NULL );
 
 	info->private->uri = g_strdup( uri );
@@ -756,36 +1306,59 @@ new_from_uri( const gchar *uri, const gchar *mimetype, gchar **errmsg )
 		info->private->mimetype = g_strdup( mimetype );
 	}
 
-	/* pwi 2011-05-18
-	 * Filename and dirname should be taken from the GFile location, itself taken
-	 * from the URI, so that we have dir='/home/pierre/.gvfs/sftp on stormy.trychlos.org/etc'
-	 * Taking filename and dirname from URI just gives '/etc'
-	 * see #650523
-	 */
-	location = g_file_new_for_uri( uri );
-	info->private->filename = g_file_get_path( location );
+	return( info );
+}
+
+static void
+derive_uri_parts( const FMASelectedInfo *nsi )
+{
+	FMAGnomeVFSURI *vfs;
 
-	vfs = g_new0( FMAGnomeVFSURI, 1 );
-	fma_gnome_vfs_uri_parse( vfs, uri );
-	if( !info->private->filename ){
-		g_debug( "fma_selected_info_new_from_uri: uri='%s', filename=NULL, setting it to '%s'", uri, vfs->path );
-		info->private->filename = g_strdup( vfs->path );
+	if( !( nsi->private->derived & DERIVED_URI_PARTS )){
+
+		vfs = g_new0( FMAGnomeVFSURI, 1 );
+		fma_gnome_vfs_uri_parse( vfs, nsi->private->uri );
+
+		nsi->private->vfs_path = g_strdup( vfs->path );
+		nsi->private->hostname = g_strdup( vfs->host_name );
+		nsi->private->username = g_strdup( vfs->user_name );
+		nsi->private->scheme = g_strdup( vfs->scheme );
+		nsi->private->port = vfs->host_port;
+		fma_gnome_vfs_uri_free( vfs );
+
+		nsi->private->derived |= DERIVED_URI_PARTS;
 	}
+}
 
-	info->private->basename = g_path_get_basename( info->private->filename );
-	info->private->dirname = g_path_get_dirname( info->private->filename );
-	info->private->hostname = g_strdup( vfs->host_name );
-	info->private->username = g_strdup( vfs->user_name );
-	info->private->scheme = g_strdup( vfs->scheme );
-	info->private->port = vfs->host_port;
-	fma_gnome_vfs_uri_free( vfs );
+static void
+derive_paths( const FMASelectedInfo *nsi )
+{
+	GFile *location;
 
-	query_file_attributes( info, location, errmsg );
-	g_object_unref( location );
+	if( !( nsi->private->derived & DERIVED_PATHS )){
+
+		/* pwi 2011-05-18
+		 * Filename and dirname should be taken from the GFile location, itself taken
+		 * from the URI, so that we have dir='/home/pierre/.gvfs/sftp on stormy.trychlos.org/etc'
+		 * Taking filename and dirname from URI just gives '/etc'
+		 * see #650523
+		 */
+		location = g_file_new_for_uri( nsi->private->uri );
+		nsi->private->filename = g_file_get_path( location );
+		g_object_unref( location );
+
+		if( !nsi->private->filename ){
+			derive_uri_parts( nsi );
+			g_debug( "fma_selected_info_derive_paths: uri='%s', filename=NULL, setting it to '%s'",
+					nsi->private->uri, nsi->private->vfs_path );
+			nsi->private->filename = g_strdup( nsi->private->vfs_path );
+		}
 
-	dump( info );
+		nsi->private->basename = g_path_get_basename( nsi->private->filename );
+		nsi->private->dirname = g_path_get_dirname( nsi->private->filename );
 
-	return( info );
+		nsi->private->derived |= DERIVED_PATHS;
+	}
 }
 
 static void
@@ -818,15 +1391,134 @@ query_file_attributes( FMASelectedInfo *nsi, GFile *location, gchar **errmsg )
 		nsi->private->mimetype = g_strdup( g_file_info_get_attribute_as_string( info, G_FILE_ATTRIBUTE_STANDARD_CONTENT_TYPE ));
 	}
 
-	nsi->private->file_type = ( GFileType ) g_file_info_get_attribute_uint32( info, G_FILE_ATTRIBUTE_STANDARD_TYPE );
+	set_file_attributes( nsi, info );
+
+	g_object_unref( info );
+}
+
+/*
+ * only set the attributes which have actually been queried, so that
+ * the other ones keep the values provided by the file manager
+ */
+static void
+set_file_attributes( FMASelectedInfo *nsi, GFileInfo *info )
+{
+	if( g_file_info_has_attribute( info, G_FILE_ATTRIBUTE_STANDARD_TYPE )){
+		nsi->private->file_type = ( GFileType ) g_file_info_get_attribute_uint32( info, G_FILE_ATTRIBUTE_STANDARD_TYPE );
+	}
 
-	nsi->private->can_read = g_file_info_get_attribute_boolean( info, G_FILE_ATTRIBUTE_ACCESS_CAN_READ );
-	nsi->private->can_write = g_file_info_get_attribute_boolean( info, G_FILE_ATTRIBUTE_ACCESS_CAN_WRITE );
-	nsi->private->can_execute = g_file_info_get_attribute_boolean( info, G_FILE_ATTRIBUTE_ACCESS_CAN_EXECUTE );
+	if( g_file_info_has_attribute( info, G_FILE_ATTRIBUTE_ACCESS_CAN_READ )){
+		nsi->private->can_read = g_file_info_get_attribute_boolean( info, G_FILE_ATTRIBUTE_ACCESS_CAN_READ );
+		nsi->private->can_write = g_file_info_get_attribute_boolean( info, G_FILE_ATTRIBUTE_ACCESS_CAN_WRITE );
+		nsi->private->can_execute = g_file_info_get_attribute_boolean( info, G_FILE_ATTRIBUTE_ACCESS_CAN_EXECUTE );
+	}
 
-	nsi->private->owner = g_strdup( g_file_info_get_attribute_as_string( info, G_FILE_ATTRIBUTE_OWNER_USER ));
+	if( g_file_info_has_attribute( info, G_FILE_ATTRIBUTE_OWNER_USER )){
+		g_free( nsi->private->owner );
+		nsi->private->owner = g_strdup( g_file_info_get_attribute_as_string( info, G_FILE_ATTRIBUTE_OWNER_USER ));
+	}
 
 	nsi->private->attributes_are_set = TRUE;
+}
 
-	g_object_unref( info );
+/*
+ * Returns: the GIO attributes string which corresponds to the needed
+ * @attributes, or NULL.
+ */
+static gchar *
+get_query_attributes( guint attributes )
+{
+	GString *str;
+
+	str = g_string_new( NULL );
+
+	if( attributes & SELECTED_INFO_ATTRIBUTE_TYPE ){
+		g_string_append_printf( str, "%s%s", str->len ? "," : "", G_FILE_ATTRIBUTE_STANDARD_TYPE );
+	}
+	if( attributes & SELECTED_INFO_ATTRIBUTE_CONTENT_TYPE ){
+		g_string_append_printf( str, "%s%s", str->len ? "," : "", G_FILE_ATTRIBUTE_STANDARD_CONTENT_TYPE );
+	}
+	if( attributes & SELECTED_INFO_ATTRIBUTE_ACCESS ){
+		g_string_append_printf( str, "%s%s,%s,%s", str->len ? "," : "",
+				G_FILE_ATTRIBUTE_ACCESS_CAN_READ, G_FILE_ATTRIBUTE_ACCESS_CAN_WRITE, G_FILE_ATTRIBUTE_ACCESS_CAN_EXECUTE );
+	}
+	if( attributes & SELECTED_INFO_ATTRIBUTE_OWNER ){
+		g_string_append_printf( str, "%s%s", str->len ? "," : "", G_FILE_ATTRIBUTE_OWNER_USER );
+	}
+
+	return( g_string_free( str, str->len == 0 ));
+}
+
+/*
+ * the worker pool is shared by all the selections of the process
+ */
+static GThreadPool *
+probe_get_pool( void )
+{
+	G_LOCK( st_probe_pool );
+
+	if( !st_probe_pool ){
+		st_probe_pool = g_thread_pool_new(( GFunc ) probe_run, NULL, PROBE_MAX_THREADS, FALSE, NULL );
+	}
+
+	G_UNLOCK( st_probe_pool );
+
+	return( st_probe_pool );
+}
+
+/*
+ * run in a worker thread
+ * the job is handed back to the caller through the 'done' queue of the
+ * batch - if the caller has already given up, the job will be released
+ * with the batch itself
+ */
+static void
+probe_run( sProbeJob *job, void *empty )
+{
+	sProbeBatch *batch;
+
+	batch = job->batch;
+	job->batch = NULL;
+
+	if( !g_cancellable_is_cancelled( batch->cancellable )){
+		job->info = g_file_query_info( job->location, batch->attributes, G_FILE_QUERY_INFO_NONE, batch->cancellable, &job->error );
+	}
+
+	g_async_queue_push( batch->done, job );
+	probe_batch_unref( batch );
+}
+
+static sProbeBatch *
+probe_batch_ref( sProbeBatch *batch )
+{
+	g_atomic_int_inc( &batch->ref_count );
+
+	return( batch );
+}
+
+static void
+probe_batch_unref( sProbeBatch *batch )
+{
+	if( g_atomic_int_dec_and_test( &batch->ref_count )){
+		g_async_queue_unref( batch->done );
+		g_object_unref( batch->cancellable );
+		g_free( batch->attributes );
+		g_free( batch );
+	}
+}
+
+static void
+probe_job_free( sProbeJob *job )
+{
+	if( job->batch ){
+		probe_batch_unref( job->batch );
+	}
+	if( job->info ){
+		g_object_unref( job->info );
+	}
+	if( job->error ){
+		g_error_free( job->error );
+	}
+	g_object_unref( job->location );
+	g_free( job );
 }
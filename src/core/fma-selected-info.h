@@ -43,7 +43,7 @@
  * file_manager_file_info_create_for_uri() API (2.28 for Nautilus)
  */
 
-#include <glib-object.h>
+#include <gio/gio.h>
 
 G_BEGIN_DECLS
 
@@ -72,6 +72,56 @@ typedef struct {
 }
 	FMASelectedInfoClass;
 
+/* The file attributes which may have to be queried for a selection,
+ * depending of the conditions of the loaded items
+ */
+typedef enum {
+	SELECTED_INFO_ATTRIBUTE_NONE         = 0,
+	SELECTED_INFO_ATTRIBUTE_TYPE         = 1 << 0,
+	SELECTED_INFO_ATTRIBUTE_CONTENT_TYPE = 1 << 1,
+	SELECTED_INFO_ATTRIBUTE_ACCESS       = 1 << 2,
+	SELECTED_INFO_ATTRIBUTE_OWNER        = 1 << 3,
+	SELECTED_INFO_ATTRIBUTE_ALL          = 0xff
+}
+	FMASelectedInfoAttribute;
+
+/* An aggregate view of a selection, which lets the conditions be only
+ * checked once per distinct value instead of once per selected item.
+ * It is owned by the first item of the selection, and must be
+ * considered as read-only.
+ *
+ * Each part of the summary is only built when it is requested.
+ */
+typedef enum {
+	SELECTION_SUMMARY_COUNT     = 0,		/* always available */
+	SELECTION_SUMMARY_SCHEMES   = 1 << 0,
+	SELECTION_SUMMARY_DIRNAMES  = 1 << 1,
+	SELECTION_SUMMARY_MIMETYPES = 1 << 2
+}
+	FMASelectionSummaryPart;
+
+typedef struct {
+	gchar *mimetype;
+	guint  count;						/* count of items with this mimetype */
+	guint  regulars;					/* of which are regular files */
+}
+	FMASelectionMimetype;
+
+typedef struct {
+	GList   *files;						/* the selection this summary has been built for */
+	gboolean registered;				/* whether the selection has been registered */
+	guint    parts;						/* the FMASelectionSummaryPart's already built */
+	guint    count;						/* count of selected items */
+	GSList  *schemes;					/* distinct schemes */
+	GSList  *dirnames;					/* distinct dirnames */
+	GSList  *mimetypes;					/* histogram of FMASelectionMimetype */
+	guint    unknown_mimetypes;			/* count of items without mimetype */
+	GWeakRef tokens;					/* the FMATokens of the registered selection */
+	guint   *file_ids;					/* the ids of the files in the current view, */
+	guint    file_ids_view;				/*  as interned by FMAIContext */
+}
+	FMASelectionSummary;
+
 GType            fma_selected_info_get_type          ( void );
 
 GList           *fma_selected_info_copy_list         ( GList *files );
@@ -94,7 +144,20 @@ gboolean         fma_selected_info_is_owner          ( const FMASelectedInfo *ns
 gboolean         fma_selected_info_is_readable       ( const FMASelectedInfo *nsi );
 gboolean         fma_selected_info_is_writable       ( const FMASelectedInfo *nsi );
 
+const gchar     *fma_selected_info_peek_basename     ( const FMASelectedInfo *nsi );
+const gchar     *fma_selected_info_peek_dirname      ( const FMASelectedInfo *nsi );
+const gchar     *fma_selected_info_peek_mime_type    ( const FMASelectedInfo *nsi );
+const gchar     *fma_selected_info_peek_uri          ( const FMASelectedInfo *nsi );
+const gchar     *fma_selected_info_peek_uri_scheme   ( const FMASelectedInfo *nsi );
+
 FMASelectedInfo *fma_selected_info_create_for_uri    ( const gchar *uri, const gchar *mimetype, gchar **errmsg );
+FMASelectedInfo *fma_selected_info_new_from_file_manager( const gchar *uri, const gchar *mimetype, GFileType file_type, gboolean can_write );
+void             fma_selected_info_query_list        ( GList *files, guint attributes, guint deadline );
+
+void             fma_selected_info_begin_query       ( GList *files, GObject *tokens );
+GObject         *fma_selected_info_get_query_tokens  ( GList *files );
+const FMASelectionSummary
+                *fma_selected_info_get_summary       ( GList *files, guint parts );
 
 G_END_DECLS
 
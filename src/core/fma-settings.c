@@ -106,13 +106,22 @@ typedef struct {
 }
 	Consumer;
 
+typedef struct _Snapshot Snapshot;
+
 /* private instance data
+ * - content is the configuration as it has been last notified to the
+ *   consumers; it is only used to compute the modifications when the
+ *   configuration files change on the disk
+ * - snapshot is the configuration as it is seen by the readers; it is
+ *   replaced each time the configuration changes, including when we
+ *   write ourselves into the user configuration file
  */
 struct _FMASettingsPrivate {
 	gboolean   dispose_has_run;
 	KeyFile   *mandatory;
 	KeyFile   *user;
-	GList     *content;
+	Snapshot  *content;
+	Snapshot  *snapshot;
 	GList     *consumers;
 	FMATimeout timeout;
 };
@@ -143,6 +152,10 @@ static const KeyDef st_def_keys[] = {
 	{ IPREFS_WORKING_DIR_URI,                  GROUP_FMA,    FMA_DATA_TYPE_STRING,      "file:///" },
 	{ IPREFS_SHOW_IF_RUNNING_WSP,              GROUP_FMA,    FMA_DATA_TYPE_UINT_LIST,   "" },
 	{ IPREFS_SHOW_IF_RUNNING_URI,              GROUP_FMA,    FMA_DATA_TYPE_STRING,      "file:///bin" },
+	{ IPREFS_SHOW_IF_RUNNING_INTERVAL,         GROUP_RUNTIME, FMA_DATA_TYPE_UINT,        "0" },
+	{ IPREFS_SHOW_IF_TRUE_REFRESH,             GROUP_RUNTIME, FMA_DATA_TYPE_BOOLEAN,     "false" },
+	{ IPREFS_SHOW_IF_TRUE_TIMEOUT,             GROUP_RUNTIME, FMA_DATA_TYPE_UINT,        "500" },
+	{ IPREFS_SHOW_IF_TRUE_TTL,                 GROUP_RUNTIME, FMA_DATA_TYPE_UINT,        "5" },
 	{ IPREFS_TRY_EXEC_WSP,                     GROUP_FMA,    FMA_DATA_TYPE_UINT_LIST,   "" },
 	{ IPREFS_TRY_EXEC_URI,                     GROUP_FMA,    FMA_DATA_TYPE_STRING,      "file:///bin" },
 	{ IPREFS_EXPORT_ASK_USER_WSP,              GROUP_FMA,    FMA_DATA_TYPE_UINT_LIST,   "" },
@@ -202,6 +215,24 @@ typedef struct {
 }
 	KeyValue;
 
+/* A snapshot is the merged content of the two configuration files, i.e.
+ * the user view of the configuration where mandatory keys take precedence.
+ *
+ * The KeyValue structs are indexed by their KeyDef, each KeyDef leading
+ * to the list of the groups where the key has been found (usually only
+ * one, but the i/o providers keys are found in each i/o provider group).
+ *
+ * A snapshot is never modified once built: it is replaced as a whole
+ * when the configuration changes, so that readers only have to take a
+ * reference on the current snapshot to get a consistent view of the
+ * configuration, without having to parse the key files again.
+ */
+struct _Snapshot {
+	gint        ref_count;
+	GList      *content;
+	GHashTable *index;
+};
+
 /* signals
  */
 enum {
@@ -211,9 +242,12 @@ enum {
 
 static GObjectClass *st_parent_class           = NULL;
 static gint          st_burst_timeout          = 100;		/* burst timeout in msec */
+static gint          st_burst_max_latency      = 1000;		/* max burst latency in msec */
 static gint          st_signals[ LAST_SIGNAL ] = { 0 };
 static FMASettings   *st_settings               = NULL;
 
+G_LOCK_DEFINE_STATIC( st_snapshot );
+
 static GType     settings_get_type( void );
 static GType     register_type( void );
 static void      class_init( FMASettingsClass *klass );
@@ -223,20 +257,28 @@ static void      instance_finalize( GObject *object );
 
 static void      settings_new( void );
 
-static GList    *content_diff( GList *old, GList *new );
-static GList    *content_load_keys( GList *content, KeyFile *keyfile );
+static GList    *content_diff( const Snapshot *old, const Snapshot *new );
+static void      content_load_keys( Snapshot *snapshot, KeyFile *keyfile );
 static KeyDef   *get_key_def( const gchar *key );
 static KeyFile  *key_file_new( const gchar *dir );
+static void      key_file_load( KeyFile *keyfile );
 static void      on_keyfile_changed( GFileMonitor *monitor, GFile *file, GFile *other_file, GFileMonitorEvent event_type );
 static void      on_keyfile_changed_timeout( void );
 static void      on_key_changed_final_handler( FMASettings *settings, gchar *group, gchar *key, FMABoxed *new_value, gboolean mandatory );
-static KeyValue *peek_key_value_from_content( GList *content, const gchar *group, const gchar *key );
-static KeyValue *read_key_value( const gchar *group, const gchar *key, gboolean *found, gboolean *mandatory );
+static const KeyValue *read_key_value( const Snapshot *snapshot, const gchar *group, const gchar *key, gboolean *found, gboolean *mandatory );
 static KeyValue *read_key_value_from_key_file( KeyFile *keyfile, const gchar *group, const gchar *key, const KeyDef *key_def );
 static void      release_consumer( Consumer *consumer );
 static void      release_key_file( KeyFile *key_file );
 static void      release_key_value( KeyValue *value );
 static gboolean  set_key_value( const gchar *group, const gchar *key, const gchar *string );
+static void      snapshot_add( Snapshot *snapshot, KeyValue *key_value );
+static Snapshot *snapshot_get( void );
+static Snapshot *snapshot_load( void );
+static Snapshot *snapshot_new( void );
+static KeyValue *snapshot_peek( const Snapshot *snapshot, const gchar *group, const KeyDef *key_def );
+static Snapshot *snapshot_ref( Snapshot *snapshot );
+static void      snapshot_set( Snapshot *snapshot );
+static void      snapshot_unref( Snapshot *snapshot );
 static gboolean  write_user_key_file( void );
 
 static GType
@@ -342,9 +384,11 @@ instance_init( GTypeInstance *instance, gpointer klass )
 	self->private->mandatory = NULL;
 	self->private->user = NULL;
 	self->private->content = NULL;
+	self->private->snapshot = NULL;
 	self->private->consumers = NULL;
 
 	self->private->timeout.timeout = st_burst_timeout;
+	self->private->timeout.max_latency = st_burst_max_latency;
 	self->private->timeout.handler = ( FMATimeoutFunc ) on_keyfile_changed_timeout;
 	self->private->timeout.user_data = NULL;
 	self->private->timeout.source_id = 0;
@@ -387,8 +431,12 @@ instance_finalize( GObject *object )
 
 	self = NA_SETTINGS( object );
 
-	g_list_foreach( self->private->content, ( GFunc ) release_key_value, NULL );
-	g_list_free( self->private->content );
+	if( self->private->content ){
+		snapshot_unref( self->private->content );
+	}
+	if( self->private->snapshot ){
+		snapshot_unref( self->private->snapshot );
+	}
 
 	g_list_foreach( self->private->consumers, ( GFunc ) release_consumer, NULL );
 	g_list_free( self->private->consumers );
@@ -412,12 +460,12 @@ settings_new( void )
 {
 	static const gchar *thisfn = "fma_settings_new";
 	gchar *dir;
-	GList *content;
+	Snapshot *snapshot;
 	const gchar * const *array;
 	gchar **iter;
 
 	if( !st_settings ){
-		content = NULL;
+		snapshot = NULL;
 		st_settings = g_object_new( NA_SETTINGS_TYPE, NULL );
 
 		/* iterate through system config dirs until having found a
@@ -428,14 +476,17 @@ settings_new( void )
 		while( *iter ){
 			if( st_settings->private->mandatory ){
 				release_key_file( st_settings->private->mandatory );
+				snapshot_unref( snapshot );
 			}
 			g_debug( "iter=%s", *iter );
 			dir = g_build_filename( *iter, PACKAGE, NULL );
 			st_settings->private->mandatory = key_file_new( dir );
 			g_free( dir );
 			st_settings->private->mandatory->mandatory = TRUE;
-			content = content_load_keys( NULL, st_settings->private->mandatory );
-			if( content ){
+			key_file_load( st_settings->private->mandatory );
+			snapshot = snapshot_new();
+			content_load_keys( snapshot, st_settings->private->mandatory );
+			if( snapshot->content ){
 				break;
 			}
 			iter++;
@@ -446,11 +497,12 @@ settings_new( void )
 		g_mkdir_with_parents( dir, 0750 );
 		st_settings->private->user = key_file_new( dir );
 		g_free( dir );
-		st_settings->private->mandatory->mandatory = FALSE;
-		content = content_load_keys( content, st_settings->private->user );
+		st_settings->private->user->mandatory = FALSE;
+		key_file_load( st_settings->private->user );
+		content_load_keys( snapshot, st_settings->private->user );
 
-		st_settings->private->content = g_list_copy( content );
-		g_list_free( content );
+		st_settings->private->content = snapshot;
+		st_settings->private->snapshot = snapshot_ref( snapshot );
 	}
 }
 
@@ -537,15 +589,16 @@ gboolean
 fma_settings_get_boolean_ex( const gchar *group, const gchar *key, gboolean *found, gboolean *mandatory )
 {
 	gboolean value;
-	KeyValue *key_value;
+	Snapshot *snapshot;
+	const KeyValue *key_value;
 	KeyDef *key_def;
 
 	value = FALSE;
-	key_value = read_key_value( group, key, found, mandatory );
+	snapshot = snapshot_get();
+	key_value = read_key_value( snapshot, group, key, found, mandatory );
 
 	if( key_value ){
 		value = fma_boxed_get_boolean( key_value->boxed );
-		release_key_value( key_value );
 
 	} else {
 		key_def = get_key_def( key );
@@ -554,6 +607,8 @@ fma_settings_get_boolean_ex( const gchar *group, const gchar *key, gboolean *fou
 		}
 	}
 
+	snapshot_unref( snapshot );
+
 	return( value );
 }
 
@@ -580,15 +635,16 @@ gchar *
 fma_settings_get_string( const gchar *key, gboolean *found, gboolean *mandatory )
 {
 	gchar *value;
-	KeyValue *key_value;
+	Snapshot *snapshot;
+	const KeyValue *key_value;
 	KeyDef *key_def;
 
 	value = NULL;
-	key_value = read_key_value( NULL, key, found, mandatory );
+	snapshot = snapshot_get();
+	key_value = read_key_value( snapshot, NULL, key, found, mandatory );
 
 	if( key_value ){
 		value = fma_boxed_get_string( key_value->boxed );
-		release_key_value( key_value );
 
 	} else {
 		key_def = get_key_def( key );
@@ -597,6 +653,8 @@ fma_settings_get_string( const gchar *key, gboolean *found, gboolean *mandatory
 		}
 	}
 
+	snapshot_unref( snapshot );
+
 	return( value );
 }
 
@@ -623,15 +681,16 @@ GSList *
 fma_settings_get_string_list( const gchar *key, gboolean *found, gboolean *mandatory )
 {
 	GSList *value;
-	KeyValue *key_value;
+	Snapshot *snapshot;
+	const KeyValue *key_value;
 	KeyDef *key_def;
 
 	value = NULL;
-	key_value = read_key_value( NULL, key, found, mandatory );
+	snapshot = snapshot_get();
+	key_value = read_key_value( snapshot, NULL, key, found, mandatory );
 
 	if( key_value ){
 		value = fma_boxed_get_string_list( key_value->boxed );
-		release_key_value( key_value );
 
 	} else {
 		key_def = get_key_def( key );
@@ -640,6 +699,8 @@ fma_settings_get_string_list( const gchar *key, gboolean *found, gboolean *manda
 		}
 	}
 
+	snapshot_unref( snapshot );
+
 	return( value );
 }
 
@@ -665,15 +726,16 @@ guint
 fma_settings_get_uint( const gchar *key, gboolean *found, gboolean *mandatory )
 {
 	guint value;
+	Snapshot *snapshot;
 	KeyDef *key_def;
-	KeyValue *key_value;
+	const KeyValue *key_value;
 
 	value = 0;
-	key_value = read_key_value( NULL, key, found, mandatory );
+	snapshot = snapshot_get();
+	key_value = read_key_value( snapshot, NULL, key, found, mandatory );
 
 	if( key_value ){
 		value = fma_boxed_get_uint( key_value->boxed );
-		release_key_value( key_value );
 
 	} else {
 		key_def = get_key_def( key );
@@ -682,6 +744,8 @@ fma_settings_get_uint( const gchar *key, gboolean *found, gboolean *mandatory )
 		}
 	}
 
+	snapshot_unref( snapshot );
+
 	return( value );
 }
 
@@ -708,15 +772,16 @@ GList *
 fma_settings_get_uint_list( const gchar *key, gboolean *found, gboolean *mandatory )
 {
 	GList *value;
+	Snapshot *snapshot;
 	KeyDef *key_def;
-	KeyValue *key_value;
+	const KeyValue *key_value;
 
 	value = NULL;
-	key_value = read_key_value( NULL, key, found, mandatory );
+	snapshot = snapshot_get();
+	key_value = read_key_value( snapshot, NULL, key, found, mandatory );
 
 	if( key_value ){
 		value = fma_boxed_get_uint_list( key_value->boxed );
-		release_key_value( key_value );
 
 	} else {
 		key_def = get_key_def( key );
@@ -725,6 +790,8 @@ fma_settings_get_uint_list( const gchar *key, gboolean *found, gboolean *mandato
 		}
 	}
 
+	snapshot_unref( snapshot );
+
 	return( value );
 }
 
@@ -968,6 +1035,29 @@ fma_settings_get_groups( void )
 	return( groups );
 }
 
+/*
+ * fma_settings_get_files:
+ *
+ * Returns: the list of the paths of the mandatory and user configuration
+ * files, whether they actually exist or not; this list should be
+ * fma_core_utils_slist_free() by the caller.
+ *
+ * Since: 3.5
+ */
+GSList *
+fma_settings_get_files( void )
+{
+	GSList *files;
+
+	settings_new();
+
+	files = NULL;
+	files = g_slist_prepend( files, g_strdup( st_settings->private->user->fname ));
+	files = g_slist_prepend( files, g_strdup( st_settings->private->mandatory->fname ));
+
+	return( files );
+}
+
 /*
  * returns a list of modified KeyValue
  * - order in the lists is not signifiant
@@ -979,35 +1069,33 @@ fma_settings_get_groups( void )
  *
  * we return here a new list, with newly allocated KeyValue structs
  * which hold the new value of each modified key
+ *
+ * each key is searched for in the index of the other snapshot, so that
+ * the cost of the comparison is linear in the count of keys
  */
 static GList *
-content_diff( GList *old, GList *new )
+content_diff( const Snapshot *old, const Snapshot *new )
 {
 	GList *diffs, *io, *in;
 	KeyValue *kold, *knew, *kdiff;
-	gboolean found;
 
 	diffs = NULL;
 
-	for( io = old ; io ; io = io->next ){
+	for( io = old->content ; io ; io = io->next ){
 		kold = ( KeyValue * ) io->data;
-		found = FALSE;
-		for( in = new ; in && !found ; in = in->next ){
-			knew = ( KeyValue * ) in->data;
-			if( !strcmp( kold->group, knew->group ) && ( gpointer ) kold->def == ( gpointer ) knew->def ){
-				found = TRUE;
-				if( !fma_boxed_are_equal( kold->boxed, knew->boxed )){
-					/* a key has been modified */
-					kdiff = g_new0( KeyValue, 1 );
-					kdiff->group = g_strdup( knew->group );
-					kdiff->def = knew->def;
-					kdiff->mandatory = knew->mandatory;
-					kdiff->boxed = fma_boxed_copy( knew->boxed );
-					diffs = g_list_prepend( diffs, kdiff );
-				}
+		knew = snapshot_peek( new, kold->group, kold->def );
+		if( knew ){
+			if( !fma_boxed_are_equal( kold->boxed, knew->boxed )){
+				/* a key has been modified */
+				kdiff = g_new0( KeyValue, 1 );
+				kdiff->group = g_strdup( knew->group );
+				kdiff->def = knew->def;
+				kdiff->mandatory = knew->mandatory;
+				kdiff->boxed = fma_boxed_copy( knew->boxed );
+				diffs = g_list_prepend( diffs, kdiff );
 			}
-		}
-		if( !found ){
+
+		} else {
 			/* a key has disappeared */
 			kdiff = g_new0( KeyValue, 1 );
 			kdiff->group = g_strdup( kold->group );
@@ -1018,16 +1106,9 @@ content_diff( GList *old, GList *new )
 		}
 	}
 
-	for( in = new ; in ; in = in->next ){
+	for( in = new->content ; in ; in = in->next ){
 		knew = ( KeyValue * ) in->data;
-		found = FALSE;
-		for( io = old ; io && !found ; io = io->next ){
-			kold = ( KeyValue * ) io->data;
-			if( !strcmp( kold->group, knew->group ) && ( gpointer ) kold->def == ( gpointer ) knew->def ){
-				found = TRUE;
-			}
-		}
-		if( !found ){
+		if( !snapshot_peek( old, knew->group, knew->def )){
 			/* a key is new */
 			kdiff = g_new0( KeyValue, 1 );
 			kdiff->group = g_strdup( knew->group );
@@ -1041,75 +1122,72 @@ content_diff( GList *old, GList *new )
 	return( diffs );
 }
 
-/* add the content of a configuration files to those already loaded
+/* add the content of a configuration file to those already loaded
+ * in the snapshot
  *
- * when the two configuration files have been read, then the content of
- * _the_ configuration has been loaded, while preserving the mandatory
- * keys
+ * when the two configuration files have been added, then the snapshot
+ * holds _the_ configuration, while preserving the mandatory keys
+ *
+ * the key file is expected to have been loaded from the disk
  */
-static GList *
-content_load_keys( GList *content, KeyFile *keyfile )
+static void
+content_load_keys( Snapshot *snapshot, KeyFile *keyfile )
 {
-	static const gchar *thisfn = "fma_settings_content_load_keys";
-	GError *error;
 	gchar **groups, **ig;
 	gchar **keys, **ik;
 	KeyValue *key_value;
 	KeyDef *key_def;
 
-	error = NULL;
-	if( !g_key_file_load_from_file( keyfile->key_file, keyfile->fname, G_KEY_FILE_KEEP_COMMENTS, &error )){
-		if( error->code != G_FILE_ERROR_NOENT ){
-			g_warning( "%s: %s (%d) %s", thisfn, keyfile->fname, error->code, error->message );
-		} else {
-			g_debug( "%s: %s: file doesn't exist", thisfn, keyfile->fname );
-		}
-		g_error_free( error );
-		error = NULL;
-
-	} else {
-		groups = g_key_file_get_groups( keyfile->key_file, NULL );
-		ig = groups;
-		while( *ig ){
-			keys = g_key_file_get_keys( keyfile->key_file, *ig, NULL, NULL );
-			ik = keys;
-			while( *ik ){
-				key_def = get_key_def( *ik );
-				if( key_def ){
-					key_value = peek_key_value_from_content( content, *ig, *ik );
-					if( !key_value ){
-						key_value = read_key_value_from_key_file( keyfile, *ig, *ik, key_def );
-						if( key_value ){
-							key_value->mandatory = keyfile->mandatory;
-							content = g_list_prepend( content, key_value );
-						}
+	groups = g_key_file_get_groups( keyfile->key_file, NULL );
+	ig = groups;
+	while( *ig ){
+		keys = g_key_file_get_keys( keyfile->key_file, *ig, NULL, NULL );
+		ik = keys;
+		while( *ik ){
+			key_def = get_key_def( *ik );
+			if( key_def ){
+				key_value = snapshot_peek( snapshot, *ig, key_def );
+				if( !key_value ){
+					key_value = read_key_value_from_key_file( keyfile, *ig, *ik, key_def );
+					if( key_value ){
+						key_value->mandatory = keyfile->mandatory;
+						snapshot_add( snapshot, key_value );
 					}
 				}
-				ik++;
 			}
-			g_strfreev( keys );
-			ig++;
+			ik++;
 		}
-		g_strfreev( groups );
+		g_strfreev( keys );
+		ig++;
 	}
-
-	return( content );
+	g_strfreev( groups );
 }
 
+/* the definitions of the keys are indexed by key name the first time
+ * one is searched for
+ */
 static KeyDef *
 get_key_def( const gchar *key )
 {
 	static const gchar *thisfn = "fma_settings_get_key_def";
-	KeyDef *found = NULL;
+	static GHashTable *st_key_defs = NULL;
+	GHashTable *key_defs;
+	KeyDef *found;
 	KeyDef *idef;
 
-	idef = ( KeyDef * ) st_def_keys;
-	while( idef->key && !found ){
-		if( !strcmp( idef->key, key )){
-			found = idef;
+	if( g_once_init_enter( &st_key_defs )){
+		key_defs = g_hash_table_new( g_str_hash, g_str_equal );
+		idef = ( KeyDef * ) st_def_keys;
+		while( idef->key ){
+			if( !g_hash_table_lookup( key_defs, idef->key )){
+				g_hash_table_insert( key_defs, ( gpointer ) idef->key, idef );
+			}
+			idef++;
 		}
-		idef++;
+		g_once_init_leave( &st_key_defs, key_defs );
 	}
+
+	found = ( KeyDef * ) g_hash_table_lookup( st_key_defs, key );
 	if( !found ){
 		g_warning( "%s: no KeyDef found for key=%s", thisfn, key );
 	}
@@ -1150,6 +1228,31 @@ key_file_new( const gchar *dir )
 	return( keyfile );
 }
 
+/*
+ * (re)load the key file from the disk
+ *
+ * a configuration file which does not exist (or no longer exists) is
+ * just empty; on other errors, we keep the previously loaded content
+ */
+static void
+key_file_load( KeyFile *keyfile )
+{
+	static const gchar *thisfn = "fma_settings_key_file_load";
+	GError *error;
+
+	error = NULL;
+	if( !g_key_file_load_from_file( keyfile->key_file, keyfile->fname, G_KEY_FILE_KEEP_COMMENTS, &error )){
+		if( error->code != G_FILE_ERROR_NOENT ){
+			g_warning( "%s: %s (%d) %s", thisfn, keyfile->fname, error->code, error->message );
+		} else {
+			g_debug( "%s: %s: file doesn't exist", thisfn, keyfile->fname );
+			g_key_file_free( keyfile->key_file );
+			keyfile->key_file = g_key_file_new();
+		}
+		g_error_free( error );
+	}
+}
+
 /*
  * one of the two monitored configuration files have changed on the disk
  * we do not try to identify which keys have actually change
@@ -1170,7 +1273,7 @@ static void
 on_keyfile_changed_timeout( void )
 {
 	static const gchar *thisfn = "fma_settings_on_keyfile_changed_timeout";
-	GList *new_content;
+	Snapshot *new_content;
 	GList *modifs;
 	GList *ic, *im;
 	const KeyValue *changed;
@@ -1183,10 +1286,14 @@ on_keyfile_changed_timeout( void )
 	/* last individual notification is older that the st_burst_timeout
 	 * we may so suppose that the burst is terminated
 	 */
-	new_content = content_load_keys( NULL, st_settings->private->mandatory );
-	new_content = content_load_keys( new_content, st_settings->private->user );
+	key_file_load( st_settings->private->mandatory );
+	key_file_load( st_settings->private->user );
+	new_content = snapshot_load();
 	modifs = content_diff( st_settings->private->content, new_content );
 
+	/* consumers are allowed to read the new values from their callbacks */
+	snapshot_set( snapshot_ref( new_content ));
+
 #ifdef FMA_MAINTAINER_MODE
 	g_debug( "%s: %d found update(s)", thisfn, g_list_length( modifs ));
 	for( im = modifs ; im ; im = im->next ){
@@ -1234,8 +1341,7 @@ on_keyfile_changed_timeout( void )
 	}
 
 	g_debug( "%s: releasing content", thisfn );
-	g_list_foreach( st_settings->private->content, ( GFunc ) release_key_value, NULL );
-	g_list_free( st_settings->private->content );
+	snapshot_unref( st_settings->private->content );
 	st_settings->private->content = new_content;
 
 	g_debug( "%s: releasing modifs", thisfn );
@@ -1250,32 +1356,16 @@ on_key_changed_final_handler( FMASettings *settings, gchar *group, gchar *key, F
 	fma_boxed_dump( new_value );
 }
 
-static KeyValue *
-peek_key_value_from_content( GList *content, const gchar *group, const gchar *key )
-{
-	KeyValue *value, *found;
-	GList *ic;
-
-	found = NULL;
-	for( ic = content ; ic && !found ; ic = ic->next ){
-		value = ( KeyValue * ) ic->data;
-		if( !strcmp( value->group, group ) && !strcmp( value->def->key, key )){
-			found = value;
-		}
-	}
-
-	return( found );
-}
-
 /* group may be NULL
+ *
+ * the returned KeyValue is owned by the snapshot
  */
-static KeyValue *
-read_key_value( const gchar *group, const gchar *key, gboolean *found, gboolean *mandatory )
+static const KeyValue *
+read_key_value( const Snapshot *snapshot, const gchar *group, const gchar *key, gboolean *found, gboolean *mandatory )
 {
 	static const gchar *thisfn = "fma_settings_read_key_value";
 	KeyDef *key_def;
-	gboolean has_entry;
-	KeyValue *key_value;
+	const KeyValue *key_value;
 
 	key_value = NULL;
 	if( found ){
@@ -1285,31 +1375,19 @@ read_key_value( const gchar *group, const gchar *key, gboolean *found, gboolean
 		*mandatory = FALSE;
 	}
 
-	settings_new();
 	key_def = get_key_def( key );
 
 	if( key_def ){
-		has_entry = FALSE;
-		key_value = read_key_value_from_key_file( st_settings->private->mandatory, group ? group : key_def->group, key, key_def );
+		key_value = snapshot_peek( snapshot, group ? group : key_def->group, key_def );
 		if( key_value ){
-			has_entry = TRUE;
 			if( found ){
 				*found = TRUE;
 			}
-			if( mandatory ){
+			if( mandatory && key_value->mandatory ){
 				*mandatory = TRUE;
 				g_debug( "%s: %s: key is mandatory", thisfn, key );
 			}
 		}
-		if( !has_entry ){
-			key_value = read_key_value_from_key_file( st_settings->private->user, group ? group : key_def->group, key, key_def );
-			if( key_value ){
-				has_entry = TRUE;
-				if( found ){
-					*found = TRUE;
-				}
-			}
-		}
 	}
 
 	return( key_value );
@@ -1449,12 +1527,148 @@ set_key_value( const gchar *group, const gchar *key, const gchar *string )
 			}
 		}
 
+		/* readers see the new value right now, while consumers will
+		 * be notified when the file monitor signals the change */
+		snapshot_set( snapshot_load());
+
 		ok &= write_user_key_file();
 	}
 
 	return( ok );
 }
 
+/*
+ * add a KeyValue to a snapshot being built
+ * the snapshot takes ownership of the KeyValue
+ */
+static void
+snapshot_add( Snapshot *snapshot, KeyValue *key_value )
+{
+	GList *groups;
+
+	groups = ( GList * ) g_hash_table_lookup( snapshot->index, key_value->def );
+	g_hash_table_insert( snapshot->index, ( gpointer ) key_value->def, g_list_prepend( groups, key_value ));
+
+	snapshot->content = g_list_prepend( snapshot->content, key_value );
+}
+
+/*
+ * returns a new reference on the current snapshot, which should be
+ * snapshot_unref() by the caller
+ *
+ * the lock only protects the reference counting, while the lookups
+ * are then done without any lock as the snapshot is never modified
+ */
+static Snapshot *
+snapshot_get( void )
+{
+	Snapshot *snapshot;
+
+	settings_new();
+
+	G_LOCK( st_snapshot );
+	snapshot = snapshot_ref( st_settings->private->snapshot );
+	G_UNLOCK( st_snapshot );
+
+	return( snapshot );
+}
+
+/*
+ * build a new snapshot from the key files, as they are currently loaded
+ * in memory
+ */
+static Snapshot *
+snapshot_load( void )
+{
+	Snapshot *snapshot;
+
+	snapshot = snapshot_new();
+	content_load_keys( snapshot, st_settings->private->mandatory );
+	content_load_keys( snapshot, st_settings->private->user );
+
+	return( snapshot );
+}
+
+static Snapshot *
+snapshot_new( void )
+{
+	Snapshot *snapshot;
+
+	snapshot = g_new0( Snapshot, 1 );
+	snapshot->ref_count = 1;
+	snapshot->content = NULL;
+	snapshot->index = g_hash_table_new( g_direct_hash, g_direct_equal );
+
+	return( snapshot );
+}
+
+static KeyValue *
+snapshot_peek( const Snapshot *snapshot, const gchar *group, const KeyDef *key_def )
+{
+	KeyValue *value, *found;
+	GList *ig;
+
+	found = NULL;
+	for( ig = g_hash_table_lookup( snapshot->index, key_def ) ; ig && !found ; ig = ig->next ){
+		value = ( KeyValue * ) ig->data;
+		if( !strcmp( value->group, group )){
+			found = value;
+		}
+	}
+
+	return( found );
+}
+
+static Snapshot *
+snapshot_ref( Snapshot *snapshot )
+{
+	g_atomic_int_inc( &snapshot->ref_count );
+
+	return( snapshot );
+}
+
+/*
+ * install a new snapshot as the current one, taking ownership of the
+ * provided reference
+ *
+ * readers which already hold the previous snapshot keep using it until
+ * they release it
+ */
+static void
+snapshot_set( Snapshot *snapshot )
+{
+	Snapshot *previous;
+
+	G_LOCK( st_snapshot );
+	previous = st_settings->private->snapshot;
+	st_settings->private->snapshot = snapshot;
+	G_UNLOCK( st_snapshot );
+
+	if( previous ){
+		snapshot_unref( previous );
+	}
+}
+
+static void
+snapshot_unref( Snapshot *snapshot )
+{
+	GHashTableIter iter;
+	gpointer groups;
+
+	if( g_atomic_int_dec_and_test( &snapshot->ref_count )){
+		g_hash_table_iter_init( &iter, snapshot->index );
+		while( g_hash_table_iter_next( &iter, NULL, &groups )){
+			g_list_free(( GList * ) groups );
+		}
+		g_hash_table_destroy( snapshot->index );
+
+		g_list_foreach( snapshot->content, ( GFunc ) release_key_value, NULL );
+		g_list_free( snapshot->content );
+
+		g_free( snapshot );
+	}
+}
+
 static gboolean
 write_user_key_file( void )
 {
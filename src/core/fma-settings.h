@@ -84,6 +84,10 @@ G_BEGIN_DECLS
 #define IPREFS_WORKING_DIR_URI					"command-working-dir-chooser-lfu"
 #define IPREFS_SHOW_IF_RUNNING_WSP				"environment-show-if-running-wsp"
 #define IPREFS_SHOW_IF_RUNNING_URI				"environment-show-if-running-lfu"
+#define IPREFS_SHOW_IF_RUNNING_INTERVAL			"show-if-running-refresh-interval"
+#define IPREFS_SHOW_IF_TRUE_REFRESH				"show-if-true-refresh-in-background"
+#define IPREFS_SHOW_IF_TRUE_TIMEOUT				"show-if-true-timeout"
+#define IPREFS_SHOW_IF_TRUE_TTL					"show-if-true-ttl"
 #define IPREFS_TRY_EXEC_WSP						"environment-try-exec-wsp"
 #define IPREFS_TRY_EXEC_URI						"environment-try-exec-lfu"
 #define IPREFS_EXPORT_ASK_USER_WSP				"export-ask-user-wsp"
@@ -160,6 +164,7 @@ gboolean  fma_settings_set_uint             ( const gchar *key, guint value );
 gboolean  fma_settings_set_uint_list        ( const gchar *key, const GList *value );
 
 GSList   *fma_settings_get_groups           ( void );
+GSList   *fma_settings_get_files            ( void );
 
 G_END_DECLS
 
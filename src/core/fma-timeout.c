@@ -33,65 +33,125 @@
 
 #include <api/fma-timeout.h>
 
+static void     schedule_at( FMATimeout *timeout, gint64 now );
 static gboolean on_timeout_event_timeout( FMATimeout *timeout );
-static gulong   time_val_diff( const GTimeVal *recent, const GTimeVal *old );
 
 /**
  * fma_timeout_event:
  * @timeout: the #FMATimeout structure which will handle this event.
+ *
+ * Records an event.
+ *
+ * The first event of a burst installs a one-shot source at the deadline;
+ * following events only record their (monotonic) time, and the deadline
+ * is recomputed when the source fires.
  */
 void
 fma_timeout_event( FMATimeout *event )
 {
 	g_return_if_fail( event != NULL );
 
-	g_get_current_time( &event->last_time );
+	event->last_time = g_get_monotonic_time();
+
+	if( event->source_id ){
+		event->coalesced += 1;
 
-	if( !event->source_id ){
-		event->source_id = g_timeout_add( event->timeout, ( GSourceFunc ) on_timeout_event_timeout, event );
+	} else {
+		event->first_time = event->last_time;
+		schedule_at( event, event->last_time );
 	}
 }
 
+/**
+ * fma_timeout_get_coalesced:
+ * @timeout: this #FMATimeout structure.
+ *
+ * Returns: the count of events which have been coalesced into an already
+ * pending handler call since the structure has been initialized.
+ *
+ * Since: 3.5
+ */
+guint
+fma_timeout_get_coalesced( const FMATimeout *timeout )
+{
+	g_return_val_if_fail( timeout != NULL, 0 );
+
+	return( timeout->coalesced );
+}
+
+/**
+ * fma_timeout_get_flushes:
+ * @timeout: this #FMATimeout structure.
+ *
+ * Returns: the count of times the handler has been triggered since the
+ * structure has been initialized.
+ *
+ * Since: 3.5
+ */
+guint
+fma_timeout_get_flushes( const FMATimeout *timeout )
+{
+	g_return_val_if_fail( timeout != NULL, 0 );
+
+	return( timeout->flushes );
+}
+
 /*
- * this timer is set when we receive the first event of a serie
- * we continue to loop until last event is older that our burst timeout
+ * installs a one-shot source which will fire at the current deadline,
+ * i.e. 'timeout' after the last event, but not later than 'max_latency'
+ * after the first event of the burst
  */
-static gboolean
-on_timeout_event_timeout( FMATimeout *timeout )
+static void
+schedule_at( FMATimeout *timeout, gint64 now )
 {
-	GTimeVal now;
-	gulong diff;
-	gulong timeout_usec;
+	gint64 deadline;
+	gint64 delay;
 
-	g_get_current_time( &now );
-	diff = time_val_diff( &now, &timeout->last_time );
-	timeout_usec = 1000*timeout->timeout;
+	deadline = timeout->last_time + 1000 * ( gint64 ) timeout->timeout;
 
-	if( diff < timeout_usec ){
-		/* do not stop */
-		return( TRUE );
+	if( timeout->max_latency ){
+		deadline = MIN( deadline, timeout->first_time + 1000 * ( gint64 ) timeout->max_latency );
 	}
 
-	/* last individual notification is older that the 'timeout' parameter
-	 * we may so suppose that the burst is terminated
-	 * and feel authorized to trigger the defined callback
+	/* round up to the next millisecond, so that we do not wake up just
+	 * before the deadline
 	 */
-	( *timeout->handler )( timeout->user_data );
+	delay = MAX( 0, ( deadline - now + 999 ) / 1000 );
 
-	/* at the end of the callback execution, reset the event source id.
-	 * and stop the execution of this one
-	 */
-	timeout->source_id = 0;
-	return( FALSE );
+	timeout->source_id = g_timeout_add(( guint ) delay, ( GSourceFunc ) on_timeout_event_timeout, timeout );
 }
 
 /*
- * returns the difference in microseconds.
+ * this one-shot timer is set when we receive the first event of a serie
+ * if other events have been recorded meanwhile, it is rescheduled once
+ * at the new deadline instead of polling
  */
-static gulong
-time_val_diff( const GTimeVal *recent, const GTimeVal *old )
+static gboolean
+on_timeout_event_timeout( FMATimeout *timeout )
 {
-	gulong microsec = 1000000 * ( recent->tv_sec - old->tv_sec );
-	microsec += recent->tv_usec  - old->tv_usec;
-	return( microsec );
+	gint64 now;
+	gboolean quiet, late;
+
+	now = g_get_monotonic_time();
+	quiet = ( now - timeout->last_time >= 1000 * ( gint64 ) timeout->timeout );
+	late = ( timeout->max_latency && now - timeout->first_time >= 1000 * ( gint64 ) timeout->max_latency );
+
+	if( !quiet && !late ){
+		schedule_at( timeout, now );
+		return( FALSE );
+	}
+
+	/* last individual notification is older that the 'timeout' parameter
+	 * we may so suppose that the burst is terminated (or it lasts for
+	 * too long) and feel authorized to trigger the defined callback
+	 *
+	 * reset the event source id before the callback execution, so that
+	 * an event recorded by the handler itself starts a new burst
+	 */
+	timeout->source_id = 0;
+	timeout->flushes += 1;
+
+	( *timeout->handler )( timeout->user_data );
+
+	return( FALSE );
 }
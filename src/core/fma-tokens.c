@@ -50,22 +50,43 @@ struct _FMATokensClassPrivate {
 	void *empty;						/* so that gcc -pedantic is happy */
 };
 
+enum {
+	TOKEN_ITEM_URI = 0,
+	TOKEN_ITEM_FILENAME,
+	TOKEN_ITEM_BASEDIR,
+	TOKEN_ITEM_BASENAME,
+	TOKEN_ITEM_BASENAME_WOEXT,
+	TOKEN_ITEM_EXT,
+	TOKEN_ITEM_MIMETYPE,
+	TOKEN_ITEM_N
+};
+
+#define TOKEN_ITEM_ALL					(( 1 << TOKEN_ITEM_N )-1 )
+
 /* private instance data
+ * the per-item strings of the selection are stored in contiguous 'arenas'
+ * blocks, while 'items' is an array of count*TOKEN_ITEM_N pointers into
+ * these arenas, so that the i-th string of a given kind is
+ * items[i*TOKEN_ITEM_N+kind]
+ * the kinds of strings are materialized by batch: those which are used
+ * by the loaded items at construction time, and the others on demand,
+ * from the kept 'selection' - 'materialized' is the bitmask of the
+ * already available kinds
+ * 'lengths' is the cumulated length of the strings of each kind, so that
+ * plural forms may be expanded without reallocation
  */
 struct _FMATokensPrivate {
-	gboolean dispose_has_run;
-	guint    count;
-	GSList  *uris;
-	GSList  *filenames;
-	GSList  *basedirs;
-	GSList  *basenames;
-	GSList  *basenames_woext;
-	GSList  *exts;
-	GSList  *mimetypes;
-	gchar   *hostname;
-	gchar   *username;
-	guint    port;
-	gchar   *scheme;
+	gboolean      dispose_has_run;
+	guint         count;
+	GList        *selection;
+	guint         materialized;
+	GSList       *arenas;
+	const gchar **items;
+	gsize         lengths[ TOKEN_ITEM_N ];
+	gchar        *hostname;
+	gchar        *username;
+	guint         port;
+	gchar        *scheme;
 };
 
 /*  the structure passed to the callback which waits for the end of the child
@@ -96,8 +117,15 @@ static gchar    *get_command_execution_normal( const gchar *command );
 static gchar    *get_command_execution_terminal( const gchar *command );
 static gboolean  is_singular_exec( const FMATokens *tokens, const gchar *exec );
 static gchar    *parse_singular( const FMATokens *tokens, const gchar *input, guint i, gboolean utf8, gboolean quoted );
+static void      materialize( const FMATokens *tokens, guint kinds );
+static void      set_items( const FMATokens *tokens, gchar **strings, guint kinds );
+static guint     scan_items_rec( GList *items );
+static guint     scan_object( const FMAObject *object );
+static guint     scan_string( const gchar *string );
+static gsize     get_output_size( const FMATokens *tokens, const gchar *input, gboolean quoted );
 static GString  *quote_string( GString *input, const gchar *name, gboolean quoted );
-static GString  *quote_string_list( GString *input, GSList *names, gboolean quoted );
+static GString  *quote_string_list( GString *input, const FMATokens *tokens, guint kind, gboolean quoted );
+static const gchar *get_nth( const FMATokens *tokens, guint i, guint kind );
 
 GType
 fma_tokens_get_type( void )
@@ -168,13 +196,10 @@ instance_init( GTypeInstance *instance, gpointer klass )
 
 	self->private = g_new0( FMATokensPrivate, 1 );
 
-	self->private->uris = NULL;
-	self->private->filenames = NULL;
-	self->private->basedirs = NULL;
-	self->private->basenames = NULL;
-	self->private->basenames_woext = NULL;
-	self->private->exts = NULL;
-	self->private->mimetypes = NULL;
+	self->private->selection = NULL;
+	self->private->materialized = 0;
+	self->private->arenas = NULL;
+	self->private->items = NULL;
 	self->private->hostname = NULL;
 	self->private->username = NULL;
 	self->private->port = 0;
@@ -199,6 +224,9 @@ instance_dispose( GObject *object )
 
 		self->private->dispose_has_run = TRUE;
 
+		fma_selected_info_free_list( self->private->selection );
+		self->private->selection = NULL;
+
 		if( G_OBJECT_CLASS( st_parent_class )->dispose ){
 			G_OBJECT_CLASS( st_parent_class )->dispose( object );
 		}
@@ -220,13 +248,8 @@ instance_finalize( GObject *object )
 	g_free( self->private->scheme );
 	g_free( self->private->username );
 	g_free( self->private->hostname );
-	fma_core_utils_slist_free( self->private->mimetypes );
-	fma_core_utils_slist_free( self->private->exts );
-	fma_core_utils_slist_free( self->private->basenames_woext );
-	fma_core_utils_slist_free( self->private->basenames );
-	fma_core_utils_slist_free( self->private->basedirs );
-	fma_core_utils_slist_free( self->private->filenames );
-	fma_core_utils_slist_free( self->private->uris );
+	g_free( self->private->items );
+	g_slist_free_full( self->private->arenas, g_free );
 
 	g_free( self->private );
 
@@ -255,43 +278,40 @@ fma_tokens_new_for_example( void )
 	const guint  ex_port = 8080;
 	const gchar *ex_host = _( "test.example.net" );
 	const gchar *ex_user = _( "user" );
+	const gchar *ex_uris[] = { ex_uri1, ex_uri2 };
+	const gchar *ex_mimetypes[] = { ex_mimetype1, ex_mimetype2 };
 	FMAGnomeVFSURI *vfs;
-	gchar *dirname, *bname, *bname_woext, *ext;
-	GSList *is;
-	gboolean first;
+	gchar **strings, **item;
+	guint i;
 
 	g_debug( "%s:", thisfn );
 
 	tokens = g_object_new( FMA_TYPE_TOKENS, NULL );
-	first = TRUE;
-	tokens->private->count = 2;
+	tokens->private->count = G_N_ELEMENTS( ex_uris );
+	tokens->private->items = g_new0( const gchar *, tokens->private->count * TOKEN_ITEM_N );
+	strings = g_new0( gchar *, tokens->private->count * TOKEN_ITEM_N );
 
-	tokens->private->uris = g_slist_append( tokens->private->uris, g_strdup( ex_uri1 ));
-	tokens->private->uris = g_slist_append( tokens->private->uris, g_strdup( ex_uri2 ));
+	for( i = 0 ; i < G_N_ELEMENTS( ex_uris ) ; ++i ){
+		item = strings + i * TOKEN_ITEM_N;
 
-	for( is = tokens->private->uris ; is ; is = is->next ){
 		vfs = g_new0( FMAGnomeVFSURI, 1 );
-		fma_gnome_vfs_uri_parse( vfs, is->data );
-
-		tokens->private->filenames = g_slist_append( tokens->private->filenames, g_strdup( vfs->path ));
-		dirname = g_path_get_dirname( vfs->path );
-		tokens->private->basedirs = g_slist_append( tokens->private->basedirs, dirname );
-		bname = g_path_get_basename( vfs->path );
-		tokens->private->basenames = g_slist_append( tokens->private->basenames, bname );
-		fma_core_utils_dir_split_ext( bname, &bname_woext, &ext );
-		tokens->private->basenames_woext = g_slist_append( tokens->private->basenames_woext, bname_woext );
-		tokens->private->exts = g_slist_append( tokens->private->exts, ext );
-
-		if( first ){
+		fma_gnome_vfs_uri_parse( vfs, ex_uris[i] );
+
+		item[TOKEN_ITEM_URI] = g_strdup( ex_uris[i] );
+		item[TOKEN_ITEM_FILENAME] = g_strdup( vfs->path );
+		item[TOKEN_ITEM_BASEDIR] = g_path_get_dirname( vfs->path );
+		item[TOKEN_ITEM_BASENAME] = g_path_get_basename( vfs->path );
+		fma_core_utils_dir_split_ext( item[TOKEN_ITEM_BASENAME], &item[TOKEN_ITEM_BASENAME_WOEXT], &item[TOKEN_ITEM_EXT] );
+		item[TOKEN_ITEM_MIMETYPE] = g_strdup( ex_mimetypes[i] );
+
+		if( i == 0 ){
 			tokens->private->scheme = g_strdup( vfs->scheme );
-			first = FALSE;
 		}
 
 		fma_gnome_vfs_uri_free( vfs );
 	}
 
-	tokens->private->mimetypes = g_slist_append( tokens->private->mimetypes, g_strdup( ex_mimetype1 ));
-	tokens->private->mimetypes = g_slist_append( tokens->private->mimetypes, g_strdup( ex_mimetype2 ));
+	set_items( tokens, strings, TOKEN_ITEM_ALL );
 
 	tokens->private->hostname = g_strdup( ex_host );
 	tokens->private->username = g_strdup( ex_user );
@@ -309,46 +329,266 @@ fma_tokens_new_for_example( void )
 FMATokens *
 fma_tokens_new_from_selection( GList *selection )
 {
-	static const gchar *thisfn = "fma_tokens_new_from_selection";
-	FMATokens *tokens;
-	GList *it;
-	gchar *uri, *filename, *basedir, *basename, *bname_woext, *ext, *mimetype;
-	gboolean first;
+	return( fma_tokens_new_from_selection_used( selection, TOKEN_ITEM_ALL ));
+}
 
-	g_debug( "%s: selection=%p (count=%d)", thisfn, ( void * ) selection, g_list_length( selection ));
+/*
+ * fma_tokens_new_from_selection_used:
+ * @selection: a #GList list of #FMASelectedInfo objects.
+ * @used: the tokens used by the loaded items, as returned by
+ *  fma_tokens_scan_items().
+ *
+ * Returns: a new #FMATokens object.
+ *
+ * Only the @used per-item tokens are computed here, while the others
+ * will be computed on demand.
+ */
+FMATokens *
+fma_tokens_new_from_selection_used( GList *selection, guint used )
+{
+	static const gchar *thisfn = "fma_tokens_new_from_selection_used";
+	FMATokens *tokens;
+	FMASelectedInfo *nsi;
 
-	first = TRUE;
 	tokens = g_object_new( FMA_TYPE_TOKENS, NULL );
 
 	tokens->private->count = g_list_length( selection );
+	tokens->private->items = g_new0( const gchar *, tokens->private->count * TOKEN_ITEM_N );
+	tokens->private->selection = fma_selected_info_copy_list( selection );
+
+	g_debug( "%s: selection=%p (count=%u), used=%u",
+			thisfn, ( void * ) selection, tokens->private->count, used );
+
+	if( selection ){
+		nsi = FMA_SELECTED_INFO( selection->data );
+		tokens->private->hostname = fma_selected_info_get_uri_host( nsi );
+		tokens->private->username = fma_selected_info_get_uri_user( nsi );
+		tokens->private->port = fma_selected_info_get_uri_port( nsi );
+		tokens->private->scheme = fma_selected_info_get_uri_scheme( nsi );
+	}
 
-	for( it = selection ; it ; it = it->next ){
-		mimetype = fma_selected_info_get_mime_type( FMA_SELECTED_INFO( it->data ));
+	materialize( tokens, used );
 
-		uri = fma_selected_info_get_uri( FMA_SELECTED_INFO( it->data ));
-		filename = fma_selected_info_get_path( FMA_SELECTED_INFO( it->data ));
-		basedir = fma_selected_info_get_dirname( FMA_SELECTED_INFO( it->data ));
-		basename = fma_selected_info_get_basename( FMA_SELECTED_INFO( it->data ));
-		fma_core_utils_dir_split_ext( basename, &bname_woext, &ext );
+	return( tokens );
+}
 
-		if( first ){
-			tokens->private->hostname = fma_selected_info_get_uri_host( FMA_SELECTED_INFO( it->data ));
-			tokens->private->username = fma_selected_info_get_uri_user( FMA_SELECTED_INFO( it->data ));
-			tokens->private->port = fma_selected_info_get_uri_port( FMA_SELECTED_INFO( it->data ));
-			tokens->private->scheme = fma_selected_info_get_uri_scheme( FMA_SELECTED_INFO( it->data ));
-			first = FALSE;
+/*
+ * fma_tokens_scan_items:
+ * @tree: a tree of #FMAObjectItem items.
+ *
+ * Returns: the bitmask of the per-item tokens which are used by the
+ * labels, tooltips, icons, conditions and commands of the @tree.
+ */
+guint
+fma_tokens_scan_items( GList *tree )
+{
+	static const gchar *thisfn = "fma_tokens_scan_items";
+	guint used;
+
+	used = scan_items_rec( tree );
+
+	g_debug( "%s: tree=%p, used=%u", thisfn, ( void * ) tree, used );
+
+	return( used );
+}
+
+static guint
+scan_items_rec( GList *items )
+{
+	GList *it;
+	guint used;
+
+	used = 0;
+
+	for( it = items ; it && used != TOKEN_ITEM_ALL ; it = it->next ){
+		used |= scan_object( FMA_OBJECT( it->data ));
+
+		/* the items of a menu, or the profiles of an action
+		 */
+		if( FMA_IS_OBJECT_ITEM( it->data )){
+			used |= scan_items_rec( fma_object_get_items( it->data ));
+		}
+	}
+
+	return( used );
+}
+
+static guint
+scan_object( const FMAObject *object )
+{
+	guint used;
+
+	used = 0;
+
+	if( FMA_IS_OBJECT_ITEM( object )){
+		used |= scan_string( fma_object_peek_label( object ));
+		used |= scan_string( fma_object_peek_tooltip( object ));
+		used |= scan_string( fma_object_peek_icon( object ));
+	}
+
+	if( FMA_IS_OBJECT_ACTION( object )){
+		used |= scan_string( fma_object_peek_toolbar_label( object ));
+	}
+
+	if( FMA_IS_OBJECT_PROFILE( object )){
+		used |= scan_string( fma_object_peek_path( object ));
+		used |= scan_string( fma_object_peek_parameters( object ));
+		used |= scan_string( fma_object_peek_working_dir( object ));
+	}
+
+	if( FMA_IS_ICONTEXT( object )){
+		used |= scan_string( fma_object_peek_try_exec( object ));
+		used |= scan_string( fma_object_peek_show_if_registered( object ));
+		used |= scan_string( fma_object_peek_show_if_true( object ));
+		used |= scan_string( fma_object_peek_show_if_running( object ));
+	}
+
+	return( used );
+}
+
+static guint
+scan_string( const gchar *string )
+{
+	const gchar *iter;
+	guint used;
+
+	used = 0;
+
+	for( iter = string ; iter && ( iter = strchr( iter, '%' )) && iter[1] ; iter += 2 ){
+		switch( g_ascii_tolower( iter[1] )){
+			case 'b':
+				used |= ( 1 << TOKEN_ITEM_BASENAME );
+				break;
+			case 'd':
+				used |= ( 1 << TOKEN_ITEM_BASEDIR );
+				break;
+			case 'f':
+				used |= ( 1 << TOKEN_ITEM_FILENAME );
+				break;
+			case 'm':
+				used |= ( 1 << TOKEN_ITEM_MIMETYPE );
+				break;
+			case 'u':
+				used |= ( 1 << TOKEN_ITEM_URI );
+				break;
+			case 'w':
+				used |= ( 1 << TOKEN_ITEM_BASENAME_WOEXT );
+				break;
+			case 'x':
+				used |= ( 1 << TOKEN_ITEM_EXT );
+				break;
 		}
+	}
+
+	return( used );
+}
 
-		tokens->private->uris = g_slist_append( tokens->private->uris, uri );
-		tokens->private->filenames = g_slist_append( tokens->private->filenames, filename );
-		tokens->private->basedirs = g_slist_append( tokens->private->basedirs, basedir );
-		tokens->private->basenames = g_slist_append( tokens->private->basenames, basename );
-		tokens->private->basenames_woext = g_slist_append( tokens->private->basenames_woext, bname_woext );
-		tokens->private->exts = g_slist_append( tokens->private->exts, ext );
-		tokens->private->mimetypes = g_slist_append( tokens->private->mimetypes, mimetype );
+/*
+ * computes the not yet available @kinds of strings for all the items of
+ * the kept selection
+ */
+static void
+materialize( const FMATokens *tokens, guint kinds )
+{
+	FMASelectedInfo *nsi;
+	GList *it;
+	gchar **strings, **item;
+	gchar *basename, *woext, *ext;
+
+	kinds &= ~tokens->private->materialized;
+
+	if( !kinds || !tokens->private->count ){
+		tokens->private->materialized |= kinds;
+		return;
 	}
 
-	return( tokens );
+	strings = g_new0( gchar *, tokens->private->count * TOKEN_ITEM_N );
+	item = strings;
+
+	for( it = tokens->private->selection ; it ; it = it->next, item += TOKEN_ITEM_N ){
+		nsi = FMA_SELECTED_INFO( it->data );
+
+		if( kinds & ( 1 << TOKEN_ITEM_MIMETYPE )){
+			item[TOKEN_ITEM_MIMETYPE] = fma_selected_info_get_mime_type( nsi );
+		}
+		if( kinds & ( 1 << TOKEN_ITEM_URI )){
+			item[TOKEN_ITEM_URI] = fma_selected_info_get_uri( nsi );
+		}
+		if( kinds & ( 1 << TOKEN_ITEM_FILENAME )){
+			item[TOKEN_ITEM_FILENAME] = fma_selected_info_get_path( nsi );
+		}
+		if( kinds & ( 1 << TOKEN_ITEM_BASEDIR )){
+			item[TOKEN_ITEM_BASEDIR] = fma_selected_info_get_dirname( nsi );
+		}
+		if( kinds & (( 1 << TOKEN_ITEM_BASENAME ) | ( 1 << TOKEN_ITEM_BASENAME_WOEXT ) | ( 1 << TOKEN_ITEM_EXT ))){
+			basename = fma_selected_info_get_basename( nsi );
+			woext = NULL;
+			ext = NULL;
+
+			if( kinds & (( 1 << TOKEN_ITEM_BASENAME_WOEXT ) | ( 1 << TOKEN_ITEM_EXT ))){
+				fma_core_utils_dir_split_ext( basename, &woext, &ext );
+			}
+			if( kinds & ( 1 << TOKEN_ITEM_BASENAME )){
+				item[TOKEN_ITEM_BASENAME] = basename;
+			} else {
+				g_free( basename );
+			}
+			if( kinds & ( 1 << TOKEN_ITEM_BASENAME_WOEXT )){
+				item[TOKEN_ITEM_BASENAME_WOEXT] = woext;
+			} else {
+				g_free( woext );
+			}
+			if( kinds & ( 1 << TOKEN_ITEM_EXT )){
+				item[TOKEN_ITEM_EXT] = ext;
+			} else {
+				g_free( ext );
+			}
+		}
+	}
+
+	set_items( tokens, strings, kinds );
+}
+
+/*
+ * moves the @kinds of the @strings (an array of count * TOKEN_ITEM_N
+ * strings, some of them possibly NULL) into a new arena of the @tokens
+ * the @strings array and its content are released here
+ */
+static void
+set_items( const FMATokens *tokens, gchar **strings, guint kinds )
+{
+	gsize size, len;
+	guint i, count;
+	gchar *arena, *ptr;
+
+	count = tokens->private->count;
+	size = 0;
+
+	for( i = 0 ; i < count * TOKEN_ITEM_N ; ++i ){
+		if( strings[i] ){
+			len = strlen( strings[i] );
+			tokens->private->lengths[i % TOKEN_ITEM_N] += len;
+			size += len+1;
+		}
+	}
+
+	arena = g_malloc( MAX( size, 1 ));
+	tokens->private->arenas = g_slist_prepend( tokens->private->arenas, arena );
+	ptr = arena;
+
+	for( i = 0 ; i < count * TOKEN_ITEM_N ; ++i ){
+		if( strings[i] ){
+			len = strlen( strings[i] )+1;
+			memcpy( ptr, strings[i], len );
+			tokens->private->items[i] = ptr;
+			ptr += len;
+			g_free( strings[i] );
+		}
+	}
+
+	tokens->private->materialized |= kinds;
+
+	g_free( strings );
 }
 
 /*
@@ -371,6 +611,23 @@ fma_tokens_parse_for_display( const FMATokens *tokens, const gchar *string, gboo
 	return( parse_singular( tokens, string, 0, utf8, FALSE ));
 }
 
+/*
+ * fma_tokens_parse_for_command:
+ * @tokens: a #FMATokens object.
+ * @string: the input command, may or may not contain tokens.
+ *
+ * Expands the parameters in the given command, as for a singular
+ * execution, filenames being shell-quoted.
+ *
+ * Returns: a copy of @string with tokens expanded, as a newly
+ * allocated string which should be g_free() by the caller.
+ */
+gchar *
+fma_tokens_parse_for_command( const FMATokens *tokens, const gchar *string )
+{
+	return( parse_singular( tokens, string, 0, FALSE, TRUE ));
+}
+
 /*
  * fma_tokens_execute_action:
  * @tokens: a #FMATokens object.
@@ -381,16 +638,12 @@ fma_tokens_parse_for_display( const FMATokens *tokens, const gchar *string, gboo
 void
 fma_tokens_execute_action( const FMATokens *tokens, const FMAObjectProfile *profile )
 {
-	gchar *path, *parameters, *exec;
+	gchar *exec;
 	gboolean singular;
 	guint i;
 	gchar *command;
 
-	path = fma_object_get_path( profile );
-	parameters = fma_object_get_parameters( profile );
-	exec = g_strdup_printf( "%s %s", path, parameters );
-	g_free( parameters );
-	g_free( path );
+	exec = g_strdup_printf( "%s %s", fma_object_peek_path( profile ), fma_object_peek_parameters( profile ));
 
 	singular = is_singular_exec( tokens, exec );
 
@@ -746,46 +999,45 @@ parse_singular( const FMATokens *tokens, const gchar *input, guint i, gboolean u
 	g_debug( "%s: tokens=%p, input=%s, i=%d, utf8=%s, quoted=%s",
 			thisfn, ( void * ) tokens, input, i, utf8 ? "true":"false", quoted ? "true":"false" );
 
-	output = g_string_new( "" );
-
 	/* return NULL if input is NULL
 	 */
 	if( !input ){
-		return( g_string_free( output, TRUE ));
+		return( NULL );
 	}
 
 	/* return an empty string if input is empty
 	 */
-	if( utf8 ){
-		if( !g_utf8_strlen( input, -1 )){
-			return( g_string_free( output, FALSE ));
-		}
-	} else {
-		if( !strlen( input )){
-			return( g_string_free( output, FALSE ));
-		}
+	if( !input[0] ){
+		return( g_strdup( "" ));
 	}
 
+	/* the output is allocated once, with enough room for the plural forms
+	 */
+	output = g_string_sized_new( get_output_size( tokens, input, quoted ));
+
 	iter = ( gchar * ) input;
 	prev_iter = iter;
 
-	while(( iter = g_strstr_len( iter, -1, "%" ))){
-		output = g_string_append_len( output, prev_iter, strlen( prev_iter ) - strlen( iter ));
+	while(( iter = strchr( iter, '%' ))){
+		output = g_string_append_len( output, prev_iter, iter - prev_iter );
+
+		/* a trailing lone percent sign is copied as is
+		 */
+		if( !iter[1] ){
+			prev_iter = iter;
+			break;
+		}
 
 		switch( iter[1] ){
 			case 'b':
-				if( tokens->private->basenames ){
-					nth = ( const gchar * ) g_slist_nth_data( tokens->private->basenames, i );
-					if( nth ){
-						output = quote_string( output, nth, quoted );
-					}
+				nth = get_nth( tokens, i, TOKEN_ITEM_BASENAME );
+				if( nth ){
+					output = quote_string( output, nth, quoted );
 				}
 				break;
 
 			case 'B':
-				if( tokens->private->basenames ){
-					output = quote_string_list( output, tokens->private->basenames, quoted );
-				}
+				output = quote_string_list( output, tokens, TOKEN_ITEM_BASENAME, quoted );
 				break;
 
 			case 'c':
@@ -793,33 +1045,25 @@ parse_singular( const FMATokens *tokens, const gchar *input, guint i, gboolean u
 				break;
 
 			case 'd':
-				if( tokens->private->basedirs ){
-					nth = ( const gchar * ) g_slist_nth_data( tokens->private->basedirs, i );
-					if( nth ){
-						output = quote_string( output, nth, quoted );
-					}
+				nth = get_nth( tokens, i, TOKEN_ITEM_BASEDIR );
+				if( nth ){
+					output = quote_string( output, nth, quoted );
 				}
 				break;
 
 			case 'D':
-				if( tokens->private->basedirs ){
-					output = quote_string_list( output, tokens->private->basedirs, quoted );
-				}
+				output = quote_string_list( output, tokens, TOKEN_ITEM_BASEDIR, quoted );
 				break;
 
 			case 'f':
-				if( tokens->private->filenames ){
-					nth = ( const gchar * ) g_slist_nth_data( tokens->private->filenames, i );
-					if( nth ){
-						output = quote_string( output, nth, quoted );
-					}
+				nth = get_nth( tokens, i, TOKEN_ITEM_FILENAME );
+				if( nth ){
+					output = quote_string( output, nth, quoted );
 				}
 				break;
 
 			case 'F':
-				if( tokens->private->filenames ){
-					output = quote_string_list( output, tokens->private->filenames, quoted );
-				}
+				output = quote_string_list( output, tokens, TOKEN_ITEM_FILENAME, quoted );
 				break;
 
 			case 'h':
@@ -831,18 +1075,14 @@ parse_singular( const FMATokens *tokens, const gchar *input, guint i, gboolean u
 			/* mimetypes are never quoted
 			 */
 			case 'm':
-				if( tokens->private->mimetypes ){
-					nth = ( const gchar * ) g_slist_nth_data( tokens->private->mimetypes, i );
-					if( nth ){
-						output = quote_string( output, nth, FALSE );
-					}
+				nth = get_nth( tokens, i, TOKEN_ITEM_MIMETYPE );
+				if( nth ){
+					output = quote_string( output, nth, FALSE );
 				}
 				break;
 
 			case 'M':
-				if( tokens->private->mimetypes ){
-					output = quote_string_list( output, tokens->private->mimetypes, FALSE );
-				}
+				output = quote_string_list( output, tokens, TOKEN_ITEM_MIMETYPE, FALSE );
 				break;
 
 			/* no-op operators */
@@ -871,48 +1111,36 @@ parse_singular( const FMATokens *tokens, const gchar *input, guint i, gboolean u
 				break;
 
 			case 'u':
-				if( tokens->private->uris ){
-					nth = ( const gchar * ) g_slist_nth_data( tokens->private->uris, i );
-					if( nth ){
-						output = quote_string( output, nth, quoted );
-					}
+				nth = get_nth( tokens, i, TOKEN_ITEM_URI );
+				if( nth ){
+					output = quote_string( output, nth, quoted );
 				}
 				break;
 
 			case 'U':
-				if( tokens->private->uris ){
-					output = quote_string_list( output, tokens->private->uris, quoted );
-				}
+				output = quote_string_list( output, tokens, TOKEN_ITEM_URI, quoted );
 				break;
 
 			case 'w':
-				if( tokens->private->basenames_woext ){
-					nth = ( const gchar * ) g_slist_nth_data( tokens->private->basenames_woext, i );
-					if( nth ){
-						output = quote_string( output, nth, quoted );
-					}
+				nth = get_nth( tokens, i, TOKEN_ITEM_BASENAME_WOEXT );
+				if( nth ){
+					output = quote_string( output, nth, quoted );
 				}
 				break;
 
 			case 'W':
-				if( tokens->private->basenames_woext ){
-					output = quote_string_list( output, tokens->private->basenames_woext, quoted );
-				}
+				output = quote_string_list( output, tokens, TOKEN_ITEM_BASENAME_WOEXT, quoted );
 				break;
 
 			case 'x':
-				if( tokens->private->exts ){
-					nth = ( const gchar * ) g_slist_nth_data( tokens->private->exts, i );
-					if( nth ){
-						output = quote_string( output, nth, quoted );
-					}
+				nth = get_nth( tokens, i, TOKEN_ITEM_EXT );
+				if( nth ){
+					output = quote_string( output, nth, quoted );
 				}
 				break;
 
 			case 'X':
-				if( tokens->private->exts ){
-					output = quote_string_list( output, tokens->private->exts, quoted );
-				}
+				output = quote_string_list( output, tokens, TOKEN_ITEM_EXT, quoted );
 				break;
 
 			/* a percent sign
@@ -926,20 +1154,79 @@ parse_singular( const FMATokens *tokens, const gchar *input, guint i, gboolean u
 		prev_iter = iter;	/* store the new start of the string */
 	}
 
-	output = g_string_append_len( output, prev_iter, strlen( prev_iter ));
+	output = g_string_append( output, prev_iter );
 
 	return( g_string_free( output, FALSE ));
 }
 
+/*
+ * Returns: an estimation of the size of the expanded @input, taking into
+ * account the plural forms which may be very long for a huge selection
+ */
+static gsize
+get_output_size( const FMATokens *tokens, const gchar *input, gboolean quoted )
+{
+	const gchar *iter;
+	gsize size;
+	gint kind;
+
+	size = strlen( input )+1;
+	iter = input;
+
+	while(( iter = strchr( iter, '%' )) && iter[1] ){
+		switch( iter[1] ){
+			case 'B': kind = TOKEN_ITEM_BASENAME; break;
+			case 'D': kind = TOKEN_ITEM_BASEDIR; break;
+			case 'F': kind = TOKEN_ITEM_FILENAME; break;
+			case 'M': kind = TOKEN_ITEM_MIMETYPE; break;
+			case 'U': kind = TOKEN_ITEM_URI; break;
+			case 'W': kind = TOKEN_ITEM_BASENAME_WOEXT; break;
+			case 'X': kind = TOKEN_ITEM_EXT; break;
+			default: kind = -1; break;
+		}
+		if( kind >= 0 ){
+			materialize( tokens, 1 << kind );
+
+			/* one separator per item, plus two quotes when quoted
+			 */
+			size += tokens->private->lengths[kind] + tokens->private->count * ( quoted ? 3 : 1 );
+		}
+		iter += 2;
+	}
+
+	return( size );
+}
+
+/*
+ * Returns: the @kind string of the @i-th item of the selection, or NULL.
+ */
+static const gchar *
+get_nth( const FMATokens *tokens, guint i, guint kind )
+{
+	materialize( tokens, 1 << kind );
+
+	return( i < tokens->private->count ? tokens->private->items[i*TOKEN_ITEM_N+kind] : NULL );
+}
+
+/*
+ * quoting is the same than g_shell_quote() one, but is directly done
+ * into the output string
+ */
 static GString *
 quote_string( GString *input, const gchar *name, gboolean quoted )
 {
-	gchar *tmp;
+	const gchar *p;
 
 	if( quoted ){
-		tmp = g_shell_quote( name );
-		input = g_string_append( input, tmp );
-		g_free( tmp );
+		input = g_string_append_c( input, '\'' );
+		for( p = name ; *p ; ++p ){
+			if( *p == '\'' ){
+				input = g_string_append( input, "'\\''" );
+			} else {
+				input = g_string_append_c( input, *p );
+			}
+		}
+		input = g_string_append_c( input, '\'' );
 
 	} else {
 		input = g_string_append( input, name );
@@ -948,26 +1235,28 @@ quote_string( GString *input, const gchar *name, gboolean quoted )
 	return( input );
 }
 
+/*
+ * appends the space-separated list of the @kind strings of the selection
+ */
 static GString *
-quote_string_list( GString *input, GSList *names, gboolean quoted )
+quote_string_list( GString *input, const FMATokens *tokens, guint kind, gboolean quoted )
 {
-	GSList *it;
-	gchar *tmp;
+	const gchar *nth;
+	gboolean first;
+	guint i;
 
-	if( quoted ){
-		GSList *quoted_names = NULL;
-		for( it = names ; it ; it = it->next ){
-			quoted_names = g_slist_append( quoted_names, g_shell_quote(( const gchar * ) it->data ));
-		}
-		tmp = fma_core_utils_slist_join_at_end( quoted_names, " " );
-		fma_core_utils_slist_free( quoted_names );
+	first = TRUE;
 
-	} else {
-		tmp = fma_core_utils_slist_join_at_end( g_slist_reverse( names ), " " );
+	for( i = 0 ; i < tokens->private->count ; ++i ){
+		nth = get_nth( tokens, i, kind );
+		if( nth ){
+			if( !first ){
+				input = g_string_append_c( input, ' ' );
+			}
+			input = quote_string( input, nth, quoted );
+			first = FALSE;
+		}
 	}
 
-	input = g_string_append( input, tmp );
-	g_free( tmp );
-
 	return( input );
 }
@@ -112,8 +112,12 @@ GType      fma_tokens_get_type            ( void );
 
 FMATokens *fma_tokens_new_for_example     ( void );
 FMATokens *fma_tokens_new_from_selection  ( GList *selection );
+FMATokens *fma_tokens_new_from_selection_used( GList *selection, guint used );
+
+guint      fma_tokens_scan_items          ( GList *tree );
 
 gchar     *fma_tokens_parse_for_display   ( const FMATokens *tokens, const gchar *string, gboolean utf8 );
+gchar     *fma_tokens_parse_for_command   ( const FMATokens *tokens, const gchar *string );
 void       fma_tokens_execute_action      ( const FMATokens *tokens, const FMAObjectProfile *profile );
 
 gchar     *fma_tokens_command_for_terminal( const gchar *pattern, const gchar *command );
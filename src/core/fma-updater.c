@@ -423,6 +423,7 @@ fma_updater_insert_item( FMAUpdater *updater, FMAObjectItem *item, const gchar *
 
 		if( parent ){
 			fma_object_insert_at( parent, item, pos );
+			fma_pivot_items_changed_in_place( FMA_PIVOT( updater ));
 
 		} else {
 			tree = g_list_append( tree, item );
@@ -457,6 +458,7 @@ fma_updater_remove_item( FMAUpdater *updater, FMAObject *item )
 			tree = fma_object_get_items( parent );
 			tree = g_list_remove( tree, ( gconstpointer ) item );
 			fma_object_set_items( parent, tree );
+			fma_pivot_items_changed_in_place( FMA_PIVOT( updater ));
 
 		} else {
 			g_object_get( G_OBJECT( updater ), PIVOT_PROP_TREE, &tree, NULL );
@@ -0,0 +1,243 @@
+/*
+ * FileManager-Actions
+ * A file-manager extension which offers configurable context menu actions.
+ *
+ * Copyright (C) 2005 The GNOME Foundation
+ * Copyright (C) 2006-2008 Frederic Ruaudel and others (see AUTHORS)
+ * Copyright (C) 2009-2015 Pierre Wieser and others (see AUTHORS)
+ *
+ * FileManager-Actions is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * FileManager-Actions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FileManager-Actions; see the file COPYING. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Authors:
+ *   Frederic Ruaudel <grumz@grumz.net>
+ *   Rodrigo Moya <rodrigo@gnome-db.org>
+ *   Pierre Wieser <pwieser@trychlos.org>
+ *   ... and many others (see AUTHORS)
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <api/fma-worker-pool.h>
+
+/* the batch is shared between the waiting thread and the pool threads
+ * which have been pushed to help it; it is freed when the last of them
+ * releases it
+ * as a pool thread may only start when all the tasks have been run, and
+ * the tasks array released by the caller, the count of tasks is kept
+ * apart
+ */
+struct _FMAWorkerBatch {
+	gint          ref_count;
+	GPtrArray    *tasks;
+	guint         count;
+	FMAWorkerFunc func;
+	gpointer      user_data;
+	gint          next;				/* index of the next task to be run */
+	guint         done;				/* count of run tasks */
+	GMutex        mutex;
+	GCond         cond;
+};
+
+#define WORKER_POOL_MIN_THREADS			2
+#define WORKER_POOL_MAX_THREADS			16
+
+static GThreadPool *st_pool = NULL;
+
+static GThreadPool *get_pool( void );
+static void         on_pool_thread( FMAWorkerBatch *batch, gpointer pool_data );
+static void         batch_run( FMAWorkerBatch *batch );
+static void         batch_unref( FMAWorkerBatch *batch );
+
+/**
+ * fma_worker_pool_start:
+ * @tasks: the #GPtrArray array of tasks.
+ * @func: the worker function.
+ * @user_data: data to be passed to @func.
+ *
+ * Starts to run @func on each element of @tasks on the threads of the
+ * pool; the calling thread is free to do something else until it calls
+ * fma_worker_pool_wait().
+ *
+ * Returns: a new #FMAWorkerBatch, which must be passed to
+ * fma_worker_pool_wait().
+ *
+ * Since: 3.5
+ */
+FMAWorkerBatch *
+fma_worker_pool_start( GPtrArray *tasks, FMAWorkerFunc func, gpointer user_data )
+{
+	FMAWorkerBatch *batch;
+	GThreadPool *pool;
+	guint helpers, i;
+
+	g_return_val_if_fail( tasks, NULL );
+	g_return_val_if_fail( func, NULL );
+
+	batch = g_new0( FMAWorkerBatch, 1 );
+	batch->ref_count = 1;
+	batch->tasks = tasks;
+	batch->count = tasks->len;
+	batch->func = func;
+	batch->user_data = user_data;
+	g_mutex_init( &batch->mutex );
+	g_cond_init( &batch->cond );
+
+	pool = get_pool();
+
+	if( pool ){
+		helpers = MIN( tasks->len, ( guint ) g_thread_pool_get_max_threads( pool ));
+
+		for( i = 0 ; i < helpers ; ++i ){
+			g_atomic_int_inc( &batch->ref_count );
+			if( !g_thread_pool_push( pool, batch, NULL )){
+				batch_unref( batch );
+				break;
+			}
+		}
+	}
+
+	return( batch );
+}
+
+/**
+ * fma_worker_pool_wait:
+ * @batch: a #FMAWorkerBatch as returned by fma_worker_pool_start().
+ *
+ * Runs the tasks of the @batch which have not been yet taken by the
+ * threads of the pool, then waits until all the tasks have been run.
+ *
+ * The @batch is released by this function.
+ *
+ * Since: 3.5
+ */
+void
+fma_worker_pool_wait( FMAWorkerBatch *batch )
+{
+	g_return_if_fail( batch );
+
+	batch_run( batch );
+
+	g_mutex_lock( &batch->mutex );
+	while( batch->done < batch->count ){
+		g_cond_wait( &batch->cond, &batch->mutex );
+	}
+	g_mutex_unlock( &batch->mutex );
+
+	batch_unref( batch );
+}
+
+/**
+ * fma_worker_pool_run:
+ * @tasks: the #GPtrArray array of tasks.
+ * @func: the worker function.
+ * @user_data: data to be passed to @func.
+ *
+ * Runs @func on each element of @tasks, concurrently on the threads of
+ * the pool and on the calling thread, and returns when all the tasks
+ * have been run.
+ *
+ * Since: 3.5
+ */
+void
+fma_worker_pool_run( GPtrArray *tasks, FMAWorkerFunc func, gpointer user_data )
+{
+	guint i;
+
+	g_return_if_fail( tasks );
+	g_return_if_fail( func );
+
+	/* not worth the synchronization cost
+	 */
+	if( tasks->len < 2 ){
+		for( i = 0 ; i < tasks->len ; ++i ){
+			func( g_ptr_array_index( tasks, i ), user_data );
+		}
+		return;
+	}
+
+	fma_worker_pool_wait( fma_worker_pool_start( tasks, func, user_data ));
+}
+
+/*
+ * the pool is created on first use, and lives until the end of the
+ * process
+ */
+static GThreadPool *
+get_pool( void )
+{
+	static const gchar *thisfn = "fma_worker_pool_get_pool";
+	static gsize initialized = 0;
+	GError *error;
+	gint max_threads;
+
+	if( g_once_init_enter( &initialized )){
+#if GLIB_CHECK_VERSION( 2,36,0 )
+		max_threads = CLAMP( g_get_num_processors(), WORKER_POOL_MIN_THREADS, WORKER_POOL_MAX_THREADS );
+#else
+		max_threads = WORKER_POOL_MIN_THREADS;
+#endif
+		error = NULL;
+		st_pool = g_thread_pool_new(( GFunc ) on_pool_thread, NULL, max_threads, FALSE, &error );
+		if( error ){
+			g_warning( "%s: %s", thisfn, error->message );
+			g_error_free( error );
+		} else {
+			g_debug( "%s: pool=%p, max_threads=%d", thisfn, ( void * ) st_pool, max_threads );
+		}
+		g_once_init_leave( &initialized, 1 );
+	}
+
+	return( st_pool );
+}
+
+static void
+on_pool_thread( FMAWorkerBatch *batch, gpointer pool_data )
+{
+	batch_run( batch );
+	batch_unref( batch );
+}
+
+/*
+ * run the tasks which have not been yet taken by another thread
+ */
+static void
+batch_run( FMAWorkerBatch *batch )
+{
+	guint i;
+
+	while(( i = ( guint ) g_atomic_int_add( &batch->next, 1 )) < batch->count ){
+
+		batch->func( g_ptr_array_index( batch->tasks, i ), batch->user_data );
+
+		g_mutex_lock( &batch->mutex );
+		batch->done += 1;
+		if( batch->done == batch->count ){
+			g_cond_broadcast( &batch->cond );
+		}
+		g_mutex_unlock( &batch->mutex );
+	}
+}
+
+static void
+batch_unref( FMAWorkerBatch *batch )
+{
+	if( g_atomic_int_dec_and_test( &batch->ref_count )){
+		g_mutex_clear( &batch->mutex );
+		g_cond_clear( &batch->cond );
+		g_free( batch );
+	}
+}
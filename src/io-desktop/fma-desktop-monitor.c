@@ -246,5 +246,17 @@ fma_desktop_monitor_new( const FMADesktopProvider *provider, const gchar *path )
 static void
 on_monitor_changed( GFileMonitor *monitor, GFile *file, GFile *other_file, GFileMonitorEvent event_type, FMADesktopMonitor *my_monitor )
 {
-	fma_desktop_provider_on_monitor_event( my_monitor->private->provider );
+	gchar *path;
+
+	path = file ? g_file_get_path( file ) : NULL;
+	fma_desktop_provider_on_monitor_event( my_monitor->private->provider, path );
+	g_free( path );
+
+	/* a renamed file is both a deleted and a created one
+	 */
+	if( other_file ){
+		path = g_file_get_path( other_file );
+		fma_desktop_provider_on_monitor_event( my_monitor->private->provider, path );
+		g_free( path );
+	}
 }
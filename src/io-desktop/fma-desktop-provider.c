@@ -53,6 +53,7 @@ struct _FMADesktopProviderClassPrivate {
 static GType         st_module_type = 0;
 static GObjectClass *st_parent_class = NULL;
 static guint         st_burst_timeout = 100;		/* burst timeout in msec */
+static guint         st_burst_max_latency = 1000;	/* max burst latency in msec */
 
 static void   class_init( FMADesktopProviderClass *klass );
 static void   instance_init( GTypeInstance *instance, gpointer klass );
@@ -63,6 +64,7 @@ static void   iio_provider_iface_init( FMAIIOProviderInterface *iface );
 static gchar *iio_provider_get_id( const FMAIIOProvider *provider );
 static gchar *iio_provider_get_name( const FMAIIOProvider *provider );
 static guint  iio_provider_get_version( const FMAIIOProvider *provider );
+static gboolean iio_provider_is_able_to_read_concurrently( const FMAIIOProvider *provider );
 
 static void   ifactory_provider_iface_init( FMAIFactoryProviderInterface *iface );
 static guint  ifactory_provider_get_version( const FMAIFactoryProvider *reader );
@@ -173,9 +175,12 @@ instance_init( GTypeInstance *instance, gpointer klass )
 	self->private->dispose_has_run = FALSE;
 	self->private->monitors = NULL;
 	self->private->timeout.timeout = st_burst_timeout;
+	self->private->timeout.max_latency = st_burst_max_latency;
 	self->private->timeout.handler = ( FMATimeoutFunc ) on_monitor_timeout;
 	self->private->timeout.user_data = self;
 	self->private->timeout.source_id = 0;
+	self->private->changed_paths = g_hash_table_new_full( g_str_hash, g_str_equal, g_free, NULL );
+	self->private->unknown_change = FALSE;
 }
 
 static void
@@ -196,6 +201,9 @@ instance_dispose( GObject *object )
 
 		fma_desktop_provider_release_monitors( self );
 
+		g_hash_table_unref( self->private->changed_paths );
+		self->private->changed_paths = NULL;
+
 		/* chain up to the parent class */
 		if( G_OBJECT_CLASS( st_parent_class )->dispose ){
 			G_OBJECT_CLASS( st_parent_class )->dispose( object );
@@ -239,6 +247,9 @@ iio_provider_iface_init( FMAIIOProviderInterface *iface )
 	iface->write_item = fma_desktop_writer_iio_provider_write_item;
 	iface->delete_item = fma_desktop_writer_iio_provider_delete_item;
 	iface->duplicate_data = fma_desktop_writer_iio_provider_duplicate_data;
+	iface->get_sources = fma_desktop_reader_iio_provider_get_sources;
+	iface->read_item_from_path = fma_desktop_reader_iio_provider_read_item_from_path;
+	iface->is_able_to_read_concurrently = iio_provider_is_able_to_read_concurrently;
 }
 
 static guint
@@ -247,6 +258,16 @@ iio_provider_get_version( const FMAIIOProvider *provider )
 	return( 1 );
 }
 
+/*
+ * the .desktop files are read with GKeyFile, and the monitors we install
+ * while reading them are attached to the global default main context
+ */
+static gboolean
+iio_provider_is_able_to_read_concurrently( const FMAIIOProvider *provider )
+{
+	return( TRUE );
+}
+
 static gchar *
 iio_provider_get_id( const FMAIIOProvider *provider )
 {
@@ -361,16 +382,26 @@ fma_desktop_provider_add_monitor( FMADesktopProvider *provider, const gchar *dir
 /**
  * fma_desktop_provider_on_monitor_event:
  * @provider: this #FMADesktopProvider object.
+ * @path: the changed path, or %NULL if unknown.
  *
- * Factorize events received from GIO when monitoring desktop directories.
+ * Factorize events received from GIO when monitoring desktop directories,
+ * accumulating the changed paths until the end of the burst.
  */
 void
-fma_desktop_provider_on_monitor_event( FMADesktopProvider *provider )
+fma_desktop_provider_on_monitor_event( FMADesktopProvider *provider, const gchar *path )
 {
 	g_return_if_fail( FMA_IS_DESKTOP_PROVIDER( provider ));
 
 	if( !provider->private->dispose_has_run ){
 
+		if( path ){
+			if( !g_hash_table_contains( provider->private->changed_paths, path )){
+				g_hash_table_add( provider->private->changed_paths, g_strdup( path ));
+			}
+		} else {
+			provider->private->unknown_change = TRUE;
+		}
+
 		fma_timeout_event( &provider->private->timeout );
 	}
 }
@@ -402,8 +433,30 @@ on_monitor_timeout( FMADesktopProvider *provider )
 	/* last individual notification is older that the st_burst_timeout
 	 * so triggers the FMAIIOProvider interface and destroys this timeout
 	 */
-	g_debug( "%s: triggering FMAIIOProvider interface for provider=%p (%s)",
-			thisfn, ( void * ) provider, G_OBJECT_TYPE_NAME( provider ));
+	GList *keys, *ik;
+	GSList *paths;
+
+	g_debug( "%s: triggering FMAIIOProvider interface for provider=%p (%s), paths=%u, unknown_change=%s",
+			thisfn, ( void * ) provider, G_OBJECT_TYPE_NAME( provider ),
+			g_hash_table_size( provider->private->changed_paths ),
+			provider->private->unknown_change ? "True":"False" );
+
+	if( provider->private->unknown_change || !g_hash_table_size( provider->private->changed_paths )){
+		fma_iio_provider_item_changed( FMA_IIO_PROVIDER( provider ));
+
+	} else {
+		paths = NULL;
+		keys = g_hash_table_get_keys( provider->private->changed_paths );
+		for( ik = keys ; ik ; ik = ik->next ){
+			paths = g_slist_prepend( paths, ik->data );
+		}
+		g_list_free( keys );
+
+		fma_iio_provider_paths_changed( FMA_IIO_PROVIDER( provider ), paths );
+
+		g_slist_free( paths );
+	}
 
-	fma_iio_provider_item_changed( FMA_IIO_PROVIDER( provider ));
+	g_hash_table_remove_all( provider->private->changed_paths );
+	provider->private->unknown_change = FALSE;
 }
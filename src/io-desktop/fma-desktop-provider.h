@@ -63,6 +63,8 @@ typedef struct _FMADesktopProviderPrivate {
 	gboolean   dispose_has_run;
 	GList     *monitors;
 	FMATimeout timeout;
+	GHashTable *changed_paths;
+	gboolean   unknown_change;
 }
 	FMADesktopProviderPrivate;
 
@@ -91,7 +93,7 @@ GType fma_desktop_provider_get_type        ( void );
 void  fma_desktop_provider_register_type   ( GTypeModule *module );
 
 void  fma_desktop_provider_add_monitor     ( FMADesktopProvider *provider, const gchar *dir );
-void  fma_desktop_provider_on_monitor_event( FMADesktopProvider *provider );
+void  fma_desktop_provider_on_monitor_event( FMADesktopProvider *provider, const gchar *path );
 void  fma_desktop_provider_release_monitors( FMADesktopProvider *provider );
 
 G_END_DECLS
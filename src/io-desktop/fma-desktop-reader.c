@@ -40,6 +40,7 @@
 #include <api/fma-ifactory-object-data.h>
 #include <api/fma-ifactory-provider.h>
 #include <api/fma-object-api.h>
+#include <api/fma-worker-pool.h>
 
 #include "fma-desktop-provider.h"
 #include "fma-desktop-keys.h"
@@ -53,6 +54,16 @@ typedef struct {
 }
 	sDesktopPath;
 
+/* parsing a .desktop file, maybe on a worker thread
+ */
+typedef struct {
+	const FMADesktopProvider *provider;
+	sDesktopPath             *dps;
+	FMAIFactoryObject        *item;
+	GSList                   *messages;
+}
+	sParseTask;
+
 /* the structure passed as reader data to FMAIFactoryObject
  */
 typedef struct {
@@ -63,11 +74,14 @@ typedef struct {
 
 #define ERR_NOT_DESKTOP		_( "The Desktop I/O Provider is not able to handle the URI" )
 
+static GSList            *get_list_of_desktop_dirs( FMADesktopProvider *provider, gboolean monitor );
 static GList             *get_list_of_desktop_paths( FMADesktopProvider *provider, GSList **mesages );
-static void               get_list_of_desktop_files( const FMADesktopProvider *provider, GList **files, const gchar *dir, GSList **messages );
-static gboolean           is_already_loaded( const FMADesktopProvider *provider, GList *files, const gchar *desktop_id );
+static void               get_list_of_desktop_files( const FMADesktopProvider *provider, GList **files, GHashTable *loaded, const gchar *dir, GSList **messages );
+static guint              count_desktop_id_in_dir( const gchar *dir, const gchar *id, gboolean *exact );
+static gboolean           is_already_loaded( const FMADesktopProvider *provider, GHashTable *loaded, const gchar *desktop_id );
 static GList             *desktop_path_from_id( const FMADesktopProvider *provider, GList *files, const gchar *dir, const gchar *id );
 static FMAIFactoryObject *item_from_desktop_path( const FMADesktopProvider *provider, sDesktopPath *dps, GSList **messages );
+static void               item_from_parse_task( sParseTask *task, void *empty );
 static FMAIFactoryObject *item_from_desktop_file( const FMADesktopProvider *provider, FMADesktopFile *ndf, GSList **messages );
 static void               desktop_weak_notify( FMADesktopFile *ndf, GObject *item );
 static void               free_desktop_paths( GList *paths );
@@ -82,6 +96,8 @@ static void               read_done_action_load_profile( const FMAIFactoryProvid
 /*
  * Returns an unordered list of FMAIFactoryObject-derived objects
  *
+ * The .desktop files are parsed concurrently on the worker pool.
+ *
  * This is implementation of FMAIIOProvider::read_items method
  */
 GList *
@@ -90,7 +106,9 @@ fma_desktop_reader_iio_provider_read_items( const FMAIIOProvider *provider, GSLi
 	static const gchar *thisfn = "fma_desktop_reader_iio_provider_read_items";
 	GList *items;
 	GList *desktop_paths, *ip;
-	FMAIFactoryObject *item;
+	GPtrArray *tasks;
+	sParseTask *task;
+	guint i;
 
 	g_debug( "%s: provider=%p (%s), messages=%p",
 			thisfn, ( void * ) provider, G_OBJECT_TYPE_NAME( provider ), ( void * ) messages );
@@ -101,16 +119,33 @@ fma_desktop_reader_iio_provider_read_items( const FMAIIOProvider *provider, GSLi
 	fma_desktop_provider_release_monitors( FMA_DESKTOP_PROVIDER( provider ));
 
 	desktop_paths = get_list_of_desktop_paths( FMA_DESKTOP_PROVIDER( provider ), messages );
+	tasks = g_ptr_array_new_with_free_func( g_free );
+
 	for( ip = desktop_paths ; ip ; ip = ip->next ){
+		task = g_new0( sParseTask, 1 );
+		task->provider = FMA_DESKTOP_PROVIDER( provider );
+		task->dps = ( sDesktopPath * ) ip->data;
+		g_ptr_array_add( tasks, task );
+	}
+
+	fma_worker_pool_run( tasks, ( FMAWorkerFunc ) item_from_parse_task, NULL );
 
-		item = item_from_desktop_path( FMA_DESKTOP_PROVIDER( provider ), ( sDesktopPath * ) ip->data, messages );
+	for( i = 0 ; i < tasks->len ; ++i ){
+		task = ( sParseTask * ) g_ptr_array_index( tasks, i );
+
+		if( task->item ){
+			items = g_list_prepend( items, task->item );
+			fma_object_dump( task->item );
+		}
 
-		if( item ){
-			items = g_list_prepend( items, item );
-			fma_object_dump( item );
+		if( messages ){
+			*messages = g_slist_concat( *messages, task->messages );
+		} else {
+			fma_core_utils_slist_free( task->messages );
 		}
 	}
 
+	g_ptr_array_free( tasks, TRUE );
 	free_desktop_paths( desktop_paths );
 
 	g_debug( "%s: count=%d", thisfn, g_list_length( items ));
@@ -118,24 +153,118 @@ fma_desktop_reader_iio_provider_read_items( const FMAIIOProvider *provider, GSLi
 }
 
 /*
- * returns a list of sDesktopPath items
+ * Returns the list of the directories the items are read from
  *
- * we get the ordered list of XDG_DATA_DIRS, and the ordered list of
- *  subdirs to add; then for each item of each list, we search for
- *  .desktop files in the resulted built path
+ * This is implementation of FMAIIOProvider::get_sources method
+ */
+GSList *
+fma_desktop_reader_iio_provider_get_sources( const FMAIIOProvider *provider )
+{
+	static const gchar *thisfn = "fma_desktop_reader_iio_provider_get_sources";
+	GSList *dirs;
+
+	g_return_val_if_fail( FMA_IS_IIO_PROVIDER( provider ), NULL );
+
+	/* the items will not be read, but we still have to monitor the
+	 * directories they would have been read from
+	 */
+	fma_desktop_provider_release_monitors( FMA_DESKTOP_PROVIDER( provider ));
+
+	dirs = get_list_of_desktop_dirs( FMA_DESKTOP_PROVIDER( provider ), TRUE );
+
+	g_debug( "%s: provider=%p, count=%d", thisfn, ( void * ) provider, g_slist_length( dirs ));
+
+	return( dirs );
+}
+
+/*
+ * Re-reads the item a changed path refers to
  *
- * the returned list is so a list of sDesktopPath struct, in
- * the ordered of preference (most preferred first)
+ * A .desktop file directly inside one of the explored directories refers
+ * to the item of the same id; as the first directory which holds a file
+ * for this id wins, the item is searched again in all directories.
+ * A change on an explored directory itself requires a full reload, while
+ * any other path is just ignored.
+ *
+ * As the desktop ids are deduplicated case-insensitively, a full reload
+ * is also required when the first directory which holds a file for this
+ * id only holds it with another case, or holds several of them.
+ *
+ * This is implementation of FMAIIOProvider::read_item_from_path method
  */
-static GList *
-get_list_of_desktop_paths( FMADesktopProvider *provider, GSList **messages )
+gboolean
+fma_desktop_reader_iio_provider_read_item_from_path( const FMAIIOProvider *provider, const gchar *path, gchar **id, FMAObjectItem **item, GSList **messages )
 {
-	GList *files;
+	static const gchar *thisfn = "fma_desktop_reader_iio_provider_read_item_from_path";
+	GSList *dirs, *idir;
+	gchar *dirname, *bname;
+	sDesktopPath dps;
+	gboolean ok, exact;
+	guint count;
+
+	g_return_val_if_fail( FMA_IS_IIO_PROVIDER( provider ), FALSE );
+	g_return_val_if_fail( path && id && item, FALSE );
+
+	ok = TRUE;
+	*id = NULL;
+	*item = NULL;
+	dirs = get_list_of_desktop_dirs( FMA_DESKTOP_PROVIDER( provider ), FALSE );
+
+	if( fma_core_utils_slist_count( dirs, path )){
+		ok = FALSE;
+
+	} else if( g_str_has_suffix( path, FMA_DESKTOP_FILE_SUFFIX )){
+		dirname = g_path_get_dirname( path );
+
+		if( fma_core_utils_slist_count( dirs, dirname )){
+			bname = g_path_get_basename( path );
+			*id = fma_core_utils_str_remove_suffix( bname, FMA_DESKTOP_FILE_SUFFIX );
+			dps.id = *id;
+
+			for( count = 0, idir = dirs ; idir && !count ; idir = idir->next ){
+				count = count_desktop_id_in_dir(( const gchar * ) idir->data, *id, &exact );
+
+				if( count == 1 && exact ){
+					dps.path = g_build_filename(( const gchar * ) idir->data, bname, NULL );
+					*item = FMA_OBJECT_ITEM( item_from_desktop_path( FMA_DESKTOP_PROVIDER( provider ), &dps, messages ));
+					g_free( dps.path );
+
+				} else if( count ){
+					ok = FALSE;
+				}
+			}
+
+			g_free( bname );
+		}
+
+		g_free( dirname );
+	}
+
+	fma_core_utils_slist_free( dirs );
+
+	g_debug( "%s: path=%s, ok=%s, id=%s, item=%p",
+			thisfn, path, ok ? "True":"False", *id, ( void * ) *item );
+
+	return( ok );
+}
+
+/*
+ * returns the list of the directories to be explored
+ *
+ * we get the ordered list of XDG_DATA_DIRS, and the ordered list of
+ *  subdirs to add; for each item of each list, the resulted built path
+ *  is returned, in the order of preference (most preferred first), and
+ *  monitored if asked for
+ */
+static GSList *
+get_list_of_desktop_dirs( FMADesktopProvider *provider, gboolean monitor )
+{
+	GSList *dirs;
 	GSList *xdg_dirs, *idir;
 	GSList *subdirs, *isub;
 	gchar *dir;
 
-	files = NULL;
+	dirs = NULL;
 	xdg_dirs = fma_desktop_xdg_dirs_get_data_dirs();
 	subdirs = fma_core_utils_slist_from_split( FMA_DESKTOP_PROVIDER_SUBDIRS, G_SEARCHPATH_SEPARATOR_S );
 
@@ -148,24 +277,92 @@ get_list_of_desktop_paths( FMADesktopProvider *provider, GSList **messages )
 		for( isub = subdirs ; isub ; isub = isub->next ){
 
 			dir = g_build_filename(( gchar * ) idir->data, ( gchar * ) isub->data, NULL );
-			fma_desktop_provider_add_monitor( provider, dir );
-			get_list_of_desktop_files( provider, &files, dir, messages );
-			g_free( dir );
+			if( monitor ){
+				fma_desktop_provider_add_monitor( provider, dir );
+			}
+			dirs = g_slist_prepend( dirs, dir );
 		}
 	}
 
 	fma_core_utils_slist_free( subdirs );
 	fma_core_utils_slist_free( xdg_dirs );
 
+	return( g_slist_reverse( dirs ));
+}
+
+/*
+ * returns a list of sDesktopPath items
+ *
+ * for each directory to be explored, we search for .desktop files
+ *
+ * the returned list is so a list of sDesktopPath struct, in
+ * the ordered of preference (most preferred first)
+ */
+static GList *
+get_list_of_desktop_paths( FMADesktopProvider *provider, GSList **messages )
+{
+	GList *files;
+	GSList *dirs, *idir;
+	GHashTable *loaded;
+
+	files = NULL;
+	dirs = get_list_of_desktop_dirs( provider, TRUE );
+
+	/* the set of the already found desktop ids, the keys being owned by
+	 * the sDesktopPath structs of the list
+	 */
+	loaded = g_hash_table_new( fma_core_utils_str_ascii_case_hash, fma_core_utils_str_ascii_case_equal );
+
+	for( idir = dirs ; idir ; idir = idir->next ){
+		get_list_of_desktop_files( provider, &files, loaded, ( const gchar * ) idir->data, messages );
+	}
+
+	g_hash_table_destroy( loaded );
+	fma_core_utils_slist_free( dirs );
+
 	return( files );
 }
 
+/*
+ * returns the count of the .desktop files of the directory whose id is
+ * case-insensitively equal to @id, setting @exact to whether one of them
+ * has exactly this @id
+ */
+static guint
+count_desktop_id_in_dir( const gchar *dir, const gchar *id, gboolean *exact )
+{
+	GDir *dir_handle;
+	const gchar *name;
+	gchar *desktop_id;
+	guint count;
+
+	count = 0;
+	*exact = FALSE;
+	dir_handle = g_dir_open( dir, 0, NULL );
+
+	if( dir_handle ){
+		while(( name = g_dir_read_name( dir_handle ))){
+			if( g_str_has_suffix( name, FMA_DESKTOP_FILE_SUFFIX )){
+				desktop_id = fma_core_utils_str_remove_suffix( name, FMA_DESKTOP_FILE_SUFFIX );
+				if( !g_ascii_strcasecmp( desktop_id, id )){
+					count += 1;
+					*exact |= !strcmp( desktop_id, id );
+				}
+				g_free( desktop_id );
+			}
+		}
+		g_dir_close( dir_handle );
+	}
+
+	return( count );
+}
+
 /*
  * scans the directory for .desktop files
  * only adds to the list those which have not been yet loaded
  */
 static void
-get_list_of_desktop_files( const FMADesktopProvider *provider, GList **files, const gchar *dir, GSList **messages )
+get_list_of_desktop_files( const FMADesktopProvider *provider, GList **files, GHashTable *loaded, const gchar *dir, GSList **messages )
 {
 	static const gchar *thisfn = "fma_desktop_reader_get_list_of_desktop_files";
 	GDir *dir_handle;
@@ -196,8 +393,9 @@ get_list_of_desktop_files( const FMADesktopProvider *provider, GList **files, co
 		while(( name = g_dir_read_name( dir_handle ))){
 			if( g_str_has_suffix( name, FMA_DESKTOP_FILE_SUFFIX )){
 				desktop_id = fma_core_utils_str_remove_suffix( name, FMA_DESKTOP_FILE_SUFFIX );
-				if( !is_already_loaded( provider, *files, desktop_id )){
+				if( !is_already_loaded( provider, loaded, desktop_id )){
 					*files = desktop_path_from_id( provider, *files, dir, desktop_id );
+					g_hash_table_add( loaded, (( sDesktopPath * )( *files )->data )->id );
 				}
 				g_free( desktop_id );
 			}
@@ -211,21 +409,9 @@ close_dir_handle:
 }
 
 static gboolean
-is_already_loaded( const FMADesktopProvider *provider, GList *files, const gchar *desktop_id )
+is_already_loaded( const FMADesktopProvider *provider, GHashTable *loaded, const gchar *desktop_id )
 {
-	gboolean found;
-	GList *ip;
-	sDesktopPath *dps;
-
-	found = FALSE;
-	for( ip = files ; ip && !found ; ip = ip->next ){
-		dps = ( sDesktopPath * ) ip->data;
-		if( !g_ascii_strcasecmp( dps->id, desktop_id )){
-			found = TRUE;
-		}
-	}
-
-	return( found );
+	return( g_hash_table_contains( loaded, desktop_id ));
 }
 
 static GList *
@@ -265,6 +451,12 @@ item_from_desktop_path( const FMADesktopProvider *provider, sDesktopPath *dps, G
 	return( item_from_desktop_file( provider, ndf, messages ));
 }
 
+static void
+item_from_parse_task( sParseTask *task, void *empty )
+{
+	task->item = item_from_desktop_path( task->provider, task->dps, &task->messages );
+}
+
 /*
  * Returns a newly allocated FMAIFactoryObject-derived object, initialized
  * from the .desktop file
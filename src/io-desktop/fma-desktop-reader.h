@@ -37,6 +37,8 @@
 G_BEGIN_DECLS
 
 GList        *fma_desktop_reader_iio_provider_read_items     ( const FMAIIOProvider *provider, GSList **messages );
+GSList       *fma_desktop_reader_iio_provider_get_sources    ( const FMAIIOProvider *provider );
+gboolean      fma_desktop_reader_iio_provider_read_item_from_path( const FMAIIOProvider *provider, const gchar *path, gchar **id, FMAObjectItem **item, GSList **messages );
 
 guint         fma_desktop_reader_iimporter_import_from_uri   ( const FMAIImporter *instance, void *parms_ptr );
 
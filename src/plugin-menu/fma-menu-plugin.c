@@ -41,6 +41,7 @@
 
 #include <core/fma-pivot.h>
 #include <core/fma-about.h>
+#include <core/fma-process-cache.h>
 #include <core/fma-selected-info.h>
 #include <core/fma-tokens.h>
 
@@ -60,11 +61,44 @@ struct _FMAMenuPluginPrivate {
 	gulong     items_changed_handler;
 	gulong     settings_changed_handler;
 	FMATimeout change_timeout;
+	gboolean   reload_needed;
+	GQueue    *menu_cache;
 };
 
+/* an entry of the menu cache
+ * the key is a digest of the target, the pivot generation, and the
+ * URIs and mimetypes of the selection
+ * the menu is the list of FileManagerMenuItem's built for this key, each
+ * item being reffed by the cache
+ * menus which depend on a TryExec, ShowIfRunning, ShowIfTrue or
+ * Capabilities condition are not cached, as these conditions have to
+ * be evaluated again for the same selection
+ */
+typedef struct {
+	gchar *key;
+	GList *menu;
+}
+	sMenuCacheEntry;
+
+#define MENU_CACHE_MAX_ENTRIES			8
+
+/* the token-expanded display strings of a candidate item
+ * the source item is owned by the FMAPivot tree, and is never modified
+ */
+typedef struct {
+	const FMAObjectItem *source;
+	gchar               *label;
+	gchar               *tooltip;
+	gchar               *icon;
+	gchar               *toolbar_label;
+}
+	sExpandedItem;
+
 static GObjectClass *st_parent_class  = NULL;
 static GType         st_actions_type  = 0;
 static gint          st_burst_timeout = 100;		/* burst timeout in msec */
+static gint          st_burst_max_latency = 1000;	/* max burst latency in msec */
+static guint         st_probe_deadline = 500;		/* max time to query the selection attributes in msec */
 
 static void                 class_init( FMAMenuPluginClass *klass );
 static void                 instance_init( GTypeInstance *instance, gpointer klass );
@@ -81,24 +115,37 @@ static GList               *menu_provider_get_toolbar_items( FileManagerMenuProv
 static GList               *selected_info_get_list_from_item( FileManagerFileInfo *item );
 static GList               *selected_info_get_list_from_list( GList *selection );
 static FMASelectedInfo     *new_from_file_manager_file_info( FileManagerFileInfo *item );
-static GList               *build_filemanager_menu( FMAMenuPlugin *plugin, guint target, GList *selection );
-static GList               *build_filemanager_menu_rec( GList *tree, guint target, GList *selection, FMATokens *tokens );
+static GList               *build_filemanager_menu( FMAMenuPlugin *plugin, guint target, GList *selection, gboolean *dynamic );
+static GList               *build_filemanager_menu_rec( GList *tree, guint target, GList *selection, FMATokens *tokens, GHashTable *candidates, gboolean *dynamic );
+static gboolean             is_indexed_candidate( GHashTable *candidates, gpointer context );
+static void                 set_view( guint target, GList *selection );
 static void                 attach_submenu_to_item( FileManagerMenuItem *item, GList *subitems );
 static void                 weak_notify_profile( FMAObjectProfile *profile, FileManagerMenuItem *item );
 static void                 execute_action( FileManagerMenuItem *item, FMAObjectProfile *profile );
 static void                 execute_about( FileManagerMenuItem *item, FMAMenuPlugin *plugin );
-static FileManagerMenuItem *create_item_from_profile( FMAObjectProfile *profile, guint target, GList *files, FMATokens *tokens );
-static FileManagerMenuItem *create_item_from_menu( FMAObjectMenu *menu, GList *subitems, guint target );
-static FileManagerMenuItem *create_menu_item( const FMAObjectItem *item, guint target );
-static FMAObjectItem       *expand_tokens_item( const FMAObjectItem *item, FMATokens *tokens );
+static FileManagerMenuItem *create_item_from_profile( FMAObjectProfile *profile, const sExpandedItem *action, guint target, FMATokens *tokens );
+static FileManagerMenuItem *create_item_from_menu( const sExpandedItem *menu, GList *subitems, guint target );
+static FileManagerMenuItem *create_menu_item( const sExpandedItem *item, guint target );
+static sExpandedItem       *expand_tokens_item( const FMAObjectItem *item, FMATokens *tokens );
+static gchar               *expand_tokens_string( FMATokens *tokens, gchar *str, gboolean utf8 );
+static gboolean             expanded_item_is_valid( const sExpandedItem *item );
+static void                 expanded_item_free( sExpandedItem *item );
+static FMAObjectProfile    *expand_tokens_profile( const FMAObjectProfile *profile, FMATokens *tokens );
+static gboolean             profile_needs_expansion( const FMAObjectProfile *profile );
 static void                 expand_tokens_context( FMAIContext *context, FMATokens *tokens );
-static FMAObjectProfile    *get_candidate_profile( FMAObjectAction *action, guint target, GList *files );
+static FMAObjectProfile    *get_candidate_profile( const FMAObjectAction *action, guint target, GList *files, FMATokens *tokens, GHashTable *candidates, gboolean *dynamic );
 static GList               *create_root_menu( FMAMenuPlugin *plugin, GList *filemanager_menu );
 static void                 weak_notify_menu_item( void *user_data /* =NULL */, FileManagerMenuItem *item );
 static GList               *add_about_item( FMAMenuPlugin *plugin, GList *filemanager_menu );
 static void                 on_pivot_items_changed_handler( FMAPivot *pivot, FMAMenuPlugin *plugin );
 static void                 on_settings_key_changed_handler( const gchar *group, const gchar *key, gconstpointer new_value, gboolean mandatory, FMAMenuPlugin *plugin );
 static void                 on_change_event_timeout( FMAMenuPlugin *plugin );
+static gchar               *menu_cache_get_key( FMAMenuPlugin *plugin, guint target, GList *files );
+static gboolean             menu_cache_lookup( FMAMenuPlugin *plugin, const gchar *key, GList **menu );
+static void                 menu_cache_insert( FMAMenuPlugin *plugin, gchar *key, GList *menu );
+static void                 menu_cache_clear( FMAMenuPlugin *plugin );
+static void                 menu_cache_entry_free( sMenuCacheEntry *entry );
+static GList               *menu_item_list_copy( GList *menu );
 
 GType
 fma_menu_plugin_get_type( void )
@@ -176,9 +223,11 @@ instance_init( GTypeInstance *instance, gpointer klass )
 
 	self->private->dispose_has_run = FALSE;
 	self->private->change_timeout.timeout = st_burst_timeout;
+	self->private->change_timeout.max_latency = st_burst_max_latency;
 	self->private->change_timeout.handler = ( FMATimeoutFunc ) on_change_event_timeout;
 	self->private->change_timeout.user_data = self;
 	self->private->change_timeout.source_id = 0;
+	self->private->menu_cache = g_queue_new();
 }
 
 /*
@@ -216,6 +265,8 @@ instance_constructed( GObject *object )
 		/* setup FMAPivot properties before loading items
 		 */
 		fma_pivot_set_loadable( priv->pivot, !PIVOT_LOAD_DISABLED & !PIVOT_LOAD_INVALID );
+		fma_pivot_set_use_snapshot( priv->pivot, TRUE );
+		fma_pivot_set_incremental_reload( priv->pivot, TRUE );
 		fma_pivot_load_items( priv->pivot );
 
 		/* register against FMAPivot to be notified of items changes
@@ -275,6 +326,7 @@ instance_dispose( GObject *object )
 		if( self->private->items_changed_handler ){
 			g_signal_handler_disconnect( self->private->pivot, self->private->items_changed_handler );
 		}
+		menu_cache_clear( self );
 		g_object_unref( self->private->pivot );
 
 		/* chain up to the parent class */
@@ -294,6 +346,7 @@ instance_finalize( GObject *object )
 	g_return_if_fail( FMA_IS_MENU_PLUGIN( object ));
 	self = FMA_MENU_PLUGIN( object );
 
+	g_queue_free( self->private->menu_cache );
 	g_free( self->private );
 
 	/* chain up to the parent class */
@@ -341,13 +394,23 @@ menu_provider_get_background_items(
 {
 	static const gchar *thisfn = "fma_menu_plugin_menu_provider_get_background_items";
 	GList *filemanager_menus_list = NULL;
-	gchar *uri;
-	GList *selected;
+	gchar *uri, *key;
+	gboolean dynamic = FALSE;
+	GList *selected, *files;
 
 	g_return_val_if_fail( FMA_IS_MENU_PLUGIN( provider ), NULL );
 
 	if( !FMA_MENU_PLUGIN( provider )->private->dispose_has_run ){
 
+		files = g_list_prepend( NULL, current_folder );
+		key = menu_cache_get_key( FMA_MENU_PLUGIN( provider ), ITEM_TARGET_LOCATION, files );
+		g_list_free( files );
+
+		if( menu_cache_lookup( FMA_MENU_PLUGIN( provider ), key, &filemanager_menus_list )){
+			g_free( key );
+			return( filemanager_menus_list );
+		}
+
 		selected = selected_info_get_list_from_item( current_folder );
 
 		if( selected ){
@@ -362,10 +425,17 @@ menu_provider_get_background_items(
 			filemanager_menus_list = build_filemanager_menu(
 					FMA_MENU_PLUGIN( provider ),
 					ITEM_TARGET_LOCATION,
-					selected );
+					selected,
+					&dynamic );
 
 			fma_selected_info_free_list( selected );
 		}
+
+		if( dynamic ){
+			g_free( key );
+		} else {
+			menu_cache_insert( FMA_MENU_PLUGIN( provider ), key, filemanager_menus_list );
+		}
 	}
 
 	return( filemanager_menus_list );
@@ -383,6 +453,8 @@ menu_provider_get_file_items( FileManagerMenuProvider *provider, GtkWidget *wind
 	static const gchar *thisfn = "fma_menu_plugin_menu_provider_get_file_items";
 	GList *filemanager_menus_list = NULL;
 	GList *selected;
+	gchar *key;
+	gboolean dynamic = FALSE;
 
 	g_return_val_if_fail( FMA_IS_MENU_PLUGIN( provider ), NULL );
 
@@ -393,6 +465,15 @@ menu_provider_get_file_items( FileManagerMenuProvider *provider, GtkWidget *wind
 			return(( GList * ) NULL );
 		}
 
+		/* the same selection is very often asked for several times
+		 */
+		key = menu_cache_get_key( FMA_MENU_PLUGIN( provider ), ITEM_TARGET_SELECTION, files );
+
+		if( menu_cache_lookup( FMA_MENU_PLUGIN( provider ), key, &filemanager_menus_list )){
+			g_free( key );
+			return( filemanager_menus_list );
+		}
+
 		selected = selected_info_get_list_from_list(( GList * ) files );
 
 		if( selected ){
@@ -416,10 +497,17 @@ menu_provider_get_file_items( FileManagerMenuProvider *provider, GtkWidget *wind
 			filemanager_menus_list = build_filemanager_menu(
 					FMA_MENU_PLUGIN( provider ),
 					ITEM_TARGET_SELECTION,
-					selected );
+					selected,
+					&dynamic );
 
 			fma_selected_info_free_list( selected );
 		}
+
+		if( dynamic ){
+			g_free( key );
+		} else {
+			menu_cache_insert( FMA_MENU_PLUGIN( provider ), key, filemanager_menus_list );
+		}
 	}
 
 	return( filemanager_menus_list );
@@ -440,13 +528,23 @@ menu_provider_get_toolbar_items( FileManagerMenuProvider *provider, GtkWidget *w
 {
 	static const gchar *thisfn = "fma_menu_plugin_menu_provider_get_toolbar_items";
 	GList *filemanager_menus_list = NULL;
-	gchar *uri;
-	GList *selected;
+	gchar *uri, *key;
+	gboolean dynamic = FALSE;
+	GList *selected, *files;
 
 	g_return_val_if_fail( FMA_IS_MENU_PLUGIN( provider ), NULL );
 
 	if( !FMA_MENU_PLUGIN( provider )->private->dispose_has_run ){
 
+		files = g_list_prepend( NULL, current_folder );
+		key = menu_cache_get_key( FMA_MENU_PLUGIN( provider ), ITEM_TARGET_TOOLBAR, files );
+		g_list_free( files );
+
+		if( menu_cache_lookup( FMA_MENU_PLUGIN( provider ), key, &filemanager_menus_list )){
+			g_free( key );
+			return( filemanager_menus_list );
+		}
+
 		selected = selected_info_get_list_from_item( current_folder );
 
 		if( selected ){
@@ -461,10 +559,17 @@ menu_provider_get_toolbar_items( FileManagerMenuProvider *provider, GtkWidget *w
 			filemanager_menus_list = build_filemanager_menu(
 					FMA_MENU_PLUGIN( provider ),
 					ITEM_TARGET_TOOLBAR,
-					selected );
+					selected,
+					&dynamic );
 
 			fma_selected_info_free_list( selected );
 		}
+
+		if( dynamic ){
+			g_free( key );
+		} else {
+			menu_cache_insert( FMA_MENU_PLUGIN( provider ), key, filemanager_menus_list );
+		}
 	}
 
 	return( filemanager_menus_list );
@@ -524,7 +629,8 @@ new_from_file_manager_file_info( FileManagerFileInfo *item )
 {
 	gchar *uri = file_manager_file_info_get_uri( item );
 	gchar *mimetype = file_manager_file_info_get_mime_type( item );
-	FMASelectedInfo *info = fma_selected_info_create_for_uri( uri, mimetype, NULL );
+	FMASelectedInfo *info = fma_selected_info_new_from_file_manager( uri, mimetype,
+			file_manager_file_info_get_file_type( item ), file_manager_file_info_can_write( item ));
 	g_free( mimetype );
 	g_free( uri );
 
@@ -545,24 +651,61 @@ new_from_file_manager_file_info( FileManagerFileInfo *item )
  *
  * Returns: the Nautilus/Nemo menu list
  */
+/*
+ * @dynamic is set to %TRUE if one of the evaluated contexts has a
+ * condition whose result may change while the selection stays the
+ * same, in which case the menu must not be cached
+ */
 static GList *
-build_filemanager_menu( FMAMenuPlugin *plugin, guint target, GList *selection )
+build_filemanager_menu( FMAMenuPlugin *plugin, guint target, GList *selection, gboolean *dynamic )
 {
 	static const gchar *thisfn = "fma_menu_plugin_build_filemanager_menu";
 	GList *filemanager_menu;
 	FMATokens *tokens;
 	GList *tree;
+	GHashTable *candidates;
 	gboolean items_add_about_item;
 	gboolean items_create_root_menu;
 
 	g_return_val_if_fail( FMA_IS_PIVOT( plugin->private->pivot ), NULL );
 
-	tokens = fma_tokens_new_from_selection( selection );
+	tokens = fma_tokens_new_from_selection_used( selection, fma_pivot_get_used_tokens( plugin->private->pivot ));
 
 	tree = fma_pivot_get_items( plugin->private->pivot );
 	g_debug( "%s: tree=%p, count=%d", thisfn, ( void * ) tree, g_list_length( tree ));
 
-	filemanager_menu = build_filemanager_menu_rec( tree, target, selection, tokens );
+	/* the summary of the selection, and the tokens, are shared by the
+	 * condition index and by all the evaluated contexts
+	 */
+	fma_selected_info_begin_query( selection, G_OBJECT( tokens ));
+
+	/* the condition index lets us only fully evaluate the contexts
+	 * which are actually able to match the selection
+	 */
+	candidates = fma_pivot_get_candidates( plugin->private->pivot, target, selection );
+
+	/* the running processes are scanned at most once per menu */
+	fma_process_cache_begin();
+
+	/* the contexts keep the per-file results of their checks while
+	 * the selection is made in the same view
+	 */
+	set_view( target, selection );
+
+	/* only query the file attributes which are actually needed by the
+	 * loaded conditions - and only if some context has a chance to match
+	 */
+	if( !candidates || g_hash_table_size( candidates )){
+		fma_selected_info_query_list( selection,
+				fma_pivot_get_selection_attributes( plugin->private->pivot ), st_probe_deadline );
+	}
+
+	*dynamic = FALSE;
+	filemanager_menu = build_filemanager_menu_rec( tree, target, selection, tokens, candidates, dynamic );
+
+	if( candidates ){
+		g_hash_table_destroy( candidates );
+	}
 
 	/* the FMATokens object has been attached (and reffed) by each found
 	 * candidate profile, so it will be actually finalized only on actual
@@ -587,29 +730,35 @@ build_filemanager_menu( FMAMenuPlugin *plugin, guint target, GList *selection )
 }
 
 static GList *
-build_filemanager_menu_rec( GList *tree, guint target, GList *selection, FMATokens *tokens )
+build_filemanager_menu_rec( GList *tree, guint target, GList *selection, FMATokens *tokens, GHashTable *candidates, gboolean *dynamic )
 {
 	static const gchar *thisfn = "fma_menu_plugin_build_filemanager_menu_rec";
 	GList *filemanager_menu;
 	GList *it;
 	GList *subitems;
-	FMAObjectItem *item;
+	sExpandedItem *item;
 	GList *submenu;
 	FMAObjectProfile *profile;
 	FileManagerMenuItem *menu_item;
-	gchar *label;
+	const gchar *label;
 
 	filemanager_menu = NULL;
 
 	for( it=tree ; it ; it=it->next ){
 
 		g_return_val_if_fail( FMA_IS_OBJECT_ITEM( it->data ), NULL );
-		label = fma_object_get_label( it->data );
+		label = fma_object_peek_label( it->data );
 		g_debug( "%s: examining %s", thisfn, label );
 
+		if( !is_indexed_candidate( candidates, it->data )){
+			g_debug( "%s: is not candidate (index): %s", thisfn, label );
+			continue;
+		}
+
+		*dynamic |= fma_icontext_is_dynamic( FMA_ICONTEXT( it->data ));
+
 		if( !fma_icontext_is_candidate( FMA_ICONTEXT( it->data ), target, selection )){
 			g_debug( "%s: is not candidate (FMAIContext): %s", thisfn, label );
-			g_free( label );
 			continue;
 		}
 
@@ -618,10 +767,9 @@ build_filemanager_menu_rec( GList *tree, guint target, GList *selection, FMAToke
 		/* but we have to re-check for validity as a label may become
 		 * dynamically empty - thus the FMAObjectItem invalid :(
 		 */
-		if( !fma_object_is_valid( item )){
+		if( !expanded_item_is_valid( item )){
 			g_debug( "%s: item %s becomes invalid after tokens expansion", thisfn, label );
-			g_object_unref( item );
-			g_free( label );
+			expanded_item_free( item );
 			continue;
 		}
 
@@ -634,7 +782,7 @@ build_filemanager_menu_rec( GList *tree, guint target, GList *selection, FMAToke
 			subitems = fma_object_get_items( FMA_OBJECT( it->data ));
 			g_debug( "%s: menu has %d items", thisfn, g_list_length( subitems ));
 
-			submenu = build_filemanager_menu_rec( subitems, target, selection, tokens );
+			submenu = build_filemanager_menu_rec( subitems, target, selection, tokens, candidates, dynamic );
 			g_debug( "%s: submenu has %d items", thisfn, g_list_length( submenu ));
 
 			if( submenu ){
@@ -642,135 +790,218 @@ build_filemanager_menu_rec( GList *tree, guint target, GList *selection, FMAToke
 					filemanager_menu = g_list_concat( filemanager_menu, submenu );
 
 				} else {
-					menu_item = create_item_from_menu( FMA_OBJECT_MENU( item ), submenu, target );
+					menu_item = create_item_from_menu( item, submenu, target );
 					filemanager_menu = g_list_append( filemanager_menu, menu_item );
 				}
 			}
-			g_object_unref( item );
-			g_free( label );
+			expanded_item_free( item );
 			continue;
 		}
 
-		g_return_val_if_fail( FMA_IS_OBJECT_ACTION( item ), NULL );
+		g_return_val_if_fail( FMA_IS_OBJECT_ACTION( it->data ), NULL );
 
 		/* if we have an action, searches for a candidate profile
 		 */
-		profile = get_candidate_profile( FMA_OBJECT_ACTION( item ), target, selection );
+		profile = get_candidate_profile( FMA_OBJECT_ACTION( it->data ), target, selection, tokens, candidates, dynamic );
 		if( profile ){
-			menu_item = create_item_from_profile( profile, target, selection, tokens );
+			menu_item = create_item_from_profile( profile, item, target, tokens );
 			filemanager_menu = g_list_append( filemanager_menu, menu_item );
 
 		} else {
 			g_debug( "%s: %s does not have any valid candidate profile", thisfn, label );
 		}
 
-		g_object_unref( item );
-		g_free( label );
+		expanded_item_free( item );
 	}
 
 	return( filemanager_menu );
 }
 
+/*
+ * whether the context has been found candidate by the condition index
+ * a NULL set means that the items have not been pre-filtered
+ */
+static gboolean
+is_indexed_candidate( GHashTable *candidates, gpointer context )
+{
+	return( !candidates || g_hash_table_contains( candidates, context ));
+}
+
+/*
+ * the view is the current folder for the location and the toolbar
+ * targets, and the parent of the (first) selected file else
+ */
+static void
+set_view( guint target, GList *selection )
+{
+	const gchar *uri;
+	GFile *file, *parent;
+	gchar *view;
+
+	uri = selection ? fma_selected_info_peek_uri( FMA_SELECTED_INFO( selection->data )) : NULL;
+	view = NULL;
+
+	if( uri ){
+		if( target == ITEM_TARGET_SELECTION ){
+			file = g_file_new_for_uri( uri );
+			parent = g_file_get_parent( file );
+			view = parent ? g_file_get_uri( parent ) : g_strdup( uri );
+			if( parent ){
+				g_object_unref( parent );
+			}
+			g_object_unref( file );
+
+		} else {
+			view = g_strdup( uri );
+		}
+	}
+
+	fma_icontext_set_view( view );
+	g_free( view );
+}
+
 /*
  * expand_tokens_item:
  * @item: a FMAObjectItem read from the FMAPivot.
  * @tokens: the FMATokens object which holds current selection data
  *  (uris, basenames, mimetypes, etc.)
  *
- * Updates the @item, replacing parameters with the corresponding token.
+ * Expands the display strings of the @item, replacing parameters with
+ * the corresponding token.
  *
- * This function is not recursive, but works for the plain item:
- * - the menu (itself)
- * - the action and its profiles
+ * The @item itself is not duplicated, nor modified: profiles are only
+ * expanded when checked, by get_candidate_profile().
  *
- * Returns: a duplicated object which has to be g_object_unref() by the caller.
+ * Returns: a newly allocated sExpandedItem structure which has to be
+ * expanded_item_free() by the caller.
  */
-static FMAObjectItem *
+static sExpandedItem *
 expand_tokens_item( const FMAObjectItem *src, FMATokens *tokens )
 {
-	gchar *old, *new;
-	GSList *subitems_slist, *its, *new_slist;
-	GList *subitems, *it;
-	FMAObjectItem *item;
+	sExpandedItem *item;
 
-	item = FMA_OBJECT_ITEM( fma_object_duplicate( src, FMA_DUPLICATE_OBJECT ));
+	item = g_new0( sExpandedItem, 1 );
+	item->source = src;
 
 	/* label, tooltip and icon name
 	 * plus the toolbar label if this is an action
 	 */
-	old = fma_object_get_label( item );
-	new = fma_tokens_parse_for_display( tokens, old, TRUE );
-	fma_object_set_label( item, new );
-	g_free( old );
-	g_free( new );
+	item->label = expand_tokens_string( tokens, fma_object_get_label( src ), TRUE );
+	item->tooltip = expand_tokens_string( tokens, fma_object_get_tooltip( src ), TRUE );
+	item->icon = expand_tokens_string( tokens, fma_object_get_icon( src ), TRUE );
 
-	old = fma_object_get_tooltip( item );
-	new = fma_tokens_parse_for_display( tokens, old, TRUE );
-	fma_object_set_tooltip( item, new );
-	g_free( old );
-	g_free( new );
+	if( FMA_IS_OBJECT_ACTION( src )){
+		item->toolbar_label = expand_tokens_string( tokens, fma_object_get_toolbar_label( src ), TRUE );
+	}
 
-	old = fma_object_get_icon( item );
-	new = fma_tokens_parse_for_display( tokens, old, TRUE );
-	fma_object_set_icon( item, new );
-	g_free( old );
-	g_free( new );
+	return( item );
+}
 
-	if( FMA_IS_OBJECT_ACTION( item )){
-		old = fma_object_get_toolbar_label( item );
-		new = fma_tokens_parse_for_display( tokens, old, TRUE );
-		fma_object_set_toolbar_label( item, new );
-		g_free( old );
-		g_free( new );
+/*
+ * takes the ownership of @str, and returns it as is if it does not
+ * embed any parameter
+ */
+static gchar *
+expand_tokens_string( FMATokens *tokens, gchar *str, gboolean utf8 )
+{
+	gchar *expanded;
+
+	if( !str || !strchr( str, '%' )){
+		return( str );
 	}
 
-	/* A FMAObjectItem, whether it is an action or a menu, is also a FMAIContext
-	 */
-	expand_tokens_context( FMA_ICONTEXT( item ), tokens );
+	expanded = fma_tokens_parse_for_display( tokens, str, utf8 );
+	g_free( str );
 
-	/* subitems lists, whether this is the profiles list of an action
-	 * or the items list of a menu, may be dynamic and embed a command;
-	 * this command itself may embed parameters
-	 */
-	subitems_slist = fma_object_get_items_slist( item );
-	new_slist = NULL;
-	for( its = subitems_slist ; its ; its = its->next ){
-		old = ( gchar * ) its->data;
-		if( old[0] == '[' && old[strlen(old)-1] == ']' ){
-			new = fma_tokens_parse_for_display( tokens, old, FALSE );
-		} else {
-			new = g_strdup( old );
+	return( expanded );
+}
+
+/*
+ * the source item is valid, and only its labels may become dynamically
+ * empty - see FMAObjectAction::is_valid()
+ */
+static gboolean
+expanded_item_is_valid( const sExpandedItem *item )
+{
+	gboolean is_valid;
+
+	is_valid = fma_object_is_valid( item->source );
+
+	if( is_valid && FMA_IS_OBJECT_ACTION( item->source )){
+		if( fma_object_is_target_toolbar( item->source )){
+			is_valid &= ( item->toolbar_label && g_utf8_strlen( item->toolbar_label, -1 ) > 0 );
+		}
+		if( fma_object_is_target_selection( item->source ) || fma_object_is_target_location( item->source )){
+			is_valid &= ( item->label && g_utf8_strlen( item->label, -1 ) > 0 );
 		}
-		new_slist = g_slist_prepend( new_slist, new );
 	}
-	fma_object_set_items_slist( item, new_slist );
-	fma_core_utils_slist_free( subitems_slist );
-	fma_core_utils_slist_free( new_slist );
 
-	/* last, deal with profiles of an action
+	return( is_valid );
+}
+
+static void
+expanded_item_free( sExpandedItem *item )
+{
+	g_free( item->label );
+	g_free( item->tooltip );
+	g_free( item->icon );
+	g_free( item->toolbar_label );
+	g_free( item );
+}
+
+/*
+ * Returns: a duplicate of the @profile, without any parent, and whose
+ * working directory and conditions have been expanded.
+ */
+static FMAObjectProfile *
+expand_tokens_profile( const FMAObjectProfile *profile, FMATokens *tokens )
+{
+	FMAObjectProfile *duplicate;
+	gchar *old, *new;
+
+	duplicate = FMA_OBJECT_PROFILE( fma_object_duplicate( profile, FMA_DUPLICATE_ONLY ));
+	fma_object_set_parent( duplicate, NULL );
+
+	/* desktop Exec key = GConf path+parameters
+	 * do not touch them here
 	 */
-	if( FMA_IS_OBJECT_ACTION( item )){
+	old = fma_object_get_working_dir( duplicate );
+	new = fma_tokens_parse_for_display( tokens, old, FALSE );
+	fma_object_set_working_dir( duplicate, new );
+	g_free( old );
+	g_free( new );
 
-		subitems = fma_object_get_items( item );
+	/* a FMAObjectProfile is also a FMAIContext
+	 */
+	expand_tokens_context( FMA_ICONTEXT( duplicate ), tokens );
 
-		for( it = subitems ; it ; it = it->next ){
+	return( duplicate );
+}
 
-			/* desktop Exec key = GConf path+parameters
-			 * do not touch them here
-			 */
-			old = fma_object_get_working_dir( it->data );
-			new = fma_tokens_parse_for_display( tokens, old, FALSE );
-			fma_object_set_working_dir( it->data, new );
-			g_free( old );
-			g_free( new );
+/*
+ * whether one of the expandable strings of the @profile embeds a
+ * parameter
+ */
+static gboolean
+profile_needs_expansion( const FMAObjectProfile *profile )
+{
+	const gchar *strings[5];
+	gboolean needs;
+	guint i;
 
-			/* a FMAObjectProfile is also a FMAIContext
-			 */
-			expand_tokens_context( FMA_ICONTEXT( it->data ), tokens );
-		}
+	strings[0] = fma_object_peek_working_dir( profile );
+	strings[1] = fma_object_peek_try_exec( profile );
+	strings[2] = fma_object_peek_show_if_registered( profile );
+	strings[3] = fma_object_peek_show_if_true( profile );
+	strings[4] = fma_object_peek_show_if_running( profile );
+
+	needs = FALSE;
+
+	for( i = 0 ; i < G_N_ELEMENTS( strings ) && !needs ; ++i ){
+		needs = ( strings[i] && strchr( strings[i], '%' ) != NULL );
 	}
 
-	return( item );
+	return( needs );
 }
 
 static void
@@ -805,57 +1036,71 @@ expand_tokens_context( FMAIContext *context, FMATokens *tokens )
 
 /*
  * could also be a FMAObjectAction method - but this is not used elsewhere
+ *
+ * the profiles are read from the @action of the pivot; only those which
+ * embed parameters in their conditions have to be duplicated in order
+ * to be expanded before being checked
+ *
+ * Returns: a new reference on the candidate profile, or NULL. This is
+ * either a parentless duplicate whose working directory and conditions
+ * are expanded, or the profile of the pivot itself. In this later case,
+ * the reference keeps the profile alive after a reload of the pivot; the
+ * execution of the action does not need its parent.
  */
 static FMAObjectProfile *
-get_candidate_profile( FMAObjectAction *action, guint target, GList *files )
+get_candidate_profile( const FMAObjectAction *action, guint target, GList *files, FMATokens *tokens, GHashTable *candidates, gboolean *dynamic )
 {
 	static const gchar *thisfn = "fma_menu_plugin_get_candidate_profile";
 	FMAObjectProfile *candidate = NULL;
-	gchar *action_label;
-	gchar *profile_label;
-	GList *profiles, *ip;
+	FMAObjectProfile *profile;
+	GList *ip;
 
-	action_label = fma_object_get_label( action );
-	profiles = fma_object_get_items( action );
+	for( ip = fma_object_get_items( action ) ; ip && !candidate ; ip = ip->next ){
 
-	for( ip = profiles ; ip && !candidate ; ip = ip->next ){
-		FMAObjectProfile *profile = FMA_OBJECT_PROFILE( ip->data );
+		if( !is_indexed_candidate( candidates, ip->data )){
+			continue;
+		}
+
+		*dynamic |= fma_icontext_is_dynamic( FMA_ICONTEXT( ip->data ));
+
+		if( profile_needs_expansion( FMA_OBJECT_PROFILE( ip->data ))){
+			profile = expand_tokens_profile( FMA_OBJECT_PROFILE( ip->data ), tokens );
+		} else {
+			profile = FMA_OBJECT_PROFILE( g_object_ref( ip->data ));
+		}
 
 		if( fma_icontext_is_candidate( FMA_ICONTEXT( profile ), target, files )){
-			profile_label = fma_object_get_label( profile );
-			g_debug( "%s: selecting %s (profile=%p '%s')", thisfn, action_label, ( void * ) profile, profile_label );
-			g_free( profile_label );
+			g_debug( "%s: selecting %s (profile=%p '%s')",
+					thisfn, fma_object_peek_label( action ), ( void * ) profile, fma_object_peek_label( profile ));
 
-			candidate = profile;
+			candidate = g_object_ref( profile );
 		}
-	}
 
-	g_free( action_label );
+		g_object_unref( profile );
+	}
 
 	return( candidate );
 }
 
+/*
+ * takes the ownership of the @profile, which is released on menu item
+ * finalization
+ */
 static FileManagerMenuItem *
-create_item_from_profile( FMAObjectProfile *profile, guint target, GList *files, FMATokens *tokens )
+create_item_from_profile( FMAObjectProfile *profile, const sExpandedItem *action, guint target, FMATokens *tokens )
 {
 	FileManagerMenuItem *item;
-	FMAObjectAction *action;
-	FMAObjectProfile *duplicate;
 
-	action = FMA_OBJECT_ACTION( fma_object_get_parent( profile ));
-	duplicate = FMA_OBJECT_PROFILE( fma_object_duplicate( profile, FMA_DUPLICATE_ONLY ));
-	fma_object_set_parent( duplicate, NULL );
-
-	item = create_menu_item( FMA_OBJECT_ITEM( action ), target );
+	item = create_menu_item( action, target );
 
 	g_signal_connect( item,
 				"activate",
 				G_CALLBACK( execute_action ),
-				duplicate );
+				profile );
 
-	/* unref the duplicated profile on menu item finalization
+	/* unref the candidate profile on menu item finalization
 	 */
-	g_object_weak_ref( G_OBJECT( item ), ( GWeakNotify ) weak_notify_profile, duplicate );
+	g_object_weak_ref( G_OBJECT( item ), ( GWeakNotify ) weak_notify_profile, profile );
 
 	g_object_set_data_full( G_OBJECT( item ),
 			"filemanager-actions-tokens",
@@ -883,12 +1128,12 @@ weak_notify_profile( FMAObjectProfile *profile, FileManagerMenuItem *item )
  * the submenu
  */
 static FileManagerMenuItem *
-create_item_from_menu( FMAObjectMenu *menu, GList *subitems, guint target )
+create_item_from_menu( const sExpandedItem *menu, GList *subitems, guint target )
 {
 	/*static const gchar *thisfn = "fma_menu_plugin_create_item_from_menu";*/
 	FileManagerMenuItem *item;
 
-	item = create_menu_item( FMA_OBJECT_ITEM( menu ), target );
+	item = create_menu_item( menu, target );
 
 	attach_submenu_to_item( item, subitems );
 
@@ -905,26 +1150,18 @@ create_item_from_menu( FMAObjectMenu *menu, GList *subitems, guint target )
  * to check for instanciation/finalization cycles
  */
 static FileManagerMenuItem *
-create_menu_item( const FMAObjectItem *item, guint target )
+create_menu_item( const sExpandedItem *item, guint target )
 {
 	FileManagerMenuItem *menu_item;
-	gchar *id, *name, *label, *tooltip, *icon;
+	gchar *name;
 
-	id = fma_object_get_id( item );
-	name = g_strdup_printf( "%s-%s-%s-%d", PACKAGE, G_OBJECT_TYPE_NAME( item ), id, target );
-	label = fma_object_get_label( item );
-	tooltip = fma_object_get_tooltip( item );
-	icon = fma_object_get_icon( item );
+	name = g_strdup_printf( "%s-%s-%s-%d", PACKAGE, G_OBJECT_TYPE_NAME( item->source ), fma_object_peek_id( item->source ), target );
 
-	menu_item = file_manager_menu_item_new( name, label, tooltip, icon );
+	menu_item = file_manager_menu_item_new( name, item->label, item->tooltip, item->icon );
 
 	g_object_weak_ref( G_OBJECT( menu_item ), ( GWeakNotify ) weak_notify_menu_item, NULL );
 
-	g_free( icon );
- 	g_free( tooltip );
- 	g_free( label );
  	g_free( name );
- 	g_free( id );
 
 	return( menu_item );
 }
@@ -1086,6 +1323,10 @@ on_pivot_items_changed_handler( FMAPivot *pivot, FMAMenuPlugin *plugin )
 
 	if( !plugin->private->dispose_has_run ){
 
+		if( fma_pivot_is_reload_needed( pivot )){
+			plugin->private->reload_needed = TRUE;
+		}
+		menu_cache_clear( plugin );
 		fma_timeout_event( &plugin->private->change_timeout );
 	}
 }
@@ -1101,23 +1342,140 @@ on_settings_key_changed_handler( const gchar *group, const gchar *key, gconstpoi
 
 	if( !plugin->private->dispose_has_run ){
 
+		plugin->private->reload_needed = TRUE;
+		menu_cache_clear( plugin );
 		fma_timeout_event( &plugin->private->change_timeout );
 	}
 }
 
 /*
- * automatically reloads the items, then signal the file manager.
+ * automatically reloads the items if FMAPivot has not been able to
+ * incrementally update them, then signal the file manager.
  */
 static void
 on_change_event_timeout( FMAMenuPlugin *plugin )
 {
 	static const gchar *thisfn = "fma_menu_plugin_on_change_event_timeout";
-	g_debug( "%s: timeout expired", thisfn );
+	g_debug( "%s: timeout expired, reload_needed=%s",
+			thisfn, plugin->private->reload_needed ? "True":"False" );
 
-	fma_pivot_load_items( plugin->private->pivot );
+	if( plugin->private->reload_needed ){
+		fma_pivot_load_items( plugin->private->pivot );
+		plugin->private->reload_needed = FALSE;
+	}
+	menu_cache_clear( plugin );
 
 #if defined( HAVE_NAUTILUS_MENU_PROVIDER_EMIT_ITEMS_UPDATED_SIGNAL ) || \
 	defined( HAVE_NEMO_MENU_PROVIDER_EMIT_ITEMS_UPDATED_SIGNAL )
 	file_manager_menu_provider_emit_items_updated_signal( FILE_MANAGER_MENU_PROVIDER( plugin ));
 #endif
 }
+
+/*
+ * the key of the menu cache is a digest of all what the built menu
+ * depends on: the target, the current tree of items and the selection
+ */
+static gchar *
+menu_cache_get_key( FMAMenuPlugin *plugin, guint target, GList *files )
+{
+	GChecksum *checksum;
+	GList *it;
+	gchar *str, *uri, *mimetype;
+	gchar *key;
+
+	checksum = g_checksum_new( G_CHECKSUM_SHA1 );
+
+	str = g_strdup_printf( "%u:%u\n", target, fma_pivot_get_generation( plugin->private->pivot ));
+	g_checksum_update( checksum, ( const guchar * ) str, -1 );
+	g_free( str );
+
+	for( it = files ; it ; it = it->next ){
+		uri = file_manager_file_info_get_uri( FILE_MANAGER_FILE_INFO( it->data ));
+		mimetype = file_manager_file_info_get_mime_type( FILE_MANAGER_FILE_INFO( it->data ));
+		str = g_strdup_printf( "%s\t%s\n", uri, mimetype ? mimetype : "" );
+		g_checksum_update( checksum, ( const guchar * ) str, -1 );
+		g_free( str );
+		g_free( mimetype );
+		g_free( uri );
+	}
+
+	key = g_strdup( g_checksum_get_string( checksum ));
+	g_checksum_free( checksum );
+
+	return( key );
+}
+
+/*
+ * on cache hit, the found entry is moved to the head of the queue, and
+ * a new list of reffed menu items is returned in @menu
+ */
+static gboolean
+menu_cache_lookup( FMAMenuPlugin *plugin, const gchar *key, GList **menu )
+{
+	static const gchar *thisfn = "fma_menu_plugin_menu_cache_lookup";
+	GList *it;
+	sMenuCacheEntry *entry;
+
+	for( it = plugin->private->menu_cache->head ; it ; it = it->next ){
+		entry = ( sMenuCacheEntry * ) it->data;
+
+		if( !strcmp( entry->key, key )){
+			g_queue_unlink( plugin->private->menu_cache, it );
+			g_queue_push_head_link( plugin->private->menu_cache, it );
+			*menu = menu_item_list_copy( entry->menu );
+			g_debug( "%s: key=%s, found count=%u", thisfn, key, g_list_length( *menu ));
+			return( TRUE );
+		}
+	}
+
+	return( FALSE );
+}
+
+/*
+ * takes the ownership of the @key, while the @menu is left to the caller
+ * the least recently used entry is evicted when the cache is full
+ */
+static void
+menu_cache_insert( FMAMenuPlugin *plugin, gchar *key, GList *menu )
+{
+	sMenuCacheEntry *entry;
+
+	entry = g_new0( sMenuCacheEntry, 1 );
+	entry->key = key;
+	entry->menu = menu_item_list_copy( menu );
+
+	g_queue_push_head( plugin->private->menu_cache, entry );
+
+	while( g_queue_get_length( plugin->private->menu_cache ) > MENU_CACHE_MAX_ENTRIES ){
+		menu_cache_entry_free(( sMenuCacheEntry * ) g_queue_pop_tail( plugin->private->menu_cache ));
+	}
+}
+
+static void
+menu_cache_clear( FMAMenuPlugin *plugin )
+{
+	sMenuCacheEntry *entry;
+
+	while(( entry = ( sMenuCacheEntry * ) g_queue_pop_head( plugin->private->menu_cache )) != NULL ){
+		menu_cache_entry_free( entry );
+	}
+}
+
+static void
+menu_cache_entry_free( sMenuCacheEntry *entry )
+{
+	file_manager_menu_item_list_free( entry->menu );
+	g_free( entry->key );
+	g_free( entry );
+}
+
+static GList *
+menu_item_list_copy( GList *menu )
+{
+	GList *copy;
+
+	copy = g_list_copy( menu );
+	g_list_foreach( copy, ( GFunc ) g_object_ref, NULL );
+
+	return( copy );
+}
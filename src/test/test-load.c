@@ -0,0 +1,370 @@
+/*
+ * FileManager-Actions
+ * A file-manager extension which offers configurable context menu actions.
+ *
+ * Copyright (C) 2005 The GNOME Foundation
+ * Copyright (C) 2006-2008 Frederic Ruaudel and others (see AUTHORS)
+ * Copyright (C) 2009-2015 Pierre Wieser and others (see AUTHORS)
+ *
+ * FileManager-Actions is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * FileManager-Actions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FileManager-Actions; see the file COPYING. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Authors:
+ *   Frederic Ruaudel <grumz@grumz.net>
+ *   Rodrigo Moya <rodrigo@gnome-db.org>
+ *   Pierre Wieser <pwieser@trychlos.org>
+ *   ... and many others (see AUTHORS)
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <glib/gprintf.h>
+#include <glib/gstdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <api/fma-object-api.h>
+
+#include <core/fma-pivot.h>
+
+/* Checks the hierarchy loaded by FMAPivot from the Desktop I/O
+ * provider, which must be installed.
+ *
+ * The actions are written in a temporary XDG_DATA_HOME, and grouped by
+ * MENU_SIZE in menus which are listed as level zero in a temporary
+ * configuration. Half of the actions are also present in a temporary
+ * XDG_DATA_DIRS, with an id which only differs by its case, and must
+ * so be shadowed by the user ones. A last action is only present in
+ * the system dir, and must be loaded at level zero.
+ *
+ * The loaded tree is dumped as a string, and compared to the expected
+ * one.
+ *
+ * The same tree is then populated with BENCH_COUNT and twice as many
+ * actions, grouped by BENCH_MENU_SIZE, to measure the load time: the
+ * time per item should stay roughly the same, and so the ratio of the
+ * two load times be close to 2.
+ */
+
+#define MENU_SIZE		4
+#define ACTIONS_COUNT	10
+#define SYSTEM_ACTION	"system-only"
+
+#define BENCH_COUNT		20000
+#define BENCH_MENU_SIZE	100
+#define LOAD_RUNS		3
+
+static gchar *st_home_dir   = NULL;
+static gchar *st_system_dir = NULL;
+static gchar *st_config_dir = NULL;
+
+static void
+clear_dir( const gchar *dir )
+{
+	GDir *dir_handle;
+	const gchar *name;
+	gchar *path;
+
+	dir_handle = g_dir_open( dir, 0, NULL );
+	if( dir_handle ){
+		while(( name = g_dir_read_name( dir_handle ))){
+			path = g_build_filename( dir, name, NULL );
+			g_unlink( path );
+			g_free( path );
+		}
+		g_dir_close( dir_handle );
+	}
+}
+
+static void
+write_file( const gchar *dir, const gchar *name, const gchar *content )
+{
+	gchar *path;
+	GError *error;
+
+	error = NULL;
+	path = g_build_filename( dir, name, NULL );
+
+	if( !g_file_set_contents( path, content, -1, &error )){
+		g_printerr( "%s: %s\n", path, error->message );
+		g_error_free( error );
+		exit( EXIT_FAILURE );
+	}
+
+	g_free( path );
+}
+
+static void
+write_action( const gchar *dir, const gchar *id, const gchar *label )
+{
+	gchar *name, *content;
+
+	name = g_strdup_printf( "%s.desktop", id );
+	content = g_strdup_printf(
+			"[Desktop Entry]\n"
+			"Type=Action\n"
+			"Name=%s\n"
+			"Profiles=main;\n"
+			"\n"
+			"[X-Action-Profile main]\n"
+			"Name=Main profile\n"
+			"Exec=echo %%f\n", label );
+
+	write_file( dir, name, content );
+
+	g_free( content );
+	g_free( name );
+}
+
+/*
+ * writes the items, and returns the expected dump of the loaded tree
+ */
+static gchar *
+populate( guint count, guint menu_size )
+{
+	GString *items_list, *level_zero, *expected;
+	gchar *id, *label, *name, *content;
+	guint i, menu;
+
+	clear_dir( st_home_dir );
+	clear_dir( st_system_dir );
+	clear_dir( st_config_dir );
+
+	level_zero = g_string_new( "[runtime]\nitems-level-zero-order=" );
+	expected = g_string_new( "" );
+
+	for( menu = 0 ; menu * menu_size < count ; ++menu ){
+		items_list = g_string_new( "" );
+		g_string_append_printf( expected, "menu-%04u:Menu %04u(", menu, menu );
+
+		for( i = menu * menu_size ; i < count && i < ( menu+1 ) * menu_size ; ++i ){
+			id = g_strdup_printf( "action-%06u", i );
+			label = g_strdup_printf( "Action %06u", i );
+			write_action( st_home_dir, id, label );
+			g_string_append_printf( items_list, "%s;", id );
+			g_string_append_printf( expected, "%s:%s(main);", id, label );
+			g_free( label );
+			g_free( id );
+
+			if( i % 2 == 0 ){
+				id = g_strdup_printf( "ACTION-%06u", i );
+				write_action( st_system_dir, id, "Shadowed action" );
+				g_free( id );
+			}
+		}
+
+		name = g_strdup_printf( "menu-%04u.desktop", menu );
+		content = g_strdup_printf(
+				"[Desktop Entry]\n"
+				"Type=Menu\n"
+				"Name=Menu %04u\n"
+				"ItemsList=%s\n", menu, items_list->str );
+		write_file( st_home_dir, name, content );
+		g_free( content );
+		g_free( name );
+		g_string_free( items_list, TRUE );
+
+		g_string_append_printf( level_zero, "menu-%04u;", menu );
+		g_string_append( expected, ");" );
+	}
+
+	write_action( st_system_dir, SYSTEM_ACTION, "System action" );
+	g_string_append_printf( level_zero, "%s;", SYSTEM_ACTION );
+	g_string_append_printf( expected, "%s:System action(main);", SYSTEM_ACTION );
+
+	g_string_append( level_zero, "\n" );
+	name = g_strdup_printf( "%s.conf", PACKAGE );
+	write_file( st_config_dir, name, level_zero->str );
+	g_free( name );
+	g_string_free( level_zero, TRUE );
+
+	return( g_string_free( expected, FALSE ));
+}
+
+/*
+ * dumps the tree as 'id:label(children);', the children of an action
+ * being its profiles
+ */
+static void
+dump_tree( GString *dump, GList *tree )
+{
+	GList *it;
+
+	for( it = tree ; it ; it = it->next ){
+		if( FMA_IS_OBJECT_PROFILE( it->data )){
+			g_string_append_printf( dump, "%s;", fma_object_peek_id( it->data ));
+
+		} else {
+			g_string_append_printf( dump, "%s:%s(",
+					fma_object_peek_id( it->data ), fma_object_peek_label( it->data ));
+			dump_tree( dump, fma_object_get_items( it->data ));
+			g_string_append( dump, ");" );
+		}
+	}
+}
+
+/*
+ * loads the tree, returning its dump and the elapsed time
+ */
+static gchar *
+load_tree( gint64 *elapsed )
+{
+	FMAPivot *pivot;
+	GString *dump;
+	gint64 start;
+
+	pivot = fma_pivot_new();
+	fma_pivot_set_loadable( pivot, PIVOT_LOAD_ALL );
+
+	start = g_get_monotonic_time();
+	fma_pivot_load_items( pivot );
+	*elapsed = g_get_monotonic_time() - start;
+
+	dump = g_string_new( "" );
+	dump_tree( dump, fma_pivot_get_items( pivot ));
+	g_object_unref( pivot );
+
+	return( g_string_free( dump, FALSE ));
+}
+
+static gboolean
+check_load( void )
+{
+	gchar *expected, *dump;
+	gint64 elapsed;
+	gboolean ok;
+
+	expected = populate( ACTIONS_COUNT, MENU_SIZE );
+	dump = load_tree( &elapsed );
+	ok = ( strcmp( dump, expected ) == 0 );
+
+	if( ok ){
+		g_printf( "PASS: %s\n", dump );
+	} else {
+		g_printf( "FAIL: %s\n      expected %s\n", dump, expected );
+	}
+
+	g_free( dump );
+	g_free( expected );
+
+	return( ok );
+}
+
+/*
+ * returns the best load time of @count actions, or -1 if the loaded
+ * tree is not the expected one
+ */
+static gint64
+run_load( guint count )
+{
+	gchar *expected, *dump;
+	gint64 elapsed, best;
+	guint items, run;
+	gboolean ok;
+
+	expected = populate( count, BENCH_MENU_SIZE );
+	items = count + ( count + BENCH_MENU_SIZE - 1 ) / BENCH_MENU_SIZE + 1;
+	best = G_MAXINT64;
+	ok = TRUE;
+
+	for( run = 0 ; run < LOAD_RUNS ; ++run ){
+		dump = load_tree( &elapsed );
+		best = MIN( best, elapsed );
+		ok &= ( strcmp( dump, expected ) == 0 );
+		g_free( dump );
+	}
+
+	g_printf( "%s: count=%6u: %10.3f ms, %7.3f us per item\n",
+			ok ? "PASS" : "FAIL", count, best / 1000.0, ( gdouble ) best / items );
+
+	g_free( expected );
+
+	return( ok ? best : -1 );
+}
+
+/* debug output would hide the results
+ */
+static void
+log_handler( const gchar *log_domain, GLogLevelFlags log_level, const gchar *message, gpointer user_data )
+{
+}
+
+int
+main( int argc, char** argv )
+{
+	gchar *root, *dir;
+	gint64 single, twice;
+	gboolean ok;
+
+#if !GLIB_CHECK_VERSION( 2,36, 0 )
+	g_type_init();
+#endif
+
+	g_log_set_handler( G_LOG_DOMAIN, G_LOG_LEVEL_DEBUG, log_handler, NULL );
+
+	/* the environment must be set before GLib caches the XDG dirs
+	 */
+	root = g_dir_make_tmp( "fma-test-load-XXXXXX", NULL );
+	if( !root ){
+		g_printerr( "unable to create a temporary directory\n" );
+		return( EXIT_FAILURE );
+	}
+
+	dir = g_build_filename( root, "home", NULL );
+	g_setenv( "XDG_DATA_HOME", dir, TRUE );
+	st_home_dir = g_build_filename( dir, "file-manager", "actions", NULL );
+	g_free( dir );
+
+	dir = g_build_filename( root, "system", NULL );
+	g_setenv( "XDG_DATA_DIRS", dir, TRUE );
+	st_system_dir = g_build_filename( dir, "file-manager", "actions", NULL );
+	g_free( dir );
+
+	dir = g_build_filename( root, "config", NULL );
+	g_setenv( "XDG_CONFIG_HOME", dir, TRUE );
+	st_config_dir = g_build_filename( dir, PACKAGE, NULL );
+	g_free( dir );
+
+	g_mkdir_with_parents( st_home_dir, 0700 );
+	g_mkdir_with_parents( st_system_dir, 0700 );
+	g_mkdir_with_parents( st_config_dir, 0700 );
+
+	g_printf( "FMAPivot load test.\n\n" );
+
+	ok = check_load();
+
+	g_printf( "\nFMAPivot load time (best of %u runs).\n\n", LOAD_RUNS );
+
+	single = run_load( BENCH_COUNT );
+	twice = run_load( 2*BENCH_COUNT );
+	ok &= ( single > 0 && twice > 0 );
+
+	if( single > 0 && twice > 0 ){
+		g_printf( "ratio=%.2f (2.00 for a linear scaling)\n", ( gdouble ) twice / single );
+	}
+
+	clear_dir( st_home_dir );
+	clear_dir( st_system_dir );
+	clear_dir( st_config_dir );
+	g_printf( "\nEmpty temporary directories have been left in %s.\n", root );
+
+	g_free( st_home_dir );
+	g_free( st_system_dir );
+	g_free( st_config_dir );
+	g_free( root );
+
+	return( ok ? EXIT_SUCCESS : EXIT_FAILURE );
+}
@@ -0,0 +1,324 @@
+/*
+ * FileManager-Actions
+ * A file-manager extension which offers configurable context menu actions.
+ *
+ * Copyright (C) 2005 The GNOME Foundation
+ * Copyright (C) 2006-2008 Frederic Ruaudel and others (see AUTHORS)
+ * Copyright (C) 2009-2015 Pierre Wieser and others (see AUTHORS)
+ *
+ * FileManager-Actions is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * FileManager-Actions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FileManager-Actions; see the file COPYING. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Authors:
+ *   Frederic Ruaudel <grumz@grumz.net>
+ *   Rodrigo Moya <rodrigo@gnome-db.org>
+ *   Pierre Wieser <pwieser@trychlos.org>
+ *   ... and many others (see AUTHORS)
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <glib/gprintf.h>
+#include <glib/gstdio.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <glibtop/proclist.h>
+#include <glibtop/procstate.h>
+
+#include <core/fma-process-cache.h>
+
+/* Checks that a spawned process is reported as running, and is no more
+ * once it has been killed.
+ *
+ * The process is a 'sleep' run through a symbolic link, so that its
+ * name is unique to this test. Process names are truncated to fifteen
+ * characters by the kernel.
+ *
+ * Then measures the cost of evaluating CONDITIONS ShowIfRunning
+ * conditions, as when building a menu, with regards to the count of
+ * running processes. The process table is inflated by spawning idle
+ * 'sleep' processes. The searched processes do not exist, which is the
+ * worst case as the whole table has to be scanned.
+ *
+ * With a full scan per condition, the cost grows as the count of
+ * processes times the count of conditions; with the shared set, the
+ * table is only scanned once per menu.
+ */
+
+#define PROCESS_NAME	"fma-test-sleep"
+
+#define CONDITIONS		20
+#define RUNS			3
+
+/* the spawned child may not have been exec'ed yet at first lookup
+ */
+#define WAIT_TRIES		50
+#define WAIT_DELAY		20000
+
+static const guint counts[] = { 0, 500, 1000, 2000, 4000, G_MAXUINT };
+
+static guint   st_errors   = 0;
+static GArray *st_children = NULL;
+
+static void
+check( gboolean ok, const gchar *label )
+{
+	if( ok ){
+		g_printf( "PASS: %s\n", label );
+	} else {
+		g_printf( "FAIL: %s\n", label );
+		st_errors += 1;
+	}
+}
+
+static gboolean
+wait_running( gboolean expected )
+{
+	gboolean running;
+	guint i;
+
+	running = !expected;
+
+	for( i = 0 ; i < WAIT_TRIES && running != expected ; ++i ){
+		if( i ){
+			g_usleep( WAIT_DELAY );
+		}
+		fma_process_cache_begin();
+		running = fma_process_cache_is_running( PROCESS_NAME );
+	}
+
+	return( running );
+}
+
+/* this is how each ShowIfRunning condition used to be evaluated
+ */
+static gboolean
+scan_is_running( const gchar *name )
+{
+	glibtop_proclist proclist;
+	glibtop_proc_state procstate;
+	pid_t *pid_list;
+	guint i;
+	gboolean found;
+
+	found = FALSE;
+	pid_list = glibtop_get_proclist( &proclist, GLIBTOP_KERN_PROC_ALL, 0 );
+
+	for( i = 0 ; i < proclist.number && !found ; ++i ){
+		glibtop_get_proc_state( &procstate, pid_list[i] );
+		found = ( strcmp( procstate.cmd, name ) == 0 );
+	}
+
+	g_free( pid_list );
+
+	return( found );
+}
+
+static guint
+count_processes( void )
+{
+	glibtop_proclist proclist;
+
+	g_free( glibtop_get_proclist( &proclist, GLIBTOP_KERN_PROC_ALL, 0 ));
+
+	return(( guint ) proclist.number );
+}
+
+static gboolean
+spawn_children( guint count )
+{
+	gchar *argv[] = { "sleep", "600", NULL };
+	GPid pid;
+	GError *error;
+
+	while( st_children->len < count ){
+		error = NULL;
+		if( !g_spawn_async( NULL, argv, NULL,
+				G_SPAWN_SEARCH_PATH | G_SPAWN_DO_NOT_REAP_CHILD | G_SPAWN_STDOUT_TO_DEV_NULL,
+				NULL, NULL, &pid, &error )){
+			g_printerr( "unable to spawn more than %u processes: %s\n", st_children->len, error->message );
+			g_error_free( error );
+			return( FALSE );
+		}
+		g_array_append_val( st_children, pid );
+	}
+
+	return( TRUE );
+}
+
+static void
+kill_children( void )
+{
+	guint i;
+	GPid pid;
+
+	for( i = 0 ; i < st_children->len ; ++i ){
+		pid = g_array_index( st_children, GPid, i );
+		kill( pid, SIGKILL );
+		waitpid( pid, NULL, 0 );
+		g_spawn_close_pid( pid );
+	}
+
+	g_array_set_size( st_children, 0 );
+}
+
+static void
+run_bench( void )
+{
+	gchar *names[ CONDITIONS ];
+	gint64 start, scan_best, cache_best;
+	guint i, run, processes;
+
+	for( i = 0 ; i < CONDITIONS ; ++i ){
+		names[i] = g_strdup_printf( "fma-bench-%u", i );
+	}
+
+	scan_best = G_MAXINT64;
+	cache_best = G_MAXINT64;
+
+	for( run = 0 ; run < RUNS ; ++run ){
+		start = g_get_monotonic_time();
+		for( i = 0 ; i < CONDITIONS ; ++i ){
+			scan_is_running( names[i] );
+		}
+		scan_best = MIN( scan_best, g_get_monotonic_time() - start );
+
+		start = g_get_monotonic_time();
+		fma_process_cache_begin();
+		for( i = 0 ; i < CONDITIONS ; ++i ){
+			fma_process_cache_is_running( names[i] );
+		}
+		cache_best = MIN( cache_best, g_get_monotonic_time() - start );
+	}
+
+	processes = count_processes();
+
+	g_printf( "processes=%6u: full scan per condition %10.3f ms, shared set %8.3f ms, %7.3f us per process\n",
+			processes, scan_best / 1000.0, cache_best / 1000.0, processes ? ( gdouble ) cache_best / processes : 0.0 );
+
+	for( i = 0 ; i < CONDITIONS ; ++i ){
+		g_free( names[i] );
+	}
+}
+
+/* debug output would hide the results
+ */
+static void
+log_handler( const gchar *log_domain, GLogLevelFlags log_level, const gchar *message, gpointer user_data )
+{
+}
+
+int
+main( int argc, char** argv )
+{
+	gchar *root, *dir, *fname, *sleep_path, *link_path;
+	gchar *child_argv[] = { NULL, "600", NULL };
+	guint scans_before, scans_after;
+	GError *error;
+	GPid pid;
+	guint i;
+
+#if !GLIB_CHECK_VERSION( 2,36, 0 )
+	g_type_init();
+#endif
+
+	g_log_set_handler( G_LOG_DOMAIN, G_LOG_LEVEL_DEBUG, log_handler, NULL );
+
+	g_printf( "FMAProcessCache test.\n\n" );
+
+	/* refresh the set once per evaluation round, whatever be the user
+	 * configuration
+	 */
+	root = g_dir_make_tmp( "fma-test-process-cache-XXXXXX", NULL );
+	if( !root ){
+		g_printerr( "unable to create a temporary directory\n" );
+		return( EXIT_FAILURE );
+	}
+	g_setenv( "XDG_CONFIG_HOME", root, TRUE );
+	dir = g_build_filename( root, PACKAGE, NULL );
+	g_mkdir_with_parents( dir, 0700 );
+	fname = g_strdup_printf( "%s/%s.conf", dir, PACKAGE );
+	g_file_set_contents( fname, "[runtime]\nshow-if-running-refresh-interval=0\n", -1, NULL );
+
+	sleep_path = g_find_program_in_path( "sleep" );
+	link_path = g_build_filename( root, PROCESS_NAME, NULL );
+
+	if( !sleep_path || symlink( sleep_path, link_path ) != 0 ){
+		g_printerr( "unable to link the 'sleep' program\n" );
+		return( EXIT_FAILURE );
+	}
+
+	check( !wait_running( FALSE ), "the process is not running before being spawned" );
+
+	child_argv[0] = link_path;
+	error = NULL;
+	if( !g_spawn_async( NULL, child_argv, NULL,
+			G_SPAWN_DO_NOT_REAP_CHILD | G_SPAWN_STDOUT_TO_DEV_NULL, NULL, NULL, &pid, &error )){
+		g_printerr( "unable to spawn the process: %s\n", error->message );
+		g_error_free( error );
+		return( EXIT_FAILURE );
+	}
+
+	check( wait_running( TRUE ), "the spawned process is running" );
+
+	/* the set is shared by all the lookups of an evaluation round
+	 */
+	fma_process_cache_begin();
+	fma_process_cache_get_stats( &scans_before, NULL, NULL );
+	fma_process_cache_is_running( PROCESS_NAME );
+	fma_process_cache_is_running( "fma-test-none" );
+	fma_process_cache_get_stats( &scans_after, NULL, NULL );
+	check( scans_after == scans_before+1, "the process table is scanned once per evaluation round" );
+
+	kill( pid, SIGKILL );
+	waitpid( pid, NULL, 0 );
+	g_spawn_close_pid( pid );
+
+	check( !wait_running( FALSE ), "the killed process is no more running" );
+
+	g_printf( "\nShowIfRunning evaluation of %u conditions (best of %u runs).\n\n", CONDITIONS, RUNS );
+
+	st_children = g_array_new( FALSE, FALSE, sizeof( GPid ));
+
+	for( i = 0 ; counts[i] != G_MAXUINT ; ++i ){
+		if( !spawn_children( counts[i] )){
+			break;
+		}
+		run_bench();
+	}
+
+	kill_children();
+	g_array_free( st_children, TRUE );
+	fma_process_cache_free();
+
+	g_unlink( link_path );
+	g_unlink( fname );
+	g_rmdir( dir );
+	g_rmdir( root );
+	g_free( link_path );
+	g_free( sleep_path );
+	g_free( fname );
+	g_free( dir );
+	g_free( root );
+
+	g_printf( "\n%u error(s)\n", st_errors );
+
+	return( st_errors ? EXIT_FAILURE : EXIT_SUCCESS );
+}
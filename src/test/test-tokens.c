@@ -0,0 +1,223 @@
+/*
+ * FileManager-Actions
+ * A file-manager extension which offers configurable context menu actions.
+ *
+ * Copyright (C) 2005 The GNOME Foundation
+ * Copyright (C) 2006-2008 Frederic Ruaudel and others (see AUTHORS)
+ * Copyright (C) 2009-2015 Pierre Wieser and others (see AUTHORS)
+ *
+ * FileManager-Actions is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * FileManager-Actions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FileManager-Actions; see the file COPYING. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Authors:
+ *   Frederic Ruaudel <grumz@grumz.net>
+ *   Rodrigo Moya <rodrigo@gnome-db.org>
+ *   Pierre Wieser <pwieser@trychlos.org>
+ *   ... and many others (see AUTHORS)
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <glib-object.h>
+#include <glib/gprintf.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <core/fma-selected-info.h>
+#include <core/fma-tokens.h>
+
+/* Checks the expansion of the parameters against a small known selection.
+ * When run with '--bench', also measures the time needed to build the
+ * FMATokens of a huge selection, and to expand singular and plural
+ * parameters against it.
+ * The FMASelectedInfo items are built without any i/o, so the files do
+ * not need to exist.
+ */
+
+static const gchar *uris[] = {
+		"file:///tmp/fma%20test/a%20b.txt",
+		"file:///tmp/fma%20test/it's.tar.gz",
+		"file:///tmp/README",
+		NULL
+};
+
+typedef struct {
+	const gchar *input;
+	const gchar *display;
+	const gchar *command;
+}
+	sCheck;
+
+static const sCheck checks[] = {
+		{ "%b",       "a b.txt",                         "'a b.txt'" },
+		{ "%d",       "/tmp/fma test",                   "'/tmp/fma test'" },
+		{ "%f",       "/tmp/fma test/a b.txt",           "'/tmp/fma test/a b.txt'" },
+		{ "%w",       "a b",                             "'a b'" },
+		{ "%x",       "txt",                             "'txt'" },
+		{ "%m",       "text/plain",                      "text/plain" },
+		{ "%B",       "a b.txt it's.tar.gz README",      "'a b.txt' 'it'\\''s.tar.gz' 'README'" },
+		{ "%D",       "/tmp/fma test /tmp/fma test /tmp", "'/tmp/fma test' '/tmp/fma test' '/tmp'" },
+		{ "%W",       "a b it's.tar README",             "'a b' 'it'\\''s.tar' 'README'" },
+		{ "%c %s %%", "3 file %",                        "3 'file' %" },
+		{ "cmd %",    "cmd %",                           "cmd %" },
+		{ "",         "",                                "" },
+		{ NULL }
+};
+
+static const guint counts[] = { 10000, 100000, 0 };
+
+static const gchar *commands[] = {
+		"%b",
+		"%F",
+		"%U",
+		"%B %M",
+		NULL
+};
+
+static GList *
+build_selection( void )
+{
+	GList *selection;
+	guint i;
+
+	selection = NULL;
+
+	for( i = 0 ; uris[i] ; ++i ){
+		selection = g_list_prepend( selection,
+				fma_selected_info_new_from_file_manager( uris[i], "text/plain", G_FILE_TYPE_REGULAR, TRUE ));
+	}
+
+	return( g_list_reverse( selection ));
+}
+
+static gboolean
+check_output( const gchar *input, const gchar *mode, gchar *output, const gchar *expected )
+{
+	gboolean ok;
+
+	ok = ( g_strcmp0( output, expected ) == 0 );
+
+	if( ok ){
+		g_printf( "PASS: %s '%s' -> '%s'\n", mode, input, output );
+	} else {
+		g_printf( "FAIL: %s '%s' -> '%s', expected '%s'\n", mode, input, output, expected );
+	}
+
+	g_free( output );
+
+	return( ok );
+}
+
+static GList *
+build_bench_selection( guint count )
+{
+	GList *selection;
+	gchar *uri;
+	guint i;
+
+	selection = NULL;
+
+	for( i = 0 ; i < count ; ++i ){
+		uri = g_strdup_printf( "file:///tmp/fma-bench/dir-%03u/file-%06u.txt", i % 100, i );
+		selection = g_list_prepend( selection,
+				fma_selected_info_new_from_file_manager( uri, "text/plain", G_FILE_TYPE_REGULAR, TRUE ));
+		g_free( uri );
+	}
+
+	return( g_list_reverse( selection ));
+}
+
+static void
+run_bench( guint count )
+{
+	GList *selection;
+	FMATokens *tokens;
+	gchar *output;
+	gint64 start;
+	guint i;
+
+	selection = build_bench_selection( count );
+	g_printf( "count=%u\n", count );
+
+	start = g_get_monotonic_time();
+	tokens = fma_tokens_new_from_selection( selection );
+	g_printf( "  fma_tokens_new_from_selection: %8.3f ms\n", ( g_get_monotonic_time() - start ) / 1000.0 );
+
+	for( i = 0 ; commands[i] ; ++i ){
+		start = g_get_monotonic_time();
+		output = fma_tokens_parse_for_display( tokens, commands[i], FALSE );
+		g_printf( "  parse '%s': %8.3f ms (%lu bytes)\n",
+				commands[i], ( g_get_monotonic_time() - start ) / 1000.0, ( unsigned long ) strlen( output ));
+		g_free( output );
+	}
+
+	g_object_unref( tokens );
+	fma_selected_info_free_list( selection );
+	g_printf( "\n" );
+}
+
+/* debug output would hide the results
+ */
+static void
+log_handler( const gchar *log_domain, GLogLevelFlags log_level, const gchar *message, gpointer user_data )
+{
+}
+
+int
+main( int argc, char** argv )
+{
+	GList *selection;
+	FMATokens *tokens;
+	guint i, errors;
+
+#if !GLIB_CHECK_VERSION( 2,36, 0 )
+	g_type_init();
+#endif
+
+	g_log_set_handler( G_LOG_DOMAIN, G_LOG_LEVEL_DEBUG, log_handler, NULL );
+
+	g_printf( "FMATokens expansion test.\n\n" );
+
+	selection = build_selection();
+	tokens = fma_tokens_new_from_selection( selection );
+	errors = 0;
+
+	for( i = 0 ; checks[i].input ; ++i ){
+		if( !check_output( checks[i].input, "display",
+				fma_tokens_parse_for_display( tokens, checks[i].input, FALSE ), checks[i].display )){
+			errors += 1;
+		}
+		if( !check_output( checks[i].input, "command",
+				fma_tokens_parse_for_command( tokens, checks[i].input ), checks[i].command )){
+			errors += 1;
+		}
+	}
+
+	g_object_unref( tokens );
+	fma_selected_info_free_list( selection );
+
+	g_printf( "\n%u error(s)\n", errors );
+
+	if( argc > 1 && !strcmp( argv[1], "--bench" )){
+		g_printf( "\nFMATokens benchmark.\n\n" );
+
+		for( i = 0 ; counts[i] ; ++i ){
+			run_bench( counts[i] );
+		}
+	}
+
+	return( errors ? EXIT_FAILURE : EXIT_SUCCESS );
+}